@@ -26,9 +26,11 @@
 
 #include "helpers.h"
 
+#include <errno.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #ifndef _WIN32           /* { */
 #include <syslog.h>
 #include <unistd.h>
@@ -82,13 +84,40 @@ static char logger_level_char(logger_level_t level)
 #define DEFAULT_TEMP_PATH     "/tmp"
 #endif                       /* } */
 
+#define LOGGER_RING_SLOTS         4096         /* shall be power of 2 */
+#define LOGGER_SLOT_SIZE          1024
+
+typedef struct logger_slot_s               logger_slot_t;
+struct logger_slot_s {
+  atomic_int            seq;
+  char                  log[LOGGER_SLOT_SIZE];
+};
+
+// bounded lock-free multi-producer/single-consumer ring, drained by a background writer
+typedef struct logger_ring_s               logger_ring_t;
+struct logger_ring_s {
+  logger_slot_t        *slots;
+  atomic_int            enqueue_pos;
+  int                   dequeue_pos;         // owned by the writer
+  atomic_int            dropped;
+  atomic_int            stop;
+  atomic_int            stopped;
+  pthread_t             writer;
+};
+
 typedef struct logger_temp_s               logger_temp_t;
 struct logger_temp_s {
   FILE                  *file;
+  char                   path[TEMP_MAX_PATH+1];
+  size_t                 size;
+  size_t                 max_size;           // TAOS_ODBC_LOG_MAX_SIZE, 0 to never rotate
+  pthread_mutex_t        mutex;              // for synchronous writing only
+  logger_ring_t          ring;               // TAOS_ODBC_LOG_ASYNC
 };
 
 struct logger_s {
   logger_level_t            level;
+  atomic_int                no_stderr;       // TAOS_ODBC_LOG_STDERR=0, cleared by the writer once the temp file is lost
   void (*logger)(const char *log);
   union {
     logger_temp_t           temp;
@@ -98,15 +127,33 @@ struct logger_s {
 static logger_t         _system_logger;
 
 static void logger_to_temp(const char *log);
+static void logger_to_temp_async(const char *log);
+static void _temp_write(logger_temp_t *temp, const char *log);
+static size_t _ring_drain(logger_temp_t *temp);
 
 static void _exit_routine(void)
 {
-  if (_system_logger.logger == logger_to_temp) {
+  if (_system_logger.logger == logger_to_temp_async) {
     logger_temp_t *temp = &_system_logger.temp;
+    logger_ring_t *ring = &temp->ring;
+    atomic_store(&ring->stop, 1);
+    // NOTE: bounded wait, the writer might have been gone already if we are called during process teardown
+    for (int i=0; i<200 && !atomic_load(&ring->stopped); ++i) tod_sleep_ms(5);
+    if (!atomic_load(&ring->stopped)) {
+      // NOTE: the writer might still be draining into `file`, which is thus left for the process exit to close
+      return;
+    }
+    pthread_join(ring->writer, NULL);
+    _ring_drain(temp);
+  }
+  if (_system_logger.logger == logger_to_temp || _system_logger.logger == logger_to_temp_async) {
+    logger_temp_t *temp = &_system_logger.temp;
+    pthread_mutex_lock(&temp->mutex);
     if (temp->file) {
       fclose(temp->file);
       temp->file = NULL;
     }
+    pthread_mutex_unlock(&temp->mutex);
   }
 }
 
@@ -142,15 +189,143 @@ static void _init_system_logger_level(void)
       env);
 }
 
+static void _temp_rotate(logger_temp_t *temp)
+{
+  char backup[TEMP_MAX_PATH+8];
+  snprintf(backup, sizeof(backup), "%s.1", temp->path);
+
+  fclose(temp->file);
+  remove(backup);
+  rename(temp->path, backup);
+  temp->file = fopen(temp->path, "a");
+  temp->size = 0;
+  if (!temp->file) {
+    // NOTE: fall back to mirroring to stderr, rather than losing every line from now on
+    int e = errno;
+    atomic_store(&_system_logger.no_stderr, 0);
+    fprintf(stderr, "failed to reopen `%s` after rotation:[%d]%s, logging to stderr only\n", temp->path, e, strerror(e));
+  }
+}
+
+static void _temp_write(logger_temp_t *temp, const char *log)
+{
+  if (!temp->file) return;
+  int n = fprintf(temp->file, "%s\n", log);
+  if (n > 0) temp->size += (size_t)n;
+  if (temp->max_size && temp->size >= temp->max_size) {
+    fflush(temp->file);
+    _temp_rotate(temp);
+  }
+}
+
 static void logger_to_temp(const char *log)
 {
-  FILE *file = _system_logger.temp.file;
-  if (file) {
-    fprintf(file, "%s\n", log);
-    fflush(file);
+  logger_temp_t *temp = &_system_logger.temp;
+  pthread_mutex_lock(&temp->mutex);
+  _temp_write(temp, log);
+  if (temp->file) fflush(temp->file);
+  pthread_mutex_unlock(&temp->mutex);
+}
+
+static int _ring_push(logger_ring_t *ring, const char *log)
+{
+  int pos = atomic_load(&ring->enqueue_pos);
+  for (;;) {
+    logger_slot_t *slot = ring->slots + ((unsigned int)pos & (LOGGER_RING_SLOTS - 1));
+    int seq = atomic_load(&slot->seq);
+    int diff = (int)((unsigned int)seq - (unsigned int)pos);
+    if (diff == 0) {
+      int expected = pos;
+      if (atomic_compare_exchange_weak(&ring->enqueue_pos, &expected, (int)((unsigned int)pos + 1))) {
+        snprintf(slot->log, sizeof(slot->log), "%s", log);
+        atomic_store(&slot->seq, (int)((unsigned int)pos + 1));
+        return 0;
+      }
+      pos = expected;
+    } else if (diff < 0) {
+      // NOTE: full, drop rather than block the caller
+      atomic_fetch_add(&ring->dropped, 1);
+      return -1;
+    } else {
+      pos = atomic_load(&ring->enqueue_pos);
+    }
   }
 }
 
+static int _ring_pop(logger_temp_t *temp)
+{
+  logger_ring_t *ring = &temp->ring;
+  unsigned int pos = (unsigned int)ring->dequeue_pos;
+  logger_slot_t *slot = ring->slots + (pos & (LOGGER_RING_SLOTS - 1));
+  int seq = atomic_load(&slot->seq);
+  if ((int)((unsigned int)seq - (pos + 1)) != 0) return 0;
+
+  _temp_write(temp, slot->log);
+  atomic_store(&slot->seq, (int)(pos + LOGGER_RING_SLOTS));
+  ring->dequeue_pos = (int)(pos + 1);
+  return 1;
+}
+
+static size_t _ring_drain(logger_temp_t *temp)
+{
+  logger_ring_t *ring = &temp->ring;
+  size_t nr = 0;
+  pthread_mutex_lock(&temp->mutex);
+  while (_ring_pop(temp)) ++nr;
+
+  int dropped = atomic_load(&ring->dropped);
+  if (dropped) {
+    atomic_fetch_sub(&ring->dropped, dropped);
+    char buf[128];
+    snprintf(buf, sizeof(buf), "W:%d log line(s) dropped since ring buffer was full", dropped);
+    _temp_write(temp, buf);
+    ++nr;
+  }
+  if (nr && temp->file) fflush(temp->file);
+  pthread_mutex_unlock(&temp->mutex);
+
+  return nr;
+}
+
+static void* _ring_writer(void *arg)
+{
+  logger_temp_t *temp = (logger_temp_t*)arg;
+  logger_ring_t *ring = &temp->ring;
+
+  while (!atomic_load(&ring->stop)) {
+    if (_ring_drain(temp) == 0) tod_sleep_ms(2);
+  }
+  atomic_store(&ring->stopped, 1);
+
+  return NULL;
+}
+
+static void logger_to_temp_async(const char *log)
+{
+  _ring_push(&_system_logger.temp.ring, log);
+}
+
+static int _init_ring(logger_temp_t *temp)
+{
+  logger_ring_t *ring = &temp->ring;
+  ring->slots = (logger_slot_t*)malloc(sizeof(*ring->slots) * LOGGER_RING_SLOTS);
+  if (!ring->slots) return -1;
+  for (int i=0; i<LOGGER_RING_SLOTS; ++i) {
+    atomic_store(&ring->slots[i].seq, i);
+  }
+  atomic_store(&ring->enqueue_pos, 0);
+  ring->dequeue_pos = 0;
+  atomic_store(&ring->dropped, 0);
+  atomic_store(&ring->stop, 0);
+  atomic_store(&ring->stopped, 0);
+  if (pthread_create(&ring->writer, NULL, _ring_writer, temp)) {
+    free(ring->slots);
+    ring->slots = NULL;
+    return -1;
+  }
+  return 0;
+}
+
 #ifdef _WIN32              /* { */
 static void logger_to_event(const char *log)
 {
@@ -173,11 +348,36 @@ static void _init_temp(void)
 {
   const char *temp = getenv("TEMP");
   if (!temp) temp = DEFAULT_TEMP_PATH;
-  char _temp_file[TEMP_MAX_PATH+1];
-  snprintf(_temp_file, sizeof(_temp_file), "%s/taos_odbc.log", temp);
-  _system_logger.logger    = logger_to_temp;
-  _system_logger.temp.file = fopen(_temp_file, "a");
+  logger_temp_t *t = &_system_logger.temp;
+  snprintf(t->path, sizeof(t->path), "%s/taos_odbc.log", temp);
+  t->file = fopen(t->path, "a");
+  if (!t->file) {
+    int e = errno;
+    fprintf(stderr, "failed to open `%s`:[%d]%s, system logger fall back to `stderr`\n", t->path, e, strerror(e));
+    return;
+  }
   // setvbuf(_system_logger.temp.file, NULL, _IOLBF, 0);
+  fseek(t->file, 0, SEEK_END);
+  long pos = ftell(t->file);
+  t->size = pos > 0 ? (size_t)pos : 0;
+
+  const char *env = getenv("TAOS_ODBC_LOG_MAX_SIZE");
+  if (env) {
+    char *end = NULL;
+    unsigned long long v = strtoull(env, &end, 10);
+    if (end && (*end == 'k' || *end == 'K')) v *= 1024;
+    if (end && (*end == 'm' || *end == 'M')) v *= 1024 * 1024;
+    t->max_size = (size_t)v;
+  }
+
+  pthread_mutex_init(&t->mutex, NULL);
+  // NOTE: installed only after the file and mutex are ready
+  _system_logger.logger    = logger_to_temp;
+
+  env = getenv("TAOS_ODBC_LOG_ASYNC");
+  if (env && atoi(env) && _init_ring(t) == 0) {
+    _system_logger.logger  = logger_to_temp_async;
+  }
 }
 
 #ifdef _WIN32              /* { */
@@ -243,6 +443,10 @@ static void _init_all(void)
   _system_logger.level = LOGGER_ERROR;
   _init_system_logger_level();
   _init_system_logger();
+  const char *env = getenv("TAOS_ODBC_LOG_STDERR");
+  // NOTE: stderr is silenced only when lines do land in the temp file
+  int to_temp = (_system_logger.logger == logger_to_temp || _system_logger.logger == logger_to_temp_async);
+  if (env && !atoi(env) && to_temp && _system_logger.temp.file) atomic_store(&_system_logger.no_stderr, 1);
 }
 
 static void _init_all_once(void)
@@ -255,6 +459,68 @@ static void _init_all_once(void)
   }
 }
 
+#define TOD_TRACE_UNRESOLVED(_id, _name)  -1,
+#define TOD_TRACE_NAME(_id, _name)        _name,
+
+atomic_int tod_trace_flags[TOD_TRACE_NR] = {
+  TOD_TRACE_LIST(TOD_TRACE_UNRESOLVED)
+};
+
+static void _trace_set(int category, int v)
+{
+#ifdef _WIN32               /* { */
+  atomic_store(&tod_trace_flags[category], v);
+#else                       /* }{ */
+  atomic_store_explicit(&tod_trace_flags[category], v, memory_order_relaxed);
+#endif                      /* } */
+}
+
+static void _init_trace_flags(void)
+{
+  static const char *names[TOD_TRACE_NR] = {
+    TOD_TRACE_LIST(TOD_TRACE_NAME)
+  };
+
+  const char *env = getenv("TAOS_ODBC_TRACE");
+  if (!env) {
+    // NOTE: backward compatible, trace everything once DEBUG or lower is requested
+    int on = tod_get_system_logger_level() <= LOGGER_DEBUG;
+    for (int i=0; i<TOD_TRACE_NR; ++i) _trace_set(i, on);
+    return;
+  }
+
+  int flags[TOD_TRACE_NR] = {0};
+
+  const char *p = env;
+  while (*p) {
+    size_t n = strcspn(p, ",;| ");
+    if (n == 3 && tod_strncasecmp(p, "all", 3) == 0) {
+      for (int i=0; i<TOD_TRACE_NR; ++i) flags[i] = 1;
+    }
+    for (int i=0; i<TOD_TRACE_NR; ++i) {
+      if (n == strlen(names[i]) && tod_strncasecmp(p, names[i], n) == 0) flags[i] = 1;
+    }
+    p += n;
+    if (*p) ++p;
+  }
+
+  // NOTE: categories flip from unresolved straight to their final state, never transiently off
+  for (int i=0; i<TOD_TRACE_NR; ++i) _trace_set(i, flags[i]);
+}
+
+int tod_trace_resolve(tod_trace_t category)
+{
+  static pthread_once_t once = PTHREAD_ONCE_INIT;
+  pthread_once(&once, _init_trace_flags);
+  return tod_trace_flag(category) > 0;
+}
+
+void tod_trace_enable(tod_trace_t category, int on)
+{
+  (void)tod_trace_resolve(category);
+  _trace_set(category, !!on);
+}
+
 logger_level_t tod_get_system_logger_level(void)
 {
   _init_all_once();
@@ -304,8 +570,13 @@ void tod_logger_write_impl(logger_t *logger, logger_level_t request, logger_leve
   vsnprintf(p, l, fmt, ap);
   va_end(ap);
 
-  fprintf(stderr, "%s\n", buf);
+  if (!logger || !atomic_load(&logger->no_stderr)) fprintf(stderr, "%s\n", buf);
   if (logger && logger->logger) {
-    logger->logger(buf);
+    if (request >= LOGGER_FATAL && logger->logger == logger_to_temp_async) {
+      // NOTE: about to abort, don't let it sit in the ring
+      logger_to_temp(buf);
+    } else {
+      logger->logger(buf);
+    }
   }
 }
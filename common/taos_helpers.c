@@ -54,15 +54,10 @@ void bridge_taos_stmt_reclaim_fields(TAOS_STMT *stmt, TAOS_FIELD_E *fields)
 #endif
 }
 
-int helper_get_tsdb(TAOS_RES *res, int block, TAOS_FIELD *fields, int time_precision, TAOS_ROW rows, int i_row, int i_col, tsdb_data_t *tsdb, char *buf, size_t len)
+static int _helper_get_tsdb_value(TAOS_RES *res, int block, int * const *offsets, TAOS_FIELD *fields, int time_precision, TAOS_ROW rows, int i_row, int i_col, tsdb_data_t *tsdb, char *buf, size_t len)
 {
   TAOS_FIELD *field = fields + i_col;
 
-  if (CALL_taos_is_null(res, i_row, i_col)) {
-    tsdb->is_null = 1;
-    return 0;
-  }
-
   tsdb->is_null = 0;
 
   switch(field->type) {
@@ -135,9 +130,10 @@ int helper_get_tsdb(TAOS_RES *res, int block, TAOS_FIELD *fields, int time_preci
     case TSDB_DATA_TYPE_VARCHAR:
     case TSDB_DATA_TYPE_NCHAR:
       if (block) {
-        int *offsets = CALL_taos_get_column_data_offset(res, i_col);
+        int *col_offsets = offsets ? offsets[i_col] : NULL;
+        if (!col_offsets) col_offsets = CALL_taos_get_column_data_offset(res, i_col);
         char *col = (char*)(rows[i_col]);
-        col += offsets[i_row];
+        col += col_offsets[i_row];
         int16_t length = *(int16_t*)col;
         col += sizeof(int16_t);
         tsdb->str.str = col;
@@ -166,6 +162,31 @@ int helper_get_tsdb(TAOS_RES *res, int block, TAOS_FIELD *fields, int time_preci
   return 0;
 }
 
+static int _helper_get_tsdb(TAOS_RES *res, int block, int * const *offsets, TAOS_FIELD *fields, int time_precision, TAOS_ROW rows, int i_row, int i_col, tsdb_data_t *tsdb, char *buf, size_t len)
+{
+  if (CALL_taos_is_null(res, i_row, i_col)) {
+    tsdb->is_null = 1;
+    return 0;
+  }
+
+  return _helper_get_tsdb_value(res, block, offsets, fields, time_precision, rows, i_row, i_col, tsdb, buf, len);
+}
+
+int helper_get_tsdb(TAOS_RES *res, int block, TAOS_FIELD *fields, int time_precision, TAOS_ROW rows, int i_row, int i_col, tsdb_data_t *tsdb, char *buf, size_t len)
+{
+  return _helper_get_tsdb(res, block, NULL, fields, time_precision, rows, i_row, i_col, tsdb, buf, len);
+}
+
+int helper_get_tsdb_block(TAOS_RES *res, int * const *offsets, TAOS_FIELD *fields, int time_precision, TAOS_ROW rows, int i_row, int i_col, tsdb_data_t *tsdb, char *buf, size_t len)
+{
+  return _helper_get_tsdb(res, 1, offsets, fields, time_precision, rows, i_row, i_col, tsdb, buf, len);
+}
+
+int helper_get_tsdb_value(int * const *offsets, TAOS_FIELD *fields, int time_precision, TAOS_ROW rows, int i_row, int i_col, tsdb_data_t *tsdb, char *buf, size_t len)
+{
+  return _helper_get_tsdb_value(NULL, 1, offsets, fields, time_precision, rows, i_row, i_col, tsdb, buf, len);
+}
+
 
 #ifdef FAKE_TAOS
 void taos_cleanup(void)
@@ -215,17 +236,29 @@ const char* taos_data_type(int type)
   return "unknown taos_data_type";
 }
 
+// sql containing `fake_insert` is prepared as an insert into a normal table of one INT column,
+// and `fake_insert_fail` the same, but taos_stmt_execute fails
+typedef struct fake_stmt_s            fake_stmt_t;
+struct fake_stmt_s {
+  int                   insert;
+  int                   fail;
+};
+
+static TAOS_FIELD_E         _fake_insert_field = {"v", TSDB_DATA_TYPE_INT, 0, 0, 4};
+
 TAOS_STMT* taos_stmt_init(TAOS *taos)
 {
   (void)taos;
-  return (TAOS_STMT*)1;
+  return (TAOS_STMT*)calloc(1, sizeof(fake_stmt_t));
 }
 
 int taos_stmt_prepare(TAOS_STMT *stmt, const char *sql, unsigned long length)
 {
-  (void)stmt;
-  (void)sql;
-  (void)length;
+  fake_stmt_t *fake = (fake_stmt_t*)stmt;
+  char buf[1024];
+  snprintf(buf, sizeof(buf), "%.*s", (int)length, sql);
+  fake->insert = !!strstr(buf, "fake_insert");
+  fake->fail   = !!strstr(buf, "fake_insert_fail");
   return 0;
 }
 
@@ -261,16 +294,16 @@ int taos_stmt_set_sub_tbname(TAOS_STMT *stmt, const char *name)
 int taos_stmt_get_tag_fields(TAOS_STMT *stmt, int *fieldNum, TAOS_FIELD_E **fields)
 {
   (void)stmt;
-  (void)fieldNum;
-  (void)fields;
+  if (fieldNum) *fieldNum = 0;
+  if (fields) *fields = NULL;
   return 0;
 }
 
 int taos_stmt_get_col_fields(TAOS_STMT *stmt, int *fieldNum, TAOS_FIELD_E **fields)
 {
-  (void)stmt;
-  if (fieldNum) *fieldNum = 0;
-  if (fields) *fields = NULL;
+  fake_stmt_t *fake = (fake_stmt_t*)stmt;
+  if (fieldNum) *fieldNum = fake->insert ? 1 : 0;
+  if (fields) *fields = fake->insert ? &_fake_insert_field : NULL;
   return 0;
 }
 
@@ -282,8 +315,7 @@ void taos_stmt_reclaim_fields(TAOS_STMT *stmt, TAOS_FIELD_E *fields)
 
 int taos_stmt_is_insert(TAOS_STMT *stmt, int *insert)
 {
-  (void)stmt;
-  if (insert) *insert = 0;
+  if (insert) *insert = ((fake_stmt_t*)stmt)->insert;
   return 0;
 }
 
@@ -333,8 +365,7 @@ int taos_stmt_add_batch(TAOS_STMT *stmt)
 
 int taos_stmt_execute(TAOS_STMT *stmt)
 {
-  (void)stmt;
-  return 0;
+  return ((fake_stmt_t*)stmt)->fail ? -1 : 0;
 }
 
 TAOS_RES* taos_stmt_use_result(TAOS_STMT *stmt)
@@ -345,13 +376,13 @@ TAOS_RES* taos_stmt_use_result(TAOS_STMT *stmt)
 
 int taos_stmt_close(TAOS_STMT *stmt)
 {
-  (void)stmt;
+  free(stmt);
   return 0;
 }
 
 char* taos_stmt_errstr(TAOS_STMT *stmt)
 {
-  (void)stmt;
+  if (stmt && ((fake_stmt_t*)stmt)->fail) return "fake_insert_fail";
   return "unknown taos_stmt_errstr";
 }
 
@@ -367,10 +398,93 @@ int taos_stmt_affected_rows_once(TAOS_STMT *stmt)
   return 0;
 }
 
+// blocking fakes, to exercise SQLCancel/SQL_ATTR_QUERY_TIMEOUT without a server:
+//   sql containing `fake_blocking_query` blocks in taos_query until taos_kill_query
+//   sql containing `fake_blocking_fetch` returns a one-column result, whose taos_fetch_block blocks until taos_stop_query
+static atomic_int           _fake_killed;
+static atomic_int           _fake_stopped;
+static char                 _fake_blocking_res;
+static TAOS_FIELD           _fake_blocking_field = {"v", TSDB_DATA_TYPE_INT, 4};
+#define FAKE_BLOCKING_RES   ((TAOS_RES*)&_fake_blocking_res)
+
+// sql containing `fake_ins_ok` succeeds, affecting a row per `(`, thus plain inserts without column list,
+// and sql containing `fake_ins_bad` fails, merged inserts included
+static char                 _fake_failed_res;
+#define FAKE_FAILED_RES     ((TAOS_RES*)&_fake_failed_res)
+
+// NOTE: a kill/stop issued before the blocking call is entered is dropped, as taosc does, thus callers cancel repeatedly
+static void _fake_block_until(atomic_int *flag)
+{
+  atomic_store(flag, 0);
+  while (atomic_load(flag) == 0) tod_sleep_ms(1);
+  atomic_store(flag, 0);
+}
+
+// sql containing `fake_rows:<n>` returns a one-column result of INT 0 .. n-1, in blocks of FAKE_ROWS_PER_BLOCK,
+// each result with a cursor of its own, to exercise concurrent statements without a server
+// sql containing `fake_wide:<n>` returns `ts timestamp, v int, name varchar, b bool` the same way, row #r of which is:
+//   1600000000000 + r * 1000, r or null if r % 3 == 2, 'n<r>' or null if r % 5 == 4, r % 2
+#define FAKE_ROWS_PER_BLOCK 64
+typedef struct fake_rows_s            fake_rows_t;
+struct fake_rows_s {
+  int32_t               next;
+  int32_t               total;
+  int32_t               first;              // row # of the first row in the current block
+  int32_t               base;               // value of row #0
+  int                   nr_cols;
+  int                   affected;
+  int32_t               vals[FAKE_ROWS_PER_BLOCK];
+  int64_t               tss[FAKE_ROWS_PER_BLOCK];
+  int32_t               offsets[FAKE_ROWS_PER_BLOCK];
+  char                  strs[FAKE_ROWS_PER_BLOCK * 16];
+  int8_t                bools[FAKE_ROWS_PER_BLOCK];
+  void                 *cols[4];
+  TAOS_ROW              block;              // for taos_result_block
+};
+
+static TAOS_FIELD           _fake_wide_fields[] = {
+  {"ts",   TSDB_DATA_TYPE_TIMESTAMP, 8},
+  {"v",    TSDB_DATA_TYPE_INT,       4},
+  {"name", TSDB_DATA_TYPE_VARCHAR,   16},
+  {"b",    TSDB_DATA_TYPE_BOOL,      1},
+};
+
+static int _fake_is_rows(TAOS_RES *res)
+{
+  return res && res != (TAOS_RES*)1 && res != FAKE_BLOCKING_RES && res != FAKE_FAILED_RES;
+}
+
 TAOS_RES* taos_query(TAOS *taos, const char *sql)
 {
   (void)taos;
-  (void)sql;
+  if (sql && strstr(sql, "fake_blocking_query")) {
+    _fake_block_until(&_fake_killed);
+    return (TAOS_RES*)1;
+  }
+  if (sql && strstr(sql, "fake_blocking_fetch")) return FAKE_BLOCKING_RES;
+  if (sql && strstr(sql, "fake_ins_bad")) return FAKE_FAILED_RES;
+  if (sql && strstr(sql, "fake_ins_ok")) {
+    fake_rows_t *rows = (fake_rows_t*)calloc(1, sizeof(*rows));
+    if (!rows) return NULL;
+    for (const char *s = sql; *s; ++s) rows->affected += (*s == '(');
+    return (TAOS_RES*)rows;
+  }
+  const char *p = sql ? strstr(sql, "fake_rows:") : NULL;
+  if (p) {
+    fake_rows_t *rows = (fake_rows_t*)calloc(1, sizeof(*rows));
+    if (!rows) return NULL;
+    rows->total = atoi(p + strlen("fake_rows:"));
+    rows->nr_cols = 1;
+    return (TAOS_RES*)rows;
+  }
+  p = sql ? strstr(sql, "fake_wide:") : NULL;
+  if (p) {
+    fake_rows_t *rows = (fake_rows_t*)calloc(1, sizeof(*rows));
+    if (!rows) return NULL;
+    rows->total = atoi(p + strlen("fake_wide:"));
+    rows->nr_cols = sizeof(_fake_wide_fields) / sizeof(_fake_wide_fields[0]);
+    return (TAOS_RES*)rows;
+  }
   return (TAOS_RES*)1;
 }
 
@@ -388,30 +502,30 @@ int taos_result_precision(TAOS_RES *res)  // get the time precision of result
 
 void taos_free_result(TAOS_RES *res)
 {
-  (void)res;
+  if (_fake_is_rows(res)) free(res);
 }
 
 void taos_kill_query(TAOS *taos)
 {
   (void)taos;
+  atomic_store(&_fake_killed, 1);
 }
 
 int taos_field_count(TAOS_RES *res)
 {
-  (void)res;
-  return 0;
+  if (_fake_is_rows(res)) return ((fake_rows_t*)res)->nr_cols;
+  return (res == FAKE_BLOCKING_RES) ? 1 : 0;
 }
 
 int taos_affected_rows(TAOS_RES *res)
 {
-  (void)res;
-  return 0;
+  return _fake_is_rows(res) ? ((fake_rows_t*)res)->affected : 0;
 }
 
 TAOS_FIELD* taos_fetch_fields(TAOS_RES *res)
 {
-  (void)res;
-  return NULL;
+  if (_fake_is_rows(res) && ((fake_rows_t*)res)->nr_cols > 1) return _fake_wide_fields;
+  return (res == FAKE_BLOCKING_RES || _fake_is_rows(res)) ? &_fake_blocking_field : NULL;
 }
 
 int taos_select_db(TAOS *taos, const char *db)
@@ -432,14 +546,15 @@ int taos_print_row(char *str, TAOS_ROW row, TAOS_FIELD *fields, int num_fields)
 
 void taos_stop_query(TAOS_RES *res)
 {
-  (void)res;
+  if (res == FAKE_BLOCKING_RES) atomic_store(&_fake_stopped, 1);
 }
 
 bool taos_is_null(TAOS_RES *res, int32_t row, int32_t col)
 {
-  (void)res;
-  (void)row;
-  (void)col;
+  if (!_fake_is_rows(res) || ((fake_rows_t*)res)->nr_cols == 1) return 0;
+  int32_t r = ((fake_rows_t*)res)->first + row;
+  if (col == 1) return r % 3 == 2;
+  if (col == 2) return r % 5 == 4;
   return 0;
 }
 
@@ -451,9 +566,38 @@ bool taos_is_update_query(TAOS_RES *res)
 
 int taos_fetch_block(TAOS_RES *res, TAOS_ROW *rows)
 {
-  (void)res;
+  if (res == FAKE_BLOCKING_RES) _fake_block_until(&_fake_stopped);
   if (rows) *rows = NULL;
-  return 0;
+  if (!_fake_is_rows(res)) return 0;
+
+  fake_rows_t *fake = (fake_rows_t*)res;
+  int nr = fake->total - fake->next;
+  if (nr > FAKE_ROWS_PER_BLOCK) nr = FAKE_ROWS_PER_BLOCK;
+  fake->first = fake->next;
+  for (int i=0; i<nr; ++i) fake->vals[i] = fake->base + fake->next + i;
+  fake->next += nr;
+  fake->cols[0] = fake->vals;
+  if (fake->nr_cols > 1) {
+    size_t n = 0;
+    for (int i=0; i<nr; ++i) {
+      int32_t r = fake->first + i;
+      fake->tss[i] = 1600000000000LL + r * 1000LL;
+      fake->bools[i] = (int8_t)(r % 2);
+      fake->offsets[i] = -1;
+      if (r % 5 == 4) continue;
+      fake->offsets[i] = (int32_t)n;
+      int16_t len = (int16_t)snprintf(fake->strs + n + sizeof(len), 14, "n%d", r);
+      memcpy(fake->strs + n, &len, sizeof(len));
+      n += sizeof(len) + (size_t)len;
+    }
+    fake->cols[0] = fake->tss;
+    fake->cols[1] = fake->vals;
+    fake->cols[2] = fake->strs;
+    fake->cols[3] = fake->bools;
+  }
+  fake->block = nr ? (TAOS_ROW)fake->cols : NULL;
+  if (rows) *rows = fake->cols;
+  return nr;
 }
 
 int taos_fetch_block_s(TAOS_RES *res, int *numOfRows, TAOS_ROW *rows)
@@ -474,8 +618,7 @@ int taos_fetch_raw_block(TAOS_RES *res, int *numOfRows, void **pData)
 
 int* taos_get_column_data_offset(TAOS_RES *res, int columnIndex)
 {
-  (void)res;
-  (void)columnIndex;
+  if (_fake_is_rows(res) && ((fake_rows_t*)res)->nr_cols > 1 && columnIndex == 2) return ((fake_rows_t*)res)->offsets;
   return 0;
 }
 
@@ -499,8 +642,8 @@ int* taos_fetch_lengths(TAOS_RES *res)
 
 TAOS_ROW* taos_result_block(TAOS_RES *res)
 {
-  (void)res;
-  return NULL;
+  if (!_fake_is_rows(res) || !((fake_rows_t*)res)->block) return NULL;
+  return &((fake_rows_t*)res)->block;
 }
 
 const char* taos_get_server_info(TAOS *taos)
@@ -516,29 +659,73 @@ const char* taos_get_client_info(void)
 
 const char* taos_errstr(TAOS_RES *res)
 {
-  (void)res;
+  if (res == FAKE_FAILED_RES) return "fake_ins_bad";
   return "unknown taos_errstr";
 }
 
 int taos_errno(TAOS_RES *res)
 {
-  (void)res;
-  return 0;
+  return (res == FAKE_FAILED_RES) ? -1 : 0;
+}
+
+// async fakes call back from a thread of their own after FAKE_ASYNC_DELAY_MS, thus callers see SQL_STILL_EXECUTING
+#define FAKE_ASYNC_DELAY_MS 5
+typedef struct fake_async_s           fake_async_t;
+struct fake_async_s {
+  TAOS                 *taos;
+  char                 *sql;                // taos_query_a if not NULL, taos_fetch_rows_a otherwise
+  TAOS_RES             *res;
+  __taos_async_fn_t     fp;
+  void                 *param;
+};
+
+static void _fake_async_run(fake_async_t *async)
+{
+  if (async->sql) {
+    TAOS_RES *res = taos_query(async->taos, async->sql);
+    async->fp(async->param, res, 0);
+  } else {
+    async->fp(async->param, async->res, taos_fetch_block(async->res, NULL));
+  }
+}
+
+static void* _fake_async_routine(void *arg)
+{
+  fake_async_t *async = (fake_async_t*)arg;
+  tod_sleep_ms(FAKE_ASYNC_DELAY_MS);
+  _fake_async_run(async);
+  free(async->sql);
+  free(async);
+  return NULL;
+}
+
+static void _fake_async(fake_async_t *async)
+{
+  fake_async_t *p = (fake_async_t*)calloc(1, sizeof(*p));
+  if (p) {
+    *p = *async;
+    p->sql = async->sql ? strdup(async->sql) : NULL;
+    pthread_t thread;
+    if ((!async->sql || p->sql) && pthread_create(&thread, NULL, _fake_async_routine, p) == 0) {
+      pthread_detach(thread);
+      return;
+    }
+    free(p->sql);
+    free(p);
+  }
+  _fake_async_run(async);
 }
 
 void taos_query_a(TAOS *taos, const char *sql, __taos_async_fn_t fp, void *param)
 {
-  (void)taos;
-  (void)sql;
-  (void)fp;
-  (void)param;
+  fake_async_t async = {taos, (char*)sql, NULL, fp, param};
+  _fake_async(&async);
 }
 
 void taos_fetch_rows_a(TAOS_RES *res, __taos_async_fn_t fp, void *param)
 {
-  (void)res;
-  (void)fp;
-  (void)param;
+  fake_async_t async = {NULL, NULL, res, fp, param};
+  _fake_async(&async);
 }
 
 void taos_fetch_raw_block_a(TAOS_RES *res, __taos_async_fn_t fp, void *param)
@@ -561,31 +748,141 @@ int taos_load_table_info(TAOS *taos, const char *tableNameList)
   return -1;
 }
 
+// schemaless payloads are counted rather than parsed: a row per non-empty line of line/telnet protocol,
+// or per top-level object of json protocol, and payload containing `fake_sml_bad` fails
+static int _fake_sml_rows(const char *s, int len, int protocol)
+{
+  int rows = 0;
+  if (protocol == TSDB_SML_JSON_PROTOCOL) {
+    int depth = 0, quoted = 0;
+    for (int i=0; i<len; ++i) {
+      char c = s[i];
+      if (quoted) {
+        if (c == '\\') ++i;
+        else if (c == '"') quoted = 0;
+        continue;
+      }
+      if (c == '"') quoted = 1;
+      else if (c == '{' && depth++ == 0) ++rows;
+      else if (c == '}') --depth;
+    }
+    return rows;
+  }
+  int empty = 1;
+  for (int i=0; i<len; ++i) {
+    if (s[i] == '\n') {
+      rows += !empty;
+      empty = 1;
+    } else if (s[i] != '\r' && s[i] != ' ') {
+      empty = 0;
+    }
+  }
+  return rows + !empty;
+}
+
+static int _fake_sml_bad(const char *s, int len)
+{
+  const char *needle = "fake_sml_bad";
+  int n = (int)strlen(needle);
+  for (int i=0; i+n<=len; ++i) {
+    if (strncmp(s + i, needle, (size_t)n) == 0) return 1;
+  }
+  return 0;
+}
+
+static TAOS_RES* _fake_sml_res(int rows)
+{
+  fake_rows_t *res = (fake_rows_t*)calloc(1, sizeof(*res));
+  if (!res) return NULL;
+  res->affected = rows;
+  return (TAOS_RES*)res;
+}
+
 TAOS_RES* taos_schemaless_insert(TAOS *taos, char *lines[], int numLines, int protocol, int precision)
 {
   (void)taos;
-  (void)lines;
-  (void)numLines;
-  (void)protocol;
   (void)precision;
+  int rows = 0;
+  for (int i=0; i<numLines; ++i) {
+    if (_fake_sml_bad(lines[i], (int)strlen(lines[i]))) return FAKE_FAILED_RES;
+    rows += _fake_sml_rows(lines[i], (int)strlen(lines[i]), protocol);
+  }
+  return _fake_sml_res(rows);
+}
+
+TAOS_RES* taos_schemaless_insert_raw(TAOS *taos, char *lines, int len, int32_t *totalRows, int protocol, int precision)
+{
+  (void)taos;
+  (void)precision;
+  if (totalRows) *totalRows = 0;
+  if (_fake_sml_bad(lines, len)) return FAKE_FAILED_RES;
+  int rows = _fake_sml_rows(lines, len, protocol);
+  if (totalRows) *totalRows = rows;
+  return _fake_sml_res(rows);
+}
+
+// fake tmq, configured thru tmq_conf_set, to exercise topic without a server:
+//   `fake.messages=<n>`: # of messages shared among consumers created from the same conf, each of which is
+//                        a one-column result of FAKE_TMQ_ROWS INTs, continuously numbered across messages
+//   `fake.commit_fail=1`: every commit fails
+//   `fake.commit_delay_ms=<ms>`: tmq_commit_async calls back after <ms> from a thread of its own, inline if 0,
+//                        regardless of tmq_consumer_close, thus callbacks might come after the consumer is gone
+// tmq_committed returns # of commits succeeded so far
+#define FAKE_TMQ_ROWS 3
+typedef struct fake_tmq_conf_s        fake_tmq_conf_t;
+struct fake_tmq_conf_s {
+  atomic_int            refc;
+  atomic_int            next;               // # of messages polled so far
+  atomic_int            commits;
+  int                   messages;
+  int                   commit_fail;
+  int                   commit_delay_ms;
+};
+
+typedef struct fake_tmq_s             fake_tmq_t;
+struct fake_tmq_s {
+  fake_tmq_conf_t      *conf;
+};
+
+typedef struct fake_tmq_commit_s      fake_tmq_commit_t;
+struct fake_tmq_commit_s {
+  tmq_t                *tmq;                // NOTE: never dereferenced, since it might have been closed
+  tmq_commit_cb        *cb;
+  void                 *param;
+  int32_t               code;
+  int                   delay_ms;
+};
+
+static void _fake_tmq_conf_unref(fake_tmq_conf_t *conf)
+{
+  if (atomic_fetch_sub(&conf->refc, 1) == 1) free(conf);
+}
+
+static void* _fake_tmq_commit_routine(void *arg)
+{
+  fake_tmq_commit_t *commit = (fake_tmq_commit_t*)arg;
+  tod_sleep_ms(commit->delay_ms);
+  commit->cb(commit->tmq, commit->code, commit->param);
+  free(commit);
   return NULL;
 }
 
 tmq_list_t* tmq_list_new(void)
 {
-  return NULL;
+  return (tmq_list_t*)calloc(1, sizeof(int32_t));
 }
 
 int32_t     tmq_list_append(tmq_list_t *topic_list, const char *name)
 {
-  (void)topic_list;
   (void)name;
-  return -1;
+  if (!topic_list) return -1;
+  ++*(int32_t*)topic_list;
+  return 0;
 }
 
 void        tmq_list_destroy(tmq_list_t *topic_list)
 {
-  (void)topic_list;
+  free(topic_list);
 }
 
 int32_t     tmq_list_get_size(const tmq_list_t *topic_list)
@@ -602,10 +899,14 @@ char**      tmq_list_to_c_array(const tmq_list_t *topic_list)
 
 tmq_t*      tmq_consumer_new(tmq_conf_t *conf, char *errstr, int32_t errstrLen)
 {
-  (void)conf;
   (void)errstr;
   (void)errstrLen;
-  return NULL;
+  if (!conf) return NULL;
+  fake_tmq_t *tmq = (fake_tmq_t*)calloc(1, sizeof(*tmq));
+  if (!tmq) return NULL;
+  tmq->conf = (fake_tmq_conf_t*)conf;
+  atomic_fetch_add(&tmq->conf->refc, 1);
+  return (tmq_t*)tmq;
 }
 
 const char* tmq_err2str(int32_t code)
@@ -616,15 +917,12 @@ const char* tmq_err2str(int32_t code)
 
 int32_t   tmq_subscribe(tmq_t *tmq, const tmq_list_t *topic_list)
 {
-  (void)tmq;
-  (void)topic_list;
-  return -1;
+  return (tmq && topic_list) ? 0 : -1;
 }
 
 int32_t   tmq_unsubscribe(tmq_t *tmq)
 {
-  (void)tmq;
-  return -1;
+  return tmq ? 0 : -1;
 }
 
 int32_t   tmq_subscription(tmq_t *tmq, tmq_list_t **topics)
@@ -636,48 +934,117 @@ int32_t   tmq_subscription(tmq_t *tmq, tmq_list_t **topics)
 
 TAOS_RES* tmq_consumer_poll(tmq_t *tmq, int64_t timeout)
 {
-  (void)tmq;
-  (void)timeout;
-  return NULL;
+  if (!tmq) return NULL;
+  fake_tmq_conf_t *conf = ((fake_tmq_t*)tmq)->conf;
+  int i = atomic_fetch_add(&conf->next, 1);
+  if (i >= conf->messages) {
+    tod_sleep_ms((int)(timeout > 10 ? 10 : timeout));
+    return NULL;
+  }
+  fake_rows_t *rows = (fake_rows_t*)calloc(1, sizeof(*rows));
+  if (!rows) return NULL;
+  rows->total   = FAKE_TMQ_ROWS;
+  rows->base    = i * FAKE_TMQ_ROWS;
+  rows->nr_cols = 1;
+  return (TAOS_RES*)rows;
 }
 
 int32_t   tmq_consumer_close(tmq_t *tmq)
 {
-  (void)tmq;
+  if (!tmq) return -1;
+  _fake_tmq_conf_unref(((fake_tmq_t*)tmq)->conf);
+  free(tmq);
   return 0;
 }
 
 int32_t   tmq_commit_sync(tmq_t *tmq, const TAOS_RES *msg)
 {
-  (void)tmq;
   (void)msg;
-  return -1;
+  if (!tmq) return -1;
+  fake_tmq_conf_t *conf = ((fake_tmq_t*)tmq)->conf;
+  if (conf->commit_fail) return -1;
+  atomic_fetch_add(&conf->commits, 1);
+  return 0;
 }
 
 void      tmq_commit_async(tmq_t *tmq, const TAOS_RES *msg, tmq_commit_cb *cb, void *param)
 {
-  (void)tmq;
   (void)msg;
-  (void)cb;
-  (void)param;
+  fake_tmq_conf_t *conf = ((fake_tmq_t*)tmq)->conf;
+  int32_t code = conf->commit_fail ? -1 : 0;
+  if (code == 0) atomic_fetch_add(&conf->commits, 1);
+  if (!cb) return;
+
+  fake_tmq_commit_t *commit = NULL;
+  pthread_t thread;
+  if (conf->commit_delay_ms > 0) commit = (fake_tmq_commit_t*)calloc(1, sizeof(*commit));
+  if (commit) {
+    commit->tmq      = tmq;
+    commit->cb       = cb;
+    commit->param    = param;
+    commit->code     = code;
+    commit->delay_ms = conf->commit_delay_ms;
+    if (pthread_create(&thread, NULL, _fake_tmq_commit_routine, commit) == 0) {
+      pthread_detach(thread);
+      return;
+    }
+    free(commit);
+  }
+  cb(tmq, code, param);
+}
+
+int32_t   tmq_get_topic_assignment(tmq_t *tmq, const char *pTopicName, tmq_topic_assignment **assignment, int32_t *numOfAssignment)
+{
+  (void)tmq;
+  (void)pTopicName;
+  *assignment = NULL;
+  *numOfAssignment = 0;
+  return -1;
+}
+
+void      tmq_free_assignment(tmq_topic_assignment *pAssignment)
+{
+  (void)pAssignment;
+}
+
+int32_t   tmq_offset_seek(tmq_t *tmq, const char *pTopicName, int32_t vgId, int64_t offset)
+{
+  (void)tmq;
+  (void)pTopicName;
+  (void)vgId;
+  (void)offset;
+  return -1;
+}
+
+int64_t   tmq_committed(tmq_t *tmq, const char *pTopicName, int32_t vgId)
+{
+  (void)pTopicName;
+  (void)vgId;
+  if (!tmq) return -1;
+  return atomic_load(&((fake_tmq_t*)tmq)->conf->commits);
 }
 
 tmq_conf_t*    tmq_conf_new(void)
 {
-  return NULL;
+  fake_tmq_conf_t *conf = (fake_tmq_conf_t*)calloc(1, sizeof(*conf));
+  if (!conf) return NULL;
+  atomic_store(&conf->refc, 1);
+  return (tmq_conf_t*)conf;
 }
 
 tmq_conf_res_t tmq_conf_set(tmq_conf_t *conf, const char *key, const char *value)
 {
-  (void)conf;
-  (void)key;
-  (void)value;
-  return 0;
+  fake_tmq_conf_t *fake = (fake_tmq_conf_t*)conf;
+  if (!fake || !key || !value) return TMQ_CONF_INVALID;
+  if (strcmp(key, "fake.messages") == 0)        fake->messages = atoi(value);
+  if (strcmp(key, "fake.commit_fail") == 0)     fake->commit_fail = atoi(value);
+  if (strcmp(key, "fake.commit_delay_ms") == 0) fake->commit_delay_ms = atoi(value);
+  return TMQ_CONF_OK;
 }
 
 void           tmq_conf_destroy(tmq_conf_t *conf)
 {
-  (void)conf;
+  if (conf) _fake_tmq_conf_unref((fake_tmq_conf_t*)conf);
 }
 
 void           tmq_conf_set_auto_commit_cb(tmq_conf_t *conf, tmq_commit_cb *cb, void *param)
@@ -705,6 +1072,12 @@ int32_t     tmq_get_vgroup_id(TAOS_RES *res)
   return 0;
 }
 
+int64_t     tmq_get_vgroup_offset(TAOS_RES *res)
+{
+  (void)res;
+  return -1;
+}
+
 const char* tmq_get_table_name(TAOS_RES *res)
 {
   (void)res;
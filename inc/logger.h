@@ -26,6 +26,7 @@
 #define _logger_h_
 
 #include "macros.h"
+#include "os_port.h"
 
 typedef enum logger_level_e {
   LOGGER_VERBOSE,
@@ -130,6 +131,55 @@ void tod_logger_write_impl(logger_t *logger, logger_level_t request, logger_leve
 #define tod_logger_write tod_logger_write_impl
 #endif                      /* } */
 
+// category-based tracing, controlled at runtime by `TAOS_ODBC_TRACE`, and compiled out with `TODBC_NO_TRACE`
+// TOD_TRACE_LIST(_item): _item(id, name) for each category, `name` being what `TAOS_ODBC_TRACE` refers to
+#define TOD_TRACE_LIST(_item)                                                                     \
+  _item(TAOSC, "taosc")                                                                           \
+  _item(ICONV, "iconv")                                                                           \
+  _item(ODBC,  "odbc")                                                                            \
+  _item(FETCH, "fetch")                                                                           \
+  _item(BIND,  "bind")                                                                            \
+  _item(PERF,  "perf")           /* performance counters dumped when handles are freed */
+
+#define TOD_TRACE_ENUM(_id, _name)        TOD_TRACE_##_id,
+
+typedef enum tod_trace_e {
+  TOD_TRACE_LIST(TOD_TRACE_ENUM)
+  TOD_TRACE_NR,
+} tod_trace_t;
+
+int tod_trace_resolve(tod_trace_t category) FA_HIDDEN;
+void tod_trace_enable(tod_trace_t category, int on) FA_HIDDEN;
+
+#ifndef __cplusplus         /* { */
+// NOTE: -1: not resolved yet, 0: off, 1: on
+//       written once when resolved or by tod_trace_enable, and read from every thread with relaxed loads
+extern atomic_int tod_trace_flags[TOD_TRACE_NR] FA_HIDDEN;
+#ifdef _WIN32               /* { */
+#define tod_trace_flag(_cat)    atomic_load(&tod_trace_flags[_cat])
+#else                       /* }{ */
+#define tod_trace_flag(_cat)    atomic_load_explicit(&tod_trace_flags[_cat], memory_order_relaxed)
+#endif                      /* } */
+#else                       /* }{ */
+#define tod_trace_flag(_cat)    -1
+#endif                      /* } */
+
+#ifdef TODBC_NO_TRACE       /* { */
+#define TOD_TRACE_ON(_cat)      0
+#else                       /* }{ */
+#define TOD_TRACE_ON(_cat)      (tod_trace_flag(_cat) && (tod_trace_flag(_cat) > 0 || tod_trace_resolve(_cat)))
+#endif                      /* } */
+
+#define TOD_TRACE(_cat, file, line, func, fmt, ...) do {                                          \
+  if (TOD_TRACE_ON(_cat)) {                                                                       \
+    tod_logger_write(tod_get_system_logger(), LOGGER_DEBUG, LOGGER_VERBOSE,                       \
+      file, line, func,                                                                           \
+      fmt, ##__VA_ARGS__);                                                                        \
+  }                                                                                               \
+} while (0)
+
+#define TOD_TRACEF(_cat, fmt, ...) TOD_TRACE(_cat, __FILE__, __LINE__, __func__, fmt, ##__VA_ARGS__)
+
 #define TOD_LOGV(fmt, ...) do {                                                                   \
   tod_logger_write(tod_get_system_logger(), LOGGER_VERBOSE, tod_get_system_logger_level(),        \
     __FILE__, __LINE__, __func__,                                                                 \
@@ -43,11 +43,7 @@ EXTERN_C_BEGIN
   #define FAILED(_sr) (!SUCCEEDED(_sr))
 #endif
 
-#define LOGD_ODBC(file, line, func, fmt, ...) do {                                                \
-  tod_logger_write(tod_get_system_logger(), LOGGER_DEBUG, tod_get_system_logger_level(),          \
-    file, line, func,                                                                             \
-    fmt, ##__VA_ARGS__);                                                                          \
-} while (0)
+#define LOGD_ODBC(file, line, func, fmt, ...) TOD_TRACE(TOD_TRACE_ODBC, file, line, func, fmt, ##__VA_ARGS__)
 
 #define LOGE_ODBC(file, line, func, fmt, ...) do {                                                \
   tod_logger_write(tod_get_system_logger(), LOGGER_ERROR, tod_get_system_logger_level(),          \
@@ -348,6 +344,18 @@ static inline SQLRETURN call_SQLSetStmtAttr(const char *file, int line, const ch
   return sr;
 }
 
+static inline SQLRETURN call_SQLGetStmtAttr(const char *file, int line, const char *func,
+    SQLHSTMT StatementHandle, SQLINTEGER Attribute, SQLPOINTER ValuePtr, SQLINTEGER BufferLength, SQLINTEGER *StringLengthPtr)
+{
+  LOGD_ODBC(file, line, func, "SQLGetStmtAttr(StatementHandle:%p,Attribute:%s[%d/0x%x],ValuePtr:%p,BufferLength:%d,StringLengthPtr:%p) ...",
+      StatementHandle, sql_stmt_attr(Attribute), Attribute, Attribute, ValuePtr, BufferLength, StringLengthPtr);
+  SQLRETURN sr = SQLGetStmtAttr(StatementHandle, Attribute, ValuePtr, BufferLength, StringLengthPtr);
+  diag(sr, SQL_HANDLE_STMT, StatementHandle);
+  LOGD_ODBC(file, line, func, "SQLGetStmtAttr(StatementHandle:%p,Attribute:%s[%d/0x%x],ValuePtr:%p,BufferLength:%d,StringLengthPtr:%p(%d)) => %s",
+      StatementHandle, sql_stmt_attr(Attribute), Attribute, Attribute, ValuePtr, BufferLength, StringLengthPtr, StringLengthPtr ? *StringLengthPtr : 0, sql_return_type(sr));
+  return sr;
+}
+
 static inline SQLRETURN call_SQLExecute(const char *file, int line, const char *func,
     SQLHSTMT StatementHandle)
 {
@@ -395,6 +403,16 @@ static inline SQLRETURN call_SQLCloseCursor(const char *file, int line, const ch
   return sr;
 }
 
+static inline SQLRETURN call_SQLCancel(const char *file, int line, const char *func,
+    SQLHSTMT StatementHandle)
+{
+  LOGD_ODBC(file, line, func, "SQLCancel(StatementHandle:%p) ...", StatementHandle);
+  SQLRETURN sr = SQLCancel(StatementHandle);
+  // NOTE: no diag here, diagnostics belong to the function being canceled on another thread
+  LOGD_ODBC(file, line, func, "SQLCancel(StatementHandle:%p) => %s", StatementHandle, sql_return_type(sr));
+  return sr;
+}
+
 static inline SQLRETURN call_SQLSetConnectAttr(const char *file, int line, const char *func,
     SQLHDBC ConnectionHandle, SQLINTEGER Attribute, SQLPOINTER ValuePtr, SQLINTEGER StringLength)
 {
@@ -654,10 +672,12 @@ static inline SQLRETURN call_SQLRowCount(const char *file, int line, const char
 #define CALL_SQLDescribeParam(...)                 call_SQLDescribeParam(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
 #define CALL_SQLBindParameter(...)                 call_SQLBindParameter(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
 #define CALL_SQLSetStmtAttr(...)                   call_SQLSetStmtAttr(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
+#define CALL_SQLGetStmtAttr(...)                   call_SQLGetStmtAttr(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
 #define CALL_SQLExecute(...)                       call_SQLExecute(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
 #define CALL_SQLEndTran(...)                       call_SQLEndTran(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
 #define CALL_SQLFreeStmt(...)                      call_SQLFreeStmt(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
 #define CALL_SQLCloseCursor(...)                   call_SQLCloseCursor(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
+#define CALL_SQLCancel(...)                        call_SQLCancel(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
 #define CALL_SQLSetConnectAttr(...)                call_SQLSetConnectAttr(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
 #define CALL_SQLBindCol(...)                       call_SQLBindCol(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
 #define CALL_SQLDescribeColW(...)                  call_SQLDescribeColW(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
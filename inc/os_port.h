@@ -27,6 +27,8 @@
 
 #include "macros.h"
 
+#include <stdint.h>
+
 EXTERN_C_BEGIN
 
 #include <time.h>
@@ -73,6 +75,19 @@ static inline LONG atomic_load(atomic_int *obj)
 {
     return atomic_fetch_add(obj, 0);
 }
+
+static inline void atomic_store(atomic_int *obj, LONG desired)
+{
+    InterlockedExchange(obj, desired);
+}
+
+static inline int atomic_compare_exchange_weak(atomic_int *obj, int *expected, int desired)
+{
+    LONG prev = InterlockedCompareExchange(obj, desired, *expected);
+    if (prev == *expected) return 1;
+    *expected = prev;
+    return 0;
+}
 #else                    /* }{ */
 #include <stdatomic.h>
 #endif                   /* } */
@@ -84,14 +99,37 @@ char* tod_getenv(const char *name);
 #define tod_getenv     getenv
 #endif                   /* } */
 
+void tod_sleep_ms(int ms) FA_HIDDEN;
+// monotonic clock, in microseconds and nanoseconds respectively
+int64_t tod_now_us(void) FA_HIDDEN;
+int64_t tod_now_ns(void) FA_HIDDEN;
+
 #ifdef _WIN32            /* { */
 typedef INIT_ONCE pthread_once_t;
 #define PTHREAD_ONCE_INIT INIT_ONCE_STATIC_INIT
 int pthread_once(pthread_once_t *once_control, void (*init_routine)(void));
+
+typedef HANDLE             pthread_t;
+typedef CRITICAL_SECTION   pthread_mutex_t;
+typedef CONDITION_VARIABLE pthread_cond_t;
+int pthread_create(pthread_t *thread, const void *attr, void *(*start_routine)(void*), void *arg);
+int pthread_join(pthread_t thread, void **retval);
+int pthread_mutex_init(pthread_mutex_t *mutex, const void *attr);
+int pthread_mutex_destroy(pthread_mutex_t *mutex);
+int pthread_mutex_lock(pthread_mutex_t *mutex);
+int pthread_mutex_unlock(pthread_mutex_t *mutex);
+int pthread_cond_init(pthread_cond_t *cond, const void *attr);
+int pthread_cond_destroy(pthread_cond_t *cond);
+int pthread_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mutex);
+int pthread_cond_signal(pthread_cond_t *cond);
+int pthread_cond_broadcast(pthread_cond_t *cond);
 #else                    /* }{ */
 #include <pthread.h>
 #endif                   /* } */
 
+// wait on `cond` for at most `ms` milliseconds, returns 0 if signaled, ETIMEDOUT otherwise
+int tod_cond_timedwait_ms(pthread_cond_t *cond, pthread_mutex_t *mutex, int ms) FA_HIDDEN;
+
 #ifdef _WIN32            /* { */
 void* dlopen(const char* path, int mode);
 int dlclose(void* handle);
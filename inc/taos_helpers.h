@@ -31,11 +31,7 @@
 #include <taos.h>
 #include <taoserror.h>
 
-#define LOGD_TAOS(file, line, func, fmt, ...) do {                                                \
-  tod_logger_write(tod_get_system_logger(), LOGGER_DEBUG, tod_get_system_logger_level(),          \
-    file, line, func,                                                                             \
-    fmt, ##__VA_ARGS__);                                                                          \
-} while (0)
+#define LOGD_TAOS(file, line, func, fmt, ...) TOD_TRACE(TOD_TRACE_TAOSC, file, line, func, fmt, ##__VA_ARGS__)
 
 #define LOGE_TAOS(file, line, func, fmt, ...) do {                                                \
   tod_logger_write(tod_get_system_logger(), LOGGER_DEBUG, tod_get_system_logger_level(),          \
@@ -605,6 +601,15 @@ static inline TAOS_RES* call_taos_schemaless_insert(const char *file, int line,
   return res;
 }
 
+static inline TAOS_RES* call_taos_schemaless_insert_raw(const char *file, int line, const char *func, TAOS *taos, char *lines, int len, int32_t *totalRows, int protocol, int precision)
+{
+  LOGD_TAOS(file, line, func, "taos_schemaless_insert_raw(taos:%p,lines:%p,len:%d,totalRows:%p,protocol:%d,precision:%d) ...", taos, lines, len, totalRows, protocol, precision);
+  TAOS_RES *res = taos_schemaless_insert_raw(taos, lines, len, totalRows, protocol, precision);
+  diag_res(res);
+  LOGD_TAOS(file, line, func, "taos_schemaless_insert_raw(taos:%p,lines:%p,len:%d,totalRows:%p,protocol:%d,precision:%d) => %p", taos, lines, len, totalRows, protocol, precision, res);
+  return res;
+}
+
 static inline tmq_list_t* call_tmq_list_new(const char *file, int line, const char *func)
 {
   LOGD_TAOS(file, line, func, "tmq_list_new() ...");
@@ -715,6 +720,37 @@ static inline void      call_tmq_commit_async(const char *file, int line, const
   LOGD_TAOS(file, line, func, "tmq_commit_async(tmq:%p,msg:%p,cb:%p,param:%p) => void", tmq, msg, cb, param);
 }
 
+static inline int32_t   call_tmq_get_topic_assignment(const char *file, int line, const char *func, tmq_t *tmq, const char *pTopicName, tmq_topic_assignment **assignment, int32_t *numOfAssignment)
+{
+  LOGD_TAOS(file, line, func, "tmq_get_topic_assignment(tmq:%p,pTopicName:%s,assignment:%p,numOfAssignment:%p) ...", tmq, pTopicName, assignment, numOfAssignment);
+  int32_t r = tmq_get_topic_assignment(tmq, pTopicName, assignment, numOfAssignment);
+  LOGD_TAOS(file, line, func, "tmq_get_topic_assignment(tmq:%p,pTopicName:%s,assignment:%p,numOfAssignment:%p) => %d", tmq, pTopicName, assignment, numOfAssignment, r);
+  return r;
+}
+
+static inline void      call_tmq_free_assignment(const char *file, int line, const char *func, tmq_topic_assignment *pAssignment)
+{
+  LOGD_TAOS(file, line, func, "tmq_free_assignment(pAssignment:%p) ...", pAssignment);
+  tmq_free_assignment(pAssignment);
+  LOGD_TAOS(file, line, func, "tmq_free_assignment(pAssignment:%p) => void", pAssignment);
+}
+
+static inline int32_t   call_tmq_offset_seek(const char *file, int line, const char *func, tmq_t *tmq, const char *pTopicName, int32_t vgId, int64_t offset)
+{
+  LOGD_TAOS(file, line, func, "tmq_offset_seek(tmq:%p,pTopicName:%s,vgId:%d,offset:%" PRId64 ") ...", tmq, pTopicName, vgId, offset);
+  int32_t r = tmq_offset_seek(tmq, pTopicName, vgId, offset);
+  LOGD_TAOS(file, line, func, "tmq_offset_seek(tmq:%p,pTopicName:%s,vgId:%d,offset:%" PRId64 ") => %d", tmq, pTopicName, vgId, offset, r);
+  return r;
+}
+
+static inline int64_t   call_tmq_committed(const char *file, int line, const char *func, tmq_t *tmq, const char *pTopicName, int32_t vgId)
+{
+  LOGD_TAOS(file, line, func, "tmq_committed(tmq:%p,pTopicName:%s,vgId:%d) ...", tmq, pTopicName, vgId);
+  int64_t r = tmq_committed(tmq, pTopicName, vgId);
+  LOGD_TAOS(file, line, func, "tmq_committed(tmq:%p,pTopicName:%s,vgId:%d) => %" PRId64 "", tmq, pTopicName, vgId, r);
+  return r;
+}
+
 static inline tmq_conf_t*    call_tmq_conf_new(const char *file, int line, const char *func)
 {
   LOGD_TAOS(file, line, func, "tmq_conf_new() ...");
@@ -769,6 +805,14 @@ static inline int32_t     call_tmq_get_vgroup_id(const char *file, int line, con
   return r;
 }
 
+static inline int64_t     call_tmq_get_vgroup_offset(const char *file, int line, const char *func, TAOS_RES *res)
+{
+  LOGD_TAOS(file, line, func, "tmq_get_vgroup_offset(res:%p) ...", res);
+  int64_t r = tmq_get_vgroup_offset(res);
+  LOGD_TAOS(file, line, func, "tmq_get_vgroup_offset(res:%p) => %" PRId64 "", res, r);
+  return r;
+}
+
 static inline const char* call_tmq_get_table_name(const char *file, int line, const char *func, TAOS_RES *res)
 {
   LOGD_TAOS(file, line, func, "tmq_get_table_name(res:%p) ...", res);
@@ -886,6 +930,7 @@ static inline int call_taos_get_current_db(const char *file, int line, const cha
 
 #define CALL_taos_load_table_info(...) call_taos_load_table_info(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
 #define CALL_taos_schemaless_insert(...) call_taos_schemaless_insert(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
+#define CALL_taos_schemaless_insert_raw(...) call_taos_schemaless_insert_raw(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
 
 #define CALL_tmq_list_new(...) call_tmq_list_new(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
 #define CALL_tmq_list_append(...) call_tmq_list_append(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
@@ -904,6 +949,10 @@ static inline int call_taos_get_current_db(const char *file, int line, const cha
 #define CALL_tmq_consumer_close(...) call_tmq_consumer_close(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
 #define CALL_tmq_commit_sync(...) call_tmq_commit_sync(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
 #define CALL_tmq_commit_async(...) call_tmq_commit_async(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
+#define CALL_tmq_get_topic_assignment(...) call_tmq_get_topic_assignment(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
+#define CALL_tmq_free_assignment(...) call_tmq_free_assignment(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
+#define CALL_tmq_offset_seek(...) call_tmq_offset_seek(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
+#define CALL_tmq_committed(...) call_tmq_committed(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
 
 #define CALL_tmq_conf_new(...) call_tmq_conf_new(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
 #define CALL_tmq_conf_set(...) call_tmq_conf_set(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
@@ -913,6 +962,7 @@ static inline int call_taos_get_current_db(const char *file, int line, const cha
 #define CALL_tmq_get_topic_name(...) call_tmq_get_topic_name(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
 #define CALL_tmq_get_db_name(...) call_tmq_get_db_name(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
 #define CALL_tmq_get_vgroup_id(...) call_tmq_get_vgroup_id(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
+#define CALL_tmq_get_vgroup_offset(...) call_tmq_get_vgroup_offset(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
 
 #define CALL_tmq_get_table_name(...) call_tmq_get_table_name(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
 #define CALL_tmq_get_res_type(...) call_tmq_get_res_type(__FILE__, __LINE__, __func__, ##__VA_ARGS__)
@@ -960,6 +1010,10 @@ struct tsdb_data_s {
 };
 
 int helper_get_tsdb(TAOS_RES *res, int block, TAOS_FIELD *fields, int time_precision, TAOS_ROW rows, int i_row, int i_col, tsdb_data_t *tsdb, char *buf, size_t len) FA_HIDDEN;
+// `offsets[i_col]`, if not NULL, is the cached result of taos_get_column_data_offset for current block
+int helper_get_tsdb_block(TAOS_RES *res, int * const *offsets, TAOS_FIELD *fields, int time_precision, TAOS_ROW rows, int i_row, int i_col, tsdb_data_t *tsdb, char *buf, size_t len) FA_HIDDEN;
+// block in the same layout but owned by the caller: no null check, `offsets[i_col]` is required for var-length columns
+int helper_get_tsdb_value(int * const *offsets, TAOS_FIELD *fields, int time_precision, TAOS_ROW rows, int i_row, int i_col, tsdb_data_t *tsdb, char *buf, size_t len) FA_HIDDEN;
 
 EXTERN_C_END
 
@@ -0,0 +1,158 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022-2023 freemine <freemine@yeah.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _taos_odbc_ext_h_
+#define _taos_odbc_ext_h_
+
+// driver-specific attributes of taos_odbc, for applications and monitoring agents
+// this header depends on nothing but <sqlext.h>, and is installed along with the driver
+
+#include <sqlext.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// performance counters, of a statement since its allocation (or last reset),
+// or of a connection, including those of its statements, alive or freed
+typedef struct taos_odbc_perf_s            taos_odbc_perf_t;
+struct taos_odbc_perf_s {
+  int64_t          rows_fetched;          // rows returned to the application via SQLFetch/SQLFetchScroll
+  int64_t          blocks_fetched;        // result blocks fetched from taosc
+  int64_t          bytes_copied;          // bytes of column data handed over to application buffers
+  int64_t          iconv_calls;           // character set conversions
+  int64_t          iconv_bytes;           // bytes consumed by character set conversions
+  int64_t          taosc_us;              // microseconds spent within taosc query/fetch/execute calls
+  int64_t          convert_us;            // microseconds spent in the driver filling bound buffers, excluding taosc
+  int64_t          param_rows;            // parameter rows converted for execution
+  int64_t          batches;               // taos_stmt_execute round trips
+  int64_t          catalog_trips;         // queries issued on behalf of SQLTables/SQLColumns/SQLPrimaryKeys
+  // NOTE: topic counters of a statement include its open topic, those of a connection only topics closed so far
+  int64_t          topic_polls;           // tmq_consumer_poll calls, inline or by background pollers
+  int64_t          topic_polls_empty;     // of which returned no message
+  int64_t          topic_poll_us;         // microseconds spent within tmq_consumer_poll
+  int64_t          topic_poll_data_us;    // of which spent by polls returning a message
+};
+
+// SQLGetStmtAttr/SQLGetConnectAttr, ValuePtr points to SQLBIGINT
+#define SQL_ATTR_TAOS_PERF_BASE               (SQL_DRIVER_STMT_ATTR_BASE + 0x100)
+#define SQL_ATTR_TAOS_PERF_ROWS_FETCHED       (SQL_ATTR_TAOS_PERF_BASE + 0)
+#define SQL_ATTR_TAOS_PERF_BLOCKS_FETCHED     (SQL_ATTR_TAOS_PERF_BASE + 1)
+#define SQL_ATTR_TAOS_PERF_BYTES_COPIED       (SQL_ATTR_TAOS_PERF_BASE + 2)
+#define SQL_ATTR_TAOS_PERF_ICONV_CALLS        (SQL_ATTR_TAOS_PERF_BASE + 3)
+#define SQL_ATTR_TAOS_PERF_ICONV_BYTES        (SQL_ATTR_TAOS_PERF_BASE + 4)
+#define SQL_ATTR_TAOS_PERF_TAOSC_US           (SQL_ATTR_TAOS_PERF_BASE + 5)
+#define SQL_ATTR_TAOS_PERF_CONVERT_US         (SQL_ATTR_TAOS_PERF_BASE + 6)
+#define SQL_ATTR_TAOS_PERF_PARAM_ROWS         (SQL_ATTR_TAOS_PERF_BASE + 7)
+#define SQL_ATTR_TAOS_PERF_BATCHES            (SQL_ATTR_TAOS_PERF_BASE + 8)
+#define SQL_ATTR_TAOS_PERF_CATALOG_TRIPS      (SQL_ATTR_TAOS_PERF_BASE + 9)
+#define SQL_ATTR_TAOS_PERF_TOPIC_POLLS        (SQL_ATTR_TAOS_PERF_BASE + 10)
+#define SQL_ATTR_TAOS_PERF_TOPIC_POLLS_EMPTY  (SQL_ATTR_TAOS_PERF_BASE + 11)
+#define SQL_ATTR_TAOS_PERF_TOPIC_POLL_US      (SQL_ATTR_TAOS_PERF_BASE + 12)
+#define SQL_ATTR_TAOS_PERF_TOPIC_POLL_DATA_US (SQL_ATTR_TAOS_PERF_BASE + 13)
+// SQLGetStmtAttr/SQLGetConnectAttr, ValuePtr points to taos_odbc_perf_t, BufferLength >= sizeof(taos_odbc_perf_t)
+#define SQL_ATTR_TAOS_PERF                    (SQL_ATTR_TAOS_PERF_BASE + 0x20)
+// SQLSetStmtAttr/SQLSetConnectAttr, ValuePtr ignored, zeroes the counters
+#define SQL_ATTR_TAOS_PERF_RESET              (SQL_ATTR_TAOS_PERF_BASE + 0x21)
+
+// SQLSetConnectAttr, ValuePtr ignored, logs latency percentiles of ODBC entry points collected so far,
+// effective only with TAOS_ODBC_PROFILE=1
+#define SQL_ATTR_TAOS_PROFILE_DUMP            (SQL_ATTR_TAOS_PERF_BASE + 0x30)
+
+// SQLSetStmtAttr/SQLGetStmtAttr, ValuePtr is SQLULEN, number of connections a forward-only query is split across,
+// by its `ts` range, 0 or 1 to disable, at most 16
+#define SQL_ATTR_TAOS_PARALLEL_SCAN           (SQL_DRIVER_STMT_ATTR_BASE + 0x200)
+
+// Arrow C data/stream interface, as specified by https://arrow.apache.org/docs/format/CDataInterface.html
+#ifndef ARROW_C_DATA_INTERFACE         /* { */
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+  // Array type description
+  const char* format;
+  const char* name;
+  const char* metadata;
+  int64_t flags;
+  int64_t n_children;
+  struct ArrowSchema** children;
+  struct ArrowSchema* dictionary;
+
+  // Release callback
+  void (*release)(struct ArrowSchema*);
+  // Opaque producer-specific data
+  void* private_data;
+};
+
+struct ArrowArray {
+  // Array data description
+  int64_t length;
+  int64_t null_count;
+  int64_t offset;
+  int64_t n_buffers;
+  int64_t n_children;
+  const void** buffers;
+  struct ArrowArray** children;
+  struct ArrowArray* dictionary;
+
+  // Release callback
+  void (*release)(struct ArrowArray*);
+  // Opaque producer-specific data
+  void* private_data;
+};
+#endif                                 /* } */
+
+#ifndef ARROW_C_STREAM_INTERFACE       /* { */
+#define ARROW_C_STREAM_INTERFACE
+
+struct ArrowArrayStream {
+  // Callbacks providing stream functionality
+  int (*get_schema)(struct ArrowArrayStream*, struct ArrowSchema* out);
+  int (*get_next)(struct ArrowArrayStream*, struct ArrowArray* out);
+  const char* (*get_last_error)(struct ArrowArrayStream*);
+
+  // Release callback
+  void (*release)(struct ArrowArrayStream*);
+
+  // Opaque producer-specific data
+  void* private_data;
+};
+#endif                                 /* } */
+
+// SQLGetStmtAttr, ValuePtr points to struct ArrowArrayStream, BufferLength >= sizeof(struct ArrowArrayStream)
+// right after SQLExecDirect of a forward-only query, before any row is fetched, the result set is handed over to
+// the stream, one struct array per taosc block, and the statement has no more rows on its own
+// the stream shall be released before the connection is disconnected
+#define SQL_ATTR_TAOS_ARROW_STREAM            (SQL_DRIVER_STMT_ATTR_BASE + 0x210)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _taos_odbc_ext_h_
+
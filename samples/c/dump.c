@@ -23,10 +23,14 @@
  */
 
 #include "odbc_helpers.h"
+#include "os_port.h"
 
 #include <errno.h>
+#include <inttypes.h>
 #include <stdarg.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
 
 
 #define DUMP(fmt, ...)          printf(fmt "\n", ##__VA_ARGS__)
@@ -1011,6 +1015,685 @@ static int _execute_file(odbc_case_t *odbc_case, odbc_stage_t stage, odbc_handle
   return r ? -1 : 0;
 }
 
+// SAMPLE_EXPORT_*: bulk export of tables listed by SQLTables, or of the result set of SAMPLE_EXPORT_SQL
+//   each table is fetched in rowsets of SQL_ATTR_ROW_ARRAY_SIZE by one of the worker threads, with a connection of its own,
+//   while the rowset fetched before is formatted and written by the writer thread of its output file
+typedef struct export_col_s              export_col_t;
+typedef struct export_rowset_s           export_rowset_t;
+typedef struct export_table_s            export_table_t;
+typedef struct export_s                  export_t;
+
+typedef enum export_format_e {
+  EXPORT_CSV,
+  EXPORT_LINE,                        // influxdb line protocol, timestamps in the precision of the database
+} export_format_t;
+
+struct export_col_s {
+  char                  name[193];
+  SQLSMALLINT           sql_type;
+  SQLSMALLINT           c_type;
+  SQLLEN                width;
+  size_t                off_data;     // of the data array within a rowset
+  size_t                off_ind;      // of the indicator array within a rowset
+};
+
+struct export_rowset_s {
+  char                 *buf;
+  SQLULEN               nr_rows;
+  int                   full;
+};
+
+struct export_table_s {
+  char                  catalog[193];
+  char                  name[193];
+
+  // below are used by the worker/writer threads of this table
+  export_t             *exp;
+  export_col_t         *cols;
+  SQLSMALLINT           nr_cols;
+  int                   i_ts;         // column as timestamp of line protocol, -1 for none
+
+  pthread_mutex_t       mutex;
+  pthread_cond_t        cond;
+  export_rowset_t       rowsets[2];
+  int                   done;         // no more rowsets from the worker
+  int                   failed;       // writer failed, no more rowsets wanted
+
+  FILE                 *f;
+  char                 *out;
+  size_t                out_nr;
+  size_t                out_cap;
+
+  size_t                rows;
+  size_t                bytes;
+  size_t                truncated;
+};
+
+struct export_s {
+  const char           *dir;
+  const char           *sql;
+  export_format_t       format;
+  SQLULEN               row_array_size;
+  int                   nr_threads;
+
+  SQLHANDLE             henv;
+
+  pthread_mutex_t       mutex;
+  export_table_t       *tables;
+  size_t                nr_tables;
+  size_t                next;         // next table to pick up, guarded by `mutex`
+  int                   failures;     // guarded by `mutex`
+};
+
+static const odbc_conn_arg_t *_export_conn_arg;
+
+static int _export_out_keep(export_table_t *table, size_t more)
+{
+  if (table->out_nr + more <= table->out_cap) return 0;
+  size_t cap = (table->out_nr + more + 0xffff) & ~(size_t)0xffff;
+  char *p = (char*)realloc(table->out, cap);
+  if (!p) {
+    E("out of memory");
+    return -1;
+  }
+  table->out = p;
+  table->out_cap = cap;
+  return 0;
+}
+
+static int _export_out(export_table_t *table, const char *s, size_t n)
+{
+  if (_export_out_keep(table, n)) return -1;
+  memcpy(table->out + table->out_nr, s, n);
+  table->out_nr += n;
+  return 0;
+}
+
+static int _export_out_fmt(export_table_t *table, const char *fmt, ...)
+{
+  if (_export_out_keep(table, 64)) return -1;
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vsnprintf(table->out + table->out_nr, table->out_cap - table->out_nr, fmt, ap);
+  va_end(ap);
+  if (n < 0 || (size_t)n >= table->out_cap - table->out_nr) {
+    E("internal logic error");
+    return -1;
+  }
+  table->out_nr += (size_t)n;
+  return 0;
+}
+
+// escape every char found in `special` by `esc`, or by doubling it if `esc` is 0
+static int _export_out_escaped(export_table_t *table, const char *s, size_t n, const char *special, char esc)
+{
+  if (_export_out_keep(table, n * 2)) return -1;
+  char *p = table->out + table->out_nr;
+  for (size_t i=0; i<n; ++i) {
+    if (strchr(special, s[i])) *p++ = esc ? esc : s[i];
+    *p++ = s[i];
+  }
+  table->out_nr = (size_t)(p - table->out);
+  return 0;
+}
+
+// returns the length of the char value, with truncation counted
+static size_t _export_char_len(export_table_t *table, export_col_t *col, const char *data, SQLLEN ind)
+{
+  if (ind == SQL_NO_TOTAL || ind > col->width - 1) {
+    ++table->truncated;
+    return strnlen(data, (size_t)col->width - 1);
+  }
+  return (size_t)ind;
+}
+
+static int _export_csv_header(export_table_t *table)
+{
+  for (SQLSMALLINT i=0; i<table->nr_cols; ++i) {
+    if (i && _export_out(table, ",", 1)) return -1;
+    if (_export_out(table, "\"", 1)) return -1;
+    if (_export_out_escaped(table, table->cols[i].name, strlen(table->cols[i].name), "\"", 0)) return -1;
+    if (_export_out(table, "\"", 1)) return -1;
+  }
+  return _export_out(table, "\n", 1);
+}
+
+static int _export_csv_row(export_table_t *table, const char *buf, SQLULEN i_row)
+{
+  for (SQLSMALLINT i=0; i<table->nr_cols; ++i) {
+    export_col_t *col = table->cols + i;
+    SQLLEN ind = ((const SQLLEN*)(buf + col->off_ind))[i_row];
+    const char *data = buf + col->off_data + col->width * i_row;
+
+    if (i && _export_out(table, ",", 1)) return -1;
+    if (ind == SQL_NULL_DATA) continue;
+
+    size_t n = _export_char_len(table, col, data, ind);
+    if (n == 0 || strcspn(data, ",\"\r\n") < n) {
+      // NOTE: empty string quoted to tell from null
+      if (_export_out(table, "\"", 1)) return -1;
+      if (_export_out_escaped(table, data, n, "\"", 0)) return -1;
+      if (_export_out(table, "\"", 1)) return -1;
+    } else {
+      if (_export_out(table, data, n)) return -1;
+    }
+  }
+  return _export_out(table, "\n", 1);
+}
+
+static int _export_line_row(export_table_t *table, const char *buf, SQLULEN i_row)
+{
+  size_t begin = table->out_nr;
+  int nr_fields = 0;
+
+  if (_export_out_escaped(table, table->name, strlen(table->name), ", =", '\\')) return -1;
+
+  for (SQLSMALLINT i=0; i<table->nr_cols; ++i) {
+    if (i == table->i_ts) continue;
+
+    export_col_t *col = table->cols + i;
+    SQLLEN ind = ((const SQLLEN*)(buf + col->off_ind))[i_row];
+    const char *data = buf + col->off_data + col->width * i_row;
+    if (ind == SQL_NULL_DATA) continue;
+
+    if (_export_out(table, nr_fields++ ? "," : " ", 1)) return -1;
+    if (_export_out_escaped(table, col->name, strlen(col->name), ", =", '\\')) return -1;
+    if (_export_out(table, "=", 1)) return -1;
+
+    int r = 0;
+    switch (col->c_type) {
+      case SQL_C_BIT:
+        r = _export_out(table, *(const unsigned char*)data ? "t" : "f", 1);
+        break;
+      case SQL_C_SBIGINT:
+        r = _export_out_fmt(table, "%" PRId64 "i", *(const int64_t*)data);
+        break;
+      case SQL_C_UBIGINT:
+        r = _export_out_fmt(table, "%" PRIu64 "u", *(const uint64_t*)data);
+        break;
+      case SQL_C_DOUBLE:
+        r = _export_out_fmt(table, "%.17g", *(const double*)data);
+        break;
+      default: {
+        size_t n = _export_char_len(table, col, data, ind);
+        r = _export_out(table, "\"", 1);
+        if (!r) r = _export_out_escaped(table, data, n, "\"\\", '\\');
+        if (!r) r = _export_out(table, "\"", 1);
+      } break;
+    }
+    if (r) return -1;
+  }
+
+  // NOTE: line protocol requires at least one field, rows of all nulls are dropped
+  if (nr_fields == 0) {
+    table->out_nr = begin;
+    return 0;
+  }
+
+  if (table->i_ts >= 0) {
+    export_col_t *col = table->cols + table->i_ts;
+    SQLLEN ind = ((const SQLLEN*)(buf + col->off_ind))[i_row];
+    if (ind != SQL_NULL_DATA) {
+      if (_export_out_fmt(table, " %" PRId64 "", *(const int64_t*)(buf + col->off_data + col->width * i_row))) return -1;
+    }
+  }
+
+  return _export_out(table, "\n", 1);
+}
+
+static int _export_write_rowset(export_table_t *table, export_rowset_t *rowset)
+{
+  table->out_nr = 0;
+  for (SQLULEN i=0; i<rowset->nr_rows; ++i) {
+    int r = 0;
+    if (table->exp->format == EXPORT_CSV) r = _export_csv_row(table, rowset->buf, i);
+    else                                  r = _export_line_row(table, rowset->buf, i);
+    if (r) return -1;
+  }
+
+  if (table->out_nr && fwrite(table->out, 1, table->out_nr, table->f) != table->out_nr) {
+    E("writing `%s` failed:[%d]%s", table->name, errno, strerror(errno));
+    return -1;
+  }
+  table->rows  += rowset->nr_rows;
+  table->bytes += table->out_nr;
+  return 0;
+}
+
+static void* _export_writer_routine(void *arg)
+{
+  export_table_t *table = (export_table_t*)arg;
+  int r = 0;
+
+  for (int i=0; ; i ^= 1) {
+    export_rowset_t *rowset = table->rowsets + i;
+
+    pthread_mutex_lock(&table->mutex);
+    while (!rowset->full && !table->done) pthread_cond_wait(&table->cond, &table->mutex);
+    int full = rowset->full;
+    pthread_mutex_unlock(&table->mutex);
+    if (!full) break;
+
+    r = _export_write_rowset(table, rowset);
+
+    pthread_mutex_lock(&table->mutex);
+    rowset->full = 0;
+    if (r) table->failed = 1;
+    pthread_cond_broadcast(&table->cond);
+    pthread_mutex_unlock(&table->mutex);
+    if (r) break;
+  }
+
+  return r ? (void*)(uintptr_t)-1 : NULL;
+}
+
+static int _export_describe(export_table_t *table, SQLHANDLE hstmt)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+
+  sr = CALL_SQLNumResultCols(hstmt, &table->nr_cols);
+  if (FAILED(sr)) return -1;
+  if (table->nr_cols <= 0) {
+    E("no result set to export for `%s`", table->name);
+    return -1;
+  }
+
+  table->cols = (export_col_t*)calloc((size_t)table->nr_cols, sizeof(*table->cols));
+  if (!table->cols) {
+    E("out of memory");
+    return -1;
+  }
+
+  table->i_ts = -1;
+  size_t off = 0;
+  for (SQLSMALLINT i=0; i<table->nr_cols; ++i) {
+    export_col_t *col = table->cols + i;
+    SQLSMALLINT NameLength;
+    SQLLEN DisplaySize = 0, OctetLength = 0, Unsigned = 0;
+
+    sr = CALL_SQLColAttribute(hstmt, i+1, SQL_DESC_NAME, col->name, sizeof(col->name), &NameLength, NULL);
+    if (FAILED(sr)) return -1;
+    sr = CALL_SQLColAttribute(hstmt, i+1, SQL_DESC_CONCISE_TYPE, NULL, 0, NULL, &DisplaySize);
+    if (FAILED(sr)) return -1;
+    col->sql_type = (SQLSMALLINT)DisplaySize;
+    sr = CALL_SQLColAttribute(hstmt, i+1, SQL_DESC_DISPLAY_SIZE, NULL, 0, NULL, &DisplaySize);
+    if (FAILED(sr)) return -1;
+    sr = CALL_SQLColAttribute(hstmt, i+1, SQL_DESC_OCTET_LENGTH, NULL, 0, NULL, &OctetLength);
+    if (FAILED(sr)) return -1;
+    sr = CALL_SQLColAttribute(hstmt, i+1, SQL_DESC_UNSIGNED, NULL, 0, NULL, &Unsigned);
+    if (FAILED(sr)) return -1;
+
+    // NOTE: csv is written as is, thus every column is fetched as SQL_C_CHAR
+    col->c_type = SQL_C_CHAR;
+    col->width  = (DisplaySize > OctetLength ? DisplaySize : OctetLength) + 1;
+    if (col->width < 32)    col->width = 32;
+    if (col->width > 16384) col->width = 16384;
+
+    if (table->exp->format == EXPORT_LINE) {
+      switch (col->sql_type) {
+        case SQL_TYPE_TIMESTAMP:
+        case SQL_TIMESTAMP:
+          col->c_type = SQL_C_SBIGINT;
+          if (table->i_ts < 0) table->i_ts = i;
+          break;
+        case SQL_BIT:
+          col->c_type = SQL_C_BIT;
+          break;
+        case SQL_TINYINT:
+        case SQL_SMALLINT:
+        case SQL_INTEGER:
+        case SQL_BIGINT:
+          col->c_type = Unsigned ? SQL_C_UBIGINT : SQL_C_SBIGINT;
+          break;
+        case SQL_REAL:
+        case SQL_FLOAT:
+        case SQL_DOUBLE:
+          col->c_type = SQL_C_DOUBLE;
+          break;
+        default:
+          break;
+      }
+      if (col->c_type != SQL_C_CHAR) col->width = 8;
+    }
+
+    col->off_data = off;
+    off += ((size_t)col->width * table->exp->row_array_size + 7) / 8 * 8;
+    col->off_ind = off;
+    off += sizeof(SQLLEN) * table->exp->row_array_size;
+  }
+
+  for (int i=0; i<2; ++i) {
+    table->rowsets[i].buf = (char*)malloc(off);
+    if (!table->rowsets[i].buf) {
+      E("out of memory");
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+static int _export_bind(export_table_t *table, SQLHANDLE hstmt, export_rowset_t *rowset)
+{
+  for (SQLSMALLINT i=0; i<table->nr_cols; ++i) {
+    export_col_t *col = table->cols + i;
+    SQLRETURN sr = CALL_SQLBindCol(hstmt, i+1, col->c_type, rowset->buf + col->off_data, col->width, (SQLLEN*)(rowset->buf + col->off_ind));
+    if (FAILED(sr)) return -1;
+  }
+  return 0;
+}
+
+// fetch rowsets in turn while the writer is writing the other one
+static int _export_fetch(export_table_t *table, SQLHANDLE hstmt)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+  SQLULEN fetched = 0;
+
+  sr = CALL_SQLSetStmtAttr(hstmt, SQL_ATTR_ROWS_FETCHED_PTR, &fetched, 0);
+  if (FAILED(sr)) return -1;
+
+  for (int i=0; ; i ^= 1) {
+    export_rowset_t *rowset = table->rowsets + i;
+
+    pthread_mutex_lock(&table->mutex);
+    while (rowset->full && !table->failed) pthread_cond_wait(&table->cond, &table->mutex);
+    int failed = table->failed;
+    pthread_mutex_unlock(&table->mutex);
+    if (failed) return -1;
+
+    if (_export_bind(table, hstmt, rowset)) return -1;
+
+    sr = CALL_SQLFetch(hstmt);
+    if (sr == SQL_NO_DATA) return 0;
+    if (FAILED(sr)) return -1;
+
+    pthread_mutex_lock(&table->mutex);
+    rowset->nr_rows = fetched;
+    rowset->full    = 1;
+    pthread_cond_broadcast(&table->cond);
+    pthread_mutex_unlock(&table->mutex);
+  }
+}
+
+static int _export_table_with_stmt(export_table_t *table, SQLHANDLE hstmt)
+{
+  export_t *exp = table->exp;
+  SQLRETURN sr = SQL_SUCCESS;
+  char sql[1024];
+
+  if (exp->sql) {
+    snprintf(sql, sizeof(sql), "%s", exp->sql);
+  } else if (table->catalog[0]) {
+    snprintf(sql, sizeof(sql), "select * from `%s`.`%s`", table->catalog, table->name);
+  } else {
+    snprintf(sql, sizeof(sql), "select * from `%s`", table->name);
+  }
+
+  sr = CALL_SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)exp->row_array_size, 0);
+  if (FAILED(sr)) return -1;
+
+  sr = CALL_SQLExecDirect(hstmt, (SQLCHAR*)sql, SQL_NTS);
+  if (FAILED(sr)) return -1;
+
+  if (_export_describe(table, hstmt)) return -1;
+
+  char fn[PATH_MAX];
+  snprintf(fn, sizeof(fn), "%s/%s%s%s.%s", exp->dir,
+      table->catalog, table->catalog[0] ? "." : "", table->name, exp->format == EXPORT_CSV ? "csv" : "lp");
+  table->f = fopen(fn, "wb");
+  if (!table->f) {
+    E("open file `%s` failed:[%d]%s", fn, errno, strerror(errno));
+    return -1;
+  }
+  if (exp->format == EXPORT_CSV) {
+    if (_export_csv_header(table)) return -1;
+    if (fwrite(table->out, 1, table->out_nr, table->f) != table->out_nr) return -1;
+    table->bytes += table->out_nr;
+  }
+
+  pthread_t writer;
+  int e = pthread_create(&writer, NULL, _export_writer_routine, table);
+  if (e) {
+    E("pthread_create failed:[%d]%s", e, strerror(e));
+    return -1;
+  }
+
+  int r = _export_fetch(table, hstmt);
+
+  pthread_mutex_lock(&table->mutex);
+  table->done = 1;
+  pthread_cond_broadcast(&table->cond);
+  pthread_mutex_unlock(&table->mutex);
+
+  void *p = NULL;
+  pthread_join(writer, &p);
+  if (p) r = -1;
+
+  if (fclose(table->f)) r = -1;
+  table->f = NULL;
+
+  return r;
+}
+
+static int _export_table(export_table_t *table, SQLHANDLE hconn)
+{
+  int64_t t0 = tod_now_us();
+
+  SQLHANDLE hstmt = SQL_NULL_HANDLE;
+  SQLRETURN sr = CALL_SQLAllocHandle(SQL_HANDLE_STMT, hconn, &hstmt);
+  if (FAILED(sr)) return -1;
+
+  pthread_mutex_init(&table->mutex, NULL);
+  pthread_cond_init(&table->cond, NULL);
+
+  int r = _export_table_with_stmt(table, hstmt);
+
+  if (table->f) fclose(table->f);
+  pthread_cond_destroy(&table->cond);
+  pthread_mutex_destroy(&table->mutex);
+  for (int i=0; i<2; ++i) free(table->rowsets[i].buf);
+  free(table->cols);
+  free(table->out);
+  CALL_SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+
+  double secs = (double)(tod_now_us() - t0) / 1000000;
+  if (secs <= 0) secs = 1e-6;
+  DUMP("%s%s%s:%s, rows:%zd, bytes:%zd, truncated:%zd, %.3fs, %.0f rows/s, %.2f MB/s",
+      table->catalog, table->catalog[0] ? "." : "", table->name, r ? "failure" : "success",
+      table->rows, table->bytes, table->truncated, secs, table->rows / secs, table->bytes / secs / 1024 / 1024);
+
+  return r;
+}
+
+static int _export_connect(SQLHANDLE hconn)
+{
+  const odbc_conn_arg_t *conn_arg = _export_conn_arg;
+  SQLRETURN sr = SQL_SUCCESS;
+
+  if (conn_arg->connstr) {
+    sr = CALL_SQLDriverConnect(hconn, NULL, (SQLCHAR*)conn_arg->connstr, SQL_NTS, NULL, 0, NULL, SQL_DRIVER_NOPROMPT);
+  } else {
+    sr = CALL_SQLConnect(hconn, (SQLCHAR*)conn_arg->dsn, SQL_NTS, (SQLCHAR*)conn_arg->uid, SQL_NTS, (SQLCHAR*)conn_arg->pwd, SQL_NTS);
+  }
+
+  return FAILED(sr) ? -1 : 0;
+}
+
+static void* _export_worker_routine(void *arg)
+{
+  export_t *exp = (export_t*)arg;
+  SQLHANDLE hconn = SQL_NULL_HANDLE;
+  int failures = 0;
+
+  SQLRETURN sr = CALL_SQLAllocHandle(SQL_HANDLE_DBC, exp->henv, &hconn);
+  if (FAILED(sr)) return (void*)(uintptr_t)-1;
+
+  if (_export_connect(hconn)) {
+    CALL_SQLFreeHandle(SQL_HANDLE_DBC, hconn);
+    return (void*)(uintptr_t)-1;
+  }
+
+  while (1) {
+    pthread_mutex_lock(&exp->mutex);
+    size_t i = exp->next++;
+    pthread_mutex_unlock(&exp->mutex);
+    if (i >= exp->nr_tables) break;
+
+    if (_export_table(exp->tables + i, hconn)) ++failures;
+  }
+
+  CALL_SQLDisconnect(hconn);
+  CALL_SQLFreeHandle(SQL_HANDLE_DBC, hconn);
+
+  pthread_mutex_lock(&exp->mutex);
+  exp->failures += failures;
+  pthread_mutex_unlock(&exp->mutex);
+
+  return NULL;
+}
+
+static int _export_list_tables(export_t *exp, SQLHANDLE hstmt)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+
+  const char *CatalogName = getenv("CATALOG");
+  const char *SchemaName  = getenv("SCHEMA");
+  const char *TableName   = getenv("TABLE");
+  const char *TableType   = getenv("TYPE");
+  // NOTE: super tables are left out by default, their rows are exported by way of their child tables
+  if (!TableType) TableType = "TABLE,CHILD TABLE";
+
+  sr = CALL_SQLTables(hstmt,
+    (SQLCHAR*)CatalogName, CatalogName ? (SQLSMALLINT)strlen(CatalogName) : 0,
+    (SQLCHAR*)SchemaName,  SchemaName ? (SQLSMALLINT)strlen(SchemaName) : 0,
+    (SQLCHAR*)TableName,   TableName ? (SQLSMALLINT)strlen(TableName) : 0,
+    (SQLCHAR*)TableType,   (SQLSMALLINT)strlen(TableType));
+  if (FAILED(sr)) return -1;
+
+  size_t cap = 0;
+  while (1) {
+    sr = CALL_SQLFetch(hstmt);
+    if (sr == SQL_NO_DATA) break;
+    if (FAILED(sr)) return -1;
+
+    if (exp->nr_tables == cap) {
+      size_t n = cap ? cap * 2 : 64;
+      export_table_t *p = (export_table_t*)realloc(exp->tables, n * sizeof(*p));
+      if (!p) {
+        E("out of memory");
+        return -1;
+      }
+      exp->tables = p;
+      cap = n;
+    }
+
+    export_table_t *table = exp->tables + exp->nr_tables;
+    memset(table, 0, sizeof(*table));
+    SQLLEN ind;
+    sr = CALL_SQLGetData(hstmt, 1, SQL_C_CHAR, table->catalog, sizeof(table->catalog), &ind);
+    if (FAILED(sr)) return -1;
+    if (ind == SQL_NULL_DATA) table->catalog[0] = '\0';
+    sr = CALL_SQLGetData(hstmt, 3, SQL_C_CHAR, table->name, sizeof(table->name), &ind);
+    if (FAILED(sr)) return -1;
+    table->exp = exp;
+    ++exp->nr_tables;
+  }
+
+  CALL_SQLCloseCursor(hstmt);
+  return 0;
+}
+
+static int _export_run(export_t *exp)
+{
+  int64_t t0 = tod_now_us();
+
+  if (exp->nr_tables == 0) {
+    DUMP("no tables to export");
+    return 0;
+  }
+
+  pthread_t threads[64];
+  int nr = 0;
+  for (nr=0; nr<exp->nr_threads && (size_t)nr<exp->nr_tables; ++nr) {
+    int e = pthread_create(threads + nr, NULL, _export_worker_routine, exp);
+    if (e) {
+      E("pthread_create failed:[%d]%s", e, strerror(e));
+      break;
+    }
+  }
+  if (nr == 0) return -1;
+
+  int r = 0;
+  for (int i=0; i<nr; ++i) {
+    void *p = NULL;
+    pthread_join(threads[i], &p);
+    if (p) r = -1;
+  }
+
+  size_t rows = 0, bytes = 0;
+  for (size_t i=0; i<exp->nr_tables; ++i) {
+    rows  += exp->tables[i].rows;
+    bytes += exp->tables[i].bytes;
+  }
+  double secs = (double)(tod_now_us() - t0) / 1000000;
+  if (secs <= 0) secs = 1e-6;
+  DUMP("exported %zd table(s) by %d thread(s), failures:%d, rows:%zd, bytes:%zd, %.3fs, %.0f rows/s, %.2f MB/s",
+      exp->nr_tables, nr, exp->failures, rows, bytes, secs, rows / secs, bytes / secs / 1024 / 1024);
+
+  return (r || exp->failures) ? -1 : 0;
+}
+
+static int _export(odbc_case_t *odbc_case, odbc_stage_t stage, odbc_handles_t *handles)
+{
+  (void)odbc_case;
+
+  if (stage != ODBC_STMT) return 0;
+
+  DUMP("%s:", __func__);
+
+  export_t exp = {0};
+  exp.henv           = handles->henv;
+  exp.dir            = getenv("SAMPLE_EXPORT_DIR");
+  exp.sql            = getenv("SAMPLE_EXPORT_SQL");
+  exp.row_array_size = 1024;
+  exp.nr_threads     = 4;
+  if (!exp.dir) exp.dir = ".";
+
+  const char *s = getenv("SAMPLE_EXPORT_FORMAT");
+  if (s && strcmp(s, "line") == 0) {
+    exp.format = EXPORT_LINE;
+  } else if (s && strcmp(s, "csv")) {
+    DUMP("env `SAMPLE_EXPORT_FORMAT`:%s, `csv` or `line` expected", s);
+    return -1;
+  }
+  s = getenv("SAMPLE_EXPORT_ROWS");
+  if (s && atoi(s) > 0) exp.row_array_size = (SQLULEN)atoi(s);
+  s = getenv("SAMPLE_EXPORT_THREADS");
+  if (s && atoi(s) > 0) exp.nr_threads = atoi(s);
+  if (exp.nr_threads > 64) exp.nr_threads = 64;
+
+  DUMP("dir:%s, format:%s, rows:%zd, threads:%d", exp.dir, exp.format == EXPORT_CSV ? "csv" : "line",
+      (size_t)exp.row_array_size, exp.nr_threads);
+
+  int r = 0;
+  if (exp.sql) {
+    exp.tables = (export_table_t*)calloc(1, sizeof(*exp.tables));
+    if (!exp.tables) return -1;
+    snprintf(exp.tables->name, sizeof(exp.tables->name), "export");
+    exp.tables->exp = &exp;
+    exp.nr_tables   = 1;
+  } else {
+    r = _export_list_tables(&exp, handles->hstmt);
+  }
+
+  pthread_mutex_init(&exp.mutex, NULL);
+  if (r == 0) r = _export_run(&exp);
+  pthread_mutex_destroy(&exp.mutex);
+
+  free(exp.tables);
+  return r;
+}
+
 static odbc_case_t odbc_cases[] = {
   ODBC_CASE(_dummy),
   ODBC_CASE(_dump_stmt_col_info),
@@ -1023,11 +1706,13 @@ static odbc_case_t odbc_cases[] = {
   ODBC_CASE(_exec_direct),
   ODBC_CASE(_bind_exec_direct),
   ODBC_CASE(_execute_file),
+  ODBC_CASE(_export),
 };
 
 static int _dumping(arg_t *arg)
 {
   odbc_conn_arg_t conn_arg = arg->conn_arg;
+  _export_conn_arg = &conn_arg;
   return run_odbc_cases(arg->name, &conn_arg, odbc_cases, sizeof(odbc_cases)/sizeof(odbc_cases[0]));
 }
 
@@ -1042,6 +1727,14 @@ static void usage(const char *arg0)
   for (size_t i=0; i<sizeof(odbc_cases)/sizeof(odbc_cases[0]); ++i) {
     DUMP("  %s", odbc_cases[i].name);
   }
+  DUMP("");
+  DUMP("envs of _export:");
+  DUMP("  SAMPLE_EXPORT_DIR       output directory, `.` by default");
+  DUMP("  SAMPLE_EXPORT_FORMAT    `csv` by default, or `line` for line protocol");
+  DUMP("  SAMPLE_EXPORT_ROWS      SQL_ATTR_ROW_ARRAY_SIZE, 1024 by default");
+  DUMP("  SAMPLE_EXPORT_THREADS   tables exported in parallel, 4 by default");
+  DUMP("  SAMPLE_EXPORT_SQL       export the result set of this sql into `export.<csv|lp>`, instead of tables");
+  DUMP("  CATALOG/SCHEMA/TABLE/TYPE  arguments of SQLTables to list tables to export");
 }
 
 static int dumping(int argc, char *argv[])
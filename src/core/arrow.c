@@ -0,0 +1,391 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022-2023 freemine <freemine@yeah.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "internal.h"
+
+#include "arrow.h"
+
+#include "log.h"
+#include "taos_helpers.h"
+
+#include <errno.h>
+
+// return the format of the child array, with `*width` set to bytes per value if the values could be borrowed as is
+static const char* _tsdb_arrow_format(int8_t type, int time_precision, size_t *width)
+{
+  *width = 0;
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:      return "b";  // re-packed into bits
+    case TSDB_DATA_TYPE_TINYINT:   *width = 1; return "c";
+    case TSDB_DATA_TYPE_UTINYINT:  *width = 1; return "C";
+    case TSDB_DATA_TYPE_SMALLINT:  *width = 2; return "s";
+    case TSDB_DATA_TYPE_USMALLINT: *width = 2; return "S";
+    case TSDB_DATA_TYPE_INT:       *width = 4; return "i";
+    case TSDB_DATA_TYPE_UINT:      *width = 4; return "I";
+    case TSDB_DATA_TYPE_BIGINT:    *width = 8; return "l";
+    case TSDB_DATA_TYPE_UBIGINT:   *width = 8; return "L";
+    case TSDB_DATA_TYPE_FLOAT:     *width = 4; return "f";
+    case TSDB_DATA_TYPE_DOUBLE:    *width = 8; return "g";
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      *width = 8;
+      switch (time_precision) {
+        case 0:  return "tsm:";
+        case 1:  return "tsu:";
+        case 2:  return "tsn:";
+        default: return NULL;
+      }
+    case TSDB_DATA_TYPE_VARCHAR:   return "u";
+    case TSDB_DATA_TYPE_NCHAR:     return "u";
+    default:                       return NULL;
+  }
+}
+
+static void _tsdb_arrow_schema_release(struct ArrowSchema *schema)
+{
+  if (!schema || !schema->release) return;
+  for (int64_t i=0; i<schema->n_children; ++i) {
+    struct ArrowSchema *child = schema->children[i];
+    if (child && child->release) child->release(child);
+    free(child);
+  }
+  TOD_SAFE_FREE(schema->children);
+  free((char*)schema->name);
+  schema->name    = NULL;
+  schema->release = NULL;
+}
+
+static int _tsdb_arrow_get_schema(struct ArrowArrayStream *stream, struct ArrowSchema *out)
+{
+  tsdb_arrow_t *arrow = (tsdb_arrow_t*)stream->private_data;
+  if (!arrow) return EINVAL;
+
+  memset(out, 0, sizeof(*out));
+  out->format     = "+s";
+  out->n_children = (int64_t)arrow->nr_fields;
+  out->release    = _tsdb_arrow_schema_release;
+  out->children   = (struct ArrowSchema**)calloc(arrow->nr_fields + 1, sizeof(*out->children));
+  if (!out->children) goto oom;
+
+  for (size_t i=0; i<arrow->nr_fields; ++i) {
+    TAOS_FIELD *field = arrow->fields + i;
+    struct ArrowSchema *child = (struct ArrowSchema*)calloc(1, sizeof(*child));
+    if (!child) goto oom;
+    out->children[i] = child;
+
+    size_t width = 0;
+    child->format  = _tsdb_arrow_format(field->type, arrow->time_precision, &width);
+    child->name    = strdup(field->name);
+    child->flags   = ARROW_FLAG_NULLABLE;
+    child->release = _tsdb_arrow_schema_release;
+    if (!child->name) goto oom;
+  }
+
+  return 0;
+
+oom:
+  _tsdb_arrow_schema_release(out);
+  snprintf(arrow->errmsg, sizeof(arrow->errmsg), "out of memory");
+  return ENOMEM;
+}
+
+static void _tsdb_arrow_batch_unref(tsdb_arrow_batch_t *batch)
+{
+  if (--batch->refc) return;
+  if (batch->arrow && batch->arrow->borrowing == batch) batch->arrow->borrowing = NULL;
+  TOD_SAFE_FREE(batch->children);
+  TOD_SAFE_FREE(batch->cols);
+  free(batch);
+}
+
+static void _tsdb_arrow_col_release(struct ArrowArray *array)
+{
+  if (!array || !array->release) return;
+  tsdb_arrow_col_t *col = (tsdb_arrow_col_t*)array->private_data;
+  tsdb_arrow_batch_t *batch = col->batch;
+  for (size_t i=0; i<batch->nr_cols; ++i) {
+    if (batch->cols[i] != col) continue;
+    // NOTE: `children[i]` points into `col`, thus shall not be touched once `col` is freed below
+    batch->cols[i]     = NULL;
+    batch->children[i] = NULL;
+  }
+  _tsdb_arrow_batch_unref(batch);
+  TOD_SAFE_FREE(col->owned);
+  TOD_SAFE_FREE(col->detached);
+  array->release = NULL;
+  // NOTE: `array` might have been moved by the consumer, thus `col` is freed as a whole
+  free(col);
+}
+
+static void _tsdb_arrow_batch_release(struct ArrowArray *array)
+{
+  if (!array || !array->release) return;
+  tsdb_arrow_batch_t *batch = (tsdb_arrow_batch_t*)array->private_data;
+  for (size_t i=0; i<batch->nr_cols; ++i) {
+    struct ArrowArray *child = batch->children[i];
+    // NOTE: children moved away by the consumer have their release callbacks cleared here
+    if (child && child->release) child->release(child);
+  }
+  array->release = NULL;
+  _tsdb_arrow_batch_unref(batch);
+}
+
+// copy the values still borrowed from the current taos block, which is about to be overwritten or freed
+static int _tsdb_arrow_detach(tsdb_arrow_t *arrow)
+{
+  tsdb_arrow_batch_t *batch = arrow->borrowing;
+  if (!batch) return 0;
+
+  for (size_t i=0; i<batch->nr_cols; ++i) {
+    tsdb_arrow_col_t *col = batch->cols[i];
+    if (!col || !col->width || col->detached) continue;
+    size_t bytes = col->width * (size_t)col->array.length;
+    col->detached = malloc(bytes ? bytes : 1);
+    if (!col->detached) return -1;
+    memcpy(col->detached, col->buffers[1], bytes);
+    col->buffers[1] = col->detached;
+  }
+
+  batch->arrow     = NULL;
+  arrow->borrowing = NULL;
+  return 0;
+}
+
+// NOTE: the int16_t length prefix of var-length values is not necessarily aligned
+static int _tsdb_arrow_fill_col(tsdb_arrow_t *arrow, tsdb_arrow_col_t *col, int i_col, TAOS_ROW rows, int nr_rows)
+{
+  TAOS_FIELD *field = arrow->fields + i_col;
+  const char *data = (const char*)rows[i_col];
+  size_t bitmap = ((size_t)nr_rows + 7) / 8;
+  int *offsets = NULL;
+  int64_t nulls = 0;
+
+  _tsdb_arrow_format(field->type, arrow->time_precision, &col->width);
+
+  size_t bytes = 0;
+  if (field->type == TSDB_DATA_TYPE_VARCHAR || field->type == TSDB_DATA_TYPE_NCHAR) {
+    offsets = CALL_taos_get_column_data_offset(arrow->res, i_col);
+    if (!offsets) {
+      snprintf(arrow->errmsg, sizeof(arrow->errmsg), "no offsets of column[%d/%s]", i_col + 1, field->name);
+      return EIO;
+    }
+    for (int i=0; i<nr_rows; ++i) {
+      if (offsets[i] < 0) {
+        ++nulls;
+        continue;
+      }
+      uint16_t len;
+      memcpy(&len, data + offsets[i], sizeof(len));
+      bytes += len;
+    }
+  } else {
+    for (int i=0; i<nr_rows; ++i) {
+      if (CALL_taos_is_null(arrow->res, i, i_col)) ++nulls;
+    }
+  }
+
+  // NOTE: [validity bitmap][bits of bool | int32_t offsets[nr_rows+1] + data], 8-byte aligned each
+  size_t off_values = (nulls ? (bitmap + 7) / 8 * 8 : 0);
+  size_t off_data   = off_values + ((size_t)nr_rows + 1) * sizeof(int32_t);
+  size_t total = off_values;
+  if (field->type == TSDB_DATA_TYPE_BOOL) total += bitmap;
+  if (offsets) total = off_data + bytes;
+
+  col->owned = calloc(1, total ? total : 1);
+  if (!col->owned) {
+    snprintf(arrow->errmsg, sizeof(arrow->errmsg), "out of memory");
+    return ENOMEM;
+  }
+  unsigned char *base = (unsigned char*)col->owned;
+
+  if (nulls) {
+    memset(base, 0xff, bitmap);
+    for (int i=0; i<nr_rows; ++i) {
+      int is_null = offsets ? (offsets[i] < 0) : !!CALL_taos_is_null(arrow->res, i, i_col);
+      if (is_null) base[i / 8] &= (unsigned char)~(1 << (i % 8));
+    }
+  }
+
+  col->buffers[0] = nulls ? base : NULL;
+  col->array.n_buffers = 2;
+  if (offsets) {
+    int32_t *dst_offsets = (int32_t*)(base + off_values);
+    char *dst = (char*)(base + off_data);
+    int32_t n = 0;
+    for (int i=0; i<nr_rows; ++i) {
+      dst_offsets[i] = n;
+      if (offsets[i] < 0) continue;
+      const char *p = data + offsets[i];
+      uint16_t len;
+      memcpy(&len, p, sizeof(len));
+      memcpy(dst + n, p + sizeof(len), len);
+      n += len;
+    }
+    dst_offsets[nr_rows] = n;
+    col->buffers[1] = dst_offsets;
+    col->buffers[2] = dst;
+    col->array.n_buffers = 3;
+  } else if (field->type == TSDB_DATA_TYPE_BOOL) {
+    unsigned char *bits = base + off_values;
+    for (int i=0; i<nr_rows; ++i) {
+      if (data[i]) bits[i / 8] |= (unsigned char)(1 << (i % 8));
+    }
+    col->buffers[1] = bits;
+  } else {
+    // NOTE: zero-copy, valid until the next taos_fetch_block, unless detached before that
+    col->buffers[1] = data;
+  }
+
+  col->array.length     = nr_rows;
+  col->array.null_count = nulls;
+  col->array.buffers    = col->buffers;
+  col->array.release    = _tsdb_arrow_col_release;
+  col->array.private_data = col;
+
+  return 0;
+}
+
+static int _tsdb_arrow_get_next(struct ArrowArrayStream *stream, struct ArrowArray *out)
+{
+  tsdb_arrow_t *arrow = (tsdb_arrow_t*)stream->private_data;
+  if (!arrow) return EINVAL;
+
+  memset(out, 0, sizeof(*out));
+  arrow->errmsg[0] = '\0';
+
+  if (_tsdb_arrow_detach(arrow)) {
+    snprintf(arrow->errmsg, sizeof(arrow->errmsg), "out of memory");
+    return ENOMEM;
+  }
+
+  TAOS_ROW rows = NULL;
+  int nr_rows = CALL_taos_fetch_block(arrow->res, &rows);
+  int e = CALL_taos_errno(arrow->res);
+  if (nr_rows < 0 || e) {
+    snprintf(arrow->errmsg, sizeof(arrow->errmsg), "[taosc]%s", CALL_taos_errstr(arrow->res));
+    return EIO;
+  }
+  // NOTE: end of stream, as the spec says, with `out` released
+  if (nr_rows == 0) return 0;
+
+  tsdb_arrow_batch_t *batch = (tsdb_arrow_batch_t*)calloc(1, sizeof(*batch));
+  if (!batch) {
+    snprintf(arrow->errmsg, sizeof(arrow->errmsg), "out of memory");
+    return ENOMEM;
+  }
+  batch->arrow    = arrow;
+  batch->refc     = 1;
+  batch->children = (struct ArrowArray**)calloc(arrow->nr_fields + 1, sizeof(*batch->children));
+  batch->cols     = (tsdb_arrow_col_t**)calloc(arrow->nr_fields + 1, sizeof(*batch->cols));
+
+  out->length       = nr_rows;
+  out->n_buffers    = 1;
+  out->buffers      = batch->buffers;
+  out->n_children   = (int64_t)arrow->nr_fields;
+  out->children     = batch->children;
+  out->release      = _tsdb_arrow_batch_release;
+  out->private_data = batch;
+
+  int r = (batch->children && batch->cols) ? 0 : ENOMEM;
+  if (r) snprintf(arrow->errmsg, sizeof(arrow->errmsg), "out of memory");
+  for (size_t i=0; r == 0 && i<arrow->nr_fields; ++i) {
+    tsdb_arrow_col_t *col = (tsdb_arrow_col_t*)calloc(1, sizeof(*col));
+    if (!col) {
+      snprintf(arrow->errmsg, sizeof(arrow->errmsg), "out of memory");
+      r = ENOMEM;
+      break;
+    }
+    col->batch = batch;
+    batch->refc += 1;
+    batch->cols[i] = col;
+    batch->children[i] = &col->array;
+    batch->nr_cols = i + 1;
+    col->array.release      = _tsdb_arrow_col_release;
+    col->array.private_data = col;
+    r = _tsdb_arrow_fill_col(arrow, col, (int)i, rows, nr_rows);
+  }
+
+  if (r) {
+    out->release(out);
+    return r;
+  }
+
+  arrow->borrowing = batch;
+  return 0;
+}
+
+static const char* _tsdb_arrow_get_last_error(struct ArrowArrayStream *stream)
+{
+  tsdb_arrow_t *arrow = (tsdb_arrow_t*)stream->private_data;
+  if (!arrow || !arrow->errmsg[0]) return NULL;
+  return arrow->errmsg;
+}
+
+static void _tsdb_arrow_release(struct ArrowArrayStream *stream)
+{
+  if (!stream || !stream->release) return;
+  tsdb_arrow_t *arrow = (tsdb_arrow_t*)stream->private_data;
+  if (arrow) {
+    if (_tsdb_arrow_detach(arrow)) {
+      // NOTE: out of memory, the batch still alive is left with values that shall not be read any more
+      arrow->borrowing->arrow = NULL;
+    }
+    CALL_taos_free_result(arrow->res);
+    free(arrow);
+  }
+  stream->private_data = NULL;
+  stream->release      = NULL;
+}
+
+int tsdb_arrow_export(TAOS_RES *res, struct ArrowArrayStream *stream, char *err, size_t len)
+{
+  int nr_fields = CALL_taos_field_count(res);
+  TAOS_FIELD *fields = CALL_taos_fetch_fields(res);
+  int time_precision = CALL_taos_result_precision(res);
+
+  for (int i=0; i<nr_fields; ++i) {
+    size_t width = 0;
+    if (_tsdb_arrow_format(fields[i].type, time_precision, &width)) continue;
+    snprintf(err, len, "column[%d/%s] of `%s[0x%x/%d]` not supported yet",
+        i + 1, fields[i].name, taos_data_type(fields[i].type), fields[i].type, fields[i].type);
+    return -1;
+  }
+
+  tsdb_arrow_t *arrow = (tsdb_arrow_t*)calloc(1, sizeof(*arrow));
+  if (!arrow) {
+    snprintf(err, len, "out of memory");
+    return -1;
+  }
+  arrow->res            = res;
+  arrow->fields         = fields;
+  arrow->nr_fields      = (size_t)nr_fields;
+  arrow->time_precision = time_precision;
+
+  stream->get_schema     = _tsdb_arrow_get_schema;
+  stream->get_next       = _tsdb_arrow_get_next;
+  stream->get_last_error = _tsdb_arrow_get_last_error;
+  stream->release        = _tsdb_arrow_release;
+  stream->private_data   = arrow;
+
+  return 0;
+}
@@ -31,6 +31,7 @@
 #include "errs.h"
 #include "log.h"
 #include "conn_parser.h"
+#include "profile.h"
 #include "stmt.h"
 #include "taos_helpers.h"
 #include "taos_odbc_config.h"
@@ -57,6 +58,7 @@ void conn_cfg_release(conn_cfg_t *conn_cfg)
 
 static void _conn_init(conn_t *conn, env_t *env)
 {
+  pthread_mutex_init(&conn->stmts_mutex, NULL);
   INIT_TOD_LIST_HEAD(&conn->stmts);
 
   conn->env = env_ref(env);
@@ -65,6 +67,13 @@ static void _conn_init(conn_t *conn, env_t *env)
 
   errs_init(&conn->errs);
 
+  pthread_mutex_init(&conn->timer.mutex, NULL);
+  pthread_cond_init(&conn->timer.cond, NULL);
+
+  pthread_mutex_init(&conn->busy_mutex, NULL);
+
+  pthread_mutex_init(&conn->pool.mutex, NULL);
+
   conn->refc = 1;
 }
 
@@ -78,6 +87,173 @@ static void _conn_release_information_schema_ins_configs(conn_t *conn)
   conn->tsdb_charset[0] = '\0';
 }
 
+static void* _conn_timer_routine(void *arg)
+{
+  conn_t *conn = (conn_t*)arg;
+  conn_timer_t *timer = &conn->timer;
+
+  pthread_mutex_lock(&timer->mutex);
+  while (!timer->stop) {
+    int64_t now = tod_now_us();
+    int64_t wait = 1000 * 1000;
+    size_t i = 0;
+    while (i < timer->nr) {
+      conn_timer_entry_t *entry = timer->entries + i;
+      if (entry->deadline <= now) {
+        // NOTE: lock order is timer->mutex -> stmt->cancel_mutex, stmt would not be freed while armed
+        OD("stmt[%p]:query timeout expired", entry->stmt);
+        stmt_cancel_with(entry->stmt, STMT_CANCEL_TIMEOUT);
+        timer->entries[i] = timer->entries[--timer->nr];
+        continue;
+      }
+      if (entry->deadline - now < wait) wait = entry->deadline - now;
+      ++i;
+    }
+    tod_cond_timedwait_ms(&timer->cond, &timer->mutex, (int)((wait + 999) / 1000));
+  }
+  pthread_mutex_unlock(&timer->mutex);
+
+  return NULL;
+}
+
+static void _conn_timer_stop(conn_t *conn)
+{
+  conn_timer_t *timer = &conn->timer;
+
+  pthread_mutex_lock(&timer->mutex);
+  int started = timer->started;
+  timer->stop = 1;
+  pthread_cond_signal(&timer->cond);
+  pthread_mutex_unlock(&timer->mutex);
+
+  if (started) pthread_join(timer->thread, NULL);
+
+  timer->started = 0;
+  timer->stop    = 0;
+  timer->nr      = 0;
+}
+
+int conn_timer_arm(conn_t *conn, stmt_t *stmt, int64_t timeout_us)
+{
+  conn_timer_t *timer = &conn->timer;
+  int r = 0;
+
+  pthread_mutex_lock(&timer->mutex);
+  if (timer->nr == timer->cap) {
+    size_t cap = timer->cap + 16;
+    conn_timer_entry_t *entries = (conn_timer_entry_t*)realloc(timer->entries, sizeof(*entries) * cap);
+    if (!entries) {
+      r = -1;
+      goto end;
+    }
+    timer->entries = entries;
+    timer->cap     = cap;
+  }
+  if (!timer->started) {
+    if (pthread_create(&timer->thread, NULL, _conn_timer_routine, conn)) {
+      r = -1;
+      goto end;
+    }
+    timer->started = 1;
+  }
+  timer->entries[timer->nr].stmt     = stmt;
+  timer->entries[timer->nr].deadline = tod_now_us() + timeout_us;
+  timer->nr += 1;
+  pthread_cond_signal(&timer->cond);
+
+end:
+  pthread_mutex_unlock(&timer->mutex);
+  return r;
+}
+
+void conn_timer_disarm(conn_t *conn, stmt_t *stmt)
+{
+  conn_timer_t *timer = &conn->timer;
+
+  pthread_mutex_lock(&timer->mutex);
+  for (size_t i=0; i<timer->nr; ++i) {
+    if (timer->entries[i].stmt != stmt) continue;
+    timer->entries[i] = timer->entries[--timer->nr];
+    break;
+  }
+  pthread_mutex_unlock(&timer->mutex);
+}
+
+void conn_set_busy(conn_t *conn, int busy)
+{
+  pthread_mutex_lock(&conn->busy_mutex);
+  if (busy) {
+    conn->nr_busy += 1;
+  } else {
+    OA_ILE(conn->nr_busy > 0);
+    conn->nr_busy -= 1;
+  }
+  pthread_mutex_unlock(&conn->busy_mutex);
+}
+
+int conn_kill_query_if_alone(conn_t *conn)
+{
+  int killed = 0;
+
+  // NOTE: held across taos_kill_query, so that no other statement would start a query on `taos` in the meantime
+  pthread_mutex_lock(&conn->busy_mutex);
+  if (conn->nr_busy == 1) {
+    CALL_taos_kill_query(conn->taos);
+    killed = 1;
+  }
+  pthread_mutex_unlock(&conn->busy_mutex);
+
+  return killed;
+}
+
+TAOS* conn_pool_get(conn_t *conn)
+{
+  conn_pool_t *pool = &conn->pool;
+  TAOS *taos = NULL;
+
+  pthread_mutex_lock(&pool->mutex);
+  if (pool->nr) taos = pool->idle[--pool->nr];
+  pthread_mutex_unlock(&pool->mutex);
+  if (taos) return taos;
+
+  const conn_cfg_t *cfg = &conn->cfg;
+  return CALL_taos_connect(cfg->ip, cfg->uid, cfg->pwd, NULL, cfg->port);
+}
+
+void conn_pool_put(conn_t *conn, TAOS *taos)
+{
+  conn_pool_t *pool = &conn->pool;
+
+  pthread_mutex_lock(&pool->mutex);
+  if (pool->nr == pool->cap) {
+    size_t cap = pool->cap + 16;
+    TAOS **idle = (TAOS**)realloc(pool->idle, sizeof(*idle) * cap);
+    if (idle) {
+      pool->idle = idle;
+      pool->cap  = cap;
+    }
+  }
+  if (pool->nr < pool->cap) {
+    pool->idle[pool->nr++] = taos;
+    taos = NULL;
+  }
+  pthread_mutex_unlock(&pool->mutex);
+
+  if (taos) CALL_taos_close(taos);
+}
+
+static void _conn_pool_close(conn_t *conn)
+{
+  conn_pool_t *pool = &conn->pool;
+
+  pthread_mutex_lock(&pool->mutex);
+  for (size_t i=0; i<pool->nr; ++i) {
+    CALL_taos_close(pool->idle[i]);
+  }
+  pool->nr = 0;
+  pthread_mutex_unlock(&pool->mutex);
+}
+
 static void _conn_release(conn_t *conn)
 {
   OA_ILE(conn->taos == NULL);
@@ -86,6 +262,7 @@ static void _conn_release(conn_t *conn)
   OA_ILE(prev >= 1);
   size_t stmts = conn->nr_stmts;
   OA_ILE(stmts == 0);
+  stmt_perf_dump("conn", conn, &conn->perf);
   env_unref(conn->env);
   conn->env = NULL;
 
@@ -94,6 +271,21 @@ static void _conn_release(conn_t *conn)
 
   errs_release(&conn->errs);
 
+  _conn_timer_stop(conn);
+  TOD_SAFE_FREE(conn->timer.entries);
+  conn->timer.cap = 0;
+  pthread_cond_destroy(&conn->timer.cond);
+  pthread_mutex_destroy(&conn->timer.mutex);
+
+  pthread_mutex_destroy(&conn->busy_mutex);
+
+  _conn_pool_close(conn);
+  TOD_SAFE_FREE(conn->pool.idle);
+  conn->pool.cap = 0;
+  pthread_mutex_destroy(&conn->pool.mutex);
+
+  pthread_mutex_destroy(&conn->stmts_mutex);
+
   return;
 }
 
@@ -424,6 +616,69 @@ static int _conn_get_timezone(conn_t *conn)
   return r;
 }
 
+static SQLRETURN _conn_flush_deferred(conn_t *conn)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+
+  // NOTE: statements are collected under stmts_mutex, but flushed after it's released, since flushing talks to taosc,
+  //       and each is referenced meanwhile, in case it's being freed by another thread
+  stmt_t *p;
+  stmt_t **stmts = NULL;
+  size_t nr = 0;
+  pthread_mutex_lock(&conn->stmts_mutex);
+  if (conn->nr_stmts) stmts = (stmt_t**)malloc(sizeof(*stmts) * conn->nr_stmts);
+  if (stmts) {
+    tod_list_for_each_entry(p, &conn->stmts, stmt_t, node) {
+      int refc = atomic_load(&p->refc);
+      while (refc > 0 && !atomic_compare_exchange_weak(&p->refc, &refc, refc + 1)) ;
+      if (refc > 0) stmts[nr++] = p;
+    }
+  }
+  int oom = (conn->nr_stmts && !stmts);
+  pthread_mutex_unlock(&conn->stmts_mutex);
+
+  if (oom) {
+    conn_oom(conn);
+    return SQL_ERROR;
+  }
+
+  for (size_t i=0; i<nr; ++i) {
+    p = stmts[i];
+    err_t *last = errs_last(&p->errs);
+    if (stmt_flush_deferred(p) != SQL_SUCCESS) {
+      conn_append_err_format(conn, "HY000", 0, "General error:failed to execute deferred rows of statement [%p]", p);
+      // NOTE: the application checks diagnostics of the connection, thus carry over those of the flush
+      errs_move(&conn->errs, &p->errs, errs_next(&p->errs, last), (size_t)-1);
+      sr = SQL_ERROR;
+    }
+    stmt_unref(p);
+  }
+  free(stmts);
+
+  return sr;
+}
+
+static void _conn_disconnect(conn_t *conn)
+{
+  stmt_t *p, *n;
+  tod_list_for_each_entry_safe(p, n, &conn->stmts, stmt_t, node) {
+    OW("statement [%p] is still associated with connection [%p], but have to be freed by SQLDisconnect, "
+       "and it's application's responsibility not use the statment anymore", p, conn);
+    OA_NIY(p->refc == 1);
+    stmt_unref(p);
+  }
+  conn->nr_stmts = 0;
+
+  _conn_timer_stop(conn);
+  _conn_pool_close(conn);
+
+  if (conn->taos) {
+    CALL_taos_close(conn->taos);
+    conn->taos = NULL;
+  }
+  conn_cfg_release(&conn->cfg);
+}
+
 static SQLRETURN _do_conn_connect(conn_t *conn)
 {
   SQLRETURN sr;
@@ -521,7 +776,7 @@ static SQLRETURN _do_conn_connect(conn_t *conn)
 
     return SQL_SUCCESS;
   } while (0);
-  conn_disconnect(conn);
+  _conn_disconnect(conn);
   return SQL_ERROR;
 }
 
@@ -603,6 +858,23 @@ static void _conn_fill_out_connection_str(
   }
   if (n>0) count += n;
 
+  if (conn->cfg.write_behind) {
+    fixed_buf_sprintf(n, &buffer, "WRITE_BEHIND=%d;", conn->cfg.write_behind);
+    if (n>0) count += n;
+    fixed_buf_sprintf(n, &buffer, "WRITE_BEHIND_MS=%d;", conn->cfg.write_behind_ms);
+    if (n>0) count += n;
+  }
+
+  if (conn->cfg.static_cursor_kb) {
+    fixed_buf_sprintf(n, &buffer, "STATIC_CURSOR_KB=%d;", conn->cfg.static_cursor_kb);
+    if (n>0) count += n;
+  }
+
+  if (conn->cfg.result_cache_ttl_ms) {
+    fixed_buf_sprintf(n, &buffer, "RESULT_CACHE_TTL_MS=%d;", conn->cfg.result_cache_ttl_ms);
+    if (n>0) count += n;
+  }
+
   if (buffer.nr+1 == buffer.cap) {
     char *x = buffer.buf + buffer.nr;
     for (int i=0; i<3 && x>buffer.buf; ++i, --x) x[-1] = '.';
@@ -628,6 +900,26 @@ static int _conn_cfg_init_by_dsn(conn_cfg_t *cfg, char *ebuf, size_t elen)
   r = SQLGetPrivateProfileString((LPCSTR)cfg->dsn, "TIMESTAMP_AS_IS", (LPCSTR)"0", (LPSTR)buf, sizeof(buf), "Odbc.ini");
   if (r == 1) cfg->timestamp_as_is = !!atoi(buf);
 
+  r = 0;
+  buf[0] = '\0';
+  r = SQLGetPrivateProfileString((LPCSTR)cfg->dsn, "WRITE_BEHIND", (LPCSTR)"0", (LPSTR)buf, sizeof(buf), "Odbc.ini");
+  if (r > 0) cfg->write_behind = atoi(buf);
+
+  r = 0;
+  buf[0] = '\0';
+  r = SQLGetPrivateProfileString((LPCSTR)cfg->dsn, "WRITE_BEHIND_MS", (LPCSTR)"0", (LPSTR)buf, sizeof(buf), "Odbc.ini");
+  if (r > 0) cfg->write_behind_ms = atoi(buf);
+
+  r = 0;
+  buf[0] = '\0';
+  r = SQLGetPrivateProfileString((LPCSTR)cfg->dsn, "STATIC_CURSOR_KB", (LPCSTR)"0", (LPSTR)buf, sizeof(buf), "Odbc.ini");
+  if (r > 0) cfg->static_cursor_kb = atoi(buf);
+
+  r = 0;
+  buf[0] = '\0';
+  r = SQLGetPrivateProfileString((LPCSTR)cfg->dsn, "RESULT_CACHE_TTL_MS", (LPCSTR)"0", (LPSTR)buf, sizeof(buf), "Odbc.ini");
+  if (r > 0) cfg->result_cache_ttl_ms = atoi(buf);
+
   buf[0] = '\0';
   r = SQLGetPrivateProfileString((LPCSTR)cfg->dsn, "PWD", (LPCSTR)"", (LPSTR)buf, sizeof(buf), "Odbc.ini");
   if (buf[0]) {
@@ -753,22 +1045,13 @@ SQLRETURN conn_driver_connect(
   return SQL_ERROR;
 }
 
-void conn_disconnect(conn_t *conn)
+SQLRETURN conn_disconnect(conn_t *conn)
 {
-  stmt_t *p, *n;
-  tod_list_for_each_entry_safe(p, n, &conn->stmts, stmt_t, node) {
-    OW("statement [%p] is still associated with connection [%p], but have to be freed by SQLDisconnect, "
-       "and it's application's responsibility not use the statment anymore", p, conn);
-    OA_NIY(p->refc == 1);
-    stmt_unref(p);
-  }
-  conn->nr_stmts = 0;
+  // NOTE: SQL_ERROR leaves the connection open, as ODBC requires, deferred rows are no longer pending anyway
+  if (_conn_flush_deferred(conn) != SQL_SUCCESS) return SQL_ERROR;
 
-  if (conn->taos) {
-    CALL_taos_close(conn->taos);
-    conn->taos = NULL;
-  }
-  conn_cfg_release(&conn->cfg);
+  _conn_disconnect(conn);
+  return SQL_SUCCESS;
 }
 
 static SQLRETURN _conn_commit(conn_t *conn)
@@ -1081,6 +1364,13 @@ SQLRETURN conn_get_info(
       *(SQLUINTEGER*)InfoValuePtr = SQL_ASYNC_NOTIFICATION_NOT_CAPABLE;
       break;
 #endif                       /* } */
+    case SQL_ASYNC_MODE:
+      *(SQLUINTEGER*)InfoValuePtr = SQL_AM_STATEMENT;
+      break;
+    case SQL_MAX_ASYNC_CONCURRENT_STATEMENTS:
+      // NOTE: no limit
+      *(SQLUINTEGER*)InfoValuePtr = 0;
+      break;
     case SQL_DTC_TRANSITION_COST:
       *(SQLUINTEGER*)InfoValuePtr = 0;
       break;
@@ -1109,6 +1399,7 @@ SQLRETURN conn_get_info(
       *(SQLUSMALLINT*)InfoValuePtr = SQL_IC_SENSITIVE;
       break;
     case SQL_MAX_CONCURRENT_ACTIVITIES:
+      // NOTE: no limit, statements of a connection keep result sets of their own alive concurrently
       *(SQLUSMALLINT*)InfoValuePtr = 0;
       break;
     case SQL_BOOKMARK_PERSISTENCE:
@@ -1195,7 +1486,21 @@ SQLRETURN conn_get_info(
       *(SQLINTEGER*)InfoValuePtr = SQL_AT_DROP_COLUMN | SQL_AT_ADD_COLUMN; // FIXME:
       break;
     case SQL_FETCH_DIRECTION:
-      *(SQLINTEGER*)InfoValuePtr = SQL_FD_FETCH_NEXT; // FIXME:
+      *(SQLINTEGER*)InfoValuePtr = SQL_FD_FETCH_NEXT | SQL_FD_FETCH_FIRST | SQL_FD_FETCH_LAST |
+                                   SQL_FD_FETCH_PRIOR | SQL_FD_FETCH_ABSOLUTE | SQL_FD_FETCH_RELATIVE;
+      break;
+    case SQL_SCROLL_OPTIONS:
+      *(SQLUINTEGER*)InfoValuePtr = SQL_SO_FORWARD_ONLY | SQL_SO_STATIC;
+      break;
+    case SQL_FORWARD_ONLY_CURSOR_ATTRIBUTES1:
+      *(SQLUINTEGER*)InfoValuePtr = SQL_CA1_NEXT;
+      break;
+    case SQL_STATIC_CURSOR_ATTRIBUTES1:
+      *(SQLUINTEGER*)InfoValuePtr = SQL_CA1_NEXT | SQL_CA1_ABSOLUTE | SQL_CA1_RELATIVE;
+      break;
+    case SQL_FORWARD_ONLY_CURSOR_ATTRIBUTES2:
+    case SQL_STATIC_CURSOR_ATTRIBUTES2:
+      *(SQLUINTEGER*)InfoValuePtr = SQL_CA2_READ_ONLY_CONCURRENCY;
       break;
     case SQL_LOCK_TYPES:
       *(SQLINTEGER*)InfoValuePtr = SQL_LCK_NO_CHANGE; // FIXME:
@@ -1230,6 +1535,8 @@ SQLRETURN conn_end_tran(
     conn_t       *conn,
     SQLSMALLINT   CompletionType)
 {
+  if (_conn_flush_deferred(conn) != SQL_SUCCESS) return SQL_ERROR;
+
   switch (CompletionType) {
     case SQL_COMMIT:
       return _conn_commit(conn);
@@ -1241,6 +1548,35 @@ SQLRETURN conn_end_tran(
   }
 }
 
+static SQLRETURN _conn_set_async_enable(conn_t *conn, SQLULEN async_enable)
+{
+  if (async_enable != SQL_ASYNC_ENABLE_OFF && async_enable != SQL_ASYNC_ENABLE_ON) {
+    conn_append_err_format(conn, "HY024", 0, "Invalid attribute value:`%zd` for `SQL_ATTR_ASYNC_ENABLE`", (size_t)async_enable);
+    return SQL_ERROR;
+  }
+
+  // NOTE: applies to all statements of the connection, as well as those allocated afterwards
+  SQLRETURN sr = SQL_SUCCESS;
+  stmt_t *p;
+  pthread_mutex_lock(&conn->stmts_mutex);
+  tod_list_for_each_entry(p, &conn->stmts, stmt_t, node) {
+    if (p->async.op != STMT_ASYNC_NONE) {
+      conn_append_err(conn, "HY010", 0, "Function sequence error:an asynchronous function is still executing");
+      sr = SQL_ERROR;
+      break;
+    }
+  }
+  if (sr == SQL_SUCCESS) {
+    tod_list_for_each_entry(p, &conn->stmts, stmt_t, node) {
+      p->async.enable = async_enable;
+    }
+    conn->async_enable = async_enable;
+  }
+  pthread_mutex_unlock(&conn->stmts_mutex);
+
+  return sr;
+}
+
 SQLRETURN conn_set_attr(
     conn_t       *conn,
     SQLINTEGER    Attribute,
@@ -1279,6 +1615,20 @@ SQLRETURN conn_set_attr(
     case SQL_ATTR_ANSI_APP:
       OA_NIY(0);
       break;
+    case SQL_ATTR_TAOS_PERF_RESET: {
+      stmt_t *p;
+      pthread_mutex_lock(&conn->stmts_mutex);
+      memset(&conn->perf, 0, sizeof(conn->perf));
+      tod_list_for_each_entry(p, &conn->stmts, stmt_t, node) {
+        memset(&p->perf, 0, sizeof(p->perf));
+      }
+      pthread_mutex_unlock(&conn->stmts_mutex);
+    } return SQL_SUCCESS;
+    case SQL_ATTR_TAOS_PROFILE_DUMP:
+      profile_dump();
+      return SQL_SUCCESS;
+    case SQL_ATTR_ASYNC_ENABLE:
+      return _conn_set_async_enable(conn, (SQLULEN)(uintptr_t)ValuePtr);
     default:
       conn_append_err_format(conn, "HY000", 0, "General error:`%s[0x%x/%d]` not supported yet", sql_conn_attr(Attribute), Attribute, Attribute);
       return SQL_ERROR;
@@ -1315,6 +1665,30 @@ static SQLRETURN _conn_get_attr_current_qualifier(
   return SQL_SUCCESS;
 }
 
+static SQLRETURN _conn_get_attr_perf(
+    conn_t       *conn,
+    SQLINTEGER    Attribute,
+    SQLPOINTER    Value,
+    SQLINTEGER    BufferLength,
+    SQLINTEGER   *StringLengthPtr)
+{
+  stmt_t *p;
+  pthread_mutex_lock(&conn->stmts_mutex);
+  taos_odbc_perf_t perf = conn->perf;
+  tod_list_for_each_entry(p, &conn->stmts, stmt_t, node) {
+    stmt_perf_add(&perf, &p->perf);
+  }
+  pthread_mutex_unlock(&conn->stmts_mutex);
+
+  if (stmt_perf_get_attr(&perf, Attribute, Value, BufferLength, StringLengthPtr)) {
+    conn_append_err_format(conn, "HY090", 0, "Invalid string or buffer length:`%d` for `SQL_ATTR_TAOS_PERF`, `%zd` required",
+        BufferLength, sizeof(perf));
+    return SQL_ERROR;
+  }
+
+  return SQL_SUCCESS;
+}
+
 SQLRETURN conn_get_attr(
     conn_t       *conn,
     SQLINTEGER    Attribute,
@@ -1325,7 +1699,11 @@ SQLRETURN conn_get_attr(
   switch (Attribute) {
     case SQL_CURRENT_QUALIFIER: /* SQL_ATTR_CURRENT_CATALOG */
       return _conn_get_attr_current_qualifier(conn, Value, BufferLength, StringLengthPtr);
+    case SQL_ATTR_ASYNC_ENABLE:
+      *(SQLULEN*)Value = conn->async_enable;
+      return SQL_SUCCESS;
     default:
+      if (stmt_perf_is_attr(Attribute)) return _conn_get_attr_perf(conn, Attribute, Value, BufferLength, StringLengthPtr);
       conn_append_err_format(conn, "HY000", 0, "General error:`%s[0x%x/%d]` not supported yet", sql_conn_attr(Attribute), Attribute, Attribute);
       return SQL_ERROR;
   }
@@ -0,0 +1,398 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022-2023 freemine <freemine@yeah.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "internal.h"
+
+#include "cursor.h"
+
+#include "log.h"
+#include "taos_helpers.h"
+
+#include <errno.h>
+
+// NOTE: blocks beyond this are written to a temp file, unless STATIC_CURSOR_KB says otherwise
+#define CURSOR_CACHE_DEFAULT_BUDGET          (64 * 1024 * 1024)
+
+#ifdef _WIN32              /* { */
+#define _cursor_fseek(_f, _off)              _fseeki64(_f, (__int64)(_off), SEEK_SET)
+#else                      /* }{ */
+#define _cursor_fseek(_f, _off)              fseeko(_f, (off_t)(_off), SEEK_SET)
+#endif                     /* } */
+
+// layout of a cached block, all sections 8-byte aligned:
+//   uint64_t   sections[nr_fields][3];      // offsets of null-bitmap, var-offsets (0 if fixed-length), and data
+//   per column:
+//     null-bitmap, 1 bit per row
+//     int32_t offsets[nr_rows], -1 for null, only for var-length columns
+//     data, `nr_rows` fixed-length values, or `[int16_t len][bytes]` of each non-null var-length value
+#define SECTION_NULLS         0
+#define SECTION_OFFSETS       1
+#define SECTION_DATA          2
+#define SECTION_NR            3
+
+static size_t _align8(size_t n)
+{
+  return (n + 7) & ~(size_t)7;
+}
+
+static size_t _fixed_bytes(int8_t type)
+{
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+    case TSDB_DATA_TYPE_UTINYINT:
+      return 1;
+    case TSDB_DATA_TYPE_SMALLINT:
+    case TSDB_DATA_TYPE_USMALLINT:
+      return 2;
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_UINT:
+    case TSDB_DATA_TYPE_FLOAT:
+      return 4;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_UBIGINT:
+    case TSDB_DATA_TYPE_DOUBLE:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      return 8;
+    default:
+      // NOTE: not convertible by helper_get_tsdb_value anyway, thus nothing is kept but nulls
+      return 0;
+  }
+}
+
+static int _is_var(int8_t type)
+{
+  return type == TSDB_DATA_TYPE_VARCHAR || type == TSDB_DATA_TYPE_NCHAR;
+}
+
+static void _cursor_cache_unload(cursor_cache_t *cache)
+{
+  cache->loaded = 0;
+  cache->i_block = 0;
+  cache->i_row = 0;
+}
+
+void cursor_cache_reset(cursor_cache_t *cache)
+{
+  if (!cache) return;
+  if (cache->borrowed) {
+    cache->blocks     = NULL;
+    cache->blocks_nr  = 0;
+    cache->blocks_cap = 0;
+    cache->borrowed   = 0;
+  }
+  for (size_t i=0; i<cache->blocks_nr; ++i) {
+    TOD_SAFE_FREE(cache->blocks[i].data);
+  }
+  cache->blocks_nr    = 0;
+  cache->nr_fields    = 0;
+  cache->nr_rows      = 0;
+  cache->limit        = 0;
+  cache->mem_bytes    = 0;
+  cache->spill_bytes  = 0;
+  if (cache->spill) {
+    fclose(cache->spill);
+    cache->spill = NULL;
+  }
+  cache->spill_failed = 0;
+  mem_reset(&cache->spilled);
+  _cursor_cache_unload(cache);
+}
+
+void cursor_cache_release(cursor_cache_t *cache)
+{
+  if (!cache) return;
+  cursor_cache_reset(cache);
+  TOD_SAFE_FREE(cache->blocks);
+  cache->blocks_cap = 0;
+  TOD_SAFE_FREE(cache->cols);
+  TOD_SAFE_FREE(cache->offsets);
+  TOD_SAFE_FREE(cache->nulls);
+  cache->views_cap = 0;
+  mem_release(&cache->spilled);
+}
+
+void cursor_cache_init(cursor_cache_t *cache, size_t mem_budget, size_t limit)
+{
+  cursor_cache_reset(cache);
+  cache->mem_budget = mem_budget ? mem_budget : CURSOR_CACHE_DEFAULT_BUDGET;
+  cache->limit      = limit;
+}
+
+int cursor_cache_is_full(cursor_cache_t *cache)
+{
+  return cache->limit && cache->nr_rows >= cache->limit;
+}
+
+static int _cursor_cache_keep_views(cursor_cache_t *cache, size_t nr_fields)
+{
+  if (nr_fields <= cache->views_cap) return 0;
+
+  size_t cap = (nr_fields + 15) / 16 * 16;
+  void **cols = (void**)realloc(cache->cols, sizeof(*cols) * cap);
+  if (!cols) return -1;
+  cache->cols = cols;
+  int **offsets = (int**)realloc(cache->offsets, sizeof(*offsets) * cap);
+  if (!offsets) return -1;
+  cache->offsets = offsets;
+  unsigned char **nulls = (unsigned char**)realloc(cache->nulls, sizeof(*nulls) * cap);
+  if (!nulls) return -1;
+  cache->nulls = nulls;
+  cache->views_cap = cap;
+
+  return 0;
+}
+
+static int _cursor_cache_keep_blocks(cursor_cache_t *cache)
+{
+  if (cache->blocks_nr < cache->blocks_cap) return 0;
+
+  size_t cap = cache->blocks_cap + 64;
+  cursor_block_t *blocks = (cursor_block_t*)realloc(cache->blocks, sizeof(*blocks) * cap);
+  if (!blocks) return -1;
+  cache->blocks     = blocks;
+  cache->blocks_cap = cap;
+
+  return 0;
+}
+
+int cursor_cache_borrow(cursor_cache_t *cache, const cursor_cache_t *src, size_t limit)
+{
+  cursor_cache_reset(cache);
+  if (_cursor_cache_keep_views(cache, src->nr_fields)) return -1;
+  TOD_SAFE_FREE(cache->blocks);
+
+  cache->blocks     = src->blocks;
+  cache->blocks_nr  = src->blocks_nr;
+  cache->blocks_cap = 0;
+  cache->nr_fields  = src->nr_fields;
+  cache->nr_rows    = src->nr_rows;
+  cache->limit      = limit;
+  cache->borrowed   = 1;
+  if (limit && cache->nr_rows > limit) cache->nr_rows = limit;
+
+  return 0;
+}
+
+static size_t _cursor_block_bytes(TAOS_ROW rows, const TAOS_FIELD *fields, size_t nr_fields,
+    int * const *offsets, size_t nr_rows)
+{
+  size_t bytes = _align8(sizeof(uint64_t) * SECTION_NR * nr_fields);
+
+  for (size_t i_col=0; i_col<nr_fields; ++i_col) {
+    bytes += _align8((nr_rows + 7) / 8);
+    if (!_is_var(fields[i_col].type)) {
+      bytes += _align8(_fixed_bytes(fields[i_col].type) * nr_rows);
+      continue;
+    }
+    bytes += _align8(sizeof(int32_t) * nr_rows);
+    size_t payload = 0;
+    for (size_t i_row=0; i_row<nr_rows; ++i_row) {
+      int off = offsets[i_col][i_row];
+      if (off < 0) continue;
+      payload += sizeof(int16_t) + *(int16_t*)((char*)rows[i_col] + off);
+    }
+    bytes += _align8(payload);
+  }
+
+  return bytes;
+}
+
+static void _cursor_block_fill(unsigned char *base, TAOS_RES *res, TAOS_ROW rows, const TAOS_FIELD *fields, size_t nr_fields,
+    int * const *offsets, size_t nr_rows)
+{
+  uint64_t *sections = (uint64_t*)base;
+  size_t pos = _align8(sizeof(uint64_t) * SECTION_NR * nr_fields);
+
+  for (size_t i_col=0; i_col<nr_fields; ++i_col) {
+    uint64_t *section = sections + i_col * SECTION_NR;
+    int8_t type = fields[i_col].type;
+
+    unsigned char *nulls = base + pos;
+    section[SECTION_NULLS] = pos;
+    memset(nulls, 0, (nr_rows + 7) / 8);
+    pos += _align8((nr_rows + 7) / 8);
+
+    if (!_is_var(type)) {
+      size_t bytes = _fixed_bytes(type);
+      section[SECTION_OFFSETS] = 0;
+      section[SECTION_DATA]    = pos;
+      for (size_t i_row=0; i_row<nr_rows; ++i_row) {
+        if (CALL_taos_is_null(res, (int)i_row, (int)i_col)) nulls[i_row / 8] |= (unsigned char)(1 << (i_row % 8));
+      }
+      if (bytes) memcpy(base + pos, rows[i_col], bytes * nr_rows);
+      pos += _align8(bytes * nr_rows);
+      continue;
+    }
+
+    int32_t *dst_offsets = (int32_t*)(base + pos);
+    section[SECTION_OFFSETS] = pos;
+    pos += _align8(sizeof(int32_t) * nr_rows);
+
+    char *data = (char*)(base + pos);
+    section[SECTION_DATA] = pos;
+    int32_t n = 0;
+    for (size_t i_row=0; i_row<nr_rows; ++i_row) {
+      int off = offsets[i_col][i_row];
+      if (off < 0) {
+        nulls[i_row / 8] |= (unsigned char)(1 << (i_row % 8));
+        dst_offsets[i_row] = -1;
+        continue;
+      }
+      const char *src = (const char*)rows[i_col] + off;
+      size_t len = sizeof(int16_t) + *(int16_t*)src;
+      memcpy(data + n, src, len);
+      dst_offsets[i_row] = n;
+      n += (int32_t)len;
+    }
+    pos += _align8((size_t)n);
+  }
+}
+
+static int _cursor_cache_spill(cursor_cache_t *cache, cursor_block_t *block)
+{
+  if (cache->spill_failed) return -1;
+  if (!cache->spill) {
+    cache->spill = tmpfile();
+    if (!cache->spill) {
+      OW("static cursor cache:failed to create temp file to spill into:[%d]%s, keeping in memory instead", errno, strerror(errno));
+      cache->spill_failed = 1;
+      return -1;
+    }
+  }
+
+  if (_cursor_fseek(cache->spill, cache->spill_bytes) ||
+      fwrite(block->data, 1, block->bytes, cache->spill) != block->bytes)
+  {
+    OW("static cursor cache:failed to spill [%zd] bytes:[%d]%s, keeping in memory instead", block->bytes, errno, strerror(errno));
+    cache->spill_failed = 1;
+    return -1;
+  }
+
+  block->spill_off = cache->spill_bytes;
+  cache->spill_bytes += (int64_t)block->bytes;
+  TOD_SAFE_FREE(block->data);
+
+  return 0;
+}
+
+int cursor_cache_append(cursor_cache_t *cache, TAOS_RES *res, const TAOS_FIELD *fields, size_t nr_fields,
+    TAOS_ROW rows, int * const *offsets, size_t nr_rows)
+{
+  if (cache->limit && cache->nr_rows + nr_rows > cache->limit) nr_rows = cache->limit - cache->nr_rows;
+  if (nr_rows == 0) return 0;
+
+  if (cache->blocks_nr == 0) cache->nr_fields = nr_fields;
+  if (_cursor_cache_keep_blocks(cache)) return -1;
+  if (_cursor_cache_keep_views(cache, nr_fields)) return -1;
+
+  cursor_block_t *block = cache->blocks + cache->blocks_nr;
+  block->first_row = cache->nr_rows;
+  block->nr_rows   = nr_rows;
+  block->bytes     = _cursor_block_bytes(rows, fields, nr_fields, offsets, nr_rows);
+  block->spill_off = -1;
+  block->data      = (unsigned char*)malloc(block->bytes);
+  if (!block->data) return -1;
+
+  _cursor_block_fill(block->data, res, rows, fields, nr_fields, offsets, nr_rows);
+
+  int spilled = cache->mem_bytes + block->bytes > cache->mem_budget && _cursor_cache_spill(cache, block) == 0;
+  if (!spilled) cache->mem_bytes += block->bytes;
+
+  ++cache->blocks_nr;
+  cache->nr_rows += nr_rows;
+
+  return (int)nr_rows;
+}
+
+static int _cursor_cache_load(cursor_cache_t *cache, size_t i_block)
+{
+  cursor_block_t *block = cache->blocks + i_block;
+  unsigned char *base = block->data;
+
+  if (!base) {
+    mem_reset(&cache->spilled);
+    if (mem_keep(&cache->spilled, block->bytes)) return -1;
+    base = cache->spilled.base;
+    if (_cursor_fseek(cache->spill, block->spill_off) ||
+        fread(base, 1, block->bytes, cache->spill) != block->bytes)
+    {
+      OE("static cursor cache:failed to read back [%zd] bytes at [%" PRId64 "]:[%d]%s", block->bytes, block->spill_off, errno, strerror(errno));
+      return -1;
+    }
+  }
+
+  const uint64_t *sections = (const uint64_t*)base;
+  for (size_t i_col=0; i_col<cache->nr_fields; ++i_col) {
+    const uint64_t *section = sections + i_col * SECTION_NR;
+    cache->nulls[i_col]   = base + section[SECTION_NULLS];
+    cache->offsets[i_col] = section[SECTION_OFFSETS] ? (int*)(base + section[SECTION_OFFSETS]) : NULL;
+    cache->cols[i_col]    = base + section[SECTION_DATA];
+  }
+
+  cache->i_block = i_block;
+  cache->loaded  = 1;
+
+  return 0;
+}
+
+int cursor_cache_seek(cursor_cache_t *cache, size_t i_row)
+{
+  if (i_row >= cache->nr_rows) return -1;
+
+  size_t i_block = cache->i_block;
+  cursor_block_t *block = cache->blocks + i_block;
+  if (!cache->loaded || i_row < block->first_row || i_row >= block->first_row + block->nr_rows) {
+    size_t lo = 0, hi = cache->blocks_nr;
+    while (hi - lo > 1) {
+      size_t mid = lo + (hi - lo) / 2;
+      if (cache->blocks[mid].first_row <= i_row) lo = mid;
+      else                                       hi = mid;
+    }
+    i_block = lo;
+    block = cache->blocks + i_block;
+    if (_cursor_cache_load(cache, i_block)) {
+      _cursor_cache_unload(cache);
+      return -1;
+    }
+  }
+
+  cache->i_row = i_row - block->first_row;
+
+  return 0;
+}
+
+int cursor_cache_get_data(cursor_cache_t *cache, TAOS_FIELD *fields, int time_precision, int i_col,
+    tsdb_data_t *tsdb, char *buf, size_t len)
+{
+  size_t i_row = cache->i_row;
+
+  if (cache->nulls[i_col][i_row / 8] & (1 << (i_row % 8))) {
+    tsdb->is_null = 1;
+    return 0;
+  }
+
+  return helper_get_tsdb_value(cache->offsets, fields, time_precision, (TAOS_ROW)cache->cols, (int)i_row, i_col, tsdb, buf, len);
+}
+
@@ -27,7 +27,9 @@
 #include "env.h"
 #include "conn.h"
 #include "errs.h"
+#include "fetch_pool.h"
 #include "log.h"
+#include "result_cache.h"
 #include "taos_helpers.h"
 
 static unsigned int         _taos_init_failed      = 0;
@@ -68,6 +70,17 @@ static int _env_init(env_t *env)
 
   if (_taos_init_failed) return -1;
 
+  env->result_cache = result_cache_create();
+  if (!env->result_cache) return -1;
+
+  // NOTE: optional, SQLFetch keeps converting rowsets on the calling thread alone if unset or failed to start
+  const char *s = tod_getenv("TAOS_ODBC_FETCH_THREADS");
+  int nr_threads = s ? atoi(s) : 0;
+  if (nr_threads > 0) {
+    env->fetch_pool = fetch_pool_create((size_t)nr_threads);
+    if (!env->fetch_pool) OW("TAOS_ODBC_FETCH_THREADS:[%s], failed to start the fetch pool", s);
+  }
+
   env->refc = 1;
 
   return 0;
@@ -89,6 +102,10 @@ static void _env_release(env_t *env)
   OA_ILE(conns == 0);
   errs_release(&env->errs);
   mem_release(&env->mem);
+  result_cache_destroy(env->result_cache);
+  env->result_cache = NULL;
+  fetch_pool_destroy(env->fetch_pool);
+  env->fetch_pool = NULL;
 }
 
 env_t* env_create(void)
@@ -108,6 +108,36 @@ void errs_release_x(errs_t *errs)
   errs->connected_conn = NULL;
 }
 
+err_t* errs_last(errs_t *errs)
+{
+  if (tod_list_empty(&errs->errs)) return NULL;
+  return tod_list_entry(errs->errs.prev, err_t, node);
+}
+
+err_t* errs_next(errs_t *errs, err_t *prev)
+{
+  struct tod_list_head *p = prev ? prev->node.next : errs->errs.next;
+  if (p == &errs->errs) return NULL;
+  return tod_list_entry(p, err_t, node);
+}
+
+void errs_move(errs_t *dst, errs_t *src, err_t *first, size_t n)
+{
+  err_t *p = first;
+  for (size_t i=0; i<n && p; ++i) {
+    err_t *next = errs_next(src, p);
+    tod_list_del(&p->node);
+    src->count -= 1;
+    if (dst) {
+      tod_list_add_tail(&p->node, &dst->errs);
+      dst->count += 1;
+    } else {
+      tod_list_add_tail(&p->node, &src->frees);
+    }
+    p = next;
+  }
+}
+
 SQLRETURN errs_get_diag_rec_x(
     errs_t         *errs,
     SQLSMALLINT     RecNumber,
@@ -0,0 +1,162 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022-2023 freemine <freemine@yeah.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "internal.h"
+
+#include "fetch_pool.h"
+
+#include "log.h"
+
+// claim the next task of the first pending job, with `pool->mutex` held
+static fetch_job_t* _fetch_pool_claim(fetch_pool_t *pool, size_t *i)
+{
+  fetch_job_t *job = NULL;
+  tod_list_first_entry_or_null(job, &pool->jobs, fetch_job_t, node);
+  if (!job) return NULL;
+
+  *i = job->next++;
+  if (job->next == job->nr) tod_list_del(&job->node);
+
+  return job;
+}
+
+// run task `i` of `job` with `pool->mutex` released
+static void _fetch_pool_exec(fetch_pool_t *pool, fetch_job_t *job, size_t i)
+{
+  pthread_mutex_unlock(&pool->mutex);
+  job->run(job->arg, i);
+  pthread_mutex_lock(&pool->mutex);
+
+  if (++job->done == job->nr) pthread_cond_broadcast(&pool->done);
+}
+
+static void* _fetch_pool_routine(void *arg)
+{
+  fetch_pool_t *pool = (fetch_pool_t*)arg;
+
+  pthread_mutex_lock(&pool->mutex);
+  while (1) {
+    while (!pool->stop && tod_list_empty(&pool->jobs)) pthread_cond_wait(&pool->cond, &pool->mutex);
+    if (pool->stop) break;
+
+    size_t i = 0;
+    fetch_job_t *job = _fetch_pool_claim(pool, &i);
+    _fetch_pool_exec(pool, job, i);
+  }
+  pthread_mutex_unlock(&pool->mutex);
+
+  return NULL;
+}
+
+fetch_pool_t* fetch_pool_create(size_t nr_threads)
+{
+  if (nr_threads == 0) return NULL;
+  if (nr_threads > FETCH_POOL_MAX_THREADS) nr_threads = FETCH_POOL_MAX_THREADS;
+
+  fetch_pool_t *pool = (fetch_pool_t*)calloc(1, sizeof(*pool));
+  if (!pool) return NULL;
+
+  pool->threads = (pthread_t*)calloc(nr_threads, sizeof(*pool->threads));
+  if (!pool->threads) {
+    free(pool);
+    return NULL;
+  }
+
+  pthread_mutex_init(&pool->mutex, NULL);
+  pthread_cond_init(&pool->cond, NULL);
+  pthread_cond_init(&pool->done, NULL);
+  INIT_TOD_LIST_HEAD(&pool->jobs);
+
+  for (size_t i=0; i<nr_threads; ++i) {
+    if (pthread_create(&pool->threads[i], NULL, _fetch_pool_routine, pool)) {
+      OE("failed to start fetch worker #%zd of %zd", i+1, nr_threads);
+      break;
+    }
+    pool->nr_threads += 1;
+  }
+
+  if (pool->nr_threads == 0) {
+    fetch_pool_destroy(pool);
+    return NULL;
+  }
+
+  return pool;
+}
+
+void fetch_pool_destroy(fetch_pool_t *pool)
+{
+  if (!pool) return;
+
+  pthread_mutex_lock(&pool->mutex);
+  OA_ILE(tod_list_empty(&pool->jobs));
+  pool->stop = 1;
+  pthread_cond_broadcast(&pool->cond);
+  pthread_mutex_unlock(&pool->mutex);
+
+  for (size_t i=0; i<pool->nr_threads; ++i) {
+    pthread_join(pool->threads[i], NULL);
+  }
+
+  pthread_cond_destroy(&pool->done);
+  pthread_cond_destroy(&pool->cond);
+  pthread_mutex_destroy(&pool->mutex);
+
+  TOD_SAFE_FREE(pool->threads);
+  free(pool);
+}
+
+size_t fetch_pool_threads(fetch_pool_t *pool)
+{
+  return pool ? pool->nr_threads : 0;
+}
+
+void fetch_pool_run(fetch_pool_t *pool, void (*run)(void *arg, size_t i), void *arg, size_t nr)
+{
+  if (nr == 0) return;
+
+  if (!pool || nr == 1) {
+    for (size_t i=0; i<nr; ++i) run(arg, i);
+    return;
+  }
+
+  fetch_job_t job = {0};
+  job.run = run;
+  job.arg = arg;
+  job.nr  = nr;
+
+  pthread_mutex_lock(&pool->mutex);
+  tod_list_add_tail(&job.node, &pool->jobs);
+  pthread_cond_broadcast(&pool->cond);
+
+  // NOTE: the caller lends a hand rather than idling, which also keeps a job progressing when every worker is busy
+  while (job.next < job.nr) {
+    size_t i = job.next++;
+    if (job.next == job.nr) tod_list_del(&job.node);
+    _fetch_pool_exec(pool, &job, i);
+  }
+
+  while (job.done < job.nr) pthread_cond_wait(&pool->done, &pool->mutex);
+  pthread_mutex_unlock(&pool->mutex);
+}
+
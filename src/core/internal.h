@@ -34,9 +34,12 @@
 #include "typedefs.h"
 
 #include "taos_helpers.h"
+#include "taos_odbc_ext.h"
 
 #include <taos.h>
 
+#include <stdio.h>
+
 EXTERN_C_BEGIN
 
 // <TDengine/ include/util/tdef.h
@@ -209,6 +212,9 @@ struct env_s {
 
   mem_t               mem;
 
+  result_cache_t     *result_cache;
+  fetch_pool_t       *fetch_pool;         // NULL unless TAOS_ODBC_FETCH_THREADS is set
+
   unsigned int        debug_flex:1;
   unsigned int        debug_bison:1;
 };
@@ -362,6 +368,18 @@ struct conn_cfg_s {
   // NOTE: this is to hack PowerBI, which seems not displace seconds-fractional,
   //       thus, if timestamp_as_is is not set, TSDB_DATA_TYPE_TIMESTAMP would map to SQL_WVARCHAR
   unsigned int           timestamp_as_is:1;
+
+  // NOTE: write-behind for parameterized insert-statement, 0 to disable
+  //       rows are buffered in taos_stmt, and executed once `write_behind` rows reached
+  //       or `write_behind_ms` milliseconds (0 for no limit) elapsed since the first buffered row
+  int                    write_behind;
+  int                    write_behind_ms;
+
+  // NOTE: memory budget in KB of static cursor cache before spilling into a temp file, 0 for the default
+  int                    static_cursor_kb;
+
+  // NOTE: time-to-live in milliseconds of result sets kept in the environment-wide result cache, 0 to disable
+  int                    result_cache_ttl_ms;
 };
 
 struct parser_nterm_s {
@@ -381,6 +399,15 @@ struct sqls_s {
   uint8_t                failed:1;
 };
 
+struct coalesced_inserts_s {
+  mem_t                  tsdb_sql;     // merged multi-table insert, in tsdb charset
+  int64_t               *rows;         // value-tuples of each merged statement
+  size_t                 cap;
+  size_t                 nr;
+
+  size_t                 pos;          // next merged statement to report
+};
+
 struct parser_token_s {
   const char      *text;
   size_t           leng;
@@ -394,6 +421,12 @@ struct topic_cfg_s {
   kvs_t                  kvs;
 };
 
+struct schemaless_cfg_s {
+  char                  *protocol;
+
+  kvs_t                  kvs;
+};
+
 struct parser_ctx_s {
   int                    row0, col0;
   int                    row1, col1;
@@ -417,6 +450,9 @@ struct conn_parser_param_s {
 
 struct ext_parser_param_s {
   topic_cfg_t            topic_cfg;
+  schemaless_cfg_t       schemaless_cfg;
+
+  unsigned int           is_schemaless:1;
 
   parser_ctx_t           ctx;
 };
@@ -436,11 +472,40 @@ struct charset_convs_s {
   charset_conv_t            *cnv_from_wchar_to_tsdb;
 };
 
+struct conn_timer_entry_s {
+  stmt_t             *stmt;
+  int64_t             deadline;       // in microseconds, tod_now_us
+};
+
+struct conn_timer_s {
+  pthread_mutex_t          mutex;
+  pthread_cond_t           cond;
+  pthread_t                thread;
+
+  conn_timer_entry_t      *entries;
+  size_t                   cap;
+  size_t                   nr;
+
+  unsigned int             started:1;
+  unsigned int             stop:1;
+};
+
+// idle internal connections, for SQL_ATTR_TAOS_PARALLEL_SCAN
+struct conn_pool_s {
+  pthread_mutex_t          mutex;
+  TAOS                   **idle;
+  size_t                   cap;
+  size_t                   nr;
+};
+
 struct conn_s {
   atomic_int          refc;
   atomic_int          descs;
   atomic_int          outstandings;
 
+  // NOTE: statements run concurrently, each with a TAOS_RES and fetch state of its own, on the shared `taos`
+  //       `stmts_mutex` guards `stmts`, `nr_stmts` and `perf`, which are touched when allocating/freeing statements
+  pthread_mutex_t          stmts_mutex;
   size_t                   nr_stmts;
   struct tod_list_head     stmts;
 
@@ -479,6 +544,22 @@ struct conn_s {
 #endif                  /* } */
   int32_t             txn_isolation;
 
+  // counters of statements already freed, live ones are summed on demand
+  taos_odbc_perf_t    perf;
+
+  // enforces SQL_ATTR_QUERY_TIMEOUT for statements of this connection
+  conn_timer_t        timer;
+
+  // statements with a cancelable call in progress or an asynchronous function pending, guarded by `busy_mutex`
+  // NOTE: taos_kill_query interrupts every query on `taos`, thus is issued only for the one and only busy statement
+  pthread_mutex_t     busy_mutex;
+  size_t              nr_busy;
+
+  conn_pool_t         pool;
+
+  // SQL_ATTR_ASYNC_ENABLE, inherited by statements allocated afterwards
+  SQLULEN             async_enable;
+
   unsigned int        fmt_time:1;
 };
 
@@ -491,6 +572,38 @@ struct stmt_get_data_args_s {
   SQLLEN        *IndPtr;
 };
 
+// TAOS_ODBC_FETCH_THREADS: a bound column of a row, captured on the calling thread, then converted by a lane
+struct stmt_fetch_cell_s {
+  tsdb_data_t                tsdb;            // borrowed from the current block of taosc
+  SQLRETURN                  sr;
+  stmt_t                    *lane;            // whose `errs` hold the diagnostics of this cell, if any
+  err_t                     *first_err;
+  size_t                     nr_errs;
+  unsigned int               pending:1;       // yet to be converted
+};
+
+// rows [from, to) of the k-th bound column, converted by a single lane
+struct stmt_fetch_unit_s {
+  size_t                     k;
+  size_t                     from;
+  size_t                     to;
+};
+
+// TAOS_ODBC_FETCH_THREADS: rowset converted in parallel, kept across SQLFetch calls
+struct stmt_fetch_s {
+  // NOTE: private stand-ins of the statement, one per thread of the pool plus the calling one,
+  //       conversion touches nothing of a statement but `conn`, `errs`, `get_data_ctx` and `perf`
+  stmt_t                    *lanes;
+  size_t                     nr_lanes;
+
+  mem_t                      cols;            // size_t, 0-based indices of bound columns
+  size_t                     nr_cols;
+  mem_t                      cells;           // stmt_fetch_cell_t, [i_row * nr_cols + k]
+  mem_t                      units;           // stmt_fetch_unit_t
+  size_t                     nr_units;
+  size_t                     nr_tasks;
+};
+
 struct stmt_base_s {
   SQLRETURN (*prepare)(stmt_base_t *base, const sqlc_tsdb_t *sqlc_tsdb);
   SQLRETURN (*execute)(stmt_base_t *base);
@@ -519,8 +632,177 @@ struct tsdb_rows_block_s {
   TAOS_ROW            rows;
   size_t              nr;
   size_t              pos;           // 1-based
+
+  // taos_get_column_data_offset of var-length columns, cached per block
+  int               **offsets;
+  size_t              offsets_cap;
+};
+
+struct cursor_block_s {
+  size_t                     first_row;       // 0-based, within the result set
+  size_t                     nr_rows;
+  size_t                     bytes;
+  unsigned char             *data;            // NULL if spilled
+  int64_t                    spill_off;       // offset within the spill file, -1 if in memory
+};
+
+// static cursor: taosc blocks copied in columnar layout, spilled to a temp file past `mem_budget`
+struct cursor_cache_s {
+  cursor_block_t            *blocks;
+  size_t                     blocks_nr;
+  size_t                     blocks_cap;
+
+  size_t                     nr_fields;
+  size_t                     nr_rows;
+  size_t                     limit;           // SQL_ATTR_MAX_ROWS, 0 for no limit
+
+  size_t                     mem_bytes;
+  size_t                     mem_budget;
+  FILE                      *spill;
+  int64_t                    spill_bytes;
+
+  // block loaded for reading, and the row therein
+  size_t                     i_block;
+  size_t                     i_row;
+  mem_t                      spilled;
+  void                     **cols;
+  int                      **offsets;
+  unsigned char            **nulls;
+  size_t                     views_cap;
+
+  unsigned int               loaded:1;
+  unsigned int               spill_failed:1;
+  unsigned int               borrowed:1;      // `blocks` belong to a result cache entry
+};
+
+struct result_cache_entry_s {
+  struct tod_list_head       node;            // within result_cache_s::lru
+  atomic_int                 refc;
+
+  // scope `ip:port|uid|db`, normalized sql-statement and serialized parameter values, each null-terminated
+  char                      *key;
+  size_t                     key_len;
+  uint64_t                   hash;
+  const char                *sql;             // within `key`
+
+  int64_t                    expire_us;
+  size_t                     bytes;
+
+  TAOS_FIELD                *fields;
+  size_t                     nr_fields;
+  int                        time_precision;
+  cursor_cache_t             blocks;          // never spilled
+};
+
+// environment-wide LRU of result sets, bounded by `budget` bytes
+struct result_cache_s {
+  pthread_mutex_t            mutex;
+  struct tod_list_head       lru;             // most recently used first
+  size_t                     bytes;
+  size_t                     budget;
+  atomic_int                 entries;         // also read without `mutex`, to skip invalidation quickly
+};
+
+// TAOS_ODBC_FETCH_THREADS: workers shared by every statement of the env, to convert large rowsets in parallel
+struct fetch_pool_s {
+  pthread_mutex_t            mutex;
+  pthread_cond_t             cond;            // jobs pending or `stop`
+  pthread_cond_t             done;            // a job finished
+
+  pthread_t                 *threads;
+  size_t                     nr_threads;
+
+  struct tod_list_head       jobs;            // FIFO
+
+  unsigned int               stop:1;
+};
+
+struct fetch_job_s {
+  struct tod_list_head       node;            // in `pool->jobs` until every task is claimed
+
+  void                     (*run)(void *arg, size_t i);
+  void                      *arg;
+
+  size_t                     nr;
+  size_t                     next;            // next task to claim
+  size_t                     done;            // tasks returned
+};
+
+// one sub-range query of a parallel scan, run by a thread of its own on a pooled connection
+struct tsdb_scan_lane_s {
+  tsdb_scan_t               *scan;
+  pthread_t                  thread;
+  char                      *sql;
+  TAOS_RES                  *res;
+
+  // each holds a single taosc block, ready ones are [head, head + ready)
+  cursor_cache_t             slots[2];
+  size_t                     head;
+  size_t                     ready;
+
+  int                        code;
+  char                       errmsg[256];
+
+  unsigned int               started:1;
+  unsigned int               queried:1;       // taos_query succeeded, fields are known
+  unsigned int               done:1;
+};
+
+// SQL_ATTR_TAOS_PARALLEL_SCAN: time range split into lanes, whose blocks are consumed lane by lane
+struct tsdb_scan_s {
+  conn_t                    *conn;
+  char                       db[256];         // current database of `conn` when the scan starts
+
+  pthread_mutex_t            mutex;
+  pthread_cond_t             cond;
+
+  tsdb_scan_lane_t          *lanes;
+  size_t                     nr_lanes;
+  size_t                     i_lane;
+
+  TAOS_FIELD                *fields;          // copied from the result of the first lane
+  size_t                     nr_fields;
+  int                        time_precision;
+
+  unsigned int               stop:1;
 };
 
+// SQL_ATTR_TAOS_ARROW_STREAM: private data of the stream, which owns `res`
+struct tsdb_arrow_s {
+  TAOS_RES                  *res;
+  TAOS_FIELD                *fields;
+  size_t                     nr_fields;
+  int                        time_precision;
+
+  // the batch with columns exported zero-copy from the current block of `res`, which taos_fetch_block overwrites
+  tsdb_arrow_batch_t        *borrowing;
+
+  char                       errmsg[1024];
+};
+
+// private data of a struct array, alive until the array and all its children are released
+struct tsdb_arrow_batch_s {
+  tsdb_arrow_t              *arrow;           // NULL once detached from the stream
+  size_t                     refc;            // the struct array, and each child still alive
+  const void                *buffers[1];
+  struct ArrowArray        **children;
+  tsdb_arrow_col_t         **cols;            // NULL once the child is released, so is `children[i]`
+  size_t                     nr_cols;
+};
+
+// private data of a child array
+struct tsdb_arrow_col_s {
+  struct ArrowArray          array;
+  tsdb_arrow_batch_t        *batch;
+  const void                *buffers[3];
+  size_t                     width;           // bytes per value, if the values are borrowed from the taos block
+  void                      *owned;           // validity bitmap, as well as values re-packed, if any
+  void                      *detached;        // copy of borrowed values, taken before the taos block is overwritten
+};
+
+// affected rows not known, SQLRowCount reports -1
+#define TSDB_ROW_COUNT_UNKNOWN ((size_t)-1)
+
 struct tsdb_res_s {
   TAOS_RES                  *res;
   size_t                     affected_row_count;
@@ -528,7 +810,22 @@ struct tsdb_res_s {
   tsdb_fields_t              fields;
   tsdb_rows_block_t          rows_block;
 
+  // SQL_CURSOR_STATIC: every block fetched is kept in `cache`, and rows are read from there
+  cursor_cache_t             cache;
+  size_t                     cache_pos;       // 1-based, 0 for before the first row
+
+  // RESULT_CACHE_TTL_MS: `hit` is where rows are borrowed from, or blocks are recorded under `rc_key` to publish at eof
+  result_cache_entry_t      *hit;
+  cursor_cache_t             record;
+  mem_t                      rc_key;
+
+  // SQL_ATTR_TAOS_PARALLEL_SCAN: blocks are taken from `scan` into `cache` one at a time
+  tsdb_scan_t               *scan;
+
   unsigned int               res_is_from_taos_query:1;
+  unsigned int               eof:1;           // taos_fetch_rows_a reported no more rows
+  unsigned int               cached:1;
+  unsigned int               recording:1;
 };
 
 struct tsdb_params_s {
@@ -561,11 +858,55 @@ struct tsdb_stmt_s {
 
   tsdb_res_t                 res;
 
+  // write-behind: rows already added into `stmt` but not executed yet
+  size_t                     deferred_rows;
+  size_t                     deferred_bytes;
+  int64_t                    deferred_since;   // in milliseconds
+
   unsigned int               prepared:1;
-  unsigned int               is_topic:1;
+  unsigned int               is_ext:1;
   unsigned int               is_insert_stmt:1;
 };
 
+struct topic_consumer_s {
+  topic_t                   *topic;
+  tmq_t                     *tmq;
+
+  TAOS_RES                 **done;                 // used up by app, handed over to poller to commit
+  size_t                     done_cap;
+  size_t                     done_nr;
+  TAOS_RES                 **held;                 // owned by poller, waiting for next commit
+  size_t                     held_cap;
+  size_t                     held_nr;
+  int64_t                    committed_at;         // in milliseconds
+
+  // adaptive poll timeout, between taos_odbc.poll.min_ms and taos_odbc.poll.max_ms
+  int32_t                    poll_timeout_ms;
+  // poll stats, guarded by topic->mutex, folded into owner's perf once closed
+  int64_t                    polls;
+  int64_t                    polls_empty;
+  int64_t                    poll_us_total;        // time spent within tmq_consumer_poll
+  int64_t                    poll_us_data;         // of which, spent before a res arrived
+
+  pthread_t                  poller;
+
+  uint8_t                    subscribed:1;
+};
+
+enum topic_commit_mode_e {
+  TOPIC_COMMIT_SYNC,                   // tmq_commit_sync once a res is used up
+  TOPIC_COMMIT_ASYNC,                  // tmq_commit_async, final tmq_commit_sync on close
+  TOPIC_COMMIT_INTERVAL,               // tmq_commit_sync every N res or T ms, final one on close
+};
+
+// outcome of commits, shared with tmq_commit_async callbacks which might come after the topic is gone, thus refcounted
+struct topic_commit_ctx_s {
+  atomic_int                 refc;
+  atomic_int                 pending;              // tmq_commit_async not yet called back
+  atomic_int                 failures;             // failed tmq_commit_async or background tmq_commit_sync
+  atomic_int                 code;                 // of the last failure
+};
+
 struct topic_s {
   stmt_base_t                base;
   stmt_t                    *owner;
@@ -577,24 +918,71 @@ struct topic_s {
   int64_t                    seconds_max;
 
   int64_t                    records_count;
-  time_t                     t0;
+  int64_t                    t0;                   // in milliseconds
+
+  int32_t                    poll_min_ms;
+  int32_t                    poll_max_ms;
 
   tmq_conf_t                *conf;
-  tmq_t                     *tmq;
+  topic_consumer_t          *consumers;           // taos_odbc.consumers, all within the same group.id
+  size_t                     consumers_cap;
+  size_t                     consumers_nr;
 
   TAOS_RES                  *res;
+  topic_consumer_t          *res_from;
   mem_t                      res_topic_name;
   mem_t                      res_db_name;
   int32_t                    res_vgroup_id;
+  int64_t                    res_offset;
+  int64_t                    res_committed;        // valid only if res_committed_fetched
 
   TAOS_FIELD                *fields;
   size_t                     fields_cap;
   size_t                     fields_nr;
 
-  TAOS_ROW                   row;
+  int                        res_precision;
+  tsdb_rows_block_t          rows_block;
+  size_t                     rows_in_fetch;        // rows delivered within current SQLFetch
+
+  // taos_odbc.commit.mode/taos_odbc.commit.every
+  topic_commit_mode_t        commit_mode;
+  int64_t                    commit_every;         // # of res between commits
+  int64_t                    commit_every_ms;      // or, ms between commits
+  int64_t                    uncommitted;          // # of res used up but not committed yet
+  int64_t                    committed_at;         // in milliseconds
+  topic_commit_ctx_t        *commit_ctx;
+
+  // taos_odbc.prefetch: res polled by a background poller, ready to be used up by the app thread
+  size_t                     prefetch;             // capacity of `ready`, 0 to poll inline
+  TAOS_RES                 **ready;
+  topic_consumer_t         **ready_from;
+  int64_t                   *ready_committed;      // fetched by the poller, which owns tmq of `ready_from`
+  size_t                     ready_head;
+  size_t                     ready_nr;
+  pthread_mutex_t            mutex;
+  pthread_cond_t             cond;
+  int                        poller_running;
+  int                        poller_stop;
 
-  uint8_t                    subscribed:1;
   uint8_t                    do_not_commit:1;
+  uint8_t                    res_committed_fetched:1;
+};
+
+struct schemaless_s {
+  stmt_base_t                base;
+  stmt_t                    *owner;
+
+  schemaless_cfg_t           cfg;
+
+  int                        protocol;             // TSDB_SML_PROTOCOL_TYPE
+  int                        precision;            // TSDB_SML_TIMESTAMP_TYPE
+
+  buffer_t                   lines;
+  mem_t                      payload;              // intermediate for charset conversion
+
+  int64_t                    total_rows;
+
+  uint8_t                    opened:1;
 };
 
 struct tables_args_s {
@@ -823,6 +1211,34 @@ struct param_bind_map_s {
   param_f        conv;      // conv sqlc to tsdb
 };
 
+enum stmt_async_op_e {
+  STMT_ASYNC_NONE,
+  STMT_ASYNC_QUERY,                    // taos_query_a in flight, for SQLExecDirect/SQLExecute/SQLMoreResults
+  STMT_ASYNC_FETCH,                    // taos_fetch_rows_a in flight, for SQLFetch/SQLFetchScroll
+};
+
+
+// NOTE: polling mode only, since notification mode (SQL_ATTR_ASYNC_STMT_PCALLBACK etc.) requires ODBC 3.8,
+//       whereas the driver is built as ODBC 3.51
+struct stmt_async_s {
+  SQLULEN                    enable;          // SQL_ATTR_ASYNC_ENABLE
+
+  stmt_async_op_t            op;              // guarded by stmt->cancel_mutex
+  SQLSMALLINT                orientation;     // of the SQLFetchScroll to resume
+  SQLLEN                     offset;
+
+  // written by the taosc callback before `done` is set
+  TAOS_RES                  *res;
+  int                        code;            // error code of taos_query_a, or rows of taos_fetch_rows_a
+  atomic_int                 done;
+};
+
+enum stmt_cancel_reason_e {
+  STMT_CANCEL_NONE,
+  STMT_CANCEL_APP,                     // SQLCancel, HY008
+  STMT_CANCEL_TIMEOUT,                 // SQL_ATTR_QUERY_TIMEOUT expired, HYT00
+};
+
 struct stmt_s {
   atomic_int                 refc;
 
@@ -854,6 +1270,7 @@ struct stmt_s {
 
   mem_t                      tsdb_sql;
   sqlc_tsdb_t                current_sql;
+  coalesced_inserts_t        coalesced;
 
   tsdb_paramset_t            tsdb_paramset;
 
@@ -865,17 +1282,49 @@ struct stmt_s {
   typesinfo_t                typesinfo;
   primarykeys_t              primarykeys;
   topic_t                    topic;
+  schemaless_t               schemaless;
 
   mem_t                      mem;
 
   stmt_base_t               *base;
 
+  taos_odbc_perf_t           perf;
+
+  stmt_fetch_t               fetch;
+
+  // SQLCancel/SQL_ATTR_QUERY_TIMEOUT, `running_res` and `running` are guarded by `cancel_mutex`
+  pthread_mutex_t            cancel_mutex;
+  TAOS_RES                  *running_res;     // result set that taos_stop_query applies to, if any
+  int                        running;         // nesting of cancelable calls in progress
+  atomic_int                 cancelled;       // stmt_cancel_reason_t
+  SQLULEN                    query_timeout;   // in seconds, 0 for no timeout
+
+  // SQL_ATTR_MAX_ROWS, pushed down as `LIMIT` for plain select, otherwise enforced while fetching
+  SQLULEN                    max_rows;        // 0 for no limit
+  SQLULEN                    rows_returned;   // within current result set
+  mem_t                      max_rows_sql;
+
+  SQLULEN                    parallel_scan;   // SQL_ATTR_TAOS_PARALLEL_SCAN, 0 or 1 to disable
+
+  // SQL_ATTR_CURSOR_TYPE, SQL_CURSOR_STATIC scrolls over tsdb_res_t::cache
+  SQLULEN                    cursor_type;
+  SQLULEN                    rowset_size;     // SQL_ROWSET_SIZE, for SQLExtendedFetch
+  SQLLEN                     rowset_start;    // 1-based, 0: before start, -1: after end
+  size_t                     rowset_nr;       // rowset size of the previous fetch
+
+  // SQL_ATTR_ASYNC_ENABLE, SQLCompleteAsync
+  stmt_async_t               async;
+
   unsigned int               strict:1; // 1: param-truncation as failure
+  unsigned int               timer_armed:1;
 };
 
 struct tls_s {
   mem_t                      intermediate;
   charset_conv_mgr_t        *mgr;
+  tz_cache_t                 tz_cache;
+  // per-thread latency histograms, with TAOS_ODBC_PROFILE=1
+  profile_thread_t          *profile;
   // debug leakage only
   char                      *leakage;
 };
@@ -0,0 +1,238 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022-2023 freemine <freemine@yeah.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "internal.h"
+
+#include "profile.h"
+#include "tls.h"
+
+#include "log.h"
+
+// log-linear buckets, the way HDR histograms do:
+// values below 2^PROFILE_SUB_BITS nanoseconds are exact, beyond that each power-of-two range
+// is split into 2^PROFILE_SUB_BITS sub-buckets, which bounds the relative error of percentiles to ~6%
+#define PROFILE_SUB_BITS           4
+#define PROFILE_SUB_NR             (1 << PROFILE_SUB_BITS)
+#define PROFILE_MAX_BITS           48                      // ~78 hours in nanoseconds, longer calls are clamped
+#define PROFILE_BUCKETS            (PROFILE_SUB_NR * (PROFILE_MAX_BITS - PROFILE_SUB_BITS + 1))
+
+typedef struct profile_histo_s             profile_histo_t;
+struct profile_histo_s {
+  uint64_t                   count;
+  uint64_t                   total;
+  uint64_t                   max;
+  uint64_t                   buckets[PROFILE_BUCKETS];
+};
+
+struct profile_thread_s {
+  struct tod_list_head       node;
+  // allocated on first call of each entry point within this thread
+  profile_histo_t           *histos[PROFILE_API_NR];
+};
+
+typedef struct profile_global_s            profile_global_t;
+struct profile_global_s {
+  pthread_mutex_t            mutex;
+  struct tod_list_head       threads;
+  // merged from threads already gone
+  profile_histo_t           *retired[PROFILE_API_NR];
+};
+
+int profile_enabled = 0;
+
+static profile_global_t _profile;
+
+#define PROFILE_API_NAME(_api)     #_api,
+static const char *_profile_api_names[PROFILE_API_NR] = {
+  PROFILE_APIS(PROFILE_API_NAME)
+};
+#undef PROFILE_API_NAME
+
+#define PROFILE_LOG(fmt, ...)                                                                     \
+  tod_logger_write(tod_get_system_logger(), LOGGER_INFO, LOGGER_VERBOSE,                          \
+      __FILE__, __LINE__, __func__, fmt, ##__VA_ARGS__)
+
+static int _profile_msb(uint64_t v)
+{
+#ifdef _MSC_VER          /* { */
+  unsigned long idx = 0;
+  _BitScanReverse64(&idx, v);
+  return (int)idx;
+#else                    /* }{ */
+  return 63 - __builtin_clzll(v);
+#endif                   /* } */
+}
+
+static size_t _profile_bucket(uint64_t v)
+{
+  if (v < PROFILE_SUB_NR) return (size_t)v;
+  int msb = _profile_msb(v);
+  if (msb >= PROFILE_MAX_BITS) return PROFILE_BUCKETS - 1;
+  size_t sub = (size_t)(v >> (msb - PROFILE_SUB_BITS)) & (PROFILE_SUB_NR - 1);
+  return (size_t)(msb - PROFILE_SUB_BITS + 1) * PROFILE_SUB_NR + sub;
+}
+
+// highest value that falls into bucket `idx`
+static uint64_t _profile_bucket_value(size_t idx)
+{
+  if (idx < PROFILE_SUB_NR) return idx;
+  int shift = (int)(idx / PROFILE_SUB_NR) - 1;
+  uint64_t sub = idx % PROFILE_SUB_NR;
+  return ((PROFILE_SUB_NR + sub + 1) << shift) - 1;
+}
+
+static void _profile_histo_merge(profile_histo_t *dst, const profile_histo_t *src)
+{
+  if (!src) return;
+  dst->count += src->count;
+  dst->total += src->total;
+  if (src->max > dst->max) dst->max = src->max;
+  for (size_t i=0; i<PROFILE_BUCKETS; ++i) dst->buckets[i] += src->buckets[i];
+}
+
+static uint64_t _profile_histo_percentile(const profile_histo_t *histo, double q)
+{
+  uint64_t rank = (uint64_t)(q * (double)histo->count + 0.5);
+  if (rank == 0) rank = 1;
+  uint64_t acc = 0;
+  for (size_t i=0; i<PROFILE_BUCKETS; ++i) {
+    acc += histo->buckets[i];
+    if (acc < rank) continue;
+    uint64_t v = _profile_bucket_value(i);
+    return v < histo->max ? v : histo->max;
+  }
+  return histo->max;
+}
+
+static void _profile_exit(void)
+{
+  profile_dump();
+}
+
+void profile_init(int enabled)
+{
+  if (!enabled || profile_enabled) return;
+
+  pthread_mutex_init(&_profile.mutex, NULL);
+  INIT_TOD_LIST_HEAD(&_profile.threads);
+
+  // NOTE: have the system logger registered its exit routine first,
+  //       so that ours runs earlier and the logger is still alive when dumping
+  (void)tod_get_system_logger();
+  atexit(_profile_exit);
+
+  profile_enabled = 1;
+}
+
+static profile_histo_t* _profile_get_histo(profile_api_t api)
+{
+  tls_t *tls = tls_get();
+  if (!tls) return NULL;
+
+  profile_thread_t *profile = tls->profile;
+  if (!profile) {
+    profile = (profile_thread_t*)calloc(1, sizeof(*profile));
+    if (!profile) return NULL;
+    pthread_mutex_lock(&_profile.mutex);
+    tod_list_add_tail(&profile->node, &_profile.threads);
+    pthread_mutex_unlock(&_profile.mutex);
+    tls->profile = profile;
+  }
+
+  profile_histo_t *histo = profile->histos[api];
+  if (!histo) {
+    histo = (profile_histo_t*)calloc(1, sizeof(*histo));
+    if (!histo) return NULL;
+    profile->histos[api] = histo;
+  }
+
+  return histo;
+}
+
+void profile_record(profile_api_t api, int64_t t0)
+{
+  uint64_t elapsed = (uint64_t)(tod_now_ns() - t0);
+
+  profile_histo_t *histo = _profile_get_histo(api);
+  if (!histo) return;
+
+  // NOTE: written by the owning thread only, readers in profile_dump tolerate counts in flight
+  histo->count += 1;
+  histo->total += elapsed;
+  if (elapsed > histo->max) histo->max = elapsed;
+  histo->buckets[_profile_bucket(elapsed)] += 1;
+}
+
+void profile_thread_release(profile_thread_t *profile)
+{
+  if (!profile) return;
+
+  pthread_mutex_lock(&_profile.mutex);
+  tod_list_del(&profile->node);
+  for (size_t i=0; i<PROFILE_API_NR; ++i) {
+    profile_histo_t *histo = profile->histos[i];
+    if (!histo) continue;
+    if (!_profile.retired[i]) {
+      _profile.retired[i] = histo;
+      profile->histos[i] = NULL;
+      continue;
+    }
+    _profile_histo_merge(_profile.retired[i], histo);
+  }
+  pthread_mutex_unlock(&_profile.mutex);
+
+  for (size_t i=0; i<PROFILE_API_NR; ++i) TOD_SAFE_FREE(profile->histos[i]);
+  free(profile);
+}
+
+void profile_dump(void)
+{
+  if (!profile_enabled) return;
+
+  profile_histo_t *merged = (profile_histo_t*)malloc(sizeof(*merged));
+  if (!merged) return;
+
+  pthread_mutex_lock(&_profile.mutex);
+  for (size_t i=0; i<PROFILE_API_NR; ++i) {
+    memset(merged, 0, sizeof(*merged));
+    _profile_histo_merge(merged, _profile.retired[i]);
+    profile_thread_t *p;
+    tod_list_for_each_entry(p, &_profile.threads, profile_thread_t, node) {
+      _profile_histo_merge(merged, p->histos[i]);
+    }
+    if (merged->count == 0) continue;
+
+    PROFILE_LOG("%s:calls:%" PRIu64 ", avg:%.3fus, p50:%.3fus, p99:%.3fus, p999:%.3fus, max:%.3fus",
+        _profile_api_names[i], merged->count,
+        (double)merged->total / (double)merged->count / 1000,
+        (double)_profile_histo_percentile(merged, 0.5) / 1000,
+        (double)_profile_histo_percentile(merged, 0.99) / 1000,
+        (double)_profile_histo_percentile(merged, 0.999) / 1000,
+        (double)merged->max / 1000);
+  }
+  pthread_mutex_unlock(&_profile.mutex);
+
+  free(merged);
+}
+
@@ -0,0 +1,272 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022-2023 freemine <freemine@yeah.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "internal.h"
+
+#include "result_cache.h"
+
+#include "cursor.h"
+#include "helpers.h"
+#include "log.h"
+
+#include <ctype.h>
+
+// NOTE: fixed for now, an entry larger than 1/8 of the budget is not worth evicting others for
+#define RESULT_CACHE_BUDGET               (64 * 1024 * 1024)
+#define RESULT_CACHE_MAX_ENTRY(_budget)   ((_budget) / 8)
+
+static uint64_t _hash(const unsigned char *p, size_t n)
+{
+  uint64_t h = 14695981039346656037ULL;
+  for (size_t i=0; i<n; ++i) {
+    h ^= p[i];
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+result_cache_t* result_cache_create(void)
+{
+  result_cache_t *rc = (result_cache_t*)calloc(1, sizeof(*rc));
+  if (!rc) return NULL;
+
+  if (pthread_mutex_init(&rc->mutex, NULL)) {
+    free(rc);
+    return NULL;
+  }
+  INIT_TOD_LIST_HEAD(&rc->lru);
+  rc->budget = RESULT_CACHE_BUDGET;
+
+  return rc;
+}
+
+void result_cache_entry_unref(result_cache_entry_t *entry)
+{
+  if (!entry) return;
+
+  int prev = atomic_fetch_sub(&entry->refc, 1);
+  if (prev>1) return;
+  OA_ILE(prev==1);
+
+  cursor_cache_release(&entry->blocks);
+  TOD_SAFE_FREE(entry->fields);
+  TOD_SAFE_FREE(entry->key);
+  free(entry);
+}
+
+static void _result_cache_unlink(result_cache_t *rc, result_cache_entry_t *entry)
+{
+  tod_list_del(&entry->node);
+  rc->bytes   -= entry->bytes;
+  atomic_fetch_sub(&rc->entries, 1);
+  result_cache_entry_unref(entry);
+}
+
+void result_cache_destroy(result_cache_t *rc)
+{
+  if (!rc) return;
+
+  result_cache_invalidate(rc, NULL, 0);
+  pthread_mutex_destroy(&rc->mutex);
+  free(rc);
+}
+
+static int _key_append(mem_t *key, const void *p, size_t n)
+{
+  if (key->nr + n > key->cap) {
+    size_t cap = (key->nr + n + 255) / 256 * 256;
+    if (mem_keep(key, cap)) return -1;
+  }
+  memcpy(key->base + key->nr, p, n);
+  key->nr += n;
+  return 0;
+}
+
+int result_cache_make_key(mem_t *key, const char *scope, const char *sql, size_t len,
+    const TAOS_MULTI_BIND *mbs, int nr_mbs)
+{
+  size_t scope_len = strlen(scope);
+
+  mem_reset(key);
+  if (mem_keep(key, scope_len + 1 + len + 1)) return -1;
+  memcpy(key->base, scope, scope_len + 1);
+  key->nr = scope_len + 1;
+  key->nr += tod_normalize_sql(sql, len, (char*)key->base + key->nr) + 1;
+
+  for (int i=0; i<nr_mbs; ++i) {
+    const TAOS_MULTI_BIND *mb = mbs + i;
+    // NOTE: only a single set of parameters identifies a result set
+    if (mb->num != 1) return -1;
+
+    int32_t type    = mb->buffer_type;
+    int8_t  is_null = mb->is_null ? (int8_t)!!mb->is_null[0] : 0;
+    if (_key_append(key, &type, sizeof(type))) return -1;
+    if (_key_append(key, &is_null, sizeof(is_null))) return -1;
+    if (is_null) continue;
+
+    int32_t n = mb->length ? mb->length[0] : (int32_t)mb->buffer_length;
+    if (n < 0) return -1;
+    if (_key_append(key, &n, sizeof(n))) return -1;
+    if (_key_append(key, mb->buffer, (size_t)n)) return -1;
+  }
+
+  return 0;
+}
+
+result_cache_entry_t* result_cache_get(result_cache_t *rc, const mem_t *key)
+{
+  result_cache_entry_t *hit = NULL;
+  uint64_t hash = _hash(key->base, key->nr);
+  int64_t now = tod_now_us();
+
+  pthread_mutex_lock(&rc->mutex);
+  struct tod_list_head *pos, *n;
+  tod_list_for_each_safe(pos, n, &rc->lru) {
+    result_cache_entry_t *entry = tod_list_entry(pos, result_cache_entry_t, node);
+    if (entry->hash != hash || entry->key_len != key->nr || memcmp(entry->key, key->base, key->nr)) continue;
+    if (now >= entry->expire_us) {
+      _result_cache_unlink(rc, entry);
+      break;
+    }
+    tod_list_move(&entry->node, &rc->lru);
+    atomic_fetch_add(&entry->refc, 1);
+    hit = entry;
+    break;
+  }
+  pthread_mutex_unlock(&rc->mutex);
+
+  return hit;
+}
+
+size_t result_cache_max_entry_bytes(result_cache_t *rc)
+{
+  return RESULT_CACHE_MAX_ENTRY(rc->budget);
+}
+
+void result_cache_put(result_cache_t *rc, const mem_t *key, int ttl_ms,
+    const TAOS_FIELD *fields, size_t nr_fields, int time_precision, cursor_cache_t *blocks)
+{
+  size_t bytes = sizeof(result_cache_entry_t) + key->nr + sizeof(*fields) * nr_fields + blocks->mem_bytes;
+  if (blocks->spill_bytes || bytes > result_cache_max_entry_bytes(rc)) {
+    cursor_cache_reset(blocks);
+    return;
+  }
+
+  result_cache_entry_t *entry = (result_cache_entry_t*)calloc(1, sizeof(*entry));
+  if (!entry) goto oom;
+  entry->key = (char*)malloc(key->nr);
+  if (!entry->key) goto oom;
+  entry->fields = (TAOS_FIELD*)malloc(sizeof(*fields) * (nr_fields ? nr_fields : 1));
+  if (!entry->fields) goto oom;
+
+  memcpy(entry->key, key->base, key->nr);
+  entry->key_len        = key->nr;
+  entry->hash           = _hash(key->base, key->nr);
+  entry->sql            = entry->key + strlen(entry->key) + 1;
+  memcpy(entry->fields, fields, sizeof(*fields) * nr_fields);
+  entry->nr_fields      = nr_fields;
+  entry->time_precision = time_precision;
+  entry->bytes          = bytes;
+  entry->expire_us      = tod_now_us() + (int64_t)ttl_ms * 1000;
+  entry->refc           = 1;
+
+  // NOTE: ownership of blocks moves into the entry
+  entry->blocks = *blocks;
+  memset(blocks, 0, sizeof(*blocks));
+
+  pthread_mutex_lock(&rc->mutex);
+  struct tod_list_head *pos, *n;
+  tod_list_for_each_safe(pos, n, &rc->lru) {
+    result_cache_entry_t *p = tod_list_entry(pos, result_cache_entry_t, node);
+    if (p->hash == entry->hash && p->key_len == entry->key_len && !memcmp(p->key, entry->key, entry->key_len)) {
+      _result_cache_unlink(rc, p);
+      break;
+    }
+  }
+  tod_list_add(&entry->node, &rc->lru);
+  rc->bytes   += entry->bytes;
+  atomic_fetch_add(&rc->entries, 1);
+  while (rc->bytes > rc->budget) {
+    result_cache_entry_t *lru = tod_list_last_entry(&rc->lru, result_cache_entry_t, node);
+    _result_cache_unlink(rc, lru);
+  }
+  // NOTE: traced with `mutex` held, since `entry` might be invalidated or evicted by others as soon as it is released
+  TOD_TRACEF(TOD_TRACE_PERF, "result cache:kept [%zd] rows in [%zd] bytes, ttl:%dms, %s",
+      entry->blocks.nr_rows, bytes, ttl_ms, entry->sql);
+  pthread_mutex_unlock(&rc->mutex);
+  return;
+
+oom:
+  if (entry) {
+    TOD_SAFE_FREE(entry->fields);
+    TOD_SAFE_FREE(entry->key);
+    free(entry);
+  }
+  cursor_cache_reset(blocks);
+}
+
+static int _is_ident(char c)
+{
+  return isalnum((unsigned char)c) || c == '_';
+}
+
+static int _refers_to(const char *sql, const char *name, size_t len)
+{
+  if (len == 0) return 1;
+
+  for (const char *p = sql; *p; ++p) {
+    if (tod_strncasecmp(p, name, len)) continue;
+    if (p > sql && _is_ident(p[-1])) continue;
+    if (_is_ident(p[len])) continue;
+    return 1;
+  }
+
+  return 0;
+}
+
+void result_cache_invalidate(result_cache_t *rc, const char *tbl, size_t len)
+{
+  const char *name = tbl;
+  if (tbl) {
+    // NOTE: `db.tbl` or `tbl`, with or without backquotes, only the bare name counts
+    const char *e = tbl + len;
+    for (const char *p = tbl; p < e; ++p) {
+      if (*p == '.') name = p + 1;
+    }
+    if (name < e && *name == '`') ++name;
+    if (e > name && e[-1] == '`') --e;
+    len = (size_t)(e - name);
+  }
+
+  if (atomic_load(&rc->entries) == 0) return;
+
+  pthread_mutex_lock(&rc->mutex);
+  struct tod_list_head *pos, *n;
+  tod_list_for_each_safe(pos, n, &rc->lru) {
+    result_cache_entry_t *entry = tod_list_entry(pos, result_cache_entry_t, node);
+    if (!tbl || _refers_to(entry->sql, name, len)) _result_cache_unlink(rc, entry);
+  }
+  pthread_mutex_unlock(&rc->mutex);
+}
+
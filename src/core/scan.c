@@ -0,0 +1,326 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022-2023 freemine <freemine@yeah.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "internal.h"
+
+#include "scan.h"
+
+#include "conn.h"
+#include "cursor.h"
+#include "log.h"
+#include "taos_helpers.h"
+
+#define SCAN_SLOTS          (sizeof(((tsdb_scan_lane_t*)0)->slots) / sizeof(((tsdb_scan_lane_t*)0)->slots[0]))
+
+static void _tsdb_scan_lane_fail(tsdb_scan_lane_t *lane, int code, const char *errstr)
+{
+  lane->code = code ? code : -1;
+  snprintf(lane->errmsg, sizeof(lane->errmsg), "%s", errstr);
+}
+
+static int _tsdb_scan_lane_query(tsdb_scan_lane_t *lane, TAOS *taos)
+{
+  tsdb_scan_t *scan = lane->scan;
+
+  if (scan->db[0] && CALL_taos_select_db(taos, scan->db)) {
+    _tsdb_scan_lane_fail(lane, CALL_taos_errno(NULL), CALL_taos_errstr(NULL));
+    return -1;
+  }
+
+  TAOS_RES *res = CALL_taos_query(taos, lane->sql);
+  int e = CALL_taos_errno(res);
+  if (e) {
+    _tsdb_scan_lane_fail(lane, e, CALL_taos_errstr(res));
+    if (res) CALL_taos_free_result(res);
+    return -1;
+  }
+
+  pthread_mutex_lock(&scan->mutex);
+  lane->res = res;
+  if (lane == scan->lanes) {
+    // NOTE: fields of other lanes are the same, as sub-range queries differ in the where-clause only
+    int nr = CALL_taos_field_count(res);
+    TAOS_FIELD *fields = CALL_taos_fetch_fields(res);
+    scan->fields = (TAOS_FIELD*)malloc(sizeof(*fields) * (nr > 0 ? nr : 1));
+    if (scan->fields) {
+      memcpy(scan->fields, fields, sizeof(*fields) * nr);
+      scan->nr_fields      = nr;
+      scan->time_precision = CALL_taos_result_precision(res);
+    } else {
+      _tsdb_scan_lane_fail(lane, 0, "out of memory");
+    }
+  }
+  lane->queried = !lane->code;
+  pthread_cond_broadcast(&scan->cond);
+  pthread_mutex_unlock(&scan->mutex);
+
+  return lane->code ? -1 : 0;
+}
+
+static void _tsdb_scan_lane_fetch(tsdb_scan_lane_t *lane)
+{
+  tsdb_scan_t *scan = lane->scan;
+  TAOS_RES *res = lane->res;
+
+  int nr_fields = CALL_taos_field_count(res);
+  TAOS_FIELD *fields = CALL_taos_fetch_fields(res);
+  int **offsets = (int**)calloc(nr_fields > 0 ? nr_fields : 1, sizeof(*offsets));
+  if (!offsets) {
+    _tsdb_scan_lane_fail(lane, 0, "out of memory");
+    return;
+  }
+
+  while (1) {
+    pthread_mutex_lock(&scan->mutex);
+    while (lane->ready == SCAN_SLOTS && !scan->stop) pthread_cond_wait(&scan->cond, &scan->mutex);
+    int stop = scan->stop;
+    pthread_mutex_unlock(&scan->mutex);
+    if (stop) break;
+
+    TAOS_ROW rows = NULL;
+    int nr_rows = CALL_taos_fetch_block(res, &rows);
+    if (nr_rows <= 0) {
+      int e = CALL_taos_errno(res);
+      if (nr_rows < 0 || e) _tsdb_scan_lane_fail(lane, e ? e : nr_rows, CALL_taos_errstr(res));
+      break;
+    }
+
+    for (int i=0; i<nr_fields; ++i) {
+      int8_t type = fields[i].type;
+      int is_var = (type == TSDB_DATA_TYPE_VARCHAR || type == TSDB_DATA_TYPE_NCHAR);
+      offsets[i] = is_var ? CALL_taos_get_column_data_offset(res, i) : NULL;
+    }
+
+    // NOTE: the slot next to those ready is never touched by the consumer
+    cursor_cache_t *slot = lane->slots + (lane->head + lane->ready) % SCAN_SLOTS;
+    cursor_cache_init(slot, SIZE_MAX, 0);
+    if (cursor_cache_append(slot, res, fields, nr_fields, rows, offsets, nr_rows) < 0) {
+      _tsdb_scan_lane_fail(lane, 0, "out of memory");
+      break;
+    }
+
+    pthread_mutex_lock(&scan->mutex);
+    lane->ready += 1;
+    pthread_cond_broadcast(&scan->cond);
+    pthread_mutex_unlock(&scan->mutex);
+  }
+
+  free(offsets);
+}
+
+static void* _tsdb_scan_lane_routine(void *arg)
+{
+  tsdb_scan_lane_t *lane = (tsdb_scan_lane_t*)arg;
+  tsdb_scan_t *scan = lane->scan;
+
+  TAOS *taos = conn_pool_get(scan->conn);
+  if (!taos) {
+    _tsdb_scan_lane_fail(lane, CALL_taos_errno(NULL), CALL_taos_errstr(NULL));
+  } else if (_tsdb_scan_lane_query(lane, taos) == 0) {
+    _tsdb_scan_lane_fetch(lane);
+  }
+
+  pthread_mutex_lock(&scan->mutex);
+  TAOS_RES *res = lane->res;
+  lane->res  = NULL;
+  lane->done = 1;
+  pthread_cond_broadcast(&scan->cond);
+  pthread_mutex_unlock(&scan->mutex);
+
+  if (res) CALL_taos_free_result(res);
+  if (taos) conn_pool_put(scan->conn, taos);
+
+  return NULL;
+}
+
+static int _tsdb_scan_bound(char *buf, size_t len, const tod_ts_range_t *range, int64_t v)
+{
+  if (!range->is_str) return snprintf(buf, len, "%" PRId64 "", v);
+
+  // NOTE: rendered in utc, as taosc might be configured with a timezone other than that of this process
+  time_t t = (time_t)(v / 1000000000);
+  int ms = (int)(v % 1000000000 / 1000000);
+  struct tm tm = {0};
+  gmtime_r(&t, &tm);
+  return snprintf(buf, len, "'%04d-%02d-%02dT%02d:%02d:%02d.%03dZ'",
+      tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec, ms);
+}
+
+static int _tsdb_scan_plan(tsdb_scan_t *scan, const char *sql, const tod_ts_range_t *range, size_t nr_lanes)
+{
+  // NOTE: split points of string bounds are rounded to milliseconds, whatever the precision of the database
+  int64_t unit = range->is_str ? 1000000 : 1;
+  int64_t span = (range->hi - range->lo) / unit;
+  if (span < (int64_t)nr_lanes) nr_lanes = (size_t)span;
+  if (nr_lanes < 2) return 1;
+
+  scan->lanes = (tsdb_scan_lane_t*)calloc(nr_lanes, sizeof(*scan->lanes));
+  if (!scan->lanes) return -1;
+  scan->nr_lanes = nr_lanes;
+
+  const char *col = sql + range->col;
+  int col_len = (int)range->col_len;
+  int end = (int)range->end;
+  for (size_t i=0; i<nr_lanes; ++i) {
+    tsdb_scan_lane_t *lane = scan->lanes + i;
+    lane->scan = scan;
+
+    // NOTE: original predicates are kept, sub-ranges only narrow them down, [lo, split_1), [split_1, split_2), ...
+    char lo[64], hi[64];
+    _tsdb_scan_bound(lo, sizeof(lo), range, (range->lo / unit + span / (int64_t)nr_lanes * (int64_t)i) * unit);
+    _tsdb_scan_bound(hi, sizeof(hi), range, (range->lo / unit + span / (int64_t)nr_lanes * (int64_t)(i + 1)) * unit);
+
+    size_t len = (size_t)end + (size_t)col_len * 2 + sizeof(lo) + sizeof(hi) + 32;
+    lane->sql = (char*)malloc(len);
+    if (!lane->sql) return -1;
+    if (i == 0) {
+      snprintf(lane->sql, len, "%.*s and %.*s < %s", end, sql, col_len, col, hi);
+    } else if (i + 1 == nr_lanes) {
+      snprintf(lane->sql, len, "%.*s and %.*s >= %s", end, sql, col_len, col, lo);
+    } else {
+      snprintf(lane->sql, len, "%.*s and %.*s >= %s and %.*s < %s", end, sql, col_len, col, lo, col_len, col, hi);
+    }
+    TOD_TRACEF(TOD_TRACE_TAOSC, "scan:%p, lane #%zd => %s", scan, i, lane->sql);
+  }
+
+  return 0;
+}
+
+int tsdb_scan_start(tsdb_scan_t **pscan, conn_t *conn, const char *sql, size_t len, size_t nr_lanes)
+{
+  tod_ts_range_t range = {0};
+  *pscan = NULL;
+
+  if (nr_lanes > TSDB_SCAN_MAX_LANES) nr_lanes = TSDB_SCAN_MAX_LANES;
+  if (tod_parse_ts_range(sql, len, &range)) return 1;
+
+  tsdb_scan_t *scan = (tsdb_scan_t*)calloc(1, sizeof(*scan));
+  if (!scan) return -1;
+  scan->conn = conn;
+  pthread_mutex_init(&scan->mutex, NULL);
+  pthread_cond_init(&scan->cond, NULL);
+
+  int r = _tsdb_scan_plan(scan, sql, &range, nr_lanes);
+  if (r) {
+    tsdb_scan_destroy(scan);
+    return r;
+  }
+
+  int required = 0;
+  if (CALL_taos_get_current_db(conn->taos, scan->db, sizeof(scan->db), &required)) scan->db[0] = '\0';
+
+  *pscan = scan;
+
+  for (size_t i=0; i<scan->nr_lanes; ++i) {
+    tsdb_scan_lane_t *lane = scan->lanes + i;
+    if (pthread_create(&lane->thread, NULL, _tsdb_scan_lane_routine, lane)) {
+      _tsdb_scan_lane_fail(lane, 0, "failed to create thread");
+      lane->done = 1;
+      break;
+    }
+    lane->started = 1;
+  }
+
+  tsdb_scan_lane_t *first = scan->lanes;
+  pthread_mutex_lock(&scan->mutex);
+  while (!first->queried && !first->done) pthread_cond_wait(&scan->cond, &scan->mutex);
+  r = first->queried ? 0 : -1;
+  pthread_mutex_unlock(&scan->mutex);
+
+  return r;
+}
+
+void tsdb_scan_stop(tsdb_scan_t *scan)
+{
+  pthread_mutex_lock(&scan->mutex);
+  scan->stop = 1;
+  for (size_t i=0; i<scan->nr_lanes; ++i) {
+    tsdb_scan_lane_t *lane = scan->lanes + i;
+    if (lane->res) CALL_taos_stop_query(lane->res);
+  }
+  pthread_cond_broadcast(&scan->cond);
+  pthread_mutex_unlock(&scan->mutex);
+}
+
+void tsdb_scan_destroy(tsdb_scan_t *scan)
+{
+  if (!scan) return;
+
+  tsdb_scan_stop(scan);
+  for (size_t i=0; i<scan->nr_lanes; ++i) {
+    tsdb_scan_lane_t *lane = scan->lanes + i;
+    if (lane->started) pthread_join(lane->thread, NULL);
+    for (size_t j=0; j<SCAN_SLOTS; ++j) cursor_cache_release(lane->slots + j);
+    TOD_SAFE_FREE(lane->sql);
+  }
+  TOD_SAFE_FREE(scan->lanes);
+  TOD_SAFE_FREE(scan->fields);
+  pthread_cond_destroy(&scan->cond);
+  pthread_mutex_destroy(&scan->mutex);
+  free(scan);
+}
+
+int tsdb_scan_next_block(tsdb_scan_t *scan, cursor_cache_t *cache)
+{
+  int r = 0;
+
+  pthread_mutex_lock(&scan->mutex);
+  while (scan->i_lane < scan->nr_lanes) {
+    tsdb_scan_lane_t *lane = scan->lanes + scan->i_lane;
+    if (lane->ready) {
+      cursor_cache_t tmp = *cache;
+      *cache = lane->slots[lane->head];
+      lane->slots[lane->head] = tmp;
+      lane->head   = (lane->head + 1) % SCAN_SLOTS;
+      lane->ready -= 1;
+      pthread_cond_broadcast(&scan->cond);
+      r = 1;
+      break;
+    }
+    if (lane->done) {
+      if (lane->code) {
+        r = -1;
+        break;
+      }
+      scan->i_lane += 1;
+      continue;
+    }
+    pthread_cond_wait(&scan->cond, &scan->mutex);
+  }
+  pthread_mutex_unlock(&scan->mutex);
+
+  return r;
+}
+
+const char* tsdb_scan_error(tsdb_scan_t *scan, int *code)
+{
+  for (size_t i=0; i<scan->nr_lanes; ++i) {
+    tsdb_scan_lane_t *lane = scan->lanes + i;
+    if (!lane->code) continue;
+    *code = lane->code;
+    return lane->errmsg;
+  }
+  *code = 0;
+  return "";
+}
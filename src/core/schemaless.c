@@ -0,0 +1,387 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022-2023 freemine <freemine@yeah.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "internal.h"
+
+#include "schemaless.h"
+
+#include "errs.h"
+#include "log.h"
+#include "result_cache.h"
+#include "stmt.h"
+#include "taos_helpers.h"
+
+#include <ctype.h>
+
+void schemaless_cfg_release(schemaless_cfg_t *cfg)
+{
+  if (!cfg) return;
+  TOD_SAFE_FREE(cfg->protocol);
+  kvs_release(&cfg->kvs);
+}
+
+void schemaless_cfg_transfer(schemaless_cfg_t *from, schemaless_cfg_t *to)
+{
+  if (from == to) return;
+  schemaless_cfg_release(to);
+
+  memcpy(to, from, sizeof(*from));
+  memset(from, 0, sizeof(*from));
+}
+
+int schemaless_cfg_set_protocol(schemaless_cfg_t *cfg, const char *protocol, size_t len)
+{
+  char *p = strndup(protocol, len);
+  if (!p) return -1;
+  TOD_SAFE_FREE(cfg->protocol);
+  cfg->protocol = p;
+  return 0;
+}
+
+int schemaless_cfg_append_kv(schemaless_cfg_t *cfg, const char *k, size_t kn, const char *v, size_t vn)
+{
+  kvs_t *kvs = &cfg->kvs;
+  return kvs_append(kvs, k, kn, v, vn);
+}
+
+void schemaless_rewind(schemaless_t *schemaless)
+{
+  if (!schemaless) return;
+  buffer_reset(&schemaless->lines);
+  schemaless->total_rows = 0;
+}
+
+void schemaless_reset(schemaless_t *schemaless)
+{
+  if (!schemaless) return;
+  schemaless_rewind(schemaless);
+  mem_reset(&schemaless->payload);
+  schemaless->opened = 0;
+}
+
+void schemaless_release(schemaless_t *schemaless)
+{
+  if (!schemaless) return;
+  schemaless_reset(schemaless);
+  schemaless_cfg_release(&schemaless->cfg);
+  buffer_release(&schemaless->lines);
+  mem_release(&schemaless->payload);
+}
+
+static SQLRETURN _schemaless_insert(schemaless_t *schemaless, char *lines, size_t len)
+{
+  if (len == 0) return SQL_SUCCESS;
+  if (len > INT32_MAX) {
+    stmt_append_err_format(schemaless->owner, "HY000", 0,
+        "General error:schemaless payload too large:[%zd] bytes", len);
+    return SQL_ERROR;
+  }
+
+  int32_t total_rows = 0;
+  TAOS_RES *res = CALL_taos_schemaless_insert_raw(schemaless->owner->conn->taos,
+      lines, (int)len, &total_rows, schemaless->protocol, schemaless->precision);
+
+  // NOTE: subtables are named by taosc out of tags, thus no telling which cached results are affected,
+  //       and rows might have been partially written even on failure
+  result_cache_invalidate(schemaless->owner->conn->env->result_cache, NULL, 0);
+
+  int e = CALL_taos_errno(res);
+  if (e) {
+    const char *estr = CALL_taos_errstr(res);
+    stmt_append_err_format(schemaless->owner, "HY000", e, "General error:[taosc]%s", estr);
+    if (res) CALL_taos_free_result(res);
+    return SQL_ERROR;
+  }
+  if (res) CALL_taos_free_result(res);
+
+  schemaless->total_rows += total_rows;
+
+  return SQL_SUCCESS;
+}
+
+static void _schemaless_trim_json(const char **s, const char **e)
+{
+  while (*s < *e && isspace((unsigned char)(*s)[0])) ++*s;
+  while (*e > *s && isspace((unsigned char)(*e)[-1])) --*e;
+}
+
+SQLRETURN schemaless_append(schemaless_t *schemaless, const char *payload, size_t len)
+{
+  int r = 0;
+
+  if (len == 0) return SQL_SUCCESS;
+
+  buffer_t *lines = &schemaless->lines;
+
+  if (schemaless->protocol == TSDB_SML_JSON_PROTOCOL) {
+    // NOTE: json payloads are not concatenable as is, thus merged as elements into one json array, closed at execute
+    const char *s = payload;
+    const char *e = payload + len;
+    _schemaless_trim_json(&s, &e);
+    if (e - s >= 2 && s[0] == '[' && e[-1] == ']') {
+      ++s;
+      --e;
+      _schemaless_trim_json(&s, &e);
+    }
+    if (s == e) return SQL_SUCCESS;
+    r = buffer_concat_n(lines, lines->nr ? "," : "[", 1);
+    if (r == 0) r = buffer_concat_n(lines, s, (size_t)(e - s));
+    if (r) {
+      stmt_oom(schemaless->owner);
+      return SQL_ERROR;
+    }
+    return SQL_SUCCESS;
+  }
+
+  if (lines->nr && lines->base[lines->nr-1] != '\n') {
+    r = buffer_concat_n(lines, "\n", 1);
+  }
+  if (r == 0) r = buffer_concat_n(lines, payload, len);
+  if (r) {
+    stmt_oom(schemaless->owner);
+    return SQL_ERROR;
+  }
+
+  return SQL_SUCCESS;
+}
+
+static SQLRETURN _prepare(stmt_base_t *base, const sqlc_tsdb_t *sqlc_tsdb)
+{
+  (void)sqlc_tsdb;
+
+  schemaless_t *schemaless = (schemaless_t*)base;
+  stmt_append_err(schemaless->owner, "HY000", 0, "General error:internal logic error");
+  return SQL_ERROR;
+}
+
+static SQLRETURN _execute(stmt_base_t *base)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+
+  schemaless_t *schemaless = (schemaless_t*)base;
+  buffer_t *lines = &schemaless->lines;
+
+  if (schemaless->protocol == TSDB_SML_JSON_PROTOCOL && lines->nr) {
+    if (buffer_concat_n(lines, "]", 1)) {
+      stmt_oom(schemaless->owner);
+      return SQL_ERROR;
+    }
+  }
+
+  sr = _schemaless_insert(schemaless, lines->base, lines->nr);
+  buffer_reset(lines);
+
+  return sr;
+}
+
+static SQLRETURN _get_col_fields(stmt_base_t *base, TAOS_FIELD **fields, size_t *nr)
+{
+  (void)base;
+  if (fields) *fields = NULL;
+  if (nr) *nr = 0;
+  return SQL_SUCCESS;
+}
+
+static SQLRETURN _fetch_row(stmt_base_t *base)
+{
+  (void)base;
+  return SQL_NO_DATA;
+}
+
+static SQLRETURN _more_results(stmt_base_t *base)
+{
+  (void)base;
+  return SQL_NO_DATA;
+}
+
+static SQLRETURN _describe_param(stmt_base_t *base,
+    SQLUSMALLINT    ParameterNumber,
+    SQLSMALLINT    *DataTypePtr,
+    SQLULEN        *ParameterSizePtr,
+    SQLSMALLINT    *DecimalDigitsPtr,
+    SQLSMALLINT    *NullablePtr)
+{
+  schemaless_t *schemaless = (schemaless_t*)base;
+
+  if (ParameterNumber != 1) {
+    stmt_append_err_format(schemaless->owner, "07009", 0,
+        "Invalid descriptor index:#%d param, but schemaless-statement carries only one", ParameterNumber);
+    return SQL_ERROR;
+  }
+
+  if (DataTypePtr)         *DataTypePtr         = SQL_VARCHAR;
+  if (ParameterSizePtr)    *ParameterSizePtr    = INT32_MAX;
+  if (DecimalDigitsPtr)    *DecimalDigitsPtr    = 0;
+  if (NullablePtr)         *NullablePtr         = SQL_NULLABLE;
+
+  return SQL_SUCCESS;
+}
+
+static SQLRETURN _get_num_params(stmt_base_t *base, SQLSMALLINT *ParameterCountPtr)
+{
+  (void)base;
+  if (ParameterCountPtr) *ParameterCountPtr = 1;
+  return SQL_SUCCESS;
+}
+
+static SQLRETURN _tsdb_field_by_param(stmt_base_t *base, int i_param, TAOS_FIELD_E **field)
+{
+  (void)i_param;
+  (void)field;
+
+  schemaless_t *schemaless = (schemaless_t*)base;
+  stmt_append_err(schemaless->owner, "HY000", 0, "General error:internal logic error");
+  return SQL_ERROR;
+}
+
+static SQLRETURN _row_count(stmt_base_t *base, SQLLEN *row_count_ptr)
+{
+  schemaless_t *schemaless = (schemaless_t*)base;
+  if (row_count_ptr) *row_count_ptr = (SQLLEN)schemaless->total_rows;
+  return SQL_SUCCESS;
+}
+
+static SQLRETURN _get_num_cols(stmt_base_t *base, SQLSMALLINT *ColumnCountPtr)
+{
+  (void)base;
+  if (ColumnCountPtr) *ColumnCountPtr = 0;
+  return SQL_SUCCESS;
+}
+
+static SQLRETURN _get_data(stmt_base_t *base, SQLUSMALLINT Col_or_Param_Num, tsdb_data_t *tsdb)
+{
+  (void)Col_or_Param_Num;
+  (void)tsdb;
+
+  schemaless_t *schemaless = (schemaless_t*)base;
+  stmt_append_err(schemaless->owner, "HY000", 0, "General error:internal logic error");
+  return SQL_ERROR;
+}
+
+void schemaless_init(schemaless_t *schemaless, stmt_t *stmt)
+{
+  schemaless->owner = stmt;
+
+  stmt_base_t *base = &schemaless->base;
+
+  base->prepare                      = _prepare;
+  base->execute                      = _execute;
+  base->get_col_fields               = _get_col_fields;
+  base->fetch_row                    = _fetch_row;
+  base->more_results                 = _more_results;
+  base->describe_param               = _describe_param;
+  base->get_num_params               = _get_num_params;
+  base->tsdb_field_by_param          = _tsdb_field_by_param;
+  base->row_count                    = _row_count;
+  base->get_num_cols                 = _get_num_cols;
+  base->get_data                     = _get_data;
+}
+
+static SQLRETURN _schemaless_parse_protocol(schemaless_t *schemaless, const char *protocol)
+{
+  static const struct {
+    const char           *name;
+    int                   protocol;
+  } _protocols[] = {
+    {"influx",       TSDB_SML_LINE_PROTOCOL},
+    {"line",         TSDB_SML_LINE_PROTOCOL},
+    {"telnet",       TSDB_SML_TELNET_PROTOCOL},
+    {"json",         TSDB_SML_JSON_PROTOCOL},
+  };
+
+  for (size_t i=0; i<sizeof(_protocols)/sizeof(_protocols[0]); ++i) {
+    if (tod_strcasecmp(protocol, _protocols[i].name)) continue;
+    schemaless->protocol = _protocols[i].protocol;
+    return SQL_SUCCESS;
+  }
+
+  stmt_append_err_format(schemaless->owner, "HY000", 0,
+      "General error:schemaless protocol `%s` not supported, valid protocols:influx|telnet|json", protocol);
+  return SQL_ERROR;
+}
+
+static SQLRETURN _schemaless_parse_precision(schemaless_t *schemaless, const char *precision)
+{
+  static const struct {
+    const char           *name;
+    int                   precision;
+  } _precisions[] = {
+    {"h",            TSDB_SML_TIMESTAMP_HOURS},
+    {"m",            TSDB_SML_TIMESTAMP_MINUTES},
+    {"s",            TSDB_SML_TIMESTAMP_SECONDS},
+    {"ms",           TSDB_SML_TIMESTAMP_MILLI_SECONDS},
+    {"u",            TSDB_SML_TIMESTAMP_MICRO_SECONDS},
+    {"us",           TSDB_SML_TIMESTAMP_MICRO_SECONDS},
+    {"ns",           TSDB_SML_TIMESTAMP_NANO_SECONDS},
+  };
+
+  for (size_t i=0; i<sizeof(_precisions)/sizeof(_precisions[0]); ++i) {
+    if (tod_strcasecmp(precision, _precisions[i].name)) continue;
+    schemaless->precision = _precisions[i].precision;
+    return SQL_SUCCESS;
+  }
+
+  stmt_append_err_format(schemaless->owner, "HY000", 0,
+      "General error:schemaless precision `%s` not supported, valid precisions:h|m|s|ms|us|ns", precision);
+  return SQL_ERROR;
+}
+
+SQLRETURN schemaless_open(
+    schemaless_t        *schemaless,
+    const sqlc_tsdb_t   *sql,
+    schemaless_cfg_t    *cfg)
+{
+  (void)sql;
+  SQLRETURN sr = SQL_SUCCESS;
+
+  schemaless_reset(schemaless);
+
+  schemaless_cfg_transfer(cfg, &schemaless->cfg);
+  cfg = &schemaless->cfg;
+  if (!cfg->protocol) {
+    stmt_append_err(schemaless->owner, "HY000", 0, "General error:schemaless protocol not specified");
+    return SQL_ERROR;
+  }
+
+  sr = _schemaless_parse_protocol(schemaless, cfg->protocol);
+  if (sr != SQL_SUCCESS) return SQL_ERROR;
+
+  schemaless->precision = TSDB_SML_TIMESTAMP_NOT_CONFIGURED;
+
+  kvs_t *kvs = &cfg->kvs;
+  for (size_t i=0; i<kvs->nr; ++i) {
+    kv_t *kv = kvs->kvs + i;
+    if (tod_strcasecmp(kv->key, "precision") == 0 && kv->val) {
+      sr = _schemaless_parse_precision(schemaless, kv->val);
+      if (sr != SQL_SUCCESS) return SQL_ERROR;
+      continue;
+    }
+    stmt_append_err_format(schemaless->owner, "HY000", 0,
+        "General error:schemaless option `%s` not supported", kv->key);
+    return SQL_ERROR;
+  }
+
+  schemaless->opened = 1;
+
+  return SQL_SUCCESS;
+}
@@ -29,11 +29,14 @@
 #include "conn.h"
 #include "desc.h"
 #include "errs.h"
+#include "fetch_pool.h"
 #include "log.h"
 #include "conn_parser.h"
 #include "ext_parser.h"
 #include "sqls_parser.h"
 #include "primarykeys.h"
+#include "scan.h"
+#include "schemaless.h"
 #include "stmt.h"
 #include "tables.h"
 #include "taos_helpers.h"
@@ -201,6 +204,51 @@ static void _sqls_release(sqls_t *sqls)
   sqls->cap = 0;
 }
 
+static void _coalesced_inserts_reset(coalesced_inserts_t *coalesced)
+{
+  if (!coalesced) return;
+  mem_reset(&coalesced->tsdb_sql);
+  coalesced->nr  = 0;
+  coalesced->pos = 0;
+}
+
+static void _coalesced_inserts_release(coalesced_inserts_t *coalesced)
+{
+  if (!coalesced) return;
+  _coalesced_inserts_reset(coalesced);
+  mem_release(&coalesced->tsdb_sql);
+  TOD_SAFE_FREE(coalesced->rows);
+  coalesced->cap = 0;
+}
+
+static int _coalesced_inserts_append(coalesced_inserts_t *coalesced, const char *sql, size_t len, size_t rows)
+{
+  mem_t *mem = &coalesced->tsdb_sql;
+  size_t need = mem->nr + 1 + len + 4;
+  if (need > mem->cap) {
+    size_t cap = mem->cap * 2;
+    if (cap < need) cap = need;
+    if (mem_keep(mem, cap)) return -1;
+  }
+
+  if (coalesced->nr == coalesced->cap) {
+    size_t cap = coalesced->cap + 16;
+    int64_t *p = (int64_t*)realloc(coalesced->rows, sizeof(*p) * cap);
+    if (!p) return -1;
+    coalesced->rows = p;
+    coalesced->cap  = cap;
+  }
+
+  if (mem->nr) mem->base[mem->nr++] = ' ';
+  memcpy(mem->base + mem->nr, sql, len);
+  mem->nr += len;
+  *(int32_t*)(mem->base + mem->nr) = 0;
+
+  coalesced->rows[coalesced->nr++] = (int64_t)rows;
+
+  return 0;
+}
+
 static void _sqlc_data_reset(sqlc_data_t *sqlc)
 {
   if (!sqlc) return;
@@ -298,6 +346,13 @@ static void _stmt_init(stmt_t *stmt, conn_t *conn)
   typesinfo_init(&stmt->typesinfo, stmt);
   primarykeys_init(&stmt->primarykeys, stmt);
   topic_init(&stmt->topic, stmt);
+  schemaless_init(&stmt->schemaless, stmt);
+
+  pthread_mutex_init(&stmt->cancel_mutex, NULL);
+  stmt->async.enable = conn->async_enable;
+
+  stmt->cursor_type = SQL_CURSOR_FORWARD_ONLY;
+  stmt->rowset_size = 1;
 
   stmt->base = &stmt->tsdb_stmt.base;
 
@@ -325,6 +380,29 @@ static void _get_data_ctx_release(get_data_ctx_t *ctx)
   _sqlc_data_release(&ctx->sqlc);
 }
 
+static void _stmt_fetch_release_lanes(stmt_fetch_t *fetch)
+{
+  for (size_t i=0; i<fetch->nr_lanes; ++i) {
+    stmt_t *lane = fetch->lanes + i;
+    _get_data_ctx_release(&lane->get_data_ctx);
+    errs_release(&lane->errs);
+  }
+  TOD_SAFE_FREE(fetch->lanes);
+  fetch->nr_lanes = 0;
+}
+
+static void _stmt_fetch_release(stmt_fetch_t *fetch)
+{
+  _stmt_fetch_release_lanes(fetch);
+
+  mem_release(&fetch->cols);
+  mem_release(&fetch->cells);
+  mem_release(&fetch->units);
+  fetch->nr_cols  = 0;
+  fetch->nr_units = 0;
+  fetch->nr_tasks = 0;
+}
+
 descriptor_t* stmt_APD(stmt_t *stmt)
 {
   return stmt->current_APD;
@@ -352,8 +430,41 @@ static SQLULEN* _stmt_get_rows_fetched_ptr(stmt_t *stmt)
   return IRD_header->DESC_ROWS_PROCESSED_PTR;
 }
 
+static int _stmt_is_busy(stmt_t *stmt)
+{
+  // NOTE: called with cancel_mutex held
+  return stmt->running || stmt->async.op != STMT_ASYNC_NONE;
+}
+
+static void _stmt_async_set_op(stmt_t *stmt, stmt_async_op_t op)
+{
+  pthread_mutex_lock(&stmt->cancel_mutex);
+  int was_busy = _stmt_is_busy(stmt);
+  stmt->async.op = op;
+  if (_stmt_is_busy(stmt) != was_busy) conn_set_busy(stmt->conn, !was_busy);
+  pthread_mutex_unlock(&stmt->cancel_mutex);
+}
+
+static void _stmt_async_drain(stmt_t *stmt)
+{
+  stmt_async_t *async = &stmt->async;
+  if (async->op == STMT_ASYNC_NONE) return;
+
+  // NOTE: the taosc callback still refers to `stmt`, wait for it before the result set goes away
+  stmt_cancel_with(stmt, STMT_CANCEL_APP);
+  while (!atomic_load(&async->done)) tod_sleep_ms(1);
+
+  if (async->op == STMT_ASYNC_QUERY && async->res) CALL_taos_free_result(async->res);
+  async->res = NULL;
+  _stmt_async_set_op(stmt, STMT_ASYNC_NONE);
+  atomic_store(&async->done, 0);
+  atomic_store(&stmt->cancelled, STMT_CANCEL_NONE);
+}
+
 static void _stmt_reset_result(stmt_t *stmt)
 {
+  _stmt_async_drain(stmt);
+
   _get_data_ctx_reset(&stmt->get_data_ctx);
 
   tsdb_res_reset(&stmt->tsdb_stmt.res);
@@ -362,12 +473,17 @@ static void _stmt_reset_result(stmt_t *stmt)
   typesinfo_reset(&stmt->typesinfo);
   primarykeys_reset(&stmt->primarykeys);
   topic_reset(&stmt->topic);
+  stmt->rows_returned = 0;
+  stmt->rowset_start  = 0;
+  stmt->rowset_nr     = 0;
 
   if (_stmt_get_rows_fetched_ptr(stmt)) *_stmt_get_rows_fetched_ptr(stmt) = 0;
 }
 
 static void _stmt_release_result(stmt_t *stmt)
 {
+  _stmt_async_drain(stmt);
+
   _get_data_ctx_release(&stmt->get_data_ctx);
 
   tsdb_res_release(&stmt->tsdb_stmt.res);
@@ -376,6 +492,10 @@ static void _stmt_release_result(stmt_t *stmt)
   typesinfo_release(&stmt->typesinfo);
   primarykeys_release(&stmt->primarykeys);
   topic_release(&stmt->topic);
+  schemaless_release(&stmt->schemaless);
+  stmt->rows_returned = 0;
+  stmt->rowset_start  = 0;
+  stmt->rowset_nr     = 0;
 
   if (_stmt_get_rows_fetched_ptr(stmt)) *_stmt_get_rows_fetched_ptr(stmt) = 0;
 }
@@ -406,6 +526,14 @@ static void _stmt_close_result(stmt_t *stmt)
   stmt->base = &stmt->tsdb_stmt.base;
 }
 
+static void _stmt_close_cursor(stmt_t *stmt)
+{
+  // NOTE: a prepared `!schemaless` has no cursor to close, keep it dispatched to schemaless for the next SQLExecute
+  int schemaless = (stmt->base == &stmt->schemaless.base && stmt->schemaless.opened);
+  _stmt_close_result(stmt);
+  if (schemaless) stmt->base = &stmt->schemaless.base;
+}
+
 static void _stmt_unbind_cols(stmt_t *stmt)
 {
   descriptor_t *ARD = _stmt_ARD(stmt);
@@ -542,6 +670,9 @@ static void _stmt_release_field_arrays(stmt_t *stmt)
 static void _stmt_release(stmt_t *stmt)
 {
   _stmt_release_result(stmt);
+  topic_destroy(&stmt->topic);
+
+  _stmt_fetch_release(&stmt->fetch);
 
   _stmt_release_field_arrays(stmt);
 
@@ -555,15 +686,19 @@ static void _stmt_release(stmt_t *stmt)
 
   mem_release(&stmt->raw);
   mem_release(&stmt->tsdb_sql);
+  mem_release(&stmt->max_rows_sql);
 
   errs_release(&stmt->errs);
   mem_release(&stmt->mem);
   tsdb_paramset_release(&stmt->tsdb_paramset);
   tsdb_binds_release(&stmt->tsdb_binds);
   _sqls_release(&stmt->sqls);
+  _coalesced_inserts_release(&stmt->coalesced);
   _param_state_release(&stmt->param_state);
   _params_bind_meta_release(&stmt->params_bind_meta);
 
+  pthread_mutex_destroy(&stmt->cancel_mutex);
+
   conn_unref(stmt->conn);
   stmt->conn = NULL;
 
@@ -578,10 +713,13 @@ stmt_t* stmt_create(conn_t *conn)
     return NULL;
   }
 
+  _stmt_init(stmt, conn);
+
+  // NOTE: visible to others walking thru conn->stmts, e.g. _conn_flush_deferred, only once fully initialized
+  pthread_mutex_lock(&conn->stmts_mutex);
   tod_list_add_tail(&stmt->node, &conn->stmts);
   conn->nr_stmts += 1;
-
-  _stmt_init(stmt, conn);
+  pthread_mutex_unlock(&conn->stmts_mutex);
 
   return stmt;
 }
@@ -599,8 +737,16 @@ stmt_t* stmt_unref(stmt_t *stmt)
   if (prev>1) return stmt;
   OA_ILE(prev==1);
 
+  conn_t *conn = stmt->conn;
+  // NOTE: a topic still open is closed only by _stmt_release below, thus fold its poll stats in advance
+  topic_perf_add(&stmt->topic, &stmt->perf);
+  topic_perf_reset(&stmt->topic);
+  pthread_mutex_lock(&conn->stmts_mutex);
   tod_list_del(&stmt->node);
-  stmt->conn->nr_stmts -= 1;
+  conn->nr_stmts -= 1;
+  stmt_perf_add(&conn->perf, &stmt->perf);
+  pthread_mutex_unlock(&conn->stmts_mutex);
+  stmt_perf_dump("stmt", stmt, &stmt->perf);
   _stmt_release(stmt);
   free(stmt);
 
@@ -609,6 +755,9 @@ stmt_t* stmt_unref(stmt_t *stmt)
 
 SQLRETURN stmt_free(stmt_t *stmt)
 {
+  // NOTE: SQL_ERROR keeps the handle valid, so that the failure is reported rather than just logged
+  if (tsdb_stmt_flush(&stmt->tsdb_stmt) != SQL_SUCCESS) return SQL_ERROR;
+
   stmt_unref(stmt);
   return SQL_SUCCESS;
 }
@@ -1237,6 +1386,7 @@ static void _stmt_unprepare(stmt_t *stmt)
 {
   _stmt_close_result(stmt);
   tsdb_stmt_unprepare(&stmt->tsdb_stmt);
+  schemaless_reset(&stmt->schemaless);
   // _tsdb_binds_reset(&stmt->tsdb_binds);
   _param_state_reset(&stmt->param_state);
 }
@@ -1475,7 +1625,7 @@ SQLRETURN stmt_bind_col(stmt_t *stmt,
     return SQL_ERROR;
   }
 
-  // OW("Column%d:%s",  ColumnNumber, sqlc_data_type(TargetType));
+  TOD_TRACEF(TOD_TRACE_BIND, "stmt:%p, Column%d:%s, BufferLength:%zd", stmt, ColumnNumber, sqlc_data_type(TargetType), (size_t)BufferLength);
   return _stmt_bind_col(stmt, ColumnNumber, TargetType, TargetValuePtr, BufferLength, StrLen_or_IndPtr);
 }
 
@@ -1504,16 +1654,12 @@ SQLRETURN stmt_get_diag_rec(
   return errs_get_diag_rec(&stmt->errs, RecNumber, SQLState, NativeErrorPtr, MessageText, BufferLength, TextLengthPtr);
 }
 
-static SQLRETURN _stmt_get_data_prepare_ctx(stmt_t *stmt, stmt_get_data_args_t *args)
+// format `ctx->tsdb` already got into `ctx->buf` if needed by the target type
+static SQLRETURN _stmt_get_data_format_ctx(stmt_t *stmt, stmt_get_data_args_t *args)
 {
-  SQLRETURN sr = SQL_SUCCESS;
-
   get_data_ctx_t *ctx = &stmt->get_data_ctx;
   tsdb_data_t *tsdb = &ctx->tsdb;
 
-  sr = stmt->base->get_data(stmt->base, args->Col_or_Param_Num, tsdb);
-  if (sr != SQL_SUCCESS) return SQL_ERROR;
-
   if (tsdb->is_null) return SQL_SUCCESS;
 
   int target_is_fix = 1;
@@ -1609,6 +1755,16 @@ static SQLRETURN _stmt_get_data_prepare_ctx(stmt_t *stmt, stmt_get_data_args_t *
   return SQL_SUCCESS;
 }
 
+static SQLRETURN _stmt_get_data_prepare_ctx(stmt_t *stmt, stmt_get_data_args_t *args)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+
+  sr = stmt->base->get_data(stmt->base, args->Col_or_Param_Num, &stmt->get_data_ctx.tsdb);
+  if (sr != SQL_SUCCESS) return SQL_ERROR;
+
+  return _stmt_get_data_format_ctx(stmt, args);
+}
+
 static void _dump_iconv(
     const char *fromcode, const char *tocode,
     const char *inbuf, size_t inbytes, size_t inbytesleft,
@@ -1630,6 +1786,12 @@ static void _dump_iconv(
   OW("%s\n", buf);
 }
 
+static void _stmt_perf_iconv(stmt_t *stmt, size_t consumed)
+{
+  stmt->perf.iconv_calls += 1;
+  stmt->perf.iconv_bytes += consumed;
+}
+
 static SQLRETURN _stmt_get_data_copy_buf_to_char(stmt_t *stmt, stmt_get_data_args_t *args)
 {
   get_data_ctx_t *ctx = &stmt->get_data_ctx;
@@ -1669,6 +1831,8 @@ static SQLRETURN _stmt_get_data_copy_buf_to_char(stmt_t *stmt, stmt_get_data_arg
   size_t           outbytesleft        = outbytes;
 
   size_t n = CALL_iconv(cnv->cnv, &inbuf, &inbytesleft, &outbuf, &outbytesleft);
+
+  _stmt_perf_iconv(stmt, inbytes - inbytesleft);
   if (0) _dump_iconv(fromcode, tocode, (char*)ctx->pos, inbytes, inbytesleft, (char*)args->TargetValuePtr, outbytes, outbytesleft);
   // OW("[%.*s]", (int)(outbytes - outbytesleft), (char*)args->TargetValuePtr);
   int e = errno;
@@ -1733,6 +1897,8 @@ static SQLRETURN _stmt_get_data_copy_buf_to_wchar(stmt_t *stmt, stmt_get_data_ar
   size_t           outbytesleft        = outbytes;
 
   size_t n = CALL_iconv(cnv->cnv, &inbuf, &inbytesleft, &outbuf, &outbytesleft);
+
+  _stmt_perf_iconv(stmt, inbytes - inbytesleft);
   int e = errno;
   iconv(cnv->cnv, NULL, NULL, NULL, NULL);
   if (n == (size_t)-1) {
@@ -1805,30 +1971,18 @@ static SQLRETURN _stmt_varchar_to_int64(stmt_t *stmt, const char *s, size_t nr,
 
   get_data_ctx_t *ctx = &stmt->get_data_ctx;
   tsdb_data_t *tsdb = &ctx->tsdb;
-  mem_t *tsdb_cache = &ctx->mem;
-
-  if (s[nr]) {
-    r = mem_keep(tsdb_cache, nr + 1);
-    if (r) {
-      stmt_oom(stmt);
-      return SQL_ERROR;
-    }
-    memcpy(tsdb_cache->base, s, nr);
-    tsdb_cache->base[nr] = '\0';
-    s = (const char*)tsdb_cache->base;
-  }
 
-  char *end = NULL;
-  long long ll = strtoll(s, &end, 0);
-  int e = errno;
-  if (end) {
+  const char *end = NULL;
+  int64_t i64 = 0;
+  r = tod_str_to_i64(s, nr, &i64, &end);
+  if (r == -1) {
     stmt_append_err_format(stmt, "HY000", 0,
         "General error:Column[%d] conversion from `%s[0x%x/%d]` to `%s[0x%x/%d]` failed:invalid character[0x%02x]",
         args->Col_or_Param_Num, taos_data_type(tsdb->type), tsdb->type, tsdb->type,
-        sqlc_data_type(args->TargetType), args->TargetType, args->TargetType, *end);
+        sqlc_data_type(args->TargetType), args->TargetType, args->TargetType, end < s + nr ? (unsigned char)*end : 0);
     return SQL_ERROR;
   }
-  if (e == ERANGE) {
+  if (r) {
     stmt_append_err_format(stmt, "HY000", 0,
         "General error:Column[%d] conversion from `%s[0x%x/%d]` to `%s[0x%x/%d]` failed:overflow or underflow occurs",
         args->Col_or_Param_Num, taos_data_type(tsdb->type), tsdb->type, tsdb->type,
@@ -1836,7 +1990,7 @@ static SQLRETURN _stmt_varchar_to_int64(stmt_t *stmt, const char *s, size_t nr,
     return SQL_ERROR;
   }
 
-  *v = ll;
+  *v = i64;
   return SQL_SUCCESS;
 }
 
@@ -1870,47 +2024,23 @@ static SQLRETURN _stmt_varchar_to_float(stmt_t *stmt, const char *s, size_t nr,
 
   get_data_ctx_t *ctx = &stmt->get_data_ctx;
   tsdb_data_t *tsdb = &ctx->tsdb;
-  mem_t *tsdb_cache = &ctx->mem;
-
-  if (s[nr]) {
-    r = mem_keep(tsdb_cache, nr + 1);
-    if (r) {
-      stmt_oom(stmt);
-      return SQL_ERROR;
-    }
-    memcpy(tsdb_cache->base, s, nr);
-    tsdb_cache->base[nr] = '\0';
-    s = (const char*)tsdb_cache->base;
-  }
 
-  char *end = NULL;
-  float flt = strtof(s, &end);
-  int e = errno;
-  if (end) {
+  const char *end = NULL;
+  float flt = 0;
+  r = tod_str_to_flt(s, nr, &flt, &end);
+  if (r == -1) {
     stmt_append_err_format(stmt, "HY000", 0,
         "General error:Column[%d] conversion from `%s[0x%x/%d]` to `%s[0x%x/%d]` failed:invalid character[0x%02x]",
         args->Col_or_Param_Num, taos_data_type(tsdb->type), tsdb->type, tsdb->type,
-        sqlc_data_type(args->TargetType), args->TargetType, args->TargetType, *end);
+        sqlc_data_type(args->TargetType), args->TargetType, args->TargetType, end < s + nr ? (unsigned char)*end : 0);
     return SQL_ERROR;
   }
-  if (fabsf(flt) == HUGE_VALF) {
-    if (e == ERANGE) {
-      stmt_append_err_format(stmt, "HY000", 0,
-          "General error:Column[%d] conversion from `%s[0x%x/%d]` to `%s[0x%x/%d]` failed:overflow or underflow occurs",
-          args->Col_or_Param_Num, taos_data_type(tsdb->type), tsdb->type, tsdb->type,
-          sqlc_data_type(args->TargetType), args->TargetType, args->TargetType);
-      return SQL_ERROR;
-    }
-  }
-
-  if (fpclassify(flt) == FP_ZERO) {
-    if (e == ERANGE) {
-      stmt_append_err_format(stmt, "HY000", 0,
-          "General error:Column[%d] conversion from `%s[0x%x/%d]` to `%s[0x%x/%d]` failed:overflow or underflow occurs",
-          args->Col_or_Param_Num, taos_data_type(tsdb->type), tsdb->type, tsdb->type,
-          sqlc_data_type(args->TargetType), args->TargetType, args->TargetType);
-      return SQL_ERROR;
-    }
+  if (r) {
+    stmt_append_err_format(stmt, "HY000", 0,
+        "General error:Column[%d] conversion from `%s[0x%x/%d]` to `%s[0x%x/%d]` failed:overflow or underflow occurs",
+        args->Col_or_Param_Num, taos_data_type(tsdb->type), tsdb->type, tsdb->type,
+        sqlc_data_type(args->TargetType), args->TargetType, args->TargetType);
+    return SQL_ERROR;
   }
 
   *v = flt;
@@ -1923,47 +2053,23 @@ static SQLRETURN _stmt_varchar_to_double(stmt_t *stmt, const char *s, size_t nr,
 
   get_data_ctx_t *ctx = &stmt->get_data_ctx;
   tsdb_data_t *tsdb = &ctx->tsdb;
-  mem_t *tsdb_cache = &ctx->mem;
-
-  if (s[nr]) {
-    r = mem_keep(tsdb_cache, nr + 1);
-    if (r) {
-      stmt_oom(stmt);
-      return SQL_ERROR;
-    }
-    memcpy(tsdb_cache->base, s, nr);
-    tsdb_cache->base[nr] = '\0';
-    s = (const char*)tsdb_cache->base;
-  }
 
-  char *end = NULL;
-  double dbl = strtod(s, &end);
-  int e = errno;
-  if (end) {
+  const char *end = NULL;
+  double dbl = 0;
+  r = tod_str_to_dbl(s, nr, &dbl, &end);
+  if (r == -1) {
     stmt_append_err_format(stmt, "HY000", 0,
         "General error:Column[%d] conversion from `%s[0x%x/%d]` to `%s[0x%x/%d]` failed:invalid character[0x%02x]",
         args->Col_or_Param_Num, taos_data_type(tsdb->type), tsdb->type, tsdb->type,
-        sqlc_data_type(args->TargetType), args->TargetType, args->TargetType, *end);
+        sqlc_data_type(args->TargetType), args->TargetType, args->TargetType, end < s + nr ? (unsigned char)*end : 0);
     return SQL_ERROR;
   }
-  if (fabs(dbl) == HUGE_VAL) {
-    if (e == ERANGE) {
-      stmt_append_err_format(stmt, "HY000", 0,
-          "General error:Column[%d] conversion from `%s[0x%x/%d]` to `%s[0x%x/%d]` failed:overflow or underflow occurs",
-          args->Col_or_Param_Num, taos_data_type(tsdb->type), tsdb->type, tsdb->type,
-          sqlc_data_type(args->TargetType), args->TargetType, args->TargetType);
-      return SQL_ERROR;
-    }
-  }
-
-  if (fpclassify(dbl) == FP_ZERO) {
-    if (e == ERANGE) {
-      stmt_append_err_format(stmt, "HY000", 0,
-          "General error:Column[%d] conversion from `%s[0x%x/%d]` to `%s[0x%x/%d]` failed:overflow or underflow occurs",
-          args->Col_or_Param_Num, taos_data_type(tsdb->type), tsdb->type, tsdb->type,
-          sqlc_data_type(args->TargetType), args->TargetType, args->TargetType);
-      return SQL_ERROR;
-    }
+  if (r) {
+    stmt_append_err_format(stmt, "HY000", 0,
+        "General error:Column[%d] conversion from `%s[0x%x/%d]` to `%s[0x%x/%d]` failed:overflow or underflow occurs",
+        args->Col_or_Param_Num, taos_data_type(tsdb->type), tsdb->type, tsdb->type,
+        sqlc_data_type(args->TargetType), args->TargetType, args->TargetType);
+    return SQL_ERROR;
   }
 
   *v = dbl;
@@ -2393,6 +2499,30 @@ static SQLRETURN _stmt_get_data_copy(stmt_t *stmt, stmt_get_data_args_t *args)
   }
 }
 
+static size_t _tsdb_data_bytes(const tsdb_data_t *tsdb)
+{
+  if (tsdb->is_null) return 0;
+
+  switch (tsdb->type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+    case TSDB_DATA_TYPE_UTINYINT:
+      return 1;
+    case TSDB_DATA_TYPE_SMALLINT:
+    case TSDB_DATA_TYPE_USMALLINT:
+      return 2;
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_UINT:
+    case TSDB_DATA_TYPE_FLOAT:
+      return 4;
+    case TSDB_DATA_TYPE_VARCHAR:
+    case TSDB_DATA_TYPE_NCHAR:
+      return tsdb->str.len;
+    default:
+      return 8;
+  }
+}
+
 static SQLRETURN _stmt_get_data_x(stmt_t *stmt, stmt_get_data_args_t *args)
 {
   SQLRETURN sr = SQL_SUCCESS;
@@ -2404,6 +2534,8 @@ static SQLRETURN _stmt_get_data_x(stmt_t *stmt, stmt_get_data_args_t *args)
 
     sr = _stmt_get_data_prepare_ctx(stmt, args);
     if (sr != SQL_SUCCESS) return SQL_ERROR;
+
+    stmt->perf.bytes_copied += _tsdb_data_bytes(&ctx->tsdb);
   }
 
   if (ctx->TargetType != args->TargetType) {
@@ -2463,15 +2595,11 @@ static SQLRETURN _stmt_fetch_row(stmt_t *stmt)
   return stmt->base->fetch_row(stmt->base);
 }
 
-static SQLRETURN _stmt_fill_col(stmt_t *stmt, size_t i_row, size_t i_col)
+static void _stmt_fill_col_args(stmt_t *stmt, size_t i_row, size_t i_col, stmt_get_data_args_t *args)
 {
   descriptor_t *ARD = _stmt_ARD(stmt);
   desc_header_t *ARD_header = &ARD->header;
-
-  if (i_col >= ARD_header->DESC_COUNT) return SQL_SUCCESS;
-
   desc_record_t *ARD_record = ARD->records + i_col;
-  if (ARD_record->DESC_DATA_PTR == NULL) return SQL_SUCCESS;
 
   char *dest = _stmt_get_address(stmt, ARD_record->DESC_DATA_PTR, ARD_record->DESC_OCTET_LENGTH, i_row, ARD_header);
   SQLLEN *StrLenPtr = _stmt_get_address(stmt, ARD_record->DESC_OCTET_LENGTH_PTR, sizeof(SQLLEN), i_row, ARD_header);
@@ -2481,14 +2609,26 @@ static SQLRETURN _stmt_fill_col(stmt_t *stmt, size_t i_row, size_t i_col)
   SQLPOINTER     TargetValuePtr   = dest;
   SQLLEN         BufferLength     = ARD_record->DESC_OCTET_LENGTH;
 
-  stmt_get_data_args_t args = {
-    .Col_or_Param_Num           = (SQLUSMALLINT)i_col + 1,
-    .TargetType                 = TargetType,
-    .TargetValuePtr             = TargetValuePtr,
-    .BufferLength               = BufferLength,
-    .StrLenPtr                  = StrLenPtr,
-    .IndPtr                     = IndPtr,
-  };
+  args->Col_or_Param_Num           = (SQLUSMALLINT)i_col + 1;
+  args->TargetType                 = TargetType;
+  args->TargetValuePtr             = TargetValuePtr;
+  args->BufferLength               = BufferLength;
+  args->StrLenPtr                  = StrLenPtr;
+  args->IndPtr                     = IndPtr;
+}
+
+static SQLRETURN _stmt_fill_col(stmt_t *stmt, size_t i_row, size_t i_col)
+{
+  descriptor_t *ARD = _stmt_ARD(stmt);
+  desc_header_t *ARD_header = &ARD->header;
+
+  if (i_col >= ARD_header->DESC_COUNT) return SQL_SUCCESS;
+
+  desc_record_t *ARD_record = ARD->records + i_col;
+  if (ARD_record->DESC_DATA_PTR == NULL) return SQL_SUCCESS;
+
+  stmt_get_data_args_t args = {0};
+  _stmt_fill_col_args(stmt, i_row, i_col, &args);
 
   return _stmt_get_data_x(stmt, &args);
 }
@@ -2521,113 +2661,756 @@ static SQLRETURN _stmt_fill_row(stmt_t *stmt, size_t i_row)
   return with_info ? SQL_SUCCESS_WITH_INFO : SQL_SUCCESS;
 }
 
-static SQLRETURN _stmt_fetch_rows(stmt_t *stmt, const size_t row_array_size, size_t *nr_rows)
+// NOTE: below this, handing over to the pool costs more than converting on the calling thread alone
+#define STMT_FETCH_PARALLEL_MIN_ROWS            64
+
+// return 0 if the rowset is to be converted by _stmt_fetch_rows_parallel, -1 to stay serial
+static int _stmt_fetch_parallel_prepare(stmt_t *stmt, size_t row_array_size)
 {
-  SQLRETURN sr = SQL_SUCCESS;
-  SQLRETURN sr_row = SQL_ROW_SUCCESS;
+  stmt_fetch_t *fetch = &stmt->fetch;
+  fetch_pool_t *pool = stmt->conn->env->fetch_pool;
 
-  descriptor_t *IRD = _stmt_IRD(stmt);
-  desc_header_t *IRD_header = &IRD->header;
+  if (!pool) return -1;
+  if (row_array_size < STMT_FETCH_PARALLEL_MIN_ROWS) return -1;
+  // NOTE: cells are captured ahead of conversion, which holds only while the data stay in the current block of taosc
+  if (stmt->base != &stmt->tsdb_stmt.base) return -1;
+  if (tsdb_stmt_rows_in_block(&stmt->tsdb_stmt) < 0) return -1;
 
-  size_t i_row = 0;
+  descriptor_t *ARD = _stmt_ARD(stmt);
+  desc_header_t *ARD_header = &ARD->header;
 
-  *nr_rows = 0;
+  if (mem_keep(&fetch->cols, sizeof(size_t) * ARD->cap)) return -1;
+  size_t *cols = (size_t*)fetch->cols.base;
+  fetch->nr_cols = 0;
+  for (size_t i_col = 0; i_col < ARD->cap; ++i_col) {
+    if (i_col >= (size_t)ARD_header->DESC_COUNT) continue;
+    desc_record_t *ARD_record = ARD->records + i_col;
+    if (!ARD_record->bound) continue;
+    if (ARD_record->DESC_DATA_PTR == NULL) continue;
+    cols[fetch->nr_cols++] = i_col;
+  }
+  if (fetch->nr_cols == 0) return -1;
+
+  size_t nr_lanes = fetch_pool_threads(pool) + 1;
+  if (mem_keep(&fetch->cells, sizeof(stmt_fetch_cell_t) * row_array_size * fetch->nr_cols)) return -1;
+  if (mem_keep(&fetch->units, sizeof(stmt_fetch_unit_t) * fetch->nr_cols * nr_lanes)) return -1;
+
+  if (fetch->nr_lanes != nr_lanes) {
+    _stmt_fetch_release_lanes(fetch);
+    fetch->lanes = (stmt_t*)calloc(nr_lanes, sizeof(*fetch->lanes));
+    if (!fetch->lanes) return -1;
+    fetch->nr_lanes = nr_lanes;
+    for (size_t i=0; i<nr_lanes; ++i) {
+      stmt_t *lane = fetch->lanes + i;
+      // NOTE: no ownership of `conn`, which outlives the statement anyway
+      lane->conn = stmt->conn;
+      errs_init(&lane->errs);
+      lane->errs.connected_conn = stmt->conn;
+    }
+  }
 
-again:
+  return 0;
+}
 
-  sr = _stmt_fetch_row(stmt);
-  if (sr == SQL_NO_DATA) {
-    if (*nr_rows == 0) return SQL_NO_DATA;
-    return SQL_SUCCESS;
-  }
-  if (sr != SQL_SUCCESS) return SQL_ERROR;
+// convert a captured cell into the bound buffers of `stmt`, with `lane` in place of `stmt` for anything mutable
+static SQLRETURN _stmt_fetch_fill_cell(stmt_t *lane, stmt_t *stmt, size_t i_row, size_t i_col, const tsdb_data_t *tsdb)
+{
+  SQLRETURN sr = SQL_SUCCESS;
 
-  sr = _stmt_fill_row(stmt, i_row);
-  switch (sr) {
-    case SQL_SUCCESS:
-      sr_row = SQL_ROW_SUCCESS;
-      break;
-    case SQL_SUCCESS_WITH_INFO:
-      sr_row = SQL_ROW_SUCCESS_WITH_INFO;
-      break;
-    default:
-      sr_row = SQL_ROW_ERROR;
-      break;
-  }
+  stmt_get_data_args_t args = {0};
+  _stmt_fill_col_args(stmt, i_row, i_col, &args);
 
-  if (IRD_header->DESC_ARRAY_STATUS_PTR) {
-    IRD_header->DESC_ARRAY_STATUS_PTR[i_row] = sr_row;
-  }
+  get_data_ctx_t *ctx = &lane->get_data_ctx;
+  ctx->Col_or_Param_Num = args.Col_or_Param_Num;
+  ctx->TargetType       = args.TargetType;
+  ctx->tsdb             = *tsdb;
 
-  *nr_rows = ++i_row;
+  sr = _stmt_get_data_format_ctx(lane, &args);
+  if (sr == SQL_SUCCESS) {
+    lane->perf.bytes_copied += _tsdb_data_bytes(&ctx->tsdb);
+    sr = _stmt_get_data_copy(lane, &args);
+  } else {
+    sr = SQL_ERROR;
+  }
 
-  if (i_row < row_array_size) goto again;
+  _get_data_ctx_reset(ctx);
 
-  return SQL_SUCCESS;
+  return sr;
 }
 
-static SQLRETURN _stmt_fetch_x(stmt_t *stmt)
+static void _stmt_fetch_capture(stmt_t *stmt, size_t i_row)
 {
-  SQLRETURN sr = SQL_SUCCESS;
+  stmt_fetch_t *fetch = &stmt->fetch;
+  stmt_t *lane = fetch->lanes;
+  const size_t *cols = (const size_t*)fetch->cols.base;
+  stmt_fetch_cell_t *cells = (stmt_fetch_cell_t*)fetch->cells.base + i_row * fetch->nr_cols;
 
-  _get_data_ctx_reset(&stmt->get_data_ctx);
+  int failed = 0;
 
-  descriptor_t *IRD = _stmt_IRD(stmt);
-  desc_header_t *IRD_header = &IRD->header;
+  for (size_t k=0; k<fetch->nr_cols; ++k) {
+    stmt_fetch_cell_t *cell = cells + k;
+    memset(cell, 0, sizeof(*cell));
+    cell->sr = SQL_SUCCESS;
 
-  size_t row_array_size = _stmt_get_row_array_size(stmt);
-  if (row_array_size == 0) row_array_size = 1;
+    // NOTE: as _stmt_fill_row does, columns following the failed one are left untouched
+    if (failed) continue;
 
-  size_t nr_rows = 0;
-  sr = _stmt_fetch_rows(stmt, row_array_size, &nr_rows);
+    err_t *last = errs_last(&stmt->errs);
+    size_t count = stmt->errs.count;
 
-  if (IRD_header->DESC_ROWS_PROCESSED_PTR) *IRD_header->DESC_ROWS_PROCESSED_PTR = nr_rows;
+    SQLRETURN sr = stmt->base->get_data(stmt->base, (SQLUSMALLINT)cols[k] + 1, &cell->tsdb);
+    if (sr == SQL_SUCCESS) {
+      cell->pending = 1;
+      continue;
+    }
 
-  if (IRD_header->DESC_ARRAY_STATUS_PTR) {
-    for (size_t i=nr_rows; i<row_array_size; ++i) {
-      IRD_header->DESC_ARRAY_STATUS_PTR[i] = SQL_ROW_NOROW;
+    // NOTE: parked in the first lane, to be merged back in order along with the rest of the rowset
+    cell->sr      = SQL_ERROR;
+    cell->nr_errs = stmt->errs.count - count;
+    if (cell->nr_errs) {
+      cell->lane      = lane;
+      cell->first_err = errs_next(&stmt->errs, last);
+      errs_move(&lane->errs, &stmt->errs, cell->first_err, cell->nr_errs);
     }
+    failed = 1;
   }
-
-  if (sr == SQL_NO_DATA) return SQL_NO_DATA;
-  if (sr == SQL_SUCCESS) return SQL_SUCCESS;
-  if (sr == SQL_SUCCESS_WITH_INFO) return SQL_SUCCESS_WITH_INFO;
-  return SQL_ERROR;
 }
 
-static SQLRETURN _stmt_fetch(stmt_t *stmt)
+static void _stmt_fetch_task(void *arg, size_t i)
 {
-  _get_data_ctx_reset(&stmt->get_data_ctx);
+  stmt_t *stmt = (stmt_t*)arg;
+  stmt_fetch_t *fetch = &stmt->fetch;
+  stmt_t *lane = fetch->lanes + i;
+  const size_t *cols = (const size_t*)fetch->cols.base;
+  const stmt_fetch_unit_t *units = (const stmt_fetch_unit_t*)fetch->units.base;
+  stmt_fetch_cell_t *cells = (stmt_fetch_cell_t*)fetch->cells.base;
+
+  for (size_t u = i; u < fetch->nr_units; u += fetch->nr_tasks) {
+    const stmt_fetch_unit_t *unit = units + u;
+    for (size_t i_row = unit->from; i_row < unit->to; ++i_row) {
+      stmt_fetch_cell_t *cell = cells + i_row * fetch->nr_cols + unit->k;
+      if (!cell->pending) continue;
+
+      err_t *last = errs_last(&lane->errs);
+      size_t count = lane->errs.count;
+
+      cell->sr      = _stmt_fetch_fill_cell(lane, stmt, i_row, cols[unit->k], &cell->tsdb);
+      cell->pending = 0;
+      cell->nr_errs = lane->errs.count - count;
+      if (cell->nr_errs) {
+        cell->lane      = lane;
+        cell->first_err = errs_next(&lane->errs, last);
+      }
+    }
+  }
+}
 
+// split rows [from, to) into units, one per bound column, or one per lane for SQL_C_WCHAR columns
+static void _stmt_fetch_plan(stmt_t *stmt, size_t from, size_t to)
+{
+  stmt_fetch_t *fetch = &stmt->fetch;
   descriptor_t *ARD = _stmt_ARD(stmt);
-  desc_header_t *ARD_header = &ARD->header;
-
-  if (ARD_header->DESC_BIND_TYPE != SQL_BIND_BY_COLUMN) {
-    stmt_append_err(stmt, "HY000", 0, "General error:only `SQL_BIND_BY_COLUMN` is supported now");
-    return SQL_ERROR;
+  const size_t *cols = (const size_t*)fetch->cols.base;
+  stmt_fetch_unit_t *units = (stmt_fetch_unit_t*)fetch->units.base;
+
+  size_t nr_rows = to - from;
+
+  fetch->nr_units = 0;
+  for (size_t k=0; k<fetch->nr_cols; ++k) {
+    desc_record_t *ARD_record = ARD->records + cols[k];
+    size_t parts = 1;
+    // NOTE: iconv to UCS-2LE outweighs any other conversion by far, thus wide columns are split by rows as well
+    if (ARD_record->DESC_CONCISE_TYPE == SQL_C_WCHAR) parts = fetch->nr_lanes;
+    if (parts > nr_rows) parts = nr_rows;
+    size_t step = (nr_rows + parts - 1) / parts;
+    for (size_t i_row = from; i_row < to; i_row += step) {
+      stmt_fetch_unit_t *unit = units + fetch->nr_units++;
+      unit->k    = k;
+      unit->from = i_row;
+      unit->to   = (i_row + step < to) ? i_row + step : to;
+    }
   }
 
-  return _stmt_fetch_x(stmt);
+  fetch->nr_tasks = fetch->nr_units < fetch->nr_lanes ? fetch->nr_units : fetch->nr_lanes;
 }
 
-SQLRETURN stmt_fetch_scroll(stmt_t *stmt,
-    SQLSMALLINT   FetchOrientation,
-    SQLLEN        FetchOffset)
+// merge results of rows [from, to) in the very order _stmt_fill_row would have produced them
+static void _stmt_fetch_merge(stmt_t *stmt, size_t from, size_t to)
 {
-  _get_data_ctx_reset(&stmt->get_data_ctx);
+  stmt_fetch_t *fetch = &stmt->fetch;
+  stmt_fetch_cell_t *cells = (stmt_fetch_cell_t*)fetch->cells.base;
 
-  switch (FetchOrientation) {
-    case SQL_FETCH_NEXT:
-      (void)FetchOffset;
-      return _stmt_fetch(stmt);
+  descriptor_t *IRD = _stmt_IRD(stmt);
+  desc_header_t *IRD_header = &IRD->header;
+
+  for (size_t i_row = from; i_row < to; ++i_row) {
+    SQLUSMALLINT sr_row = SQL_ROW_SUCCESS;
+    int failed = 0;
+
+    for (size_t k=0; k<fetch->nr_cols; ++k) {
+      stmt_fetch_cell_t *cell = cells + i_row * fetch->nr_cols + k;
+      // NOTE: columns following the failed one were converted meanwhile, but their diagnostics are dropped
+      if (cell->nr_errs) errs_move(failed ? NULL : &stmt->errs, &cell->lane->errs, cell->first_err, cell->nr_errs);
+      if (failed) continue;
+      if (cell->sr == SQL_SUCCESS) continue;
+      if (cell->sr == SQL_SUCCESS_WITH_INFO) {
+        sr_row = SQL_ROW_SUCCESS_WITH_INFO;
+        continue;
+      }
+      sr_row = SQL_ROW_ERROR;
+      failed = 1;
+    }
+
+    if (IRD_header->DESC_ARRAY_STATUS_PTR) {
+      IRD_header->DESC_ARRAY_STATUS_PTR[i_row] = sr_row;
+    }
+  }
+
+  for (size_t i=0; i<fetch->nr_lanes; ++i) {
+    stmt_t *lane = fetch->lanes + i;
+    stmt_perf_add(&stmt->perf, &lane->perf);
+    memset(&lane->perf, 0, sizeof(lane->perf));
+  }
+}
+
+static void _stmt_fetch_flush(stmt_t *stmt, size_t from, size_t to)
+{
+  if (from == to) return;
+
+  _stmt_fetch_plan(stmt, from, to);
+  fetch_pool_run(stmt->conn->env->fetch_pool, _stmt_fetch_task, stmt, stmt->fetch.nr_tasks);
+  _stmt_fetch_merge(stmt, from, to);
+}
+
+// same as _stmt_fetch_rows, except that cells are captured row by row on the calling thread,
+// then converted column by column on the fetch pool, whenever the current block of taosc is about to be replaced
+static SQLRETURN _stmt_fetch_rows_parallel(stmt_t *stmt, const size_t row_array_size, size_t *nr_rows)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+
+  stmt_t *lane = stmt->fetch.lanes;
+
+  size_t from  = 0;
+  size_t i_row = 0;
+
+  *nr_rows = 0;
+
+  while (i_row < row_array_size) {
+    if (i_row > from && tsdb_stmt_rows_in_block(&stmt->tsdb_stmt) == 0) {
+      _stmt_fetch_flush(stmt, from, i_row);
+      from = i_row;
+    }
+
+    err_t *last = errs_last(&stmt->errs);
+    size_t count = stmt->errs.count;
+
+    sr = _stmt_fetch_row(stmt);
+    if (sr == SQL_NO_DATA) break;
+    if (sr != SQL_SUCCESS) {
+      // NOTE: diagnostics of rows fetched so far go first
+      size_t n = stmt->errs.count - count;
+      err_t *first = errs_next(&stmt->errs, last);
+      errs_move(&lane->errs, &stmt->errs, first, n);
+      _stmt_fetch_flush(stmt, from, i_row);
+      errs_move(&stmt->errs, &lane->errs, first, n);
+      return SQL_ERROR;
+    }
+
+    _stmt_fetch_capture(stmt, i_row);
+
+    *nr_rows = ++i_row;
+  }
+
+  _stmt_fetch_flush(stmt, from, i_row);
+
+  if (*nr_rows == 0) return SQL_NO_DATA;
+  return SQL_SUCCESS;
+}
+
+static SQLRETURN _stmt_fetch_rows(stmt_t *stmt, const size_t row_array_size, size_t *nr_rows)
+{
+  if (_stmt_fetch_parallel_prepare(stmt, row_array_size) == 0) {
+    return _stmt_fetch_rows_parallel(stmt, row_array_size, nr_rows);
+  }
+
+  SQLRETURN sr = SQL_SUCCESS;
+  SQLRETURN sr_row = SQL_ROW_SUCCESS;
+
+  descriptor_t *IRD = _stmt_IRD(stmt);
+  desc_header_t *IRD_header = &IRD->header;
+
+  size_t i_row = 0;
+
+  *nr_rows = 0;
+
+again:
+
+  sr = _stmt_fetch_row(stmt);
+  if (sr == SQL_NO_DATA) {
+    if (*nr_rows == 0) return SQL_NO_DATA;
+    return SQL_SUCCESS;
+  }
+  if (sr != SQL_SUCCESS) return SQL_ERROR;
+
+  sr = _stmt_fill_row(stmt, i_row);
+  switch (sr) {
+    case SQL_SUCCESS:
+      sr_row = SQL_ROW_SUCCESS;
+      break;
+    case SQL_SUCCESS_WITH_INFO:
+      sr_row = SQL_ROW_SUCCESS_WITH_INFO;
+      break;
     default:
-      stmt_append_err_format(stmt, "HY000", 0,
-          "General error:[%s] not implemented yet",
+      sr_row = SQL_ROW_ERROR;
+      break;
+  }
+
+  if (IRD_header->DESC_ARRAY_STATUS_PTR) {
+    IRD_header->DESC_ARRAY_STATUS_PTR[i_row] = sr_row;
+  }
+
+  *nr_rows = ++i_row;
+
+  if (i_row < row_array_size) goto again;
+
+  return SQL_SUCCESS;
+}
+
+static int _stmt_is_static(stmt_t *stmt)
+{
+  // NOTE: a result served from the result cache is cached as well, but remains forward-only unless asked otherwise
+  return stmt->cursor_type == SQL_CURSOR_STATIC &&
+    stmt->base == &stmt->tsdb_stmt.base && tsdb_stmt_is_cached(&stmt->tsdb_stmt);
+}
+
+static SQLRETURN _stmt_fetch_x(stmt_t *stmt)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+
+  _get_data_ctx_reset(&stmt->get_data_ctx);
+
+  descriptor_t *IRD = _stmt_IRD(stmt);
+  desc_header_t *IRD_header = &IRD->header;
+
+  size_t row_array_size = _stmt_get_row_array_size(stmt);
+  if (row_array_size == 0) row_array_size = 1;
+
+  size_t rows_wanted = row_array_size;
+  // NOTE: static cursor stops caching at SQL_ATTR_MAX_ROWS instead
+  if (stmt->max_rows && !_stmt_is_static(stmt)) {
+    if (stmt->rows_returned >= stmt->max_rows) {
+      // NOTE: no more blocks shall be pulled from the server, whereas fields remain valid for SQLDescribeCol and alike
+      if (stmt->base == &stmt->tsdb_stmt.base) tsdb_stmt_stop(&stmt->tsdb_stmt);
+      if (IRD_header->DESC_ROWS_PROCESSED_PTR) *IRD_header->DESC_ROWS_PROCESSED_PTR = 0;
+      return SQL_NO_DATA;
+    }
+    if (rows_wanted > stmt->max_rows - stmt->rows_returned) rows_wanted = stmt->max_rows - stmt->rows_returned;
+  }
+
+  if (stmt->base == &stmt->topic.base) topic_fetch_begin(&stmt->topic);
+
+  // NOTE: driver time = elapsed - time spent within taosc meanwhile
+  int64_t t0       = tod_now_us();
+  int64_t taosc_us = stmt->perf.taosc_us;
+
+  size_t nr_rows = 0;
+  sr = _stmt_fetch_rows(stmt, rows_wanted, &nr_rows);
+
+  stmt->rows_returned     += nr_rows;
+  stmt->perf.rows_fetched += nr_rows;
+  stmt->perf.convert_us   += tod_now_us() - t0 - (stmt->perf.taosc_us - taosc_us);
+  TOD_TRACEF(TOD_TRACE_FETCH, "stmt:%p, row_array_size:%zd => rows:%zd, sr:%d", stmt, row_array_size, nr_rows, sr);
+
+  if (IRD_header->DESC_ROWS_PROCESSED_PTR) *IRD_header->DESC_ROWS_PROCESSED_PTR = nr_rows;
+
+  if (IRD_header->DESC_ARRAY_STATUS_PTR) {
+    for (size_t i=nr_rows; i<row_array_size; ++i) {
+      IRD_header->DESC_ARRAY_STATUS_PTR[i] = SQL_ROW_NOROW;
+    }
+  }
+
+  if (sr == SQL_NO_DATA) return SQL_NO_DATA;
+  if (sr == SQL_SUCCESS) return SQL_SUCCESS;
+  if (sr == SQL_SUCCESS_WITH_INFO) return SQL_SUCCESS_WITH_INFO;
+  return SQL_ERROR;
+}
+
+static SQLRETURN _stmt_fetch(stmt_t *stmt)
+{
+  _get_data_ctx_reset(&stmt->get_data_ctx);
+
+  descriptor_t *ARD = _stmt_ARD(stmt);
+  desc_header_t *ARD_header = &ARD->header;
+
+  if (ARD_header->DESC_BIND_TYPE != SQL_BIND_BY_COLUMN) {
+    stmt_append_err(stmt, "HY000", 0, "General error:only `SQL_BIND_BY_COLUMN` is supported now");
+    return SQL_ERROR;
+  }
+
+  return _stmt_fetch_x(stmt);
+}
+
+void stmt_cancel_with(stmt_t *stmt, stmt_cancel_reason_t reason)
+{
+  pthread_mutex_lock(&stmt->cancel_mutex);
+  if (_stmt_is_busy(stmt)) {
+    atomic_store(&stmt->cancelled, reason);
+    TAOS_RES *res = stmt->running_res;
+    if (!res && stmt->async.op == STMT_ASYNC_FETCH) res = stmt->tsdb_stmt.res.res;
+    // NOTE: a result set is stopped in place, otherwise taos_query/taos_stmt_execute is interrupted by taos_kill_query,
+    //       which taosc applies to the whole connection, thus not issued while other statements are busy on it.
+    //       known limitation: taosc has no way to interrupt a single statement before its result set comes back,
+    //       in which case the cancel takes effect as soon as taosc returns
+    if (res) {
+      CALL_taos_stop_query(res);
+    } else if (!conn_kill_query_if_alone(stmt->conn)) {
+      OD("stmt[%p]:other statements are busy on the connection, cancel deferred until taosc returns", stmt);
+    }
+  }
+  pthread_mutex_unlock(&stmt->cancel_mutex);
+}
+
+SQLRETURN stmt_cancel(stmt_t *stmt)
+{
+  // NOTE: ODBC 3.x, no effect if no function is running on `stmt`
+  stmt_cancel_with(stmt, STMT_CANCEL_APP);
+  return SQL_SUCCESS;
+}
+
+void stmt_set_running_res(stmt_t *stmt, TAOS_RES *res)
+{
+  pthread_mutex_lock(&stmt->cancel_mutex);
+  if (stmt->running) stmt->running_res = res;
+  pthread_mutex_unlock(&stmt->cancel_mutex);
+}
+
+int stmt_is_cancelled(stmt_t *stmt)
+{
+  return atomic_load(&stmt->cancelled) != STMT_CANCEL_NONE;
+}
+
+static void _stmt_call_begin(stmt_t *stmt)
+{
+  pthread_mutex_lock(&stmt->cancel_mutex);
+  int was_busy = _stmt_is_busy(stmt);
+  int outermost = (stmt->running++ == 0);
+  if (!was_busy) conn_set_busy(stmt->conn, 1);
+  if (outermost) {
+    stmt->running_res = NULL;
+    // NOTE: a cancel issued while an asynchronous function is pending is reported when it's resumed
+    if (stmt->async.op == STMT_ASYNC_NONE) atomic_store(&stmt->cancelled, STMT_CANCEL_NONE);
+  }
+  pthread_mutex_unlock(&stmt->cancel_mutex);
+
+  if (outermost && stmt->query_timeout > 0) {
+    if (conn_timer_arm(stmt->conn, stmt, (int64_t)stmt->query_timeout * 1000 * 1000)) {
+      OW("stmt[%p]:failed to arm query timeout of [%zd] seconds", stmt, (size_t)stmt->query_timeout);
+    } else {
+      stmt->timer_armed = 1;
+    }
+  }
+}
+
+static SQLRETURN _stmt_call_end(stmt_t *stmt, SQLRETURN sr)
+{
+  pthread_mutex_lock(&stmt->cancel_mutex);
+  int outermost = (--stmt->running == 0);
+  if (outermost) stmt->running_res = NULL;
+  if (!_stmt_is_busy(stmt)) conn_set_busy(stmt->conn, 0);
+  pthread_mutex_unlock(&stmt->cancel_mutex);
+
+  if (!outermost) return sr;
+
+  // NOTE: disarm without holding cancel_mutex, the timer thread locks them in reverse order
+  if (stmt->timer_armed) {
+    conn_timer_disarm(stmt->conn, stmt);
+    stmt->timer_armed = 0;
+  }
+
+  if (sr == SQL_STILL_EXECUTING) return sr;
+
+  switch (atomic_load(&stmt->cancelled)) {
+    case STMT_CANCEL_APP:
+      stmt_append_err(stmt, "HY008", 0, "Operation canceled");
+      return SQL_ERROR;
+    case STMT_CANCEL_TIMEOUT:
+      stmt_append_err_format(stmt, "HYT00", 0, "Timeout expired:query timeout of [%zd] seconds", (size_t)stmt->query_timeout);
+      return SQL_ERROR;
+    default:
+      return sr;
+  }
+}
+
+#define ROWSET_BEFORE_START         0
+#define ROWSET_AFTER_END           -1
+
+// NOTE: rowset positioning follows the table of `SQLFetchScroll` in ODBC reference,
+//       LastResultRow is not known until all rows are cached, which is deferred as much as possible
+static SQLRETURN _stmt_fetch_static(stmt_t *stmt,
+    SQLSMALLINT   FetchOrientation,
+    SQLLEN        FetchOffset)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+
+  tsdb_stmt_t *tsdb_stmt = &stmt->tsdb_stmt;
+
+  size_t row_array_size = _stmt_get_row_array_size(stmt);
+  if (row_array_size == 0) row_array_size = 1;
+  const SQLLEN size  = (SQLLEN)row_array_size;
+  const SQLLEN prev  = stmt->rowset_nr ? (SQLLEN)stmt->rowset_nr : size;
+  SQLLEN       start = stmt->rowset_start;
+
+  size_t last         = 0;
+  SQLLEN target       = ROWSET_BEFORE_START;
+  int    before_first = 0;
+
+  switch (FetchOrientation) {
+    case SQL_FETCH_NEXT:
+      if (start == ROWSET_AFTER_END)         target = ROWSET_AFTER_END;
+      else if (start == ROWSET_BEFORE_START) target = 1;
+      else                                   target = start + prev;
+      break;
+    case SQL_FETCH_PRIOR:
+      if (start == ROWSET_BEFORE_START || start == 1) break;
+      if (start == ROWSET_AFTER_END) {
+        sr = tsdb_stmt_cache_rows(tsdb_stmt, SIZE_MAX, &last);
+        if (sr != SQL_SUCCESS) return SQL_ERROR;
+        start = (SQLLEN)last + 1;
+      }
+      if (start <= size) {
+        target = 1;
+        before_first = 1;
+      } else {
+        target = start - size;
+      }
+      break;
+    case SQL_FETCH_RELATIVE:
+      if (start == ROWSET_BEFORE_START) {
+        if (FetchOffset > 0) target = FetchOffset;
+        break;
+      }
+      if (start == ROWSET_AFTER_END) {
+        if (FetchOffset >= 0) {
+          target = ROWSET_AFTER_END;
+          break;
+        }
+        sr = tsdb_stmt_cache_rows(tsdb_stmt, SIZE_MAX, &last);
+        if (sr != SQL_SUCCESS) return SQL_ERROR;
+        start = (SQLLEN)last + 1;
+      }
+      if (start + FetchOffset >= 1) {
+        target = start + FetchOffset;
+      } else if (start > 1 && -FetchOffset <= size) {
+        target = 1;
+        before_first = 1;
+      }
+      break;
+    case SQL_FETCH_ABSOLUTE:
+      if (FetchOffset >= 0) {
+        target = FetchOffset;
+        break;
+      }
+      sr = tsdb_stmt_cache_rows(tsdb_stmt, SIZE_MAX, &last);
+      if (sr != SQL_SUCCESS) return SQL_ERROR;
+      if (-FetchOffset <= (SQLLEN)last) {
+        target = (SQLLEN)last + FetchOffset + 1;
+      } else if (-FetchOffset <= size) {
+        target = 1;
+        before_first = 1;
+      }
+      break;
+    case SQL_FETCH_FIRST:
+      target = 1;
+      break;
+    case SQL_FETCH_LAST:
+      sr = tsdb_stmt_cache_rows(tsdb_stmt, SIZE_MAX, &last);
+      if (sr != SQL_SUCCESS) return SQL_ERROR;
+      if (last == 0)                 target = ROWSET_AFTER_END;
+      else if ((SQLLEN)last >= size) target = (SQLLEN)last - size + 1;
+      else                           target = 1;
+      break;
+    case SQL_FETCH_BOOKMARK:
+      stmt_append_err(stmt, "HYC00", 0, "Optional feature not implemented:bookmarks not supported yet");
+      return SQL_ERROR;
+    default:
+      stmt_append_err_format(stmt, "HY106", 0, "Fetch type out of range:[%s]", sql_fetch_orientation(FetchOrientation));
+      return SQL_ERROR;
+  }
+
+  if (target > 0) {
+    sr = tsdb_stmt_cache_rows(tsdb_stmt, (size_t)target, &last);
+    if (sr != SQL_SUCCESS) return SQL_ERROR;
+    if ((size_t)target > last) target = ROWSET_AFTER_END;
+  }
+
+  stmt->rowset_start = target;
+  stmt->rowset_nr    = row_array_size;
+
+  if (target <= 0) {
+    descriptor_t *IRD = _stmt_IRD(stmt);
+    if (IRD->header.DESC_ROWS_PROCESSED_PTR) *IRD->header.DESC_ROWS_PROCESSED_PTR = 0;
+    return SQL_NO_DATA;
+  }
+
+  tsdb_stmt_cache_rewind(tsdb_stmt, (size_t)target - 1);
+  sr = _stmt_fetch(stmt);
+  if (before_first && (sr == SQL_SUCCESS || sr == SQL_SUCCESS_WITH_INFO)) {
+    stmt_append_err(stmt, "01S06", 0, "Attempt to fetch before the result set returned the first rowset");
+    sr = SQL_SUCCESS_WITH_INFO;
+  }
+
+  return sr;
+}
+
+static SQLRETURN _stmt_fetch_scroll(stmt_t *stmt,
+    SQLSMALLINT   FetchOrientation,
+    SQLLEN        FetchOffset)
+{
+  _get_data_ctx_reset(&stmt->get_data_ctx);
+
+  if (_stmt_is_static(stmt)) return _stmt_fetch_static(stmt, FetchOrientation, FetchOffset);
+
+  switch (FetchOrientation) {
+    case SQL_FETCH_NEXT:
+      (void)FetchOffset;
+      return _stmt_fetch(stmt);
+    default:
+      stmt_append_err_format(stmt, "HY106", 0,
+          "Fetch type out of range:[%s] not supported by forward-only cursor",
           sql_fetch_orientation(FetchOrientation));
       return SQL_ERROR;
   }
 }
 
+int stmt_async_enabled(stmt_t *stmt)
+{
+  // NOTE: coalesced inserts and parameterized executes complete synchronously, which ODBC allows
+  return stmt->async.enable == SQL_ASYNC_ENABLE_ON && stmt->coalesced.nr == 0;
+}
+
+static void _stmt_async_start(stmt_t *stmt, stmt_async_op_t op)
+{
+  stmt->async.res  = NULL;
+  stmt->async.code = 0;
+  atomic_store(&stmt->async.done, 0);
+  _stmt_async_set_op(stmt, op);
+}
+
+static void _stmt_async_complete(stmt_t *stmt, TAOS_RES *res, int code)
+{
+  stmt_async_t *async = &stmt->async;
+
+  // NOTE: `stmt` might be resumed and freed by the application once `done` is set, thus nothing to touch afterwards
+  async->res  = res;
+  async->code = code;
+  atomic_store(&async->done, 1);
+}
+
+static void _stmt_async_on_query(void *param, TAOS_RES *res, int code)
+{
+  _stmt_async_complete((stmt_t*)param, res, code);
+}
+
+static void _stmt_async_on_fetch(void *param, TAOS_RES *res, int nr_rows)
+{
+  (void)res;
+  _stmt_async_complete((stmt_t*)param, NULL, nr_rows);
+}
+
+const char* stmt_max_rows_sql(stmt_t *stmt, const sqlc_tsdb_t *sqlc_tsdb)
+{
+  const char *sql = sqlc_tsdb->tsdb;
+  if (stmt->max_rows == 0) return sql;
+
+  size_t start = 0, end = 0;
+  int64_t rows = -1;
+  if (tod_parse_plain_select(sql, sqlc_tsdb->tsdb_bytes, &start, &end, &rows)) return sql;
+  if (rows >= 0 && (uint64_t)rows <= (uint64_t)stmt->max_rows) return sql;
+
+  // NOTE: either tighten the row count of the top-level LIMIT, or append one
+  char digits[64];
+  int n = snprintf(digits, sizeof(digits), "%s%" PRIu64 "", rows < 0 ? " LIMIT " : "", (uint64_t)stmt->max_rows);
+  size_t tail = sqlc_tsdb->tsdb_bytes - end;
+
+  mem_t *mem = &stmt->max_rows_sql;
+  if (mem_keep(mem, start + (size_t)n + tail + 1)) return sql;
+  char *p = (char*)mem->base;
+  memcpy(p, sql, start);
+  memcpy(p + start, digits, (size_t)n);
+  memcpy(p + start + n, sql + end, tail);
+  p[start + n + tail] = '\0';
+  mem->nr = start + n + tail;
+
+  TOD_TRACEF(TOD_TRACE_TAOSC, "stmt:%p, max_rows:%zd => %s", stmt, (size_t)stmt->max_rows, p);
+  return p;
+}
+
+SQLRETURN stmt_async_query(stmt_t *stmt, const char *sql)
+{
+  _stmt_async_start(stmt, STMT_ASYNC_QUERY);
+  CALL_taos_query_a(stmt->conn->taos, sql, _stmt_async_on_query, stmt);
+  return SQL_STILL_EXECUTING;
+}
+
+static SQLRETURN _stmt_fetch_scroll_async(stmt_t *stmt,
+    SQLSMALLINT   FetchOrientation,
+    SQLLEN        FetchOffset)
+{
+  TAOS_RES *res = NULL;
+  if (stmt->async.enable == SQL_ASYNC_ENABLE_ON && stmt->base == &stmt->tsdb_stmt.base &&
+      (stmt->max_rows == 0 || stmt->rows_returned < stmt->max_rows)) {
+    // NOTE: only at rowset boundary, a block used up in the middle of a rowset is fetched synchronously
+    res = tsdb_stmt_block_needed(&stmt->tsdb_stmt);
+  }
+  if (!res) return _stmt_fetch_scroll(stmt, FetchOrientation, FetchOffset);
+
+  stmt->async.orientation = FetchOrientation;
+  stmt->async.offset      = FetchOffset;
+  _stmt_async_start(stmt, STMT_ASYNC_FETCH);
+  CALL_taos_fetch_rows_a(res, _stmt_async_on_fetch, stmt);
+  return SQL_STILL_EXECUTING;
+}
+
+static SQLRETURN _stmt_async_resume(stmt_t *stmt)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+  stmt_async_t *async = &stmt->async;
+
+  if (!atomic_load(&async->done)) return SQL_STILL_EXECUTING;
+
+  stmt_async_op_t op = async->op;
+  TAOS_RES *res = async->res;
+  int code = async->code;
+  async->res = NULL;
+  atomic_store(&async->done, 0);
+  _stmt_async_set_op(stmt, STMT_ASYNC_NONE);
+
+  switch (op) {
+    case STMT_ASYNC_QUERY:
+      sr = tsdb_stmt_query_done(&stmt->tsdb_stmt, res, code);
+      if (sr == SQL_ERROR) return SQL_ERROR;
+      return _stmt_fill_IRD(stmt);
+    case STMT_ASYNC_FETCH:
+      sr = tsdb_stmt_block_done(&stmt->tsdb_stmt, code);
+      if (sr == SQL_ERROR) return SQL_ERROR;
+      return _stmt_fetch_scroll(stmt, async->orientation, async->offset);
+    default:
+      stmt_append_err(stmt, "HY010", 0, "Function sequence error:no asynchronous function in progress");
+      return SQL_ERROR;
+  }
+}
+
+SQLRETURN stmt_fetch_scroll(stmt_t *stmt,
+    SQLSMALLINT   FetchOrientation,
+    SQLLEN        FetchOffset)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+  _stmt_call_begin(stmt);
+  if (stmt->async.op != STMT_ASYNC_NONE) sr = _stmt_async_resume(stmt);
+  else                                   sr = _stmt_fetch_scroll_async(stmt, FetchOrientation, FetchOffset);
+  return _stmt_call_end(stmt, sr);
+}
+
 SQLRETURN stmt_fetch(stmt_t *stmt)
 {
   return stmt_fetch_scroll(stmt, SQL_FETCH_NEXT, 0);
@@ -2679,39 +3462,29 @@ SQLRETURN stmt_describe_param(
   return _stmt_describe_param(stmt, ParameterNumber, DataTypePtr, ParameterSizePtr, DecimalDigitsPtr, NullablePtr);
 }
 
-static SQLRETURN _stmt_sql_c_char_to_tsdb_timestamp(stmt_t *stmt, const char *s, int64_t *timestamp)
+static SQLRETURN _stmt_sql_c_char_to_tsdb_timestamp(stmt_t *stmt, const char *s, size_t len, int64_t *timestamp)
 {
-  char *end;
-  errno = 0;
-  long long v = strtoll(s, &end, 0);
-  int e = errno;
-  if (e == ERANGE && (v == LONG_MAX || v == LONG_MIN)) {
+  const char *end = NULL;
+  int64_t v = 0;
+  int r = tod_str_to_i64(s, len, &v, &end);
+  if (r == -2) {
     stmt_append_err_format(stmt, "22008", 0,
-        "Datetime field overflow:timestamp is required, but got ==[%s]==", s);
-    stmt_append_err_format(stmt, "HY000", e,
-        "General error:[strtol]%s", strerror(e));
+        "Datetime field overflow:timestamp is required, but got ==[%.*s]==", (int)len, s);
     return SQL_ERROR;
   }
-  if (e != 0) {
+  if (r && end == s) {
     stmt_append_err_format(stmt, "22007", 0,
-        "Invalid datetime format:timestamp is required, but got ==[%s]==", s);
-    stmt_append_err_format(stmt, "HY000", e,
-        "General error:[strtol]%s", strerror(e));
-    return SQL_ERROR;
-  }
-  if (end == s) {
-    stmt_append_err_format(stmt, "22007", 0,
-        "Invalid datetime format:timestamp is required, but got ==[%s]==", s);
-    stmt_append_err_format(stmt, "HY000", e,
+        "Invalid datetime format:timestamp is required, but got ==[%.*s]==", (int)len, s);
+    stmt_append_err(stmt, "HY000", 0,
         "General error:no digits at all");
     return SQL_ERROR;
   }
-  if (end && *end) {
+  if (r) {
     stmt_append_err_format(stmt, "22007", 0,
-        "Invalid datetime format:timestamp is required, but got ==[%s]==", s);
-    stmt_append_err_format(stmt, "HY000", e,
-        "General error:string following digits[%s]",
-        end);
+        "Invalid datetime format:timestamp is required, but got ==[%.*s]==", (int)len, s);
+    stmt_append_err_format(stmt, "HY000", 0,
+        "General error:string following digits[%.*s]",
+        (int)(len - (size_t)(end - s)), end);
     return SQL_ERROR;
   }
 
@@ -2726,81 +3499,42 @@ static SQLRETURN _stmt_conv_sql_c_char_to_tsdb_timestamp_x(stmt_t *stmt, const c
   int64_t v = 0;
   // OW("len:%zd", len);
 
-  const char *p;
-  const char *format = "%Y-%m-%d %H:%M:%S";
-  struct tm t = {0};
-  time_t tt;
-  p = tod_strptime(src, format, &t);
-  tt = mktime(&t);
-  v = tt;
-  if (!p) {
+  tod_ts_t ts = {0};
+  int r = tod_parse_iso8601(src, len, tls_get_tz_cache(), &ts);
+  if (r == -1) {
     // TODO: precision
-    sr = _stmt_sql_c_char_to_tsdb_timestamp(stmt, src, &v);
+    sr = _stmt_sql_c_char_to_tsdb_timestamp(stmt, src, len, &v);
     if (sr == SQL_ERROR) return SQL_ERROR;
-  } else if (*p) {
-    if (*p != '.') {
-      stmt_append_err_format(stmt, "22007", 0,
-          "Invalid datetime format:timestamp is required, but got ==[%.*s]==", (int)len, src);
-      return SQL_ERROR;
-    }
-    int n = (int)(len - (p-src));
-    if (n == 4) {
-      if (precision != 0) {
-        stmt_append_err_format(stmt, "22007", 0,
-            "Invalid datetime format:`ms` timestamp is required, but got ==[%.*s]==", (int)len, src);
-        return SQL_ERROR;
-      }
-      char *end = NULL;
-      long int x = strtol(p+1, &end, 10);
-      if (end && end-p!=4) {
-        stmt_append_err_format(stmt, "22007", 0,
-            "Invalid datetime format:`ms` timestamp is required, but got ==[%.*s]==", (int)len, src);
-        return SQL_ERROR;
-      }
-      v *= 1000;
-      v += x;
-    } else if (n == 7) {
-      if (precision != 1) {
-        stmt_append_err_format(stmt, "22007", 0,
-            "Invalid datetime format:`us` timestamp is required, but got ==[%.*s]==", (int)len, src);
-        return SQL_ERROR;
-      }
-      char *end = NULL;
-      long int x = strtol(p+1, &end, 10);
-      if (end && end-p!=7) {
-        stmt_append_err_format(stmt, "22007", 0,
-            "Invalid datetime format:`us` timestamp is required, but got ==[%.*s]==", (int)len, src);
-        return SQL_ERROR;
-      }
-      v *= 1000000;
-      v += x;
-    } else if (n == 10) {
-      if (precision != 1) {
-        stmt_append_err_format(stmt, "22007", 0,
-            "Invalid datetime format:`ns` timestamp is required, but got ==[%.*s]==", (int)len, src);
-        return SQL_ERROR;
-      }
-      char *end = NULL;
-      long int x = strtol(p+1, &end, 10);
-      if (end && end-p!=10) {
-        stmt_append_err_format(stmt, "22007", 0,
-            "Invalid datetime format:`ns` timestamp is required, but got ==[%.*s]==", (int)len, src);
-        return SQL_ERROR;
-      }
-      v *= 1000000000;
-      v += x;
-    } else {
-      stmt_append_err_format(stmt, "22007", 0,
-          "Invalid datetime format:timestamp is required, but got ==[%.*s]==, precision:%d;n:%d", (int)len, src, precision,n);
-      return SQL_ERROR;
-    }
-  } else {
-    // TODO: precision
+    *dst = v;
+    return SQL_SUCCESS;
+  }
+  if (r) {
     stmt_append_err_format(stmt, "22007", 0,
         "Invalid datetime format:timestamp is required, but got ==[%.*s]==", (int)len, src);
     return SQL_ERROR;
   }
 
+  const char *unit   = NULL;
+  int         digits = 0;
+  int64_t     scale  = 0;
+  switch (precision) {
+    case 0: unit = "ms"; digits = 3; scale = 1000;       break;
+    case 1: unit = "us"; digits = 6; scale = 1000000;    break;
+    case 2: unit = "ns"; digits = 9; scale = 1000000000; break;
+    default:
+      stmt_append_err_format(stmt, "HY000", 0,
+          "General error:bad tsdb_timestamp precision:%d", precision);
+      return SQL_ERROR;
+  }
+
+  if (ts.frac_digits > digits) {
+    stmt_append_err_format(stmt, "22007", 0,
+        "Invalid datetime format:`%s` timestamp is required, but got ==[%.*s]==", unit, (int)len, src);
+    return SQL_ERROR;
+  }
+
+  v = ts.sec * scale + ts.nsec / (1000000000 / scale);
+
   *dst = v;
   return SQL_SUCCESS;
 }
@@ -2838,6 +3572,7 @@ static SQLRETURN _stmt_cache_and_parse(stmt_t *stmt, sqls_parser_param_t *param,
 
   mem_reset(&stmt->raw);
   _sqls_reset(&stmt->sqls);
+  _coalesced_inserts_reset(&stmt->coalesced);
 
   r = mem_keep(&stmt->raw, len + 1);
   if (r) {
@@ -2906,9 +3641,9 @@ static SQLRETURN _stmt_get_next_sql(stmt_t *stmt)
   const char *start = sqlc_tsdb->tsdb;
   const char *end   = sqlc_tsdb->tsdb + sqlc_tsdb->tsdb_bytes;
   if (end > start && start[0] == '!') {
-    stmt->tsdb_stmt.is_topic = 1;
+    stmt->tsdb_stmt.is_ext = 1;
   } else {
-    stmt->tsdb_stmt.is_topic = 0;
+    stmt->tsdb_stmt.is_ext = 0;
   }
 
   return SQL_SUCCESS;
@@ -3085,68 +3820,30 @@ static SQLRETURN _stmt_param_copy_to_sql_timestamp(stmt_t *stmt, const char *src
 {
   SQLRETURN sr = SQL_SUCCESS;
 
-  char buf[1024];
-  int n = snprintf(buf, sizeof(buf), "%.*s", (int)len, src);
-  if (n < 0 || (size_t)n >= sizeof(buf)) {
-    stmt_append_err_format(stmt, "22007", 0,
-        "Invalid datetime format:timestamp is too long, but got ==[%.*s]==", (int)len, src);
-    return SQL_ERROR;
-  }
-  src = buf;
-  len = (size_t)n;
-
   sql_data_t    *data       = &param_state->sql_data;
 
   data->type = SQL_TYPE_TIMESTAMP;
 
-  const char *p;
-  const char *format = "%Y-%m-%d %H:%M:%S";
-  struct tm t = {0};
-  p = tod_strptime(src, format, &t);
-  if (!p) {
+  tod_ts_t ts = {0};
+  int r = tod_parse_iso8601(src, len, tls_get_tz_cache(), &ts);
+  if (r == -1) {
     int64_t v = 0;
-    sr = _stmt_sql_c_char_to_tsdb_timestamp(stmt, src, &v);
+    sr = _stmt_sql_c_char_to_tsdb_timestamp(stmt, src, len, &v);
     if (sr == SQL_ERROR) return SQL_ERROR;
     data->ts.i64 = v;
     data->ts.is_i64 = 1;
     return SQL_SUCCESS;
   }
-  if (*p && *p != '.') {
+  if (r) {
     stmt_append_err_format(stmt, "22007", 0,
         "Invalid datetime format:timestamp is required, but got ==[%.*s]==", (int)len, src);
     return SQL_ERROR;
   }
 
-  data->ts.sec = (int64_t)mktime(&t);
-  data->ts.nsec = 0;
+  data->ts.sec = ts.sec;
+  data->ts.nsec = ts.nsec;
   data->ts.is_i64 = 0;
 
-  if (!p || !*p) return SQL_SUCCESS;
-
-  // TODO: precision
-  n = (int)(len - (p-src));
-  if (n<0 || n>9) {
-    stmt_append_err_format(stmt, "22007", 0,
-        "Invalid datetime format:timestamp is required, but got ==[%.*s]==", (int)len, src);
-    return SQL_ERROR;
-  }
-
-  char *end = NULL;
-  int64_t x = strtol(p+1, &end, 10);
-  if (end && *end) {
-    stmt_append_err_format(stmt, "22007", 0,
-        "Invalid datetime format:`ms` timestamp is required, but got ==[%.*s]==, unexpected [0x%02x] @ %zd", (int)len, src, (unsigned char)*end, (size_t)(end - src));
-    return SQL_ERROR;
-  }
-  if (x < 0) {
-    stmt_append_err_format(stmt, "22007", 0,
-        "Invalid datetime format:`ms` timestamp is required, but got ==[%.*s]==", (int)len, src);
-    return SQL_ERROR;
-  }
-  while (n++<=9) x *= 10;
-
-  data->ts.nsec = x;
-
   return SQL_SUCCESS;
 }
 
@@ -3306,27 +4003,19 @@ static SQLRETURN _stmt_param_check_sqlc_char_sql_bigint(stmt_t *stmt, param_stat
   const char *s = param_state->sqlc_data.str.str;
   size_t      n = param_state->sqlc_data.str.len;
 
-  mem_t *mem = &param_state->tmp;
-
-  r = mem_copy_str(mem, s, n);
-  if (r) {
-    stmt_oom(stmt);
-    return SQL_ERROR;
-  }
-
-  char *end = NULL;
-  long long ll = strtoll((const char*)mem->base, &end, 0);
-  int e = errno;
-  if (end) {
+  const char *end = NULL;
+  int64_t ll = 0;
+  r = tod_str_to_i64(s, n, &ll, &end);
+  if (r == -1) {
     stmt_append_err_format(stmt, "HY000", 0,
-        "General error:conversion from `%s` to `SQL_BIGINT` failed:invalid character[0x%02x]",
-        (const char*)mem->base, *end);
+        "General error:conversion from `%.*s` to `SQL_BIGINT` failed:invalid character[0x%02x]",
+        (int)n, s, end < s + n ? (unsigned char)*end : 0);
     return SQL_ERROR;
   }
-  if (e == ERANGE) {
+  if (r) {
     stmt_append_err_format(stmt, "HY000", 0,
-        "General error:conversion from `%s` to `SQL_BIGINT` failed:overflow or underflow occurs",
-        (const char*)mem->base);
+        "General error:conversion from `%.*s` to `SQL_BIGINT` failed:overflow or underflow occurs",
+        (int)n, s);
     return SQL_ERROR;
   }
 
@@ -3344,40 +4033,32 @@ static SQLRETURN _stmt_param_check_sqlc_char_sql_integer(stmt_t *stmt, param_sta
   const char *s = param_state->sqlc_data.str.str;
   size_t      n = param_state->sqlc_data.str.len;
 
-  mem_t *mem = &param_state->tmp;
-
-  r = mem_copy_str(mem, s, n);
-  if (r) {
-    stmt_oom(stmt);
-    return SQL_ERROR;
-  }
-
-  char *end = NULL;
-  long long ll = strtoll((const char*)mem->base, &end, 0);
-  int e = errno;
-  if (end) {
+  const char *end = NULL;
+  int64_t ll = 0;
+  r = tod_str_to_i64(s, n, &ll, &end);
+  if (r == -1) {
     stmt_append_err_format(stmt, "HY000", 0,
-        "General error:conversion from `%s` to `SQL_INTEGER` failed:invalid character[0x%02x]",
-        (const char*)mem->base, *end);
+        "General error:conversion from `%.*s` to `SQL_INTEGER` failed:invalid character[0x%02x]",
+        (int)n, s, end < s + n ? (unsigned char)*end : 0);
     return SQL_ERROR;
   }
-  if (e == ERANGE) {
+  if (r) {
     stmt_append_err_format(stmt, "HY000", 0,
-        "General error:conversion from `%s` to `SQL_INTEGER` failed:overflow or underflow occurs",
-        (const char*)mem->base);
+        "General error:conversion from `%.*s` to `SQL_INTEGER` failed:overflow or underflow occurs",
+        (int)n, s);
     return SQL_ERROR;
   }
 
   if (ll > UINT_MAX) {
     stmt_append_err_format(stmt, "22003", 0,
-        "Numeric value out of range:conversion from `%s` to `SQL_INTEGER` failed",
-        (const char*)mem->base);
+        "Numeric value out of range:conversion from `%.*s` to `SQL_INTEGER` failed",
+        (int)n, s);
     return SQL_ERROR;
   }
   if (ll < INT_MIN) {
     stmt_append_err_format(stmt, "22003", 0,
-        "Numeric value out of range:conversion from `%s` to `SQL_INTEGER` failed",
-        (const char*)mem->base);
+        "Numeric value out of range:conversion from `%.*s` to `SQL_INTEGER` failed",
+        (int)n, s);
     return SQL_ERROR;
   }
 
@@ -3400,40 +4081,32 @@ static SQLRETURN _stmt_param_check_sqlc_char_sql_smallint(stmt_t *stmt, param_st
   const char *s = param_state->sqlc_data.str.str;
   size_t      n = param_state->sqlc_data.str.len;
 
-  mem_t *mem = &param_state->tmp;
-
-  r = mem_copy_str(mem, s, n);
-  if (r) {
-    stmt_oom(stmt);
-    return SQL_ERROR;
-  }
-
-  char *end = NULL;
-  long long ll = strtoll((const char*)mem->base, &end, 0);
-  int e = errno;
-  if (end) {
+  const char *end = NULL;
+  int64_t ll = 0;
+  r = tod_str_to_i64(s, n, &ll, &end);
+  if (r == -1) {
     stmt_append_err_format(stmt, "HY000", 0,
-        "General error:conversion from `%s` to `SQL_SMALLINT` failed:invalid character[0x%02x]",
-        (const char*)mem->base, *end);
+        "General error:conversion from `%.*s` to `SQL_SMALLINT` failed:invalid character[0x%02x]",
+        (int)n, s, end < s + n ? (unsigned char)*end : 0);
     return SQL_ERROR;
   }
-  if (e == ERANGE) {
+  if (r) {
     stmt_append_err_format(stmt, "HY000", 0,
-        "General error:conversion from `%s` to `SQL_SMALLINT` failed:overflow or underflow occurs",
-        (const char*)mem->base);
+        "General error:conversion from `%.*s` to `SQL_SMALLINT` failed:overflow or underflow occurs",
+        (int)n, s);
     return SQL_ERROR;
   }
 
   if (ll > UINT16_MAX) {
     stmt_append_err_format(stmt, "22003", 0,
-        "Numeric value out of range:conversion from `%s` to `SQL_SMALLINT` failed",
-        (const char*)mem->base);
+        "Numeric value out of range:conversion from `%.*s` to `SQL_SMALLINT` failed",
+        (int)n, s);
     return SQL_ERROR;
   }
   if (ll < INT16_MIN) {
     stmt_append_err_format(stmt, "22003", 0,
-        "Numeric value out of range:conversion from `%s` to `SQL_SMALLINT` failed",
-        (const char*)mem->base);
+        "Numeric value out of range:conversion from `%.*s` to `SQL_SMALLINT` failed",
+        (int)n, s);
     return SQL_ERROR;
   }
 
@@ -3456,40 +4129,32 @@ static SQLRETURN _stmt_param_check_sqlc_char_sql_tinyint(stmt_t *stmt, param_sta
   const char *s = param_state->sqlc_data.str.str;
   size_t      n = param_state->sqlc_data.str.len;
 
-  mem_t *mem = &param_state->tmp;
-
-  r = mem_copy_str(mem, s, n);
-  if (r) {
-    stmt_oom(stmt);
-    return SQL_ERROR;
-  }
-
-  char *end = NULL;
-  long long ll = strtoll((const char*)mem->base, &end, 0);
-  int e = errno;
-  if (end) {
+  const char *end = NULL;
+  int64_t ll = 0;
+  r = tod_str_to_i64(s, n, &ll, &end);
+  if (r == -1) {
     stmt_append_err_format(stmt, "HY000", 0,
-        "General error:conversion from `%s` to `SQL_TINYINT` failed:invalid character[0x%02x]",
-        (const char*)mem->base, *end);
+        "General error:conversion from `%.*s` to `SQL_TINYINT` failed:invalid character[0x%02x]",
+        (int)n, s, end < s + n ? (unsigned char)*end : 0);
     return SQL_ERROR;
   }
-  if (e == ERANGE) {
+  if (r) {
     stmt_append_err_format(stmt, "HY000", 0,
-        "General error:conversion from `%s` to `SQL_TINYINT` failed:overflow or underflow occurs",
-        (const char*)mem->base);
+        "General error:conversion from `%.*s` to `SQL_TINYINT` failed:overflow or underflow occurs",
+        (int)n, s);
     return SQL_ERROR;
   }
 
   if (ll > UINT8_MAX) {
     stmt_append_err_format(stmt, "22003", 0,
-        "Numeric value out of range:conversion from `%s` to `SQL_TINYINT` failed",
-        (const char*)mem->base);
+        "Numeric value out of range:conversion from `%.*s` to `SQL_TINYINT` failed",
+        (int)n, s);
     return SQL_ERROR;
   }
   if (ll < INT8_MIN) {
     stmt_append_err_format(stmt, "22003", 0,
-        "Numeric value out of range:conversion from `%s` to `SQL_TINYINT` failed",
-        (const char*)mem->base);
+        "Numeric value out of range:conversion from `%.*s` to `SQL_TINYINT` failed",
+        (int)n, s);
     return SQL_ERROR;
   }
 
@@ -3512,27 +4177,19 @@ static SQLRETURN _stmt_param_check_sqlc_char_sql_bit(stmt_t *stmt, param_state_t
   const char *s = param_state->sqlc_data.str.str;
   size_t      n = param_state->sqlc_data.str.len;
 
-  mem_t *mem = &param_state->tmp;
-
-  r = mem_copy_str(mem, s, n);
-  if (r) {
-    stmt_oom(stmt);
-    return SQL_ERROR;
-  }
-
-  char *end = NULL;
-  long long ll = strtoll((const char*)mem->base, &end, 0);
-  int e = errno;
-  if (end) {
+  const char *end = NULL;
+  int64_t ll = 0;
+  r = tod_str_to_i64(s, n, &ll, &end);
+  if (r == -1) {
     stmt_append_err_format(stmt, "HY000", 0,
-        "General error:conversion from `%s` to `SQL_BIT` failed:invalid character[0x%02x]",
-        (const char*)mem->base, *end);
+        "General error:conversion from `%.*s` to `SQL_BIT` failed:invalid character[0x%02x]",
+        (int)n, s, end < s + n ? (unsigned char)*end : 0);
     return SQL_ERROR;
   }
-  if (e == ERANGE) {
+  if (r) {
     stmt_append_err_format(stmt, "HY000", 0,
-        "General error:conversion from `%s` to `SQL_BIT` failed:overflow or underflow occurs",
-        (const char*)mem->base);
+        "General error:conversion from `%.*s` to `SQL_BIT` failed:overflow or underflow occurs",
+        (int)n, s);
     return SQL_ERROR;
   }
 
@@ -3549,20 +4206,13 @@ static SQLRETURN _stmt_param_check_sqlc_char_sql_double(stmt_t *stmt, param_stat
   const char *s = param_state->sqlc_data.str.str;
   size_t      n = param_state->sqlc_data.str.len;
 
-  mem_t *mem = &param_state->tmp;
-
-  r = mem_copy_str(mem, s, n);
-  if (r) {
-    stmt_oom(stmt);
-    return SQL_ERROR;
-  }
-
+  const char *end = NULL;
   double v = 0.;
-  r = sscanf((const char*)mem->base, "%lg", &v);
-  if (r != 1) {
+  r = tod_str_to_dbl(s, n, &v, &end);
+  if (r) {
     stmt_append_err_format(stmt, "HY000", 0,
-        "General error:conversion from `%s` to `SQL_DOUBLE` failed",
-        (const char*)mem->base);
+        "General error:conversion from `%.*s` to `SQL_DOUBLE` failed",
+        (int)n, s);
     return SQL_ERROR;
   }
 
@@ -3579,20 +4229,13 @@ static SQLRETURN _stmt_param_check_sqlc_char_sql_float(stmt_t *stmt, param_state
   const char *s = param_state->sqlc_data.str.str;
   size_t      n = param_state->sqlc_data.str.len;
 
-  mem_t *mem = &param_state->tmp;
-
-  r = mem_copy_str(mem, s, n);
-  if (r) {
-    stmt_oom(stmt);
-    return SQL_ERROR;
-  }
-
+  const char *end = NULL;
   float v = 0.;
-  r = sscanf((const char*)mem->base, "%g", &v);
-  if (r != 1) {
+  r = tod_str_to_flt(s, n, &v, &end);
+  if (r) {
     stmt_append_err_format(stmt, "HY000", 0,
-        "General error:conversion from `%s` to `SQL_FLOAT` failed",
-        (const char*)mem->base);
+        "General error:conversion from `%.*s` to `SQL_FLOAT` failed",
+        (int)n, s);
     return SQL_ERROR;
   }
 
@@ -4684,6 +5327,8 @@ SQLRETURN stmt_bind_param(
     return SQL_ERROR;
   }
 
+  TOD_TRACEF(TOD_TRACE_BIND, "stmt:%p, Parameter%d:%s->%s, ColumnSize:%zd, DecimalDigits:%d, BufferLength:%zd",
+      stmt, ParameterNumber, sqlc_data_type(ValueType), sql_data_type(ParameterType), (size_t)ColumnSize, DecimalDigits, (size_t)BufferLength);
   return _stmt_bind_param(stmt, ParameterNumber, InputOutputType, ValueType, ParameterType, ColumnSize, DecimalDigits, ParameterValuePtr, BufferLength, StrLen_or_IndPtr);
 }
 
@@ -5183,6 +5828,8 @@ static SQLRETURN _stmt_conv_param_data_from_sqlc_char_tsdb_varchar(stmt_t *stmt,
   char          *outbuf              = (char*)tsdb_varchar;
 
   size_t n = CALL_iconv(cnv->cnv, &inbuf, &inbytesleft, &outbuf, &outbytesleft);
+
+  _stmt_perf_iconv(stmt, inbytes - inbytesleft);
   int e = errno;
   iconv(cnv->cnv, NULL, NULL, NULL, NULL);
   if (n == (size_t)-1) {
@@ -5276,6 +5923,8 @@ static SQLRETURN _stmt_conv_param_data_from_sqlc_wchar_tsdb_varchar(stmt_t *stmt
   char          *outbuf              = (char*)tsdb_varchar;
 
   size_t n = CALL_iconv(cnv->cnv, &inbuf, &inbytesleft, &outbuf, &outbytesleft);
+
+  _stmt_perf_iconv(stmt, inbytes - inbytesleft);
   int e = errno;
   iconv(cnv->cnv, NULL, NULL, NULL, NULL);
   if (n == (size_t)-1) {
@@ -5653,17 +6302,18 @@ static SQLRETURN _stmt_param_conv_sqlc_char_to_tsdb_bool(stmt_t *stmt, param_sta
   int tsdb_type = tsdb_field->type;
 
   const char *s = data->str.str;
+  size_t      n = data->str.len;
 
-  char *end = NULL;
-  long long ll = strtoll(s, &end, 0);
-  int e = errno;
-  if (end && *end) {
+  const char *end = NULL;
+  int64_t ll = 0;
+  int r = tod_str_to_i64(s, n, &ll, &end);
+  if (r == -1) {
     stmt_append_err_format(stmt, "HY000", 0,
         "General error:Param[%d,%d] conversion from `%s` to `%s` failed:invalid character[0x%02x]",
-        i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType), *end);
+        i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType), end < s + n ? (unsigned char)*end : 0);
     return SQL_ERROR;
   }
-  if (e == ERANGE) {
+  if (r) {
     stmt_append_err_format(stmt, "HY000", 0,
         "General error:Param[%d,%d] conversion from `%s` to `%s` failed:overflow or underflow occurs",
         i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType));
@@ -5693,17 +6343,18 @@ static SQLRETURN _stmt_param_conv_sqlc_char_to_tsdb_tinyint(stmt_t *stmt, param_
 
 
   const char *s = data->str.str;
+  size_t      n = data->str.len;
 
-  char *end = NULL;
-  long long ll = strtoll(s, &end, 0);
-  int e = errno;
-  if (end && *end) {
+  const char *end = NULL;
+  int64_t ll = 0;
+  int r = tod_str_to_i64(s, n, &ll, &end);
+  if (r == -1) {
     stmt_append_err_format(stmt, "HY000", 0,
         "General error:Param[%d,%d] conversion from `%s` to `%s` failed:invalid character[0x%02x]",
-        i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType), *end);
+        i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType), end < s + n ? (unsigned char)*end : 0);
     return SQL_ERROR;
   }
-  if (e == ERANGE) {
+  if (r) {
     stmt_append_err_format(stmt, "HY000", 0,
         "General error:Param[%d,%d] conversion from `%s` to `%s` failed:overflow or underflow occurs",
         i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType));
@@ -5741,17 +6392,18 @@ static SQLRETURN _stmt_param_conv_sqlc_char_to_tsdb_utinyint(stmt_t *stmt, param
 
 
   const char *s = data->str.str;
+  size_t      n = data->str.len;
 
-  char *end = NULL;
-  long long ll = strtoll(s, &end, 0);
-  int e = errno;
-  if (end && *end) {
+  const char *end = NULL;
+  int64_t ll = 0;
+  int r = tod_str_to_i64(s, n, &ll, &end);
+  if (r == -1) {
     stmt_append_err_format(stmt, "HY000", 0,
         "General error:Param[%d,%d] conversion from `%s` to `%s` failed:invalid character[0x%02x]",
-        i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType), *end);
+        i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType), end < s + n ? (unsigned char)*end : 0);
     return SQL_ERROR;
   }
-  if (e == ERANGE) {
+  if (r) {
     stmt_append_err_format(stmt, "HY000", 0,
         "General error:Param[%d,%d] conversion from `%s` to `%s` failed:overflow or underflow occurs",
         i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType));
@@ -5789,17 +6441,18 @@ static SQLRETURN _stmt_param_conv_sqlc_char_to_tsdb_smallint(stmt_t *stmt, param
 
 
   const char *s = data->str.str;
+  size_t      n = data->str.len;
 
-  char *end = NULL;
-  long long ll = strtoll(s, &end, 0);
-  int e = errno;
-  if (end && *end) {
+  const char *end = NULL;
+  int64_t ll = 0;
+  int r = tod_str_to_i64(s, n, &ll, &end);
+  if (r == -1) {
     stmt_append_err_format(stmt, "HY000", 0,
         "General error:Param[%d,%d] conversion from `%s` to `%s` failed:invalid character[0x%02x]",
-        i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType), *end);
+        i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType), end < s + n ? (unsigned char)*end : 0);
     return SQL_ERROR;
   }
-  if (e == ERANGE) {
+  if (r) {
     stmt_append_err_format(stmt, "HY000", 0,
         "General error:Param[%d,%d] conversion from `%s` to `%s` failed:overflow or underflow occurs",
         i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType));
@@ -5837,17 +6490,18 @@ static SQLRETURN _stmt_param_conv_sqlc_char_to_tsdb_usmallint(stmt_t *stmt, para
 
 
   const char *s = data->str.str;
+  size_t      n = data->str.len;
 
-  char *end = NULL;
-  long long ll = strtoll(s, &end, 0);
-  int e = errno;
-  if (end && *end) {
+  const char *end = NULL;
+  int64_t ll = 0;
+  int r = tod_str_to_i64(s, n, &ll, &end);
+  if (r == -1) {
     stmt_append_err_format(stmt, "HY000", 0,
         "General error:Param[%d,%d] conversion from `%s` to `%s` failed:invalid character[0x%02x]",
-        i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType), *end);
+        i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType), end < s + n ? (unsigned char)*end : 0);
     return SQL_ERROR;
   }
-  if (e == ERANGE) {
+  if (r) {
     stmt_append_err_format(stmt, "HY000", 0,
         "General error:Param[%d,%d] conversion from `%s` to `%s` failed:overflow or underflow occurs",
         i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType));
@@ -5885,17 +6539,18 @@ static SQLRETURN _stmt_param_conv_sqlc_char_to_tsdb_int(stmt_t *stmt, param_stat
 
 
   const char *s = data->str.str;
+  size_t      n = data->str.len;
 
-  char *end = NULL;
-  long long ll = strtoll(s, &end, 0);
-  int e = errno;
-  if (end && *end) {
+  const char *end = NULL;
+  int64_t ll = 0;
+  int r = tod_str_to_i64(s, n, &ll, &end);
+  if (r == -1) {
     stmt_append_err_format(stmt, "HY000", 0,
         "General error:Param[%d,%d] conversion from `%s` to `%s` failed:invalid character[0x%02x]",
-        i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType), *end);
+        i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType), end < s + n ? (unsigned char)*end : 0);
     return SQL_ERROR;
   }
-  if (e == ERANGE) {
+  if (r) {
     stmt_append_err_format(stmt, "HY000", 0,
         "General error:Param[%d,%d] conversion from `%s` to `%s` failed:overflow or underflow occurs",
         i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType));
@@ -5933,17 +6588,18 @@ static SQLRETURN _stmt_param_conv_sqlc_char_to_tsdb_uint(stmt_t *stmt, param_sta
 
 
   const char *s = data->str.str;
+  size_t      n = data->str.len;
 
-  char *end = NULL;
-  long long ll = strtoll(s, &end, 0);
-  int e = errno;
-  if (end && *end) {
+  const char *end = NULL;
+  int64_t ll = 0;
+  int r = tod_str_to_i64(s, n, &ll, &end);
+  if (r == -1) {
     stmt_append_err_format(stmt, "HY000", 0,
         "General error:Param[%d,%d] conversion from `%s` to `%s` failed:invalid character[0x%02x]",
-        i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType), *end);
+        i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType), end < s + n ? (unsigned char)*end : 0);
     return SQL_ERROR;
   }
-  if (e == ERANGE) {
+  if (r) {
     stmt_append_err_format(stmt, "HY000", 0,
         "General error:Param[%d,%d] conversion from `%s` to `%s` failed:overflow or underflow occurs",
         i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType));
@@ -5979,17 +6635,18 @@ static SQLRETURN _stmt_param_conv_sqlc_char_to_tsdb_bigint(stmt_t *stmt, param_s
 
 
   const char *s = data->str.str;
+  size_t      n = data->str.len;
 
-  char *end = NULL;
-  long long ll = strtoll(s, &end, 0);
-  int e = errno;
-  if (end && *end) {
+  const char *end = NULL;
+  int64_t ll = 0;
+  int r = tod_str_to_i64(s, n, &ll, &end);
+  if (r == -1) {
     stmt_append_err_format(stmt, "HY000", 0,
         "General error:Param[%d,%d] conversion from `%s` to `%s` failed:invalid character[0x%02x]",
-        i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType), *end);
+        i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType), end < s + n ? (unsigned char)*end : 0);
     return SQL_ERROR;
   }
-  if (e == ERANGE) {
+  if (r) {
     stmt_append_err_format(stmt, "HY000", 0,
         "General error:Param[%d,%d] conversion from `%s` to `%s` failed:overflow or underflow occurs",
         i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType));
@@ -6017,17 +6674,18 @@ static SQLRETURN _stmt_param_conv_sqlc_char_to_tsdb_ubigint(stmt_t *stmt, param_
 
 
   const char *s = data->str.str;
+  size_t      n = data->str.len;
 
-  char *end = NULL;
-  unsigned long long ull = strtoull(s, &end, 0);
-  int e = errno;
-  if (end && *end) {
+  const char *end = NULL;
+  uint64_t ull = 0;
+  int r = tod_str_to_u64(s, n, &ull, &end);
+  if (r == -1) {
     stmt_append_err_format(stmt, "HY000", 0,
         "General error:Param[%d,%d] conversion from `%s` to `%s` failed:invalid character[0x%02x]",
-        i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType), *end);
+        i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType), end < s + n ? (unsigned char)*end : 0);
     return SQL_ERROR;
   }
-  if (e == ERANGE) {
+  if (r) {
     stmt_append_err_format(stmt, "HY000", 0,
         "General error:Param[%d,%d] conversion from `%s` to `%s` failed:overflow or underflow occurs",
         i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType));
@@ -6054,32 +6712,22 @@ static SQLRETURN _stmt_param_conv_sqlc_char_to_tsdb_float(stmt_t *stmt, param_st
   int tsdb_type = tsdb_field->type;
 
   const char *s = data->str.str;
+  size_t      n = data->str.len;
 
-  char *end = NULL;
-  float flt = strtof(s, &end);
-  int e = errno;
-  if (end && *end) {
+  const char *end = NULL;
+  float flt = 0;
+  int r = tod_str_to_flt(s, n, &flt, &end);
+  if (r == -1) {
     stmt_append_err_format(stmt, "HY000", 0,
         "General error:Param[%d,%d] conversion from `%s` to `%s` failed:invalid character[0x%02x]",
-        i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType), *end);
+        i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType), end < s + n ? (unsigned char)*end : 0);
     return SQL_ERROR;
   }
-  if (fabsf(flt) == HUGE_VALF) {
-    if (e == ERANGE) {
-      stmt_append_err_format(stmt, "HY000", 0,
-          "General error:Param[%d,%d] conversion from `%s` to `%s` failed:overflow or underflow occurs",
-          i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType));
-      return SQL_ERROR;
-    }
-  }
-
-  if (fpclassify(flt) == FP_ZERO) {
-    if (e == ERANGE) {
-      stmt_append_err_format(stmt, "HY000", 0,
-          "General error:Param[%d,%d] conversion from `%s` to `%s` failed:overflow or underflow occurs",
-          i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType));
-      return SQL_ERROR;
-    }
+  if (r) {
+    stmt_append_err_format(stmt, "HY000", 0,
+        "General error:Param[%d,%d] conversion from `%s` to `%s` failed:overflow or underflow occurs",
+        i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType));
+    return SQL_ERROR;
   }
 
   TAOS_MULTI_BIND      *tsdb_bind         = param_state->tsdb_bind;
@@ -6102,32 +6750,22 @@ static SQLRETURN _stmt_param_conv_sqlc_char_to_tsdb_double(stmt_t *stmt, param_s
   int tsdb_type = tsdb_field->type;
 
   const char *s = data->str.str;
+  size_t      n = data->str.len;
 
-  char *end = NULL;
-  double dbl = strtod(s, &end);
-  int e = errno;
-  if (end && *end) {
+  const char *end = NULL;
+  double dbl = 0;
+  int r = tod_str_to_dbl(s, n, &dbl, &end);
+  if (r == -1) {
     stmt_append_err_format(stmt, "HY000", 0,
         "General error:Param[%d,%d] conversion from `%s` to `%s` failed:invalid character[0x%02x]",
-        i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType), *end);
+        i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType), end < s + n ? (unsigned char)*end : 0);
     return SQL_ERROR;
   }
-  if (fabs(dbl) == HUGE_VALF) {
-    if (e == ERANGE) {
-      stmt_append_err_format(stmt, "HY000", 0,
-          "General error:Param[%d,%d] conversion from `%s` to `%s` failed:overflow or underflow occurs",
-          i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType));
-      return SQL_ERROR;
-    }
-  }
-
-  if (fpclassify(dbl) == FP_ZERO) {
-    if (e == ERANGE) {
-      stmt_append_err_format(stmt, "HY000", 0,
-          "General error:Param[%d,%d] conversion from `%s` to `%s` failed:overflow or underflow occurs",
-          i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType));
-      return SQL_ERROR;
-    }
+  if (r) {
+    stmt_append_err_format(stmt, "HY000", 0,
+        "General error:Param[%d,%d] conversion from `%s` to `%s` failed:overflow or underflow occurs",
+        i_row+1, i_param+1, taos_data_type(tsdb_type), sqlc_data_type(ValueType));
+    return SQL_ERROR;
   }
 
   TAOS_MULTI_BIND      *tsdb_bind         = param_state->tsdb_bind;
@@ -6534,6 +7172,8 @@ static SQLRETURN _stmt_prepare_col_subtbl(stmt_t *stmt, param_state_t *param_sta
     size_t           outbytesleft        = sizeof(buf);
 
     size_t n = CALL_iconv(cnv->cnv, &inbuf, &inbytesleft, &outbuf, &outbytesleft);
+
+    _stmt_perf_iconv(stmt, inbytes - inbytesleft);
     int e = errno;
     iconv(cnv->cnv, NULL, NULL, NULL, NULL);
     if (n == (size_t)-1) {
@@ -6714,6 +7354,7 @@ static SQLRETURN _stmt_execute_with_param_state(stmt_t *stmt, param_state_t *par
     }
 
     nr_params_processed += param_state->nr_batch_size;
+    stmt->perf.param_rows += param_state->nr_batch_size;
     if (params_processed_ptr) *params_processed_ptr = nr_params_processed;
 
     for (size_t i=0; i<(size_t)param_state->nr_tsdb_fields; ++i) {
@@ -6745,7 +7386,11 @@ static SQLRETURN _stmt_execute_with_param_state(stmt_t *stmt, param_state_t *par
       return SQL_ERROR;
     }
 
-    sr = stmt->base->execute(stmt->base);
+    if (tsdb_stmt_write_behind_enabled(&stmt->tsdb_stmt)) {
+      sr = tsdb_stmt_execute_deferred(&stmt->tsdb_stmt, param_state->nr_batch_size);
+    } else {
+      sr = stmt->base->execute(stmt->base);
+    }
     if (sr != SQL_SUCCESS) return SQL_ERROR;
 
     if (param_state->row_err) return SQL_SUCCESS_WITH_INFO;
@@ -6780,6 +7425,109 @@ static SQLRETURN _stmt_execute_with_params(stmt_t *stmt)
   return _stmt_execute_with_param_state(stmt, param_state);
 }
 
+static SQLRETURN _stmt_schemaless_append_param(stmt_t *stmt, param_state_t *param_state)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+  int r = 0;
+
+  sr = _stmt_param_get(stmt, param_state);
+  if (sr != SQL_SUCCESS) return SQL_ERROR;
+
+  sqlc_data_t *sqlc_data = &param_state->sqlc_data;
+  if (sqlc_data->is_null) return SQL_SUCCESS;
+
+  const char *tocode = conn_get_tsdb_charset(stmt->conn);
+  str_t src = {0};
+  switch (sqlc_data->type) {
+    case SQL_C_CHAR:
+      src.charset = conn_get_sqlc_charset_for_param_bind(stmt->conn);
+      src.str     = sqlc_data->str.str;
+      src.bytes   = sqlc_data->str.len;
+      break;
+    case SQL_C_WCHAR:
+      src.charset = "UCS-2LE";
+      src.str     = (const char*)sqlc_data->wstr.wstr;
+      src.bytes   = sqlc_data->wstr.wlen * 2;
+      break;
+    default:
+      stmt_append_err_format(stmt, "HY000", 0,
+          "General error:`%s` for schemaless payload not supported, only SQL_C_CHAR/SQL_C_WCHAR allowed",
+          sqlc_data_type(sqlc_data->type));
+      return SQL_ERROR;
+  }
+
+  if (tod_strcasecmp(src.charset, tocode) == 0) {
+    return schemaless_append(&stmt->schemaless, src.str, src.bytes);
+  }
+
+  mem_t *payload = &stmt->schemaless.payload;
+  r = mem_conv_ex(payload, &src, tocode);
+  if (r) {
+    stmt_append_err_format(stmt, "HY000", 0, "General error:conversion for `%s` to `%s` not found or out of memory or conversion failed", src.charset, tocode);
+    return SQL_ERROR;
+  }
+
+  return schemaless_append(&stmt->schemaless, (const char*)payload->base, payload->nr);
+}
+
+static SQLRETURN _stmt_execute_schemaless(stmt_t *stmt)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+
+  descriptor_t *APD = stmt_APD(stmt);
+  desc_header_t *APD_header = &APD->header;
+  descriptor_t *IPD = stmt_IPD(stmt);
+  desc_header_t *IPD_header = &IPD->header;
+
+  if (APD_header->DESC_COUNT != 1) {
+    stmt_append_err_format(stmt, "07002", 0,
+        "COUNT field incorrect:schemaless-statement requires exactly 1 parameter, but [%d] bound", APD_header->DESC_COUNT);
+    return SQL_ERROR;
+  }
+
+  schemaless_rewind(&stmt->schemaless);
+
+  param_state_t *param_state = &stmt->param_state;
+  _param_state_reset(param_state);
+  param_state->nr_tsdb_fields = 1;
+  param_state->i_param        = 0;
+  param_state->APD_record     = APD->records;
+  param_state->IPD_record     = IPD->records;
+
+  size_t nr_paramset_size = APD_header->DESC_ARRAY_SIZE;
+  SQLUSMALLINT *param_status_ptr = IPD_header->DESC_ARRAY_STATUS_PTR;
+  SQLULEN *params_processed_ptr = IPD_header->DESC_ROWS_PROCESSED_PTR;
+  if (params_processed_ptr) *params_processed_ptr = 0;
+
+  // NOTE: payloads are only accumulated here, none is inserted until all of them are sent to taosc as a whole,
+  //       thus the status of each paramset is known only after that
+  for (size_t i_row = 0; i_row < nr_paramset_size; ++i_row) {
+    if (param_status_ptr) param_status_ptr[i_row] = SQL_PARAM_UNUSED;
+  }
+
+  for (size_t i_row = 0; i_row < nr_paramset_size; ++i_row) {
+    param_state->i_row = (int)i_row;
+
+    sr = _stmt_schemaless_append_param(stmt, param_state);
+    stmt->perf.param_rows += 1;
+    if (params_processed_ptr) *params_processed_ptr = i_row + 1;
+    if (sr != SQL_SUCCESS) {
+      if (param_status_ptr) param_status_ptr[i_row] = SQL_PARAM_ERROR;
+      schemaless_rewind(&stmt->schemaless);
+      return SQL_ERROR;
+    }
+  }
+
+  sr = stmt->base->execute(stmt->base);
+
+  // NOTE: taosc tells no paramset which failed the whole payload
+  for (size_t i_row = 0; i_row < nr_paramset_size; ++i_row) {
+    if (param_status_ptr) param_status_ptr[i_row] = (sr == SQL_SUCCESS) ? SQL_PARAM_SUCCESS : SQL_PARAM_DIAG_UNAVAILABLE;
+  }
+
+  return sr;
+}
+
 static SQLRETURN _stmt_execute(stmt_t *stmt)
 {
   descriptor_t *APD = stmt_APD(stmt);
@@ -6793,6 +7541,10 @@ static SQLRETURN _stmt_execute(stmt_t *stmt)
     return SQL_ERROR;
   }
 
+  if (stmt->base == &stmt->schemaless.base) {
+    return _stmt_execute_schemaless(stmt);
+  }
+
   if (APD_header->DESC_COUNT > 0) {
     return _stmt_execute_with_params(stmt);
   }
@@ -6823,6 +7575,7 @@ static SQLRETURN _stmt_exec_direct(stmt_t *stmt)
 
   sr = _stmt_execute(stmt);
   if (sr == SQL_ERROR) return SQL_ERROR;
+  if (sr == SQL_STILL_EXECUTING) return sr;
 
   return _stmt_fill_IRD(stmt);
 }
@@ -6844,8 +7597,118 @@ static SQLRETURN _stmt_exec_direct_sql(stmt_t *stmt)
   return sr;
 }
 
+// NOTE: taosc rejects sql-statement longer than 1M bytes
+#define COALESCED_INSERTS_MAX_BYTES          (1024 * 1024 - 1024)
+
+static SQLRETURN _stmt_coalesce_inserts(stmt_t *stmt)
+{
+  int r = 0;
+
+  coalesced_inserts_t *coalesced = &stmt->coalesced;
+  _coalesced_inserts_reset(coalesced);
+
+  sqlc_tsdb_t *sqlc_tsdb = &stmt->current_sql;
+  sqls_t *sqls = &stmt->sqls;
+  if (sqls->pos >= sqls->nr) return SQL_SUCCESS;
+  if (sqlc_tsdb->qms) return SQL_SUCCESS;
+
+  descriptor_t *APD = stmt_APD(stmt);
+  desc_header_t *APD_header = &APD->header;
+  if (APD_header->DESC_COUNT > 0) return SQL_SUCCESS;
+
+  size_t tail = 0;
+  size_t rows = 0;
+  if (tod_parse_plain_insert(sqlc_tsdb->tsdb, sqlc_tsdb->tsdb_bytes, &tail, &rows)) return SQL_SUCCESS;
+
+  r = _coalesced_inserts_append(coalesced, sqlc_tsdb->tsdb, sqlc_tsdb->tsdb_bytes, rows);
+  if (r) {
+    stmt_oom(stmt);
+    return SQL_ERROR;
+  }
+
+  // NOTE: from now on, stmt->tsdb_sql serves as scratch buffer
+  const char *fromcode = conn_get_sqlc_charset(stmt->conn);
+  const char *tocode   = conn_get_tsdb_charset(stmt->conn);
+  const parser_nterm_t *last = NULL;
+  for (size_t i = sqls->pos; i < sqls->nr; ++i) {
+    const parser_nterm_t *nterm = sqls->sqls + i;
+    if (nterm->qms) break;
+
+    str_t src = {
+      .charset             = fromcode,
+      .str                 = (const char*)stmt->raw.base + nterm->start,
+      .bytes               = nterm->end - nterm->start,
+    };
+    r = mem_conv_ex(&stmt->tsdb_sql, &src, tocode);
+    // NOTE: leave it to the statement-by-statement path to report
+    if (r) break;
+
+    const char *tsdb = (const char*)stmt->tsdb_sql.base;
+    if (tod_parse_plain_insert(tsdb, stmt->tsdb_sql.nr, &tail, &rows)) break;
+    if (coalesced->tsdb_sql.nr + 1 + stmt->tsdb_sql.nr - tail > COALESCED_INSERTS_MAX_BYTES) break;
+
+    r = _coalesced_inserts_append(coalesced, tsdb + tail, stmt->tsdb_sql.nr - tail, rows);
+    if (r) {
+      stmt_oom(stmt);
+      return SQL_ERROR;
+    }
+    last = nterm;
+  }
+
+  sqlc_tsdb->tsdb        = (const char*)coalesced->tsdb_sql.base;
+  sqlc_tsdb->tsdb_bytes  = coalesced->tsdb_sql.nr;
+
+  if (!last) {
+    coalesced->nr = 0;
+    return SQL_SUCCESS;
+  }
+
+  sqlc_tsdb->sqlc_bytes  = (const char*)stmt->raw.base + last->end - sqlc_tsdb->sqlc;
+  coalesced->pos         = 1;
+
+  return SQL_SUCCESS;
+}
+
+static size_t _coalesced_inserts_row_count(const coalesced_inserts_t *coalesced, size_t i)
+{
+  return (coalesced->rows[i] < 0) ? TSDB_ROW_COUNT_UNKNOWN : (size_t)coalesced->rows[i];
+}
+
+static void _stmt_coalesced_inserts_settle(stmt_t *stmt)
+{
+  coalesced_inserts_t *coalesced = &stmt->coalesced;
+  tsdb_res_t *res = &stmt->tsdb_stmt.res;
+
+  int64_t total = 0;
+  for (size_t i=0; i<coalesced->nr; ++i) total += coalesced->rows[i];
+
+  if ((size_t)total != res->affected_row_count) {
+    // NOTE: no way to attribute affected rows to each individual statement, thus none of them knows
+    OW("%zd statements coalesced, %" PRId64 " rows expected, but %zd rows affected",
+        coalesced->nr, total, res->affected_row_count);
+    for (size_t i=0; i<coalesced->nr; ++i) coalesced->rows[i] = -1;
+  }
+
+  res->affected_row_count = _coalesced_inserts_row_count(coalesced, 0);
+}
+
+static SQLRETURN _stmt_coalesced_inserts_next(stmt_t *stmt)
+{
+  coalesced_inserts_t *coalesced = &stmt->coalesced;
+
+  _stmt_close_result(stmt);
+
+  ++stmt->sqls.pos;
+  stmt->tsdb_stmt.res.affected_row_count = _coalesced_inserts_row_count(coalesced, coalesced->pos++);
+  if (coalesced->pos == coalesced->nr) _coalesced_inserts_reset(coalesced);
+
+  return _stmt_fill_IRD(stmt);
+}
+
 static SQLRETURN _stmt_exec_direct_with_simple_sql(stmt_t *stmt)
 {
+  SQLRETURN sr = SQL_SUCCESS;
+
   const sqlc_tsdb_t *sqlc_tsdb = &stmt->current_sql;
 
   const char *start = sqlc_tsdb->tsdb;
@@ -6855,10 +7718,31 @@ static SQLRETURN _stmt_exec_direct_with_simple_sql(stmt_t *stmt)
     return SQL_ERROR;
   }
 
-  return _stmt_exec_direct_sql(stmt);
+  sr = _stmt_coalesce_inserts(stmt);
+  if (sr != SQL_SUCCESS) return SQL_ERROR;
+
+  sr = _stmt_exec_direct_sql(stmt);
+
+  coalesced_inserts_t *coalesced = &stmt->coalesced;
+  if (coalesced->nr == 0) return sr;
+
+  if (sr == SQL_ERROR) {
+    // NOTE: no telling which statement the merged insert failed on, nor which rows did make it, e.g. across vgroups,
+    //       and running the statements again would duplicate rows timestamped by `now` and alike,
+    //       thus the merged insert fails as a whole, and SQLMoreResults goes on with the statement next to it
+    stmt_append_err_format(stmt, "HY000", 0,
+        "General error:%zd coalesced insert statements failed as a whole, rows might be partially written", coalesced->nr);
+    stmt->sqls.pos += coalesced->nr - 1;
+    _coalesced_inserts_reset(coalesced);
+    return SQL_ERROR;
+  }
+
+  _stmt_coalesced_inserts_settle(stmt);
+
+  return sr;
 }
 
-static SQLRETURN _stmt_prepare_topic(stmt_t *stmt)
+static SQLRETURN _stmt_prepare_ext(stmt_t *stmt)
 {
   SQLRETURN sr = SQL_SUCCESS;
   int r = 0;
@@ -6868,7 +7752,7 @@ static SQLRETURN _stmt_prepare_topic(stmt_t *stmt)
   const char *end   = sqlc_tsdb->tsdb + sqlc_tsdb->tsdb_bytes;
 
   if (sqlc_tsdb->qms) {
-    stmt_append_err(stmt, "HY000", 0, "General error:parameterized-topic-consumer-statement not supported yet");
+    stmt_append_err(stmt, "HY000", 0, "General error:parameterized-taos_odbc_extended-statement not supported yet");
     return SQL_ERROR;
   }
   ext_parser_param_t param = {0};
@@ -6880,11 +7764,22 @@ static SQLRETURN _stmt_prepare_topic(stmt_t *stmt)
     stmt_append_err_format(stmt, "HY000", 0, "General error:location:(%d,%d)->(%d,%d)", param.ctx.row0, param.ctx.col0, param.ctx.row1, param.ctx.col1);
     stmt_append_err_format(stmt, "HY000", 0, "General error:failed:%.*s", (int)strlen(param.ctx.err_msg), param.ctx.err_msg);
     stmt_append_err(stmt, "HY000", 0, "General error:taos_odbc_extended syntax for `topic`: !topic [name]+ [{[key[=val];]*}]?");
+    stmt_append_err(stmt, "HY000", 0, "General error:taos_odbc_extended syntax for `schemaless`: !schemaless protocol [{[key[=val];]*}]?");
 
     ext_parser_param_release(&param);
     return SQL_ERROR;
   }
 
+  if (param.is_schemaless) {
+    sr = schemaless_open(&stmt->schemaless, sqlc_tsdb, &param.schemaless_cfg);
+    ext_parser_param_release(&param);
+    if (sr != SQL_SUCCESS) return SQL_ERROR;
+
+    stmt->base = &stmt->schemaless.base;
+
+    return SQL_SUCCESS;
+  }
+
   sr = topic_open(&stmt->topic, sqlc_tsdb, &param.topic_cfg);
   ext_parser_param_release(&param);
   if (sr != SQL_SUCCESS) return SQL_ERROR;
@@ -6900,6 +7795,9 @@ SQLRETURN stmt_prepare(stmt_t *stmt,
 {
   SQLRETURN sr = SQL_SUCCESS;
 
+  sr = tsdb_stmt_flush(&stmt->tsdb_stmt);
+  if (sr != SQL_SUCCESS) return SQL_ERROR;
+
   _stmt_unprepare(stmt);
 
   const char *sql = (const char*)StatementText;
@@ -6930,17 +7828,20 @@ SQLRETURN stmt_prepare(stmt_t *stmt,
     return SQL_ERROR;
   }
 
-  if (stmt->tsdb_stmt.is_topic) {
-    return _stmt_prepare_topic(stmt);
+  if (stmt->tsdb_stmt.is_ext) {
+    return _stmt_prepare_ext(stmt);
   }
 
   return _stmt_prepare(stmt);
 }
 
-SQLRETURN stmt_exec_direct(stmt_t *stmt, SQLCHAR *StatementText, SQLINTEGER TextLength)
+static SQLRETURN _stmt_exec_direct_text(stmt_t *stmt, SQLCHAR *StatementText, SQLINTEGER TextLength)
 {
   SQLRETURN sr = SQL_SUCCESS;
 
+  sr = tsdb_stmt_flush(&stmt->tsdb_stmt);
+  if (sr != SQL_SUCCESS) return SQL_ERROR;
+
   // column-binds remain valid among executes
   _stmt_close_result(stmt);
 
@@ -6966,11 +7867,12 @@ SQLRETURN stmt_exec_direct(stmt_t *stmt, SQLCHAR *StatementText, SQLINTEGER Text
     return SQL_ERROR;
   }
 
-  if (stmt->tsdb_stmt.is_topic) {
-    sr = _stmt_prepare_topic(stmt);
+  if (stmt->tsdb_stmt.is_ext) {
+    sr = _stmt_prepare_ext(stmt);
     if (sr != SQL_SUCCESS) return SQL_ERROR;
     sr = _stmt_execute(stmt);
     if (sr == SQL_ERROR) return SQL_ERROR;
+    if (sr == SQL_STILL_EXECUTING) return sr;
     return _stmt_fill_IRD(stmt);
   }
 
@@ -6991,6 +7893,15 @@ static SQLRETURN _stmt_set_row_array_size(stmt_t *stmt, SQLULEN row_array_size)
   return SQL_SUCCESS;
 }
 
+SQLRETURN stmt_exec_direct(stmt_t *stmt, SQLCHAR *StatementText, SQLINTEGER TextLength)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+  _stmt_call_begin(stmt);
+  if (stmt->async.op != STMT_ASYNC_NONE) sr = _stmt_async_resume(stmt);
+  else                                   sr = _stmt_exec_direct_text(stmt, StatementText, TextLength);
+  return _stmt_call_end(stmt, sr);
+}
+
 SQLRETURN stmt_execute(stmt_t *stmt)
 {
   SQLRETURN sr = SQL_SUCCESS;
@@ -7000,9 +7911,32 @@ SQLRETURN stmt_execute(stmt_t *stmt)
 
   // NOTE: no need to check whether it's prepared or not, DM would have already checked
 
-  sr = _stmt_execute(stmt);
-  if (sr == SQL_ERROR) return SQL_ERROR;
-  return _stmt_fill_IRD(stmt);
+  _stmt_call_begin(stmt);
+  if (stmt->async.op != STMT_ASYNC_NONE) {
+    sr = _stmt_async_resume(stmt);
+  } else {
+    sr = _stmt_execute(stmt);
+    if (sr != SQL_ERROR && sr != SQL_STILL_EXECUTING) sr = _stmt_fill_IRD(stmt);
+  }
+  return _stmt_call_end(stmt, sr);
+}
+
+static SQLRETURN _stmt_set_async_enable(stmt_t *stmt, SQLULEN async_enable)
+{
+  if (stmt->async.op != STMT_ASYNC_NONE) {
+    stmt_append_err(stmt, "HY010", 0, "Function sequence error:an asynchronous function is still executing");
+    return SQL_ERROR;
+  }
+
+  switch (async_enable) {
+    case SQL_ASYNC_ENABLE_OFF:
+    case SQL_ASYNC_ENABLE_ON:
+      stmt->async.enable = async_enable;
+      return SQL_SUCCESS;
+    default:
+      stmt_append_err_format(stmt, "HY024", 0, "Invalid attribute value:`%zd` for `SQL_ATTR_ASYNC_ENABLE`", (size_t)async_enable);
+      return SQL_ERROR;
+  }
 }
 
 static SQLRETURN _stmt_set_cursor_type(stmt_t *stmt, SQLULEN cursor_type)
@@ -7010,13 +7944,33 @@ static SQLRETURN _stmt_set_cursor_type(stmt_t *stmt, SQLULEN cursor_type)
   switch (cursor_type) {
     case SQL_CURSOR_FORWARD_ONLY:
     case SQL_CURSOR_STATIC:
+      stmt->cursor_type = cursor_type;
       return SQL_SUCCESS;
+    case SQL_CURSOR_KEYSET_DRIVEN:
+    case SQL_CURSOR_DYNAMIC:
+      // NOTE: rows of TDengine are not updated in place, a static cursor sees the same as a keyset-driven one
+      stmt->cursor_type = SQL_CURSOR_STATIC;
+      stmt_append_err_format(stmt, "01S02", 0, "Option value changed:`%s` substituted by `SQL_CURSOR_STATIC`", sql_cursor_type(cursor_type));
+      return SQL_SUCCESS_WITH_INFO;
     default:
-      stmt_append_err_format(stmt, "HY000", 0, "General error:`%s` for `SQL_ATTR_CURSOR_TYPE` not supported yet", sql_cursor_type(cursor_type));
+      stmt_append_err_format(stmt, "HY024", 0, "Invalid attribute value:`%zd` for `SQL_ATTR_CURSOR_TYPE`", (size_t)cursor_type);
       return SQL_ERROR;
   }
 }
 
+static SQLRETURN _stmt_set_parallel_scan(stmt_t *stmt, SQLULEN lanes)
+{
+  if (lanes > TSDB_SCAN_MAX_LANES) {
+    stmt->parallel_scan = TSDB_SCAN_MAX_LANES;
+    stmt_append_err_format(stmt, "01S02", 0, "Option value changed:`%zd` for `SQL_ATTR_TAOS_PARALLEL_SCAN` is substituted by `%d`",
+        (size_t)lanes, TSDB_SCAN_MAX_LANES);
+    return SQL_SUCCESS_WITH_INFO;
+  }
+
+  stmt->parallel_scan = lanes;
+  return SQL_SUCCESS;
+}
+
 SQLRETURN stmt_set_attr(stmt_t *stmt, SQLINTEGER Attribute, SQLPOINTER ValuePtr, SQLINTEGER StringLength)
 {
   (void)StringLength;
@@ -7024,6 +7978,16 @@ SQLRETURN stmt_set_attr(stmt_t *stmt, SQLINTEGER Attribute, SQLPOINTER ValuePtr,
   switch (Attribute) {
     case SQL_ATTR_CURSOR_TYPE:
       return _stmt_set_cursor_type(stmt, (SQLULEN)ValuePtr);
+    case SQL_ATTR_CURSOR_SCROLLABLE:
+      if ((SQLULEN)ValuePtr == SQL_SCROLLABLE) return _stmt_set_cursor_type(stmt, SQL_CURSOR_STATIC);
+      return _stmt_set_cursor_type(stmt, SQL_CURSOR_FORWARD_ONLY);
+    case SQL_ROWSET_SIZE:
+      if ((SQLULEN)ValuePtr == 0) {
+        stmt_append_err(stmt, "HY024", 0, "Invalid attribute value:`0` for `SQL_ROWSET_SIZE`");
+        return SQL_ERROR;
+      }
+      stmt->rowset_size = (SQLULEN)ValuePtr;
+      return SQL_SUCCESS;
     case SQL_ATTR_ROW_ARRAY_SIZE:
       return _stmt_set_row_array_size(stmt, (SQLULEN)ValuePtr);
     case SQL_ATTR_ROW_STATUS_PTR:
@@ -7049,28 +8013,123 @@ SQLRETURN stmt_set_attr(stmt_t *stmt, SQLINTEGER Attribute, SQLPOINTER ValuePtr,
     case SQL_ATTR_APP_PARAM_DESC:
       return _stmt_set_param_desc(stmt, ValuePtr);
     case SQL_ATTR_QUERY_TIMEOUT:
-      if ((SQLULEN)(uintptr_t)ValuePtr == 0) return SQL_SUCCESS;
-      stmt_append_err_format(stmt, "01S02", 0, "Option value changed:`%zd` for `SQL_ATTR_QUERY_TIMEOUT` is substituted by `0`", (SQLULEN)(uintptr_t)ValuePtr);
-      return SQL_SUCCESS_WITH_INFO;
+      stmt->query_timeout = (SQLULEN)(uintptr_t)ValuePtr;
+      return SQL_SUCCESS;
+    case SQL_ATTR_MAX_ROWS:
+      stmt->max_rows = (SQLULEN)(uintptr_t)ValuePtr;
+      return SQL_SUCCESS;
+    case SQL_ATTR_ASYNC_ENABLE:
+      return _stmt_set_async_enable(stmt, (SQLULEN)(uintptr_t)ValuePtr);
     case SQL_ATTR_USE_BOOKMARKS:
       if ((SQLULEN)(uintptr_t)ValuePtr == SQL_UB_OFF) return SQL_SUCCESS;
       stmt_append_err_format(stmt, "HY000", 0, "General error:`%zd/%s` for `SQL_ATTR_USE_BOOKMARKS` is not supported yet",
           (SQLULEN)(uintptr_t)ValuePtr, sql_stmt_attr((SQLINTEGER)(uintptr_t)ValuePtr));
       return SQL_ERROR;
+    case SQL_ATTR_TAOS_PERF_RESET:
+      memset(&stmt->perf, 0, sizeof(stmt->perf));
+      topic_perf_reset(&stmt->topic);
+      return SQL_SUCCESS;
+    case SQL_ATTR_TAOS_PARALLEL_SCAN:
+      return _stmt_set_parallel_scan(stmt, (SQLULEN)(uintptr_t)ValuePtr);
     default:
       stmt_append_err_format(stmt, "HYC00", 0, "Optional feature not implemented:`%s[0x%x/%d]` not supported yet", sql_stmt_attr(Attribute), Attribute, Attribute);
       return SQL_ERROR;
   }
 }
 
+static int64_t* _stmt_perf_counter(taos_odbc_perf_t *perf, SQLINTEGER Attribute)
+{
+  switch (Attribute) {
+    case SQL_ATTR_TAOS_PERF_ROWS_FETCHED:    return &perf->rows_fetched;
+    case SQL_ATTR_TAOS_PERF_BLOCKS_FETCHED:  return &perf->blocks_fetched;
+    case SQL_ATTR_TAOS_PERF_BYTES_COPIED:    return &perf->bytes_copied;
+    case SQL_ATTR_TAOS_PERF_ICONV_CALLS:     return &perf->iconv_calls;
+    case SQL_ATTR_TAOS_PERF_ICONV_BYTES:     return &perf->iconv_bytes;
+    case SQL_ATTR_TAOS_PERF_TAOSC_US:        return &perf->taosc_us;
+    case SQL_ATTR_TAOS_PERF_CONVERT_US:      return &perf->convert_us;
+    case SQL_ATTR_TAOS_PERF_PARAM_ROWS:      return &perf->param_rows;
+    case SQL_ATTR_TAOS_PERF_BATCHES:         return &perf->batches;
+    case SQL_ATTR_TAOS_PERF_CATALOG_TRIPS:   return &perf->catalog_trips;
+    case SQL_ATTR_TAOS_PERF_TOPIC_POLLS:       return &perf->topic_polls;
+    case SQL_ATTR_TAOS_PERF_TOPIC_POLLS_EMPTY: return &perf->topic_polls_empty;
+    case SQL_ATTR_TAOS_PERF_TOPIC_POLL_US:     return &perf->topic_poll_us;
+    case SQL_ATTR_TAOS_PERF_TOPIC_POLL_DATA_US:return &perf->topic_poll_data_us;
+    default:                                 return NULL;
+  }
+}
+
+void stmt_perf_add(taos_odbc_perf_t *dst, const taos_odbc_perf_t *src)
+{
+  dst->rows_fetched      += src->rows_fetched;
+  dst->blocks_fetched    += src->blocks_fetched;
+  dst->bytes_copied      += src->bytes_copied;
+  dst->iconv_calls       += src->iconv_calls;
+  dst->iconv_bytes       += src->iconv_bytes;
+  dst->taosc_us          += src->taosc_us;
+  dst->convert_us        += src->convert_us;
+  dst->param_rows        += src->param_rows;
+  dst->batches           += src->batches;
+  dst->catalog_trips     += src->catalog_trips;
+  dst->topic_polls       += src->topic_polls;
+  dst->topic_polls_empty += src->topic_polls_empty;
+  dst->topic_poll_us     += src->topic_poll_us;
+  dst->topic_poll_data_us += src->topic_poll_data_us;
+}
+
+int stmt_perf_is_attr(SQLINTEGER Attribute)
+{
+  if (Attribute == SQL_ATTR_TAOS_PERF) return 1;
+  taos_odbc_perf_t perf = {0};
+  return !!_stmt_perf_counter(&perf, Attribute);
+}
+
+int stmt_perf_get_attr(const taos_odbc_perf_t *perf,
+    SQLINTEGER Attribute, SQLPOINTER Value,
+    SQLINTEGER BufferLength, SQLINTEGER *StringLength)
+{
+  if (Attribute == SQL_ATTR_TAOS_PERF) {
+    if (BufferLength < (SQLINTEGER)sizeof(*perf)) return -1;
+    memcpy(Value, perf, sizeof(*perf));
+    if (StringLength) *StringLength = (SQLINTEGER)sizeof(*perf);
+    return 0;
+  }
+
+  *(SQLBIGINT*)Value = *_stmt_perf_counter((taos_odbc_perf_t*)perf, Attribute);
+  if (StringLength) *StringLength = (SQLINTEGER)sizeof(SQLBIGINT);
+  return 0;
+}
+
+void stmt_perf_dump(const char *who, const void *handle, const taos_odbc_perf_t *perf)
+{
+  TOD_TRACEF(TOD_TRACE_PERF, "%s:%p, rows_fetched:%" PRId64 ", blocks_fetched:%" PRId64 ", bytes_copied:%" PRId64 ", "
+      "iconv_calls:%" PRId64 ", iconv_bytes:%" PRId64 ", taosc_us:%" PRId64 ", convert_us:%" PRId64 ", "
+      "param_rows:%" PRId64 ", batches:%" PRId64 ", catalog_trips:%" PRId64 ", "
+      "topic_polls:%" PRId64 ", topic_polls_empty:%" PRId64 ", topic_poll_us:%" PRId64 ", topic_poll_data_us:%" PRId64 "",
+      who, handle, perf->rows_fetched, perf->blocks_fetched, perf->bytes_copied,
+      perf->iconv_calls, perf->iconv_bytes, perf->taosc_us, perf->convert_us,
+      perf->param_rows, perf->batches, perf->catalog_trips,
+      perf->topic_polls, perf->topic_polls_empty, perf->topic_poll_us, perf->topic_poll_data_us);
+}
+
+static SQLRETURN _stmt_get_attr_perf(stmt_t *stmt,
+           SQLINTEGER Attribute, SQLPOINTER Value,
+           SQLINTEGER BufferLength, SQLINTEGER *StringLength)
+{
+  taos_odbc_perf_t perf = stmt->perf;
+  topic_perf_add(&stmt->topic, &perf);
+  if (stmt_perf_get_attr(&perf, Attribute, Value, BufferLength, StringLength)) {
+    stmt_append_err_format(stmt, "HY090", 0, "Invalid string or buffer length:`%d` for `SQL_ATTR_TAOS_PERF`, `%zd` required",
+        BufferLength, sizeof(perf));
+    return SQL_ERROR;
+  }
+  return SQL_SUCCESS;
+}
+
 #if (ODBCVER >= 0x0300)          /* { */
 SQLRETURN stmt_get_attr(stmt_t *stmt,
            SQLINTEGER Attribute, SQLPOINTER Value,
            SQLINTEGER BufferLength, SQLINTEGER *StringLength)
 {
-  (void)BufferLength;
-  (void)StringLength;
-
   switch (Attribute) {
     case SQL_ATTR_APP_ROW_DESC:
       *(SQLHANDLE*)Value = (SQLHANDLE)(stmt->current_ARD);
@@ -7088,9 +8147,40 @@ SQLRETURN stmt_get_attr(stmt_t *stmt,
       *(SQLULEN*)Value = (SQLULEN)_stmt_get_row_array_size(stmt);
       return SQL_SUCCESS;
     case SQL_ATTR_CURSOR_TYPE:
-      *(SQLULEN*)Value = SQL_CURSOR_FORWARD_ONLY;
+      *(SQLULEN*)Value = stmt->cursor_type;
+      return SQL_SUCCESS;
+    case SQL_ATTR_CURSOR_SCROLLABLE:
+      *(SQLULEN*)Value = (stmt->cursor_type == SQL_CURSOR_STATIC) ? SQL_SCROLLABLE : SQL_NONSCROLLABLE;
+      return SQL_SUCCESS;
+    case SQL_ROWSET_SIZE:
+      *(SQLULEN*)Value = stmt->rowset_size;
+      return SQL_SUCCESS;
+    case SQL_ATTR_QUERY_TIMEOUT:
+      *(SQLULEN*)Value = stmt->query_timeout;
+      return SQL_SUCCESS;
+    case SQL_ATTR_MAX_ROWS:
+      *(SQLULEN*)Value = stmt->max_rows;
+      return SQL_SUCCESS;
+    case SQL_ATTR_ASYNC_ENABLE:
+      *(SQLULEN*)Value = stmt->async.enable;
+      return SQL_SUCCESS;
+    case SQL_ATTR_TAOS_PARALLEL_SCAN:
+      *(SQLULEN*)Value = stmt->parallel_scan;
+      return SQL_SUCCESS;
+    case SQL_ATTR_TAOS_ARROW_STREAM:
+      if (BufferLength < (SQLINTEGER)sizeof(struct ArrowArrayStream)) {
+        stmt_append_err(stmt, "HY090", 0, "Invalid string or buffer length:struct ArrowArrayStream expected");
+        return SQL_ERROR;
+      }
+      if (stmt->base != &stmt->tsdb_stmt.base || stmt->async.op != STMT_ASYNC_NONE) {
+        stmt_append_err(stmt, "HY010", 0, "Function sequence error:no result set of query to export as arrow stream");
+        return SQL_ERROR;
+      }
+      if (tsdb_stmt_export_arrow(&stmt->tsdb_stmt, (struct ArrowArrayStream*)Value) != SQL_SUCCESS) return SQL_ERROR;
+      if (StringLength) *StringLength = (SQLINTEGER)sizeof(struct ArrowArrayStream);
       return SQL_SUCCESS;
     default:
+      if (stmt_perf_is_attr(Attribute)) return _stmt_get_attr_perf(stmt, Attribute, Value, BufferLength, StringLength);
       stmt_append_err_format(stmt, "HY000", 0, "General error:`%s[0x%x/%d]` not supported yet", sql_stmt_attr(Attribute), Attribute, Attribute);
       return SQL_ERROR;
   }
@@ -7104,8 +8194,8 @@ SQLRETURN stmt_free_stmt(stmt_t *stmt, SQLUSMALLINT Option)
       // TODO:
       // stmt_append_err_format(stmt, "01000", 0, "General warning:`%s[0x%x/%d]` not supported yet", sql_free_statement_option(Option), Option, Option);
       // return SQL_SUCCESS_WITH_INFO;
-      _stmt_close_result(stmt);
-      return SQL_SUCCESS;
+      _stmt_close_cursor(stmt);
+      return tsdb_stmt_flush(&stmt->tsdb_stmt);
     case SQL_UNBIND:
       _stmt_unbind_cols(stmt);
       return SQL_SUCCESS;
@@ -7126,8 +8216,13 @@ SQLRETURN stmt_close_cursor(stmt_t *stmt)
   // TODO:
   // stmt_append_err(stmt, "24000", 0, "Invalid cursor state:no cursor is open");
   // return SQL_SUCCESS_WITH_INFO;
-  _stmt_close_result(stmt);
-  return SQL_SUCCESS;
+  _stmt_close_cursor(stmt);
+  return tsdb_stmt_flush(&stmt->tsdb_stmt);
+}
+
+SQLRETURN stmt_flush_deferred(stmt_t *stmt)
+{
+  return tsdb_stmt_flush(&stmt->tsdb_stmt);
 }
 
 void stmt_clr_errs(stmt_t *stmt)
@@ -7344,7 +8439,7 @@ SQLRETURN stmt_col_attribute(
   return SQL_ERROR;
 }
 
-SQLRETURN stmt_more_results(
+static SQLRETURN _stmt_more_results(
     stmt_t         *stmt)
 {
   SQLRETURN sr = SQL_SUCCESS;
@@ -7357,6 +8452,10 @@ SQLRETURN stmt_more_results(
   }
 
   if (stmt->base == &stmt->tsdb_stmt.base) {
+    if (stmt->coalesced.pos < stmt->coalesced.nr) {
+      return _stmt_coalesced_inserts_next(stmt);
+    }
+
     sr = _stmt_get_next_sql(stmt);
     if (sr == SQL_NO_DATA) return SQL_NO_DATA;
 
@@ -7366,6 +8465,16 @@ SQLRETURN stmt_more_results(
   return SQL_NO_DATA;
 }
 
+SQLRETURN stmt_more_results(
+    stmt_t         *stmt)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+  _stmt_call_begin(stmt);
+  if (stmt->async.op != STMT_ASYNC_NONE) sr = _stmt_async_resume(stmt);
+  else                                   sr = _stmt_more_results(stmt);
+  return _stmt_call_end(stmt, sr);
+}
+
 SQLRETURN stmt_columns(
     stmt_t         *stmt,
     SQLCHAR *CatalogName, SQLSMALLINT NameLength1,
@@ -7444,11 +8553,26 @@ SQLRETURN stmt_extended_fetch(
     SQLULEN         *RowCountPtr,
     SQLUSMALLINT    *RowStatusArray)
 {
-  (void)RowCountPtr;
-  (void)RowStatusArray;
-  stmt_append_err_format(stmt, "HY000", 0, "General error:FetchOrientation[%d/0x%x],FetchOffset[%zd/0x%zx] not supported yet",
-      FetchOrientation, FetchOrientation, FetchOffset, FetchOffset);
-  return SQL_ERROR;
+  // NOTE: SQLExtendedFetch is SQLFetchScroll with SQL_ROWSET_SIZE and its own output buffers
+  descriptor_t  *ARD        = _stmt_ARD(stmt);
+  descriptor_t  *IRD        = _stmt_IRD(stmt);
+  SQLULEN        array_size = ARD->header.DESC_ARRAY_SIZE;
+  SQLULEN       *processed  = IRD->header.DESC_ROWS_PROCESSED_PTR;
+  SQLUSMALLINT  *status     = IRD->header.DESC_ARRAY_STATUS_PTR;
+  SQLULEN        rows       = 0;
+
+  ARD->header.DESC_ARRAY_SIZE         = stmt->rowset_size;
+  IRD->header.DESC_ROWS_PROCESSED_PTR = &rows;
+  IRD->header.DESC_ARRAY_STATUS_PTR   = RowStatusArray;
+
+  SQLRETURN sr = stmt_fetch_scroll(stmt, (SQLSMALLINT)FetchOrientation, FetchOffset);
+
+  ARD->header.DESC_ARRAY_SIZE         = array_size;
+  IRD->header.DESC_ROWS_PROCESSED_PTR = processed;
+  IRD->header.DESC_ARRAY_STATUS_PTR   = status;
+
+  if (RowCountPtr) *RowCountPtr = rows;
+  return sr;
 }
 
 SQLRETURN stmt_foreign_keys(
@@ -7732,8 +8856,18 @@ SQLRETURN stmt_complete_async(
     stmt_t      *stmt,
     RETCODE     *AsyncRetCodePtr)
 {
-  (void)AsyncRetCodePtr;
-  stmt_append_err(stmt, "HY000", 0, "General error:not supported yet");
-  return SQL_ERROR;
+  if (stmt->async.op == STMT_ASYNC_NONE) {
+    stmt_append_err(stmt, "HY010", 0, "Function sequence error:no asynchronous function in progress");
+    return SQL_ERROR;
+  }
+
+  // NOTE: unlike re-calling the function, SQLCompleteAsync waits for the operation to complete
+  _stmt_call_begin(stmt);
+  while (!atomic_load(&stmt->async.done)) tod_sleep_ms(1);
+  SQLRETURN sr = _stmt_async_resume(stmt);
+  sr = _stmt_call_end(stmt, sr);
+  if (AsyncRetCodePtr) *AsyncRetCodePtr = sr;
+
+  return SQL_SUCCESS;
 }
 
@@ -511,6 +511,8 @@ static SQLRETURN _tables_add_table_type(tables_t *tables, SQLCHAR *TableType, SQ
   char       *outbuf                = t;
   size_t      outbytesleft          = tables->table_types.cap - tables->table_types.nr;
   size_t n = CALL_iconv(cnv->cnv, &inbuf, &inbytesleft, &outbuf, &outbytesleft);
+  stmt->perf.iconv_calls += 1;
+  stmt->perf.iconv_bytes += (p-begin) - inbytesleft;
   if (n != 0) {
     stmt_append_err_format(tables->owner, "HY000", 0, "convert [%.*s] from %s to %s failed or non-reversible characters found therein",
         (int)NameLength4, (const char*)TableType, cnv->from, cnv->to);
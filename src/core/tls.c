@@ -25,6 +25,7 @@
 #include "internal.h"
 
 #include "charset.h"
+#include "profile.h"
 #include "tls.h"
 
 #include "log.h"
@@ -43,6 +44,8 @@ void tls_release(tls_t *tls)
     tls->mgr = NULL;
   }
   TOD_SAFE_FREE(tls->leakage);
+  profile_thread_release(tls->profile);
+  tls->profile = NULL;
 }
 
 mem_t* tls_get_mem_intermediate(void)
@@ -91,6 +94,13 @@ charset_conv_t* tls_get_charset_conv(const char *fromcode, const char *tocode)
   return charset_conv_mgr_get_charset_conv(tls->mgr, fromcode, tocode);
 }
 
+tz_cache_t* tls_get_tz_cache(void)
+{
+  tls_t *tls = tls_get();
+  if (!tls) return NULL;
+  return &tls->tz_cache;
+}
+
 // debug leakage only
 int tls_leakage_potential(void)
 {
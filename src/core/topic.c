@@ -32,6 +32,7 @@
 #include "conn_parser.h"
 #include "stmt.h"
 #include "taos_helpers.h"
+#include "tsdb.h"
 
 #include <errno.h>
 
@@ -74,47 +75,487 @@ int topic_cfg_append_kv(topic_cfg_t *cfg, const char *k, size_t kn, const char *
   return kvs_append(kvs, k, kn, v, vn);
 }
 
+// _topic_name, _db_name, _vgroup_id, _offset, _committed
+#define TOPIC_PSEUDO_NR          5
+
 static void _topic_release_tripple(topic_t *topic)
 {
   mem_release(&topic->res_topic_name);
   mem_release(&topic->res_db_name);
   topic->res_vgroup_id     = 0;
+  topic->res_offset        = 0;
+  topic->res_committed     = 0;
+  topic->res_committed_fetched = 0;
+}
+
+static int64_t _topic_now_ms(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+static topic_commit_ctx_t* _topic_commit_ctx_create(void)
+{
+  topic_commit_ctx_t *ctx = (topic_commit_ctx_t*)calloc(1, sizeof(*ctx));
+  if (!ctx) return NULL;
+  atomic_store(&ctx->refc, 1);
+  return ctx;
+}
+
+static void _topic_commit_ctx_unref(topic_commit_ctx_t *ctx)
+{
+  if (atomic_fetch_sub(&ctx->refc, 1) == 1) free(ctx);
+}
+
+static void _topic_commit_failed(topic_commit_ctx_t *ctx, int32_t code)
+{
+  atomic_store(&ctx->code, code);
+  atomic_fetch_add(&ctx->failures, 1);
+}
+
+static void _topic_commit_cb(tmq_t *tmq, int32_t code, void *param)
+{
+  (void)tmq;
+  topic_commit_ctx_t *ctx = (topic_commit_ctx_t*)param;
+  if (code) _topic_commit_failed(ctx, code);
+  atomic_fetch_sub(&ctx->pending, 1);
+  _topic_commit_ctx_unref(ctx);
+}
+
+static void _topic_commit_async(topic_t *topic, tmq_t *tmq, const TAOS_RES *res)
+{
+  // NOTE: the callback holds a reference of its own, since taosc might call back after the topic is closed
+  topic_commit_ctx_t *ctx = topic->commit_ctx;
+  atomic_fetch_add(&ctx->refc, 1);
+  atomic_fetch_add(&ctx->pending, 1);
+  CALL_tmq_commit_async(tmq, res, _topic_commit_cb, ctx);
+}
+
+static SQLRETURN _topic_check_commit_failures(topic_t *topic)
+{
+  topic_commit_ctx_t *ctx = topic->commit_ctx;
+  if (!ctx) return SQL_SUCCESS;
+  int failures = atomic_load(&ctx->failures);
+  if (failures == 0) return SQL_SUCCESS;
+  atomic_fetch_sub(&ctx->failures, failures);
+
+  int32_t r = atomic_load(&ctx->code);
+  stmt_append_err_format(topic->owner, "HY000", 0, "General error:[taosc]tmq_commit failed %d time(s), last:[%d/0x%x]%s",
+      failures, r, r, tmq_err2str(r));
+  return SQL_ERROR;
+}
+
+static int _topic_commit_due(topic_t *topic, int64_t committed_at, int64_t uncommitted)
+{
+  if (topic->commit_mode == TOPIC_COMMIT_SYNC) return 1;
+  if (topic->commit_every_ms > 0) return _topic_now_ms() - committed_at >= topic->commit_every_ms;
+  return uncommitted >= topic->commit_every;
+}
+
+static SQLRETURN _topic_commit(topic_t *topic)
+{
+  // NOTE: next res is polled only after current one is used up, thus consumer position equals to what has been consumed
+  //       and committing with msg of NULL covers every res used up since last commit, across all vgroups
+  tmq_t *tmq = topic->consumers[0].tmq;
+  int r = 0;
+  switch (topic->commit_mode) {
+    case TOPIC_COMMIT_SYNC:
+      r = CALL_tmq_commit_sync(tmq, topic->res);
+      break;
+    case TOPIC_COMMIT_ASYNC:
+      _topic_commit_async(topic, tmq, NULL);
+      break;
+    case TOPIC_COMMIT_INTERVAL:
+      r = CALL_tmq_commit_sync(tmq, NULL);
+      break;
+    default:
+      break;
+  }
+  topic->uncommitted = 0;
+  topic->committed_at = _topic_now_ms();
+  if (r) {
+    stmt_append_err_format(topic->owner, "HY000", 0, "General error:[taosc]tmq_commit_sync failed:[%d/0x%x]%s",
+        r, r, tmq_err2str(r));
+    topic->do_not_commit = 1;
+    return SQL_ERROR;
+  }
+  return SQL_SUCCESS;
+}
+
+static int _topic_res_superseded(TAOS_RES **held, size_t nr, size_t i)
+{
+  int32_t vgroup_id = CALL_tmq_get_vgroup_id(held[i]);
+  const char *name = CALL_tmq_get_topic_name(held[i]);
+  for (size_t j=i+1; j<nr; ++j) {
+    if (CALL_tmq_get_vgroup_id(held[j]) != vgroup_id) continue;
+    const char *s = CALL_tmq_get_topic_name(held[j]);
+    if (name && s && strcmp(name, s) == 0) return 1;
+  }
+  return 0;
+}
+
+static void _topic_commit_held(topic_consumer_t *consumer, int final)
+{
+  // NOTE: with prefetch, consumer position runs ahead of what has been consumed, thus commit by res rather than by NULL,
+  //       yet only the last res used up within each vgroup, since committing it covers the earlier ones
+  topic_t *topic = consumer->topic;
+  if (consumer->held_nr == 0) return;
+  if (!final && !_topic_commit_due(topic, consumer->committed_at, (int64_t)consumer->held_nr)) return;
+
+  for (size_t i=0; i<consumer->held_nr; ++i) {
+    TAOS_RES *res = consumer->held[i];
+    if (_topic_res_superseded(consumer->held, consumer->held_nr, i)) continue;
+    if (topic->commit_mode == TOPIC_COMMIT_ASYNC && !final) {
+      _topic_commit_async(topic, consumer->tmq, res);
+    } else {
+      int r = CALL_tmq_commit_sync(consumer->tmq, res);
+      if (r) _topic_commit_failed(topic->commit_ctx, r);
+    }
+  }
+  for (size_t i=0; i<consumer->held_nr; ++i) {
+    CALL_taos_free_result(consumer->held[i]);
+  }
+  consumer->held_nr = 0;
+  consumer->committed_at = _topic_now_ms();
+}
+
+static int _topic_take_done(topic_consumer_t *consumer)
+{
+  // NOTE: called with topic->mutex locked
+  if (consumer->done_nr == 0) return 0;
+  if (consumer->held_nr == 0) {
+    TAOS_RES **p       = consumer->held;
+    size_t cap         = consumer->held_cap;
+    consumer->held     = consumer->done;
+    consumer->held_cap = consumer->done_cap;
+    consumer->held_nr  = consumer->done_nr;
+    consumer->done     = p;
+    consumer->done_cap = cap;
+    consumer->done_nr  = 0;
+    return 0;
+  }
+  if (consumer->held_nr + consumer->done_nr > consumer->held_cap) {
+    size_t cap = (consumer->held_nr + consumer->done_nr + 15) / 16 * 16;
+    TAOS_RES **p = (TAOS_RES**)realloc(consumer->held, sizeof(*p) * cap);
+    if (!p) return -1;
+    consumer->held     = p;
+    consumer->held_cap = cap;
+  }
+  memcpy(consumer->held + consumer->held_nr, consumer->done, sizeof(*consumer->done) * consumer->done_nr);
+  consumer->held_nr += consumer->done_nr;
+  consumer->done_nr  = 0;
+  return 0;
+}
+
+static TAOS_RES* _topic_poll_consumer(topic_consumer_t *consumer, int32_t timeout_ms)
+{
+  topic_t *topic = consumer->topic;
+
+  int64_t t0 = tod_now_us();
+  TAOS_RES *res = CALL_tmq_consumer_poll(consumer->tmq, timeout_ms);
+  int64_t elapsed = tod_now_us() - t0;
+
+  // NOTE: locked, since the app thread might read them thru SQL_ATTR_TAOS_PERF_TOPIC_*
+  pthread_mutex_lock(&topic->mutex);
+  ++consumer->polls;
+  consumer->poll_us_total += elapsed;
+  if (res) consumer->poll_us_data += elapsed;
+  else     ++consumer->polls_empty;
+  pthread_mutex_unlock(&topic->mutex);
+
+  if (res) {
+    // NOTE: data is flowing, keep the timeout short to react quickly
+    consumer->poll_timeout_ms = topic->poll_min_ms;
+  } else {
+    // NOTE: idle, back off exponentially to avoid busy-polling
+    int64_t next = (int64_t)consumer->poll_timeout_ms * 2;
+    consumer->poll_timeout_ms = (int32_t)(next > topic->poll_max_ms ? topic->poll_max_ms : next);
+  }
+
+  return res;
+}
+
+void topic_perf_add(topic_t *topic, taos_odbc_perf_t *perf)
+{
+  pthread_mutex_lock(&topic->mutex);
+  for (size_t i=0; i<topic->consumers_nr; ++i) {
+    topic_consumer_t *consumer = topic->consumers + i;
+    perf->topic_polls        += consumer->polls;
+    perf->topic_polls_empty  += consumer->polls_empty;
+    perf->topic_poll_us      += consumer->poll_us_total;
+    perf->topic_poll_data_us += consumer->poll_us_data;
+  }
+  pthread_mutex_unlock(&topic->mutex);
+}
+
+void topic_perf_reset(topic_t *topic)
+{
+  pthread_mutex_lock(&topic->mutex);
+  for (size_t i=0; i<topic->consumers_nr; ++i) {
+    topic_consumer_t *consumer = topic->consumers + i;
+    consumer->polls         = 0;
+    consumer->polls_empty   = 0;
+    consumer->poll_us_total = 0;
+    consumer->poll_us_data  = 0;
+  }
+  pthread_mutex_unlock(&topic->mutex);
+}
+
+static void _topic_fold_poll_stats(topic_t *topic)
+{
+  // NOTE: called once pollers are stopped, right before consumers are closed
+  taos_odbc_perf_t perf = {0};
+  topic_perf_add(topic, &perf);
+  topic_perf_reset(topic);
+  stmt_perf_add(&topic->owner->perf, &perf);
+
+  int64_t polls = perf.topic_polls, polls_empty = perf.topic_polls_empty;
+  if (polls == 0) return;
+  OD("topic:[%s]%s, consumers:%zd, polls:%" PRId64 ", empty:%" PRId64 ", poll_ms:%" PRId64 ", avg_ms_per_res:%" PRId64 "",
+      topic->cfg.names_nr ? topic->cfg.names[0] : "", topic->cfg.names_nr > 1 ? "..." : "",
+      topic->consumers_nr, polls, polls_empty, perf.topic_poll_us / 1000,
+      (polls > polls_empty) ? perf.topic_poll_data_us / 1000 / (polls - polls_empty) : 0);
+}
+
+static void* _topic_poller_routine(void *arg)
+{
+  topic_consumer_t *consumer = (topic_consumer_t*)arg;
+  topic_t *topic = consumer->topic;
+
+  pthread_mutex_lock(&topic->mutex);
+  while (!topic->poller_stop) {
+    if (consumer->done_nr == 0 && topic->ready_nr == topic->prefetch) {
+      // NOTE: timed, to give interval-commit a chance while the app is idle
+      tod_cond_timedwait_ms(&topic->cond, &topic->mutex, 100);
+      if (topic->poller_stop) break;
+    }
+    int r = _topic_take_done(consumer);
+    int room = topic->ready_nr < topic->prefetch;
+    pthread_mutex_unlock(&topic->mutex);
+
+    if (r == 0) _topic_commit_held(consumer, 0);
+    TAOS_RES *res = room ? _topic_poll_consumer(consumer, consumer->poll_timeout_ms) : NULL;
+    // NOTE: tmq is not thread-safe, and the app thread is not supposed to touch it while the poller is running,
+    //       thus fetched here for `_committed`, at the cost of a round trip per res whether asked for or not
+    int64_t committed = res ? CALL_tmq_committed(consumer->tmq, CALL_tmq_get_topic_name(res), CALL_tmq_get_vgroup_id(res)) : 0;
+
+    pthread_mutex_lock(&topic->mutex);
+    if (res) {
+      // NOTE: with multiple consumers, the ring might have been filled up by others in the meantime
+      while (topic->ready_nr == topic->prefetch && !topic->poller_stop) {
+        pthread_cond_wait(&topic->cond, &topic->mutex);
+      }
+      if (topic->ready_nr == topic->prefetch) {
+        // stopping, leave it uncommitted to be redelivered
+        CALL_taos_free_result(res);
+        break;
+      }
+      size_t i = (topic->ready_head + topic->ready_nr) % topic->prefetch;
+      topic->ready[i]      = res;
+      topic->ready_from[i] = consumer;
+      topic->ready_committed[i] = committed;
+      ++topic->ready_nr;
+      pthread_cond_broadcast(&topic->cond);
+    }
+  }
+  pthread_mutex_unlock(&topic->mutex);
+
+  return NULL;
+}
+
+static void _topic_stop_pollers(topic_t *topic)
+{
+  if (!topic->poller_running) return;
+
+  pthread_mutex_lock(&topic->mutex);
+  topic->poller_stop = 1;
+  pthread_cond_broadcast(&topic->cond);
+  pthread_mutex_unlock(&topic->mutex);
+  for (size_t i=0; i<topic->consumers_nr; ++i) {
+    topic_consumer_t *consumer = topic->consumers + i;
+    if (!consumer->poller) continue;
+    pthread_join(consumer->poller, NULL);
+    consumer->poller = 0;
+  }
+  topic->poller_running = 0;
+
+  // NOTE: prefetched but not yet seen by the app, leave them uncommitted to be redelivered
+  for (size_t i=0; i<topic->ready_nr; ++i) {
+    CALL_taos_free_result(topic->ready[(topic->ready_head + i) % topic->prefetch]);
+  }
+  topic->ready_head = 0;
+  topic->ready_nr   = 0;
+
+  for (size_t i=0; i<topic->consumers_nr; ++i) {
+    topic_consumer_t *consumer = topic->consumers + i;
+    _topic_commit_held(consumer, 1);
+    if (_topic_take_done(consumer) == 0) _topic_commit_held(consumer, 1);
+  }
+}
+
+static SQLRETURN _topic_start_pollers(topic_t *topic)
+{
+  if (topic->prefetch == 0) return SQL_SUCCESS;
+
+  TAOS_RES **p = (TAOS_RES**)realloc(topic->ready, sizeof(*p) * topic->prefetch);
+  if (!p) {
+    stmt_oom(topic->owner);
+    return SQL_ERROR;
+  }
+  topic->ready = p;
+  topic_consumer_t **from = (topic_consumer_t**)realloc(topic->ready_from, sizeof(*from) * topic->prefetch);
+  if (!from) {
+    stmt_oom(topic->owner);
+    return SQL_ERROR;
+  }
+  topic->ready_from  = from;
+  int64_t *committed = (int64_t*)realloc(topic->ready_committed, sizeof(*committed) * topic->prefetch);
+  if (!committed) {
+    stmt_oom(topic->owner);
+    return SQL_ERROR;
+  }
+  topic->ready_committed = committed;
+  topic->ready_head  = 0;
+  topic->ready_nr    = 0;
+  topic->poller_stop = 0;
+
+  for (size_t i=0; i<topic->consumers_nr; ++i) {
+    topic_consumer_t *consumer = topic->consumers + i;
+    int r = pthread_create(&consumer->poller, NULL, _topic_poller_routine, consumer);
+    if (r) {
+      consumer->poller = 0;
+      stmt_append_err_format(topic->owner, "HY000", 0, "General error:failed to start topic poller:[%d]%s", r, strerror(r));
+      _topic_stop_pollers(topic);
+      return SQL_ERROR;
+    }
+    topic->poller_running = 1;
+  }
+
+  return SQL_SUCCESS;
+}
+
+static TAOS_RES* _topic_dequeue(topic_t *topic, int timeout_ms)
+{
+  TAOS_RES *res = NULL;
+
+  pthread_mutex_lock(&topic->mutex);
+  if (topic->ready_nr == 0) tod_cond_timedwait_ms(&topic->cond, &topic->mutex, timeout_ms);
+  if (topic->ready_nr) {
+    res             = topic->ready[topic->ready_head];
+    topic->res_from = topic->ready_from[topic->ready_head];
+    topic->res_committed = topic->ready_committed[topic->ready_head];
+    topic->res_committed_fetched = 1;
+    topic->ready_head = (topic->ready_head + 1) % topic->prefetch;
+    --topic->ready_nr;
+    pthread_cond_broadcast(&topic->cond);
+  }
+  pthread_mutex_unlock(&topic->mutex);
+
+  return res;
+}
+
+static SQLRETURN _topic_hand_over(topic_t *topic)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+  topic_consumer_t *consumer = topic->res_from;
+
+  pthread_mutex_lock(&topic->mutex);
+  if (consumer->done_nr == consumer->done_cap) {
+    size_t cap = consumer->done_cap + 16;
+    TAOS_RES **p = (TAOS_RES**)realloc(consumer->done, sizeof(*p) * cap);
+    if (p) {
+      consumer->done     = p;
+      consumer->done_cap = cap;
+    }
+  }
+  if (consumer->done_nr < consumer->done_cap) {
+    consumer->done[consumer->done_nr++] = topic->res;
+    topic->res = NULL;
+    pthread_cond_broadcast(&topic->cond);
+  }
+  pthread_mutex_unlock(&topic->mutex);
+
+  if (topic->res) {
+    stmt_oom(topic->owner);
+    sr = SQL_ERROR;
+  }
+
+  return sr;
 }
 
 static void _topic_reset_res(topic_t *topic, SQLRETURN *psr)
 {
   SQLRETURN sr = SQL_SUCCESS;
   if (topic->res && !topic->do_not_commit) {
-    int r = CALL_tmq_commit_sync(topic->tmq, topic->res);
-    if (r) {
-      stmt_append_err_format(topic->owner, "HY000", 0, "General error:[taosc]tmq_commit_sync failed:[%d/0x%x]%s",
-          r, r, tmq_err2str(r));
-      topic->do_not_commit = 1;
-      sr = SQL_ERROR;
+    sr = _topic_check_commit_failures(topic);
+    if (topic->poller_running) {
+      if (_topic_hand_over(topic) != SQL_SUCCESS) sr = SQL_ERROR;
+    } else {
+      ++topic->uncommitted;
+      if (sr == SQL_SUCCESS && _topic_commit_due(topic, topic->committed_at, topic->uncommitted)) sr = _topic_commit(topic);
     }
   }
   if (topic->res) {
     CALL_taos_free_result(topic->res);
     topic->res = NULL;
   }
+  topic->res_from = NULL;
+  tsdb_rows_block_reset(&topic->rows_block);
   if (psr) *psr = sr;
 }
 
+static void _topic_final_commit(topic_t *topic)
+{
+  _topic_stop_pollers(topic);
+
+  if (topic->uncommitted && !topic->do_not_commit) {
+    int r = CALL_tmq_commit_sync(topic->consumers[0].tmq, NULL);
+    if (r) {
+      stmt_append_err_format(topic->owner, "HY000", 0, "General error:[taosc]tmq_commit_sync failed:[%d/0x%x]%s",
+          r, r, tmq_err2str(r));
+    }
+    topic->uncommitted = 0;
+  }
+
+  // NOTE: late callbacks are safe as they only refer to `commit_ctx`, yet give them a while to report failures
+  topic_commit_ctx_t *ctx = topic->commit_ctx;
+  for (int i=0; ctx && i<100 && atomic_load(&ctx->pending) > 0; ++i) {
+    tod_sleep_ms(10);
+  }
+  (void)_topic_check_commit_failures(topic);
+}
+
+static void _topic_close_consumer(topic_consumer_t *consumer)
+{
+  if (consumer->subscribed) {
+    CALL_tmq_unsubscribe(consumer->tmq);
+    consumer->subscribed = 0;
+  }
+  if (consumer->tmq) {
+    CALL_tmq_consumer_close(consumer->tmq);
+    consumer->tmq = NULL;
+  }
+  TOD_SAFE_FREE(consumer->done);
+  consumer->done_cap = 0;
+  TOD_SAFE_FREE(consumer->held);
+  consumer->held_cap = 0;
+}
+
 static void _topic_reset_tmq(topic_t *topic)
 {
-  if (!topic->tmq) return;
-  if (topic->subscribed) {
-    CALL_tmq_unsubscribe(topic->tmq);
-    topic->subscribed = 0;
+  if (topic->consumers_nr == 0) return;
+  _topic_final_commit(topic);
+  _topic_fold_poll_stats(topic);
+  for (size_t i=0; i<topic->consumers_nr; ++i) {
+    _topic_close_consumer(topic->consumers + i);
   }
-  CALL_tmq_consumer_close(topic->tmq);
-  topic->tmq = NULL;
+  topic->consumers_nr = 0;
 }
 
 void topic_reset(topic_t *topic)
 {
   if (!topic) return;
-  topic->row = NULL;
   _topic_reset_res(topic, NULL);
   _topic_reset_tmq(topic);
   topic->fields_nr = 0;
@@ -134,10 +575,28 @@ void topic_release(topic_t *topic)
   topic_cfg_release(&topic->cfg);
   TOD_SAFE_FREE(topic->fields);
   topic->fields_cap = 0;
+  tsdb_rows_block_release(&topic->rows_block);
+  TOD_SAFE_FREE(topic->ready);
+  TOD_SAFE_FREE(topic->ready_from);
+  TOD_SAFE_FREE(topic->ready_committed);
+  TOD_SAFE_FREE(topic->consumers);
+  topic->consumers_cap = 0;
+  if (topic->commit_ctx) {
+    _topic_commit_ctx_unref(topic->commit_ctx);
+    topic->commit_ctx = NULL;
+  }
   _topic_release_conf(topic);
   _topic_release_tripple(topic);
 }
 
+void topic_destroy(topic_t *topic)
+{
+  // NOTE: topic_release is called whenever the result is released, whereas mutex/cond live as long as the stmt
+  topic_release(topic);
+  pthread_cond_destroy(&topic->cond);
+  pthread_mutex_destroy(&topic->mutex);
+}
+
 static SQLRETURN _prepare(stmt_base_t *base, const sqlc_tsdb_t *sqlc_tsdb)
 {
   (void)sqlc_tsdb;
@@ -197,6 +656,8 @@ static SQLRETURN _topic_desc_tripple(topic_t *topic)
   }
 
   topic->res_vgroup_id  = CALL_tmq_get_vgroup_id(topic->res);
+  topic->res_offset     = CALL_tmq_get_vgroup_offset(topic->res);
+  topic->res_precision  = CALL_taos_result_precision(topic->res);
 
   TAOS_FIELD *fields = CALL_taos_fetch_fields(topic->res);
   if (!fields) {
@@ -211,21 +672,23 @@ static SQLRETURN _topic_desc_tripple(topic_t *topic)
     "_topic_name",
     "_db_name",
     "_vgroup_id",
+    "_offset",
+    "_committed",
   };
   for (size_t i=0; i<nr; ++i) {
     TAOS_FIELD *field = fields + i;
     for (size_t j=0; j<sizeof(pseudos)/sizeof(pseudos[0]); ++j) {
-      if (tod_strncasecmp(field->name, pseudos[i], sizeof(field->name)) == 0) {
+      if (tod_strncasecmp(field->name, pseudos[j], sizeof(field->name)) == 0) {
         stmt_append_err_format(topic->owner, "HY000", 0,
             "General error:column[%zd]`%.*s` in select list conflicts with the pseudo-name:[%s]",
-            i+1, (int)sizeof(field->name), field->name, pseudos[i]);
+            i+1, (int)sizeof(field->name), field->name, pseudos[j]);
         return SQL_ERROR;
       }
     }
   }
 
-  if (nr + 3 > topic->fields_cap) {
-    size_t cap = (nr + 3 + 15) / 16 * 16;
+  if (nr + TOPIC_PSEUDO_NR > topic->fields_cap) {
+    size_t cap = (nr + TOPIC_PSEUDO_NR + 15) / 16 * 16;
     TAOS_FIELD *p = (TAOS_FIELD*)realloc(topic->fields, sizeof(*p) * cap);
     if (!p) {
       stmt_oom(topic->owner);
@@ -234,9 +697,9 @@ static SQLRETURN _topic_desc_tripple(topic_t *topic)
     topic->fields        = p;
     topic->fields_cap    = cap;
   }
-  topic->fields_nr = nr + 3;
+  topic->fields_nr = nr + TOPIC_PSEUDO_NR;
 
-  memcpy(topic->fields + 3, fields, nr * sizeof(*fields));
+  memcpy(topic->fields + TOPIC_PSEUDO_NR, fields, nr * sizeof(*fields));
   snprintf(topic->fields[0].name, sizeof(topic->fields[0].name), "_topic_name");
   snprintf(topic->fields[1].name, sizeof(topic->fields[1].name), "_db_name");
   snprintf(topic->fields[2].name, sizeof(topic->fields[2].name), "_vgroup_id");
@@ -246,6 +709,12 @@ static SQLRETURN _topic_desc_tripple(topic_t *topic)
   topic->fields[1].bytes = (int32_t)topic->res_db_name.nr;
   topic->fields[2].type = TSDB_DATA_TYPE_INT;
   topic->fields[2].bytes = sizeof(int32_t);
+  snprintf(topic->fields[3].name, sizeof(topic->fields[3].name), "_offset");
+  snprintf(topic->fields[4].name, sizeof(topic->fields[4].name), "_committed");
+  topic->fields[3].type = TSDB_DATA_TYPE_BIGINT;
+  topic->fields[3].bytes = sizeof(int64_t);
+  topic->fields[4].type = TSDB_DATA_TYPE_BIGINT;
+  topic->fields[4].bytes = sizeof(int64_t);
 
   if (topic_change) return SQL_NO_DATA;
 
@@ -261,14 +730,28 @@ static SQLRETURN _poll(topic_t *topic)
       stmt_append_err_format(topic->owner, "HY000", 0, "General error:taos_odbc.limit.records[%" PRId64 "] has been reached", topic->records_max);
       return SQL_NO_DATA;
     }
-    time_t t1 = time(NULL);
-    if (topic->seconds_max >= 0 && difftime(t1, topic->t0) > topic->seconds_max) {
+    int64_t elapsed = _topic_now_ms() - topic->t0;
+    if (topic->seconds_max >= 0 && elapsed > topic->seconds_max * 1000) {
       stmt_append_err_format(topic->owner, "HY000", 0, "General error:taos_odbc.limit.seconds[%" PRId64 "] has been reached", topic->seconds_max);
       return SQL_NO_DATA;
     }
 
-    int32_t timeout = 100;
-    topic->res = CALL_tmq_consumer_poll(topic->tmq, timeout);
+    topic_consumer_t *consumer = topic->consumers;
+    int32_t timeout = topic->poller_running ? topic->poll_max_ms : consumer->poll_timeout_ms;
+    if (topic->seconds_max >= 0) {
+      // NOTE: wake up in time for taos_odbc.limit.seconds
+      int64_t remain = topic->seconds_max * 1000 - elapsed + 1;
+      if (remain < timeout) timeout = (int32_t)remain;
+    }
+    int64_t t0 = tod_now_us();
+    if (topic->poller_running) {
+      topic->res = _topic_dequeue(topic, timeout);
+    } else {
+      topic->res = _topic_poll_consumer(consumer, timeout);
+      topic->res_from = consumer;
+      topic->res_committed_fetched = 0;
+    }
+    topic->owner->perf.taosc_us += tod_now_us() - t0;
     if (topic->res) {
       sr = _topic_desc_tripple(topic);
       if (sr == SQL_NO_DATA) return SQL_NO_DATA;
@@ -296,14 +779,17 @@ static SQLRETURN _execute(stmt_base_t *base)
   return SQL_SUCCESS;
 }
 
+void topic_fetch_begin(topic_t *topic)
+{
+  topic->rows_in_fetch = 0;
+}
+
 static SQLRETURN _fetch_row(stmt_base_t *base)
 {
   SQLRETURN sr = SQL_SUCCESS;
 
   topic_t *topic = (topic_t*)base;
-  (void)topic;
-
-  TAOS_ROW row = NULL;
+  tsdb_rows_block_t *rows_block = &topic->rows_block;
 
 again:
 
@@ -311,16 +797,29 @@ again:
   if (sr == SQL_NO_DATA) return SQL_NO_DATA;
   if (sr != SQL_SUCCESS) return SQL_ERROR;
 
-  row = CALL_taos_fetch_row(topic->res);
-  if (row == NULL) {
-    // NOTE: once no row is available, which implicitly means that user has traversed all rows within current res
-    //       this seems the right time to call tmq_commit_sync
-    _topic_reset_res(topic, &sr);
-    if (sr != SQL_SUCCESS) return SQL_ERROR;
-    goto again;
+  if (rows_block->pos >= rows_block->nr) {
+    int64_t t0 = tod_now_us();
+    int nr = tsdb_rows_block_fetch(rows_block, topic->res, topic->fields + TOPIC_PSEUDO_NR, topic->fields_nr - TOPIC_PSEUDO_NR);
+    topic->owner->perf.taosc_us += tod_now_us() - t0;
+    if (nr > 0) topic->owner->perf.blocks_fetched += 1;
+    if (nr < 0) {
+      stmt_oom(topic->owner);
+      return SQL_ERROR;
+    }
+    if (nr == 0) {
+      // NOTE: rows already delivered into the row-array of current SQLFetch are not yet seen by the application,
+      //       thus defer commit to the next SQLFetch
+      if (topic->rows_in_fetch) return SQL_NO_DATA;
+      // NOTE: once no row is available, which implicitly means that user has traversed all rows within current res
+      //       this seems the right time to call tmq_commit_sync
+      _topic_reset_res(topic, &sr);
+      if (sr != SQL_SUCCESS) return SQL_ERROR;
+      goto again;
+    }
   }
 
-  topic->row = row;
+  ++rows_block->pos;
+  ++topic->rows_in_fetch;
   ++topic->records_count;
   return SQL_SUCCESS;
 }
@@ -395,8 +894,7 @@ static SQLRETURN _get_num_cols(stmt_base_t *base, SQLSMALLINT *ColumnCountPtr)
 static SQLRETURN _get_data(stmt_base_t *base, SQLUSMALLINT Col_or_Param_Num, tsdb_data_t *tsdb)
 {
   topic_t *topic = (topic_t*)base;
-  TAOS_ROW row = topic->row;
-  if (!row) {
+  if (topic->rows_block.pos == 0) {
     stmt_append_err(topic->owner, "HY000", 0, "General error:not implemented yet");
     return SQL_ERROR;
   }
@@ -405,8 +903,6 @@ static SQLRETURN _get_data(stmt_base_t *base, SQLUSMALLINT Col_or_Param_Num, tsd
 
   int i = Col_or_Param_Num - 1;
 
-  TAOS_FIELD *field = fields + i;
-
   if (i == 0) {
     tsdb->is_null                = 0;
     tsdb->type                   = TSDB_DATA_TYPE_VARCHAR;
@@ -430,76 +926,32 @@ static SQLRETURN _get_data(stmt_base_t *base, SQLUSMALLINT Col_or_Param_Num, tsd
     return SQL_SUCCESS;
   }
 
-  int *offsets = CALL_taos_get_column_data_offset(topic->res, i-3);
-
-  char *col = row[i-3];
-  if (col) col += offsets ? *offsets : 0;
-
-  tsdb->type = field->type;
-  if (col == NULL) {
-    tsdb->is_null = 1;
+  if (i == 3) {
+    tsdb->is_null                = (topic->res_offset < 0);
+    tsdb->type                   = TSDB_DATA_TYPE_BIGINT;
+    tsdb->i64                    = topic->res_offset;
     return SQL_SUCCESS;
   }
-  tsdb->is_null = 0;
-  switch (tsdb->type) {
-    case TSDB_DATA_TYPE_TINYINT:
-      tsdb->i8 = *(int8_t*)col;
-      break;
-
-    case TSDB_DATA_TYPE_UTINYINT:
-      tsdb->u8 = *(uint8_t*)col;
-      break;
-
-    case TSDB_DATA_TYPE_SMALLINT:
-      tsdb->i16 = *(int16_t*)col;
-      break;
-
-    case TSDB_DATA_TYPE_USMALLINT:
-      tsdb->u16 = *(uint16_t*)col;
-      break;
-
-    case TSDB_DATA_TYPE_INT:
-      tsdb->i32 = *(int32_t*)col;
-      break;
-
-    case TSDB_DATA_TYPE_UINT:
-      tsdb->u32 = *(uint32_t*)col;
-      break;
-
-    case TSDB_DATA_TYPE_BIGINT:
-      tsdb->i64 = *(int64_t*)col;
-      break;
-
-    case TSDB_DATA_TYPE_UBIGINT:
-      tsdb->u64 = *(uint64_t*)col;
-      break;
-
-    case TSDB_DATA_TYPE_FLOAT:
-      tsdb->flt = *(float*)col;
-      break;
-
-    case TSDB_DATA_TYPE_DOUBLE:
-      tsdb->dbl = *(double*)col;
-      break;
 
-    case TSDB_DATA_TYPE_VARCHAR:
-    case TSDB_DATA_TYPE_NCHAR:
-      tsdb->str.len = *(int16_t*)(col - sizeof(int16_t));
-      tsdb->str.str = col;
-      break;
-
-    case TSDB_DATA_TYPE_TIMESTAMP:
-      tsdb->ts.ts = *(int64_t*)col;
-      tsdb->ts.precision = CALL_taos_result_precision(topic->res);
-      break;
-
-    case TSDB_DATA_TYPE_BOOL:
-      tsdb->b = !!*(int8_t*)col;
-      break;
+  if (i == 4) {
+    // NOTE: costs a round trip, thus fetched only when asked for, and once per res, unless already fetched by the poller
+    if (!topic->res_committed_fetched) {
+      topic->res_committed = CALL_tmq_committed(topic->res_from->tmq, (const char*)topic->res_topic_name.base, topic->res_vgroup_id);
+      topic->res_committed_fetched = 1;
+    }
+    tsdb->is_null                = (topic->res_committed < 0);
+    tsdb->type                   = TSDB_DATA_TYPE_BIGINT;
+    tsdb->i64                    = topic->res_committed;
+    return SQL_SUCCESS;
+  }
 
-    default:
-      stmt_append_err_format(topic->owner, "HY000", 0, "General error:`%s` not supported yet", taos_data_type(tsdb->type));
-      return SQL_ERROR;
+  tsdb_rows_block_t *rows_block = &topic->rows_block;
+  char buf[4096];
+  int r = helper_get_tsdb_block(topic->res, rows_block->offsets, fields + TOPIC_PSEUDO_NR, topic->res_precision,
+      rows_block->rows, (int)rows_block->pos - 1, i - TOPIC_PSEUDO_NR, tsdb, buf, sizeof(buf));
+  if (r) {
+    stmt_append_err_format(topic->owner, "HY000", 0, "General error:%.*s", (int)strlen(buf), buf);
+    return SQL_ERROR;
   }
 
   return SQL_SUCCESS;
@@ -509,6 +961,9 @@ void topic_init(topic_t *topic, stmt_t *stmt)
 {
   topic->owner = stmt;
 
+  pthread_mutex_init(&topic->mutex, NULL);
+  pthread_cond_init(&topic->cond, NULL);
+
   stmt_base_t *base = &topic->base;
 
   base->prepare                      = _prepare;
@@ -529,6 +984,111 @@ static void _tmq_commit_cb_print(tmq_t* tmq, int32_t code, void* param)
   if (0) fprintf(stderr, "%s(): code: %d, tmq: %p, param: %p\n", __func__, code, tmq, param);
 }
 
+static int _topic_is_seek_key(const char *key, int32_t *vgroup_id)
+{
+  static const char prefix[] = "taos_odbc.seek";
+  const size_t n = sizeof(prefix) - 1;
+  if (tod_strncasecmp(key, prefix, n)) return 0;
+  if (key[n] == '\0') {
+    if (vgroup_id) *vgroup_id = -1;
+    return 1;
+  }
+  if (key[n] != '.') return 0;
+
+  const char *p = key + n + 1;
+  char *end = NULL;
+  errno = 0;
+  long v = strtol(p, &end, 10);
+  if (errno || end == p || *end || v < 0 || v > INT32_MAX) return 0;
+  if (vgroup_id) *vgroup_id = (int32_t)v;
+  return 1;
+}
+
+static int _topic_seek_offset(const char *val, const tmq_topic_assignment *assignment, int64_t *offset)
+{
+  // NOTE: tmq offsets are wal-versions rather than timestamps, thus seeking by timestamp is not supported by taosc
+  if (tod_strcasecmp(val, "earliest") == 0) {
+    *offset = assignment ? assignment->begin : 0;
+    return 0;
+  }
+  if (tod_strcasecmp(val, "latest") == 0) {
+    *offset = assignment ? assignment->end : 0;
+    return 0;
+  }
+
+  char *end = NULL;
+  errno = 0;
+  long long v = strtoll(val, &end, 10);
+  if (errno || end == val || *end || v < 0) return -1;
+  *offset = v;
+  return 0;
+}
+
+static const char* _topic_seek_val(topic_t *topic, int32_t vgroup_id)
+{
+  const char *val = NULL;
+  kvs_t *kvs = &topic->cfg.kvs;
+  for (size_t i=0; i<kvs->nr; ++i) {
+    kv_t *kv = kvs->kvs + i;
+    int32_t id;
+    if (!kv->val || !_topic_is_seek_key(kv->key, &id)) continue;
+    if (id == vgroup_id) return kv->val;
+    if (id == -1) val = kv->val;
+  }
+  return val;
+}
+
+static SQLRETURN _topic_seek_consumer(topic_t *topic, topic_consumer_t *consumer, const char *name)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+
+  tmq_topic_assignment *assignments = NULL;
+  int32_t nr = 0;
+  int32_t r = CALL_tmq_get_topic_assignment(consumer->tmq, name, &assignments, &nr);
+  if (r) {
+    stmt_append_err_format(topic->owner, "HY000", 0, "General error:[taosc]tmq_get_topic_assignment(%s) failed:[%d/0x%x]%s",
+        name, r, r, tmq_err2str(r));
+    return SQL_ERROR;
+  }
+
+  for (int32_t i=0; i<nr; ++i) {
+    tmq_topic_assignment *assignment = assignments + i;
+    const char *val = _topic_seek_val(topic, assignment->vgId);
+    if (!val) continue;
+    int64_t offset = 0;
+    if (_topic_seek_offset(val, assignment, &offset)) continue;
+    r = CALL_tmq_offset_seek(consumer->tmq, name, assignment->vgId, offset);
+    if (r) {
+      stmt_append_err_format(topic->owner, "HY000", 0, "General error:[taosc]tmq_offset_seek(%s,vgroup:%d,offset:%" PRId64 ") failed:[%d/0x%x]%s",
+          name, assignment->vgId, offset, r, r, tmq_err2str(r));
+      sr = SQL_ERROR;
+      break;
+    }
+  }
+
+  if (assignments) CALL_tmq_free_assignment(assignments);
+  return sr;
+}
+
+static SQLRETURN _topic_seek(topic_t *topic)
+{
+  int found = 0;
+  kvs_t *kvs = &topic->cfg.kvs;
+  for (size_t i=0; i<kvs->nr && !found; ++i) {
+    found = kvs->kvs[i].val && _topic_is_seek_key(kvs->kvs[i].key, NULL);
+  }
+  if (!found) return SQL_SUCCESS;
+
+  for (size_t i=0; i<topic->consumers_nr; ++i) {
+    for (size_t j=0; j<topic->cfg.names_nr; ++j) {
+      SQLRETURN sr = _topic_seek_consumer(topic, topic->consumers + i, topic->cfg.names[j]);
+      if (sr != SQL_SUCCESS) return SQL_ERROR;
+    }
+  }
+
+  return SQL_SUCCESS;
+}
+
 static SQLRETURN _build_consumer(topic_t *topic)
 {
   // https://github.com/taosdata/TDengine/blob/main/docs/en/07-develop/07-tmq.mdx#create-a-consumer
@@ -545,6 +1105,14 @@ static SQLRETURN _build_consumer(topic_t *topic)
   // msg.with.table.name
   // taos_odbc.limit.records        /* return SQL_NO_DATA once # of records has been reached */
   // taos_odbc.limit.seconds        /* return SQL_NO_DATA once # of seconds has passed */
+  // taos_odbc.commit.mode          /* sync[default]|async|interval */
+  // taos_odbc.commit.every         /* commit once every N res or Nms, for async/interval mode */
+  // taos_odbc.prefetch             /* # of res polled ahead by a background poller, 0[default] to poll inline */
+  // taos_odbc.consumers            /* # of consumers within the same group.id, polled concurrently, 1[default] */
+  // taos_odbc.poll.min_ms          /* poll timeout while data is flowing, 10[default] */
+  // taos_odbc.poll.max_ms          /* poll timeout backs off up to this while idle, 500[default] */
+  // taos_odbc.seek                 /* earliest|latest|<offset>, where to start within every assigned vgroup */
+  // taos_odbc.seek.<vgroup_id>     /* earliest|latest|<offset>, where to start within the specific vgroup */
 
   _topic_release_conf(topic);
 
@@ -558,6 +1126,14 @@ static SQLRETURN _build_consumer(topic_t *topic)
 
   topic->records_max = -1;
   topic->seconds_max = -1;
+  topic->commit_mode = TOPIC_COMMIT_SYNC;
+  topic->commit_every = 1;
+  topic->commit_every_ms = 0;
+  int commit_every_set = 0;
+  topic->prefetch = 0;
+  size_t consumers = 1;
+  topic->poll_min_ms = 10;
+  topic->poll_max_ms = 500;
 
   tmq_conf_t *conf = topic->conf;
 
@@ -573,6 +1149,79 @@ static SQLRETURN _build_consumer(topic_t *topic)
       topic->seconds_max = atoi(kv->val);
       continue;
     }
+    if (_topic_is_seek_key(kv->key, NULL)) {
+      int64_t offset;
+      if (_topic_seek_offset(kv->val, NULL, &offset)) {
+        stmt_append_err_format(topic->owner, "HY000", 0,
+            "General error:%s[%s] invalid, earliest/latest/<offset> expected",
+            kv->key, kv->val);
+        return SQL_ERROR;
+      }
+      continue;
+    }
+    if (tod_strcasecmp(kv->key, "taos_odbc.poll.min_ms") == 0 || tod_strcasecmp(kv->key, "taos_odbc.poll.max_ms") == 0) {
+      int n = atoi(kv->val);
+      if (n <= 0) {
+        stmt_append_err_format(topic->owner, "HY000", 0,
+            "General error:%s[%s] invalid, positive integer expected",
+            kv->key, kv->val);
+        return SQL_ERROR;
+      }
+      if (tod_strcasecmp(kv->key, "taos_odbc.poll.min_ms") == 0) topic->poll_min_ms = n;
+      else                                                        topic->poll_max_ms = n;
+      continue;
+    }
+    if (tod_strcasecmp(kv->key, "taos_odbc.consumers") == 0) {
+      int n = atoi(kv->val);
+      if (n <= 0) {
+        stmt_append_err_format(topic->owner, "HY000", 0,
+            "General error:taos_odbc.consumers[%s] invalid, positive integer expected",
+            kv->val);
+        return SQL_ERROR;
+      }
+      consumers = (size_t)n;
+      continue;
+    }
+    if (tod_strcasecmp(kv->key, "taos_odbc.prefetch") == 0) {
+      int n = atoi(kv->val);
+      topic->prefetch = n > 0 ? (size_t)n : 0;
+      continue;
+    }
+    if (tod_strcasecmp(kv->key, "taos_odbc.commit.mode") == 0) {
+      if (tod_strcasecmp(kv->val, "sync") == 0) {
+        topic->commit_mode = TOPIC_COMMIT_SYNC;
+      } else if (tod_strcasecmp(kv->val, "async") == 0) {
+        topic->commit_mode = TOPIC_COMMIT_ASYNC;
+      } else if (tod_strcasecmp(kv->val, "interval") == 0) {
+        topic->commit_mode = TOPIC_COMMIT_INTERVAL;
+      } else {
+        stmt_append_err_format(topic->owner, "HY000", 0,
+            "General error:taos_odbc.commit.mode[%s] not supported, valid values are sync/async/interval",
+            kv->val);
+        return SQL_ERROR;
+      }
+      continue;
+    }
+    if (tod_strcasecmp(kv->key, "taos_odbc.commit.every") == 0) {
+      char *end = NULL;
+      errno = 0;
+      long long n = strtoll(kv->val, &end, 10);
+      if (errno || end == kv->val || n <= 0 || (*end && tod_strcasecmp(end, "ms"))) {
+        stmt_append_err_format(topic->owner, "HY000", 0,
+            "General error:taos_odbc.commit.every[%s] invalid, positive N or Nms expected",
+            kv->val);
+        return SQL_ERROR;
+      }
+      if (*end) {
+        topic->commit_every    = 1;
+        topic->commit_every_ms = n;
+      } else {
+        topic->commit_every    = n;
+        topic->commit_every_ms = 0;
+      }
+      commit_every_set = 1;
+      continue;
+    }
     code = CALL_tmq_conf_set(conf, kv->key, kv->val);
     if (code != TMQ_CONF_OK) {
       stmt_append_err_format(topic->owner, "HY000", 0,
@@ -582,13 +1231,46 @@ static SQLRETURN _build_consumer(topic_t *topic)
     }
   }
 
+  if (topic->commit_mode == TOPIC_COMMIT_INTERVAL && !commit_every_set) topic->commit_every_ms = 1000;
+
+  if (!topic->commit_ctx) {
+    topic->commit_ctx = _topic_commit_ctx_create();
+    if (!topic->commit_ctx) {
+      stmt_oom(topic->owner);
+      return SQL_ERROR;
+    }
+  }
+
   if (0) CALL_tmq_conf_set_auto_commit_cb(conf, _tmq_commit_cb_print, NULL);
 
+  if (topic->poll_max_ms < topic->poll_min_ms) topic->poll_max_ms = topic->poll_min_ms;
+
+  // NOTE: consumers other than the first one are only reachable through background pollers
+  if (consumers > 1 && topic->prefetch < consumers) topic->prefetch = consumers;
+
   _topic_reset_tmq(topic);
-  topic->tmq = CALL_tmq_consumer_new(conf, NULL, 0);
-  if (!topic->tmq) {
-    stmt_append_err(topic->owner, "HY000", 0, "General error:[taosc]tmq_consumer_new failed:reason unknown, but don't forget to specifi `group.id`");
-    return SQL_ERROR;
+  if (consumers > topic->consumers_cap) {
+    topic_consumer_t *p = (topic_consumer_t*)realloc(topic->consumers, sizeof(*p) * consumers);
+    if (!p) {
+      stmt_oom(topic->owner);
+      return SQL_ERROR;
+    }
+    topic->consumers     = p;
+    topic->consumers_cap = consumers;
+  }
+
+  for (size_t i=0; i<consumers; ++i) {
+    topic_consumer_t *consumer = topic->consumers + i;
+    memset(consumer, 0, sizeof(*consumer));
+    consumer->topic = topic;
+    consumer->poll_timeout_ms = topic->poll_min_ms;
+    consumer->tmq = CALL_tmq_consumer_new(conf, NULL, 0);
+    if (!consumer->tmq) {
+      stmt_append_err(topic->owner, "HY000", 0, "General error:[taosc]tmq_consumer_new failed:reason unknown, but don't forget to specifi `group.id`");
+      _topic_reset_tmq(topic);
+      return SQL_ERROR;
+    }
+    ++topic->consumers_nr;
   }
   return SQL_SUCCESS;
 }
@@ -608,19 +1290,27 @@ static SQLRETURN _topic_open(
     }
   }
 
-  r = CALL_tmq_subscribe(topic->tmq, topicList);
-  topic->subscribed = (r == 0);
+  for (size_t i=0; i<topic->consumers_nr; ++i) {
+    topic_consumer_t *consumer = topic->consumers + i;
+    r = CALL_tmq_subscribe(consumer->tmq, topicList);
+    consumer->subscribed = (r == 0);
+    consumer->committed_at = _topic_now_ms();
 
-  if (r) {
-    stmt_append_err_format(topic->owner, "HY000", 0, "General error:[taosc]:tmq_subscribe failed:[%d/0x%x]%s",
-        r, r, tmq_err2str(r));
-    return SQL_ERROR;
+    if (r) {
+      stmt_append_err_format(topic->owner, "HY000", 0, "General error:[taosc]:tmq_subscribe failed:[%d/0x%x]%s",
+          r, r, tmq_err2str(r));
+      return SQL_ERROR;
+    }
   }
 
   topic->records_count = 0;
-  topic->t0 = time(NULL);
+  topic->t0 = _topic_now_ms();
+  topic->uncommitted = 0;
+  topic->committed_at = _topic_now_ms();
 
-  return SQL_SUCCESS;
+  if (_topic_seek(topic) != SQL_SUCCESS) return SQL_ERROR;
+
+  return _topic_start_pollers(topic);
 }
 
 SQLRETURN topic_open(
@@ -629,7 +1319,7 @@ SQLRETURN topic_open(
     topic_cfg_t         *cfg)
 {
   (void)sql;
-  OA_ILE(topic->tmq == NULL);
+  OA_ILE(topic->consumers_nr == 0);
   SQLRETURN sr = SQL_SUCCESS;
 
   topic_cfg_transfer(cfg, &topic->cfg);
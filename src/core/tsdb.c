@@ -26,9 +26,13 @@
 
 #include "tsdb.h"
 
+#include "arrow.h"
+#include "cursor.h"
 #include "desc.h"
 #include "errs.h"
 #include "log.h"
+#include "result_cache.h"
+#include "scan.h"
 #include "stmt.h"
 #include "taos_helpers.h"
 
@@ -228,7 +232,7 @@ static void _tsdb_fields_release(tsdb_fields_t *fields)
   _tsdb_fields_reset(fields);
 }
 
-static void _tsdb_rows_block_reset(tsdb_rows_block_t *rows_block)
+void tsdb_rows_block_reset(tsdb_rows_block_t *rows_block)
 {
   if (!rows_block) return;
   rows_block->rows                 = NULL;
@@ -236,16 +240,59 @@ static void _tsdb_rows_block_reset(tsdb_rows_block_t *rows_block)
   rows_block->pos                  = 0;
 }
 
-static void _tsdb_rows_block_release(tsdb_rows_block_t *rows_block)
+void tsdb_rows_block_release(tsdb_rows_block_t *rows_block)
 {
   if (!rows_block) return;
-  _tsdb_rows_block_reset(rows_block);
+  tsdb_rows_block_reset(rows_block);
+  TOD_SAFE_FREE(rows_block->offsets);
+  rows_block->offsets_cap = 0;
+}
+
+static int _tsdb_rows_block_set(tsdb_rows_block_t *rows_block, TAOS_RES *res, TAOS_ROW rows, int nr_rows,
+    const TAOS_FIELD *fields, size_t nr_fields)
+{
+  if (nr_fields > rows_block->offsets_cap) {
+    size_t cap = (nr_fields + 15) / 16 * 16;
+    int **offsets = (int**)realloc(rows_block->offsets, sizeof(*offsets) * cap);
+    if (!offsets) return -1;
+    rows_block->offsets     = offsets;
+    rows_block->offsets_cap = cap;
+  }
+
+  for (size_t i=0; i<nr_fields; ++i) {
+    switch (fields[i].type) {
+      case TSDB_DATA_TYPE_VARCHAR:
+      case TSDB_DATA_TYPE_NCHAR:
+        rows_block->offsets[i] = CALL_taos_get_column_data_offset(res, (int)i);
+        break;
+      default:
+        rows_block->offsets[i] = NULL;
+        break;
+    }
+  }
+
+  rows_block->rows   = rows;
+  rows_block->nr     = nr_rows;
+  rows_block->pos    = 0;
+
+  return nr_rows;
+}
+
+int tsdb_rows_block_fetch(tsdb_rows_block_t *rows_block, TAOS_RES *res, const TAOS_FIELD *fields, size_t nr_fields)
+{
+  tsdb_rows_block_reset(rows_block);
+
+  TAOS_ROW rows = NULL;
+  int nr_rows = CALL_taos_fetch_block(res, &rows);
+  if (nr_rows <= 0) return 0;
+
+  return _tsdb_rows_block_set(rows_block, res, rows, nr_rows, fields, nr_fields);
 }
 
 void tsdb_res_reset(tsdb_res_t *res)
 {
   if (!res) return;
-  _tsdb_rows_block_reset(&res->rows_block);
+  tsdb_rows_block_reset(&res->rows_block);
   _tsdb_fields_reset(&res->fields);
   if (res->res) {
     if (res->res_is_from_taos_query) {
@@ -256,6 +303,16 @@ void tsdb_res_reset(tsdb_res_t *res)
   }
   res->affected_row_count = 0;
   res->time_precision     = 0;
+  res->eof                = 0;
+  cursor_cache_reset(&res->cache);
+  res->cache_pos          = 0;
+  res->cached             = 0;
+  result_cache_entry_unref(res->hit);
+  res->hit                = NULL;
+  cursor_cache_reset(&res->record);
+  res->recording          = 0;
+  tsdb_scan_destroy(res->scan);
+  res->scan               = NULL;
 }
 
 void tsdb_res_release(tsdb_res_t *res)
@@ -263,8 +320,11 @@ void tsdb_res_release(tsdb_res_t *res)
   if (!res) return;
   tsdb_res_reset(res);
 
-  _tsdb_rows_block_release(&res->rows_block);
+  tsdb_rows_block_release(&res->rows_block);
   _tsdb_fields_release(&res->fields);
+  cursor_cache_release(&res->cache);
+  cursor_cache_release(&res->record);
+  mem_release(&res->rc_key);
 }
 
 static int _tsdb_binds_keep(tsdb_binds_t *tsdb_binds, int nr_params)
@@ -282,6 +342,147 @@ static int _tsdb_binds_keep(tsdb_binds_t *tsdb_binds, int nr_params)
   return 0;
 }
 
+static result_cache_t* _tsdb_stmt_result_cache(tsdb_stmt_t *stmt)
+{
+  // NOTE: tables/columns/primarykeys query via tsdb_stmt of their own, which are never cached
+  if (stmt != &stmt->owner->tsdb_stmt) return NULL;
+  if (stmt->owner->conn->cfg.result_cache_ttl_ms <= 0) return NULL;
+  return stmt->owner->conn->env->result_cache;
+}
+
+static void _tsdb_stmt_invalidate_result_cache(tsdb_stmt_t *stmt, const char *sql, size_t len)
+{
+  // NOTE: writes via connections without RESULT_CACHE_TTL_MS still invalidate what others have cached
+  result_cache_t *rc = stmt->owner->conn->env->result_cache;
+  size_t start = 0, end = 0;
+
+  switch (tod_sql_write_target(sql, len, &start, &end)) {
+    case 0:
+      break;
+    case 1:
+      result_cache_invalidate(rc, sql + start, end - start);
+      break;
+    default:
+      result_cache_invalidate(rc, NULL, 0);
+      break;
+  }
+}
+
+// return 1 if served from the result cache, 0 if not, -1 on failure
+static int _tsdb_stmt_lookup_result_cache(tsdb_stmt_t *stmt, const char *sql, size_t len,
+    const TAOS_MULTI_BIND *mbs, int nr_mbs)
+{
+  tsdb_res_t          *res         = &stmt->res;
+  conn_t              *conn        = stmt->owner->conn;
+  result_cache_t      *rc          = _tsdb_stmt_result_cache(stmt);
+  size_t start = 0, end = 0;
+
+  if (!rc) return 0;
+  if (tod_sql_write_target(sql, len, &start, &end) != 0) return 0;
+
+  char db[256]; db[0] = '\0';
+  int required = 0;
+  if (CALL_taos_get_current_db(conn->taos, db, sizeof(db), &required)) db[0] = '\0';
+
+  char scope[1024];
+  snprintf(scope, sizeof(scope), "%s:%d|%s|%s",
+      conn->cfg.ip ? conn->cfg.ip : "", conn->cfg.port, conn->cfg.uid ? conn->cfg.uid : "", db);
+  if (result_cache_make_key(&res->rc_key, scope, sql, len, mbs, nr_mbs)) return 0;
+
+  result_cache_entry_t *hit = result_cache_get(rc, &res->rc_key);
+  if (!hit) {
+    cursor_cache_init(&res->record, SIZE_MAX, 0);
+    res->recording = 1;
+    return 0;
+  }
+
+  if (cursor_cache_borrow(&res->cache, &hit->blocks, stmt->owner->max_rows)) {
+    result_cache_entry_unref(hit);
+    stmt_oom(stmt->owner);
+    return -1;
+  }
+
+  // NOTE: rows are served via the same path as static cursor, with nothing left on the server side
+  res->hit            = hit;
+  res->fields.fields  = hit->fields;
+  res->fields.nr      = hit->nr_fields;
+  res->time_precision = hit->time_precision;
+  res->eof            = 1;
+  res->cached         = 1;
+
+  TOD_TRACEF(TOD_TRACE_PERF, "stmt:%p, result cache hit:[%zd] rows, %s", stmt->owner, hit->blocks.nr_rows, hit->sql);
+  return 1;
+}
+
+static void _tsdb_stmt_record_block(tsdb_stmt_t *stmt)
+{
+  tsdb_res_t           *res          = &stmt->res;
+  tsdb_rows_block_t    *rows_block   = &res->rows_block;
+
+  if (!res->recording) return;
+
+  int n = cursor_cache_append(&res->record, res->res, res->fields.fields, res->fields.nr,
+      rows_block->rows, rows_block->offsets, rows_block->nr);
+  if (n < 0 || res->record.mem_bytes > result_cache_max_entry_bytes(stmt->owner->conn->env->result_cache)) {
+    // NOTE: too large to be kept, or out of memory, neither of which is the application's concern
+    res->recording = 0;
+    cursor_cache_reset(&res->record);
+  }
+}
+
+static void _tsdb_stmt_publish_record(tsdb_stmt_t *stmt)
+{
+  tsdb_res_t           *res          = &stmt->res;
+
+  if (!res->recording) return;
+  res->recording = 0;
+  // NOTE: taosc reports failure in the middle of a result set as no more rows
+  if (CALL_taos_errno(res->res)) {
+    cursor_cache_reset(&res->record);
+    return;
+  }
+
+  result_cache_put(stmt->owner->conn->env->result_cache, &res->rc_key, stmt->owner->conn->cfg.result_cache_ttl_ms,
+      res->fields.fields, res->fields.nr, res->time_precision, &res->record);
+}
+
+// return 1 if the query is served by parallel lanes, 0 if not, -1 on failure
+static int _tsdb_stmt_start_scan(tsdb_stmt_t *stmt, const sqlc_tsdb_t *sqlc_tsdb)
+{
+  tsdb_res_t          *res         = &stmt->res;
+  stmt_t              *owner       = stmt->owner;
+
+  // NOTE: with SQL_ATTR_MAX_ROWS, LIMIT would apply to each lane rather than the whole result set
+  if (owner->parallel_scan < 2 || owner->cursor_type != SQL_CURSOR_FORWARD_ONLY || owner->max_rows) return 0;
+
+  tsdb_scan_t *scan = NULL;
+  int r = tsdb_scan_start(&scan, owner->conn, sqlc_tsdb->tsdb, sqlc_tsdb->tsdb_bytes, owner->parallel_scan);
+  if (r == 1) return 0;
+  if (r) {
+    if (!scan) {
+      stmt_oom(owner);
+      return -1;
+    }
+    int e = 0;
+    const char *estr = tsdb_scan_error(scan, &e);
+    stmt_append_err_format(owner, "HY000", e, "General error:[taosc]%s, executing:%.*s", estr, (int)sqlc_tsdb->sqlc_bytes, sqlc_tsdb->sqlc);
+    tsdb_scan_destroy(scan);
+    return -1;
+  }
+
+  // NOTE: blocks of lanes are swapped into res->cache one after another, and read via the same path as static cursor
+  res->scan           = scan;
+  res->fields.fields  = scan->fields;
+  res->fields.nr      = scan->nr_fields;
+  res->time_precision = scan->time_precision;
+  res->cached         = 1;
+  res->recording      = 0;
+  cursor_cache_reset(&res->record);
+
+  TOD_TRACEF(TOD_TRACE_PERF, "stmt:%p, parallel scan:[%zd] lanes, %.*s", owner, scan->nr_lanes, (int)sqlc_tsdb->sqlc_bytes, sqlc_tsdb->sqlc);
+  return 1;
+}
+
 static SQLRETURN _stmt_post_query(tsdb_stmt_t *stmt)
 {
   tsdb_res_t          *res         = &stmt->res;
@@ -297,21 +498,27 @@ static SQLRETURN _stmt_post_query(tsdb_stmt_t *stmt)
     fields->nr = CALL_taos_field_count(res->res);
     if (fields->nr > 0) {
       fields->fields = CALL_taos_fetch_fields(res->res);
+    } else {
+      res->recording = 0;
+    }
+    if (fields->nr > 0 && stmt == &stmt->owner->tsdb_stmt && stmt->owner->cursor_type == SQL_CURSOR_STATIC) {
+      cursor_cache_init(&res->cache, (size_t)stmt->owner->conn->cfg.static_cursor_kb * 1024, stmt->owner->max_rows);
+      res->cached = 1;
     }
   } else {
     res->affected_row_count = CALL_taos_stmt_affected_rows_once(stmt->stmt);
   }
 
+  if (fields->nr == 0 && stmt->current_sql) {
+    _tsdb_stmt_invalidate_result_cache(stmt, stmt->current_sql->tsdb, stmt->current_sql->tsdb_bytes);
+  }
+
   return SQL_SUCCESS;
 }
 
-static SQLRETURN _query(stmt_base_t *base, const sqlc_tsdb_t *sqlc_tsdb)
+static SQLRETURN _query_done(tsdb_stmt_t *stmt, const sqlc_tsdb_t *sqlc_tsdb)
 {
-  tsdb_stmt_t *stmt = (tsdb_stmt_t*)base;
-
   tsdb_res_t          *res         = &stmt->res;
-  tsdb_res_reset(res);
-  res->res = CALL_taos_query(stmt->owner->conn->taos, sqlc_tsdb->tsdb);
   res->res_is_from_taos_query = res->res ? 1 : 0;
 
   int e = CALL_taos_errno(res->res);
@@ -324,6 +531,113 @@ static SQLRETURN _query(stmt_base_t *base, const sqlc_tsdb_t *sqlc_tsdb)
   return _stmt_post_query(stmt);
 }
 
+static SQLRETURN _query(stmt_base_t *base, const sqlc_tsdb_t *sqlc_tsdb)
+{
+  tsdb_stmt_t *stmt = (tsdb_stmt_t*)base;
+
+  tsdb_res_t          *res         = &stmt->res;
+  stmt_set_running_res(stmt->owner, NULL);
+  tsdb_res_reset(res);
+  // NOTE: tables/columns/primarykeys query via tsdb_stmt of their own, and always synchronously
+  const char *sql = sqlc_tsdb->tsdb;
+  if (stmt == &stmt->owner->tsdb_stmt) sql = stmt_max_rows_sql(stmt->owner, sqlc_tsdb);
+  int hit = _tsdb_stmt_lookup_result_cache(stmt, sql, strlen(sql), NULL, 0);
+  if (hit < 0) return SQL_ERROR;
+  if (hit) return SQL_SUCCESS;
+  if (stmt == &stmt->owner->tsdb_stmt) {
+    int scan = _tsdb_stmt_start_scan(stmt, sqlc_tsdb);
+    if (scan < 0) return SQL_ERROR;
+    if (scan) return SQL_SUCCESS;
+  }
+  if (stmt == &stmt->owner->tsdb_stmt && stmt_async_enabled(stmt->owner)) {
+    return stmt_async_query(stmt->owner, sql);
+  }
+  int64_t t0 = tod_now_us();
+  res->res = CALL_taos_query(stmt->owner->conn->taos, sql);
+  stmt->owner->perf.taosc_us += tod_now_us() - t0;
+  stmt_set_running_res(stmt->owner, res->res);
+  if (stmt != &stmt->owner->tsdb_stmt) stmt->owner->perf.catalog_trips += 1;
+
+  return _query_done(stmt, sqlc_tsdb);
+}
+
+SQLRETURN tsdb_stmt_query_done(tsdb_stmt_t *stmt, TAOS_RES *taos_res, int code)
+{
+  tsdb_res_t          *res         = &stmt->res;
+  const sqlc_tsdb_t   *sqlc_tsdb   = stmt->current_sql;
+
+  if (!taos_res) {
+    stmt_append_err_format(stmt->owner, "HY000", code, "General error:[taosc]taos_query_a failed, executing:%.*s",
+        (int)sqlc_tsdb->sqlc_bytes, sqlc_tsdb->sqlc);
+    return SQL_ERROR;
+  }
+
+  res->res = taos_res;
+  stmt_set_running_res(stmt->owner, res->res);
+
+  return _query_done(stmt, sqlc_tsdb);
+}
+
+void tsdb_stmt_stop(tsdb_stmt_t *stmt)
+{
+  tsdb_res_t           *res          = &stmt->res;
+
+  // NOTE: an incomplete result set is never published to the result cache
+  res->recording = 0;
+  cursor_cache_reset(&res->record);
+
+  if (res->scan) tsdb_scan_stop(res->scan);
+  if (!res->res || res->eof) return;
+  CALL_taos_stop_query(res->res);
+  tsdb_rows_block_reset(&res->rows_block);
+  res->eof = 1;
+}
+
+TAOS_RES* tsdb_stmt_block_needed(tsdb_stmt_t *stmt)
+{
+  tsdb_res_t           *res          = &stmt->res;
+  tsdb_rows_block_t    *rows_block   = &res->rows_block;
+
+  // NOTE: blocks of static cursor are fetched synchronously, as they're cached by the way
+  if (!res->res || res->fields.nr == 0 || res->eof || res->cached) return NULL;
+  if (rows_block->pos < rows_block->nr) return NULL;
+  return res->res;
+}
+
+SQLRETURN tsdb_stmt_block_done(tsdb_stmt_t *stmt, int nr_rows)
+{
+  tsdb_res_t           *res          = &stmt->res;
+  tsdb_rows_block_t    *rows_block   = &res->rows_block;
+
+  tsdb_rows_block_reset(rows_block);
+
+  if (nr_rows < 0) {
+    stmt_append_err_format(stmt->owner, "HY000", nr_rows, "General error:[taosc]%s", CALL_taos_errstr(res->res));
+    return SQL_ERROR;
+  }
+
+  if (nr_rows == 0) {
+    res->eof = 1;
+    _tsdb_stmt_publish_record(stmt);
+    return SQL_SUCCESS;
+  }
+
+  TAOS_ROW *rows = CALL_taos_result_block(res->res);
+  if (!rows) {
+    stmt_append_err(stmt->owner, "HY000", 0, "General error:[taosc]no block available after taos_fetch_rows_a");
+    return SQL_ERROR;
+  }
+
+  if (_tsdb_rows_block_set(rows_block, res->res, *rows, nr_rows, res->fields.fields, res->fields.nr) < 0) {
+    stmt_oom(stmt->owner);
+    return SQL_ERROR;
+  }
+  stmt->owner->perf.blocks_fetched += 1;
+  _tsdb_stmt_record_block(stmt);
+
+  return SQL_SUCCESS;
+}
+
 static TAOS_FIELD_E* _tsdb_stmt_get_tsdb_field_by_tsdb_params(tsdb_stmt_t *stmt, int i_param)
 {
   tsdb_params_t *params = &stmt->params;
@@ -607,6 +921,7 @@ static SQLRETURN _execute(stmt_base_t *base)
 
   tsdb_stmt_t *stmt = (tsdb_stmt_t*)base;
   tsdb_res_t          *res         = &stmt->res;
+  stmt_set_running_res(stmt->owner, NULL);
   tsdb_res_reset(res);
 
   descriptor_t *APD = stmt_APD(stmt->owner);
@@ -638,7 +953,18 @@ static SQLRETURN _execute(stmt_base_t *base)
     return _query(base, stmt->current_sql);
   }
 
+  if (!stmt->is_insert_stmt) {
+    tsdb_binds_t *tsdb_binds = &stmt->owner->tsdb_binds;
+    int hit = _tsdb_stmt_lookup_result_cache(stmt, stmt->current_sql->tsdb, stmt->current_sql->tsdb_bytes,
+        tsdb_binds->mbs, tsdb_binds->nr);
+    if (hit < 0) return SQL_ERROR;
+    if (hit) return SQL_SUCCESS;
+  }
+
+  int64_t t0 = tod_now_us();
   r = CALL_taos_stmt_execute(stmt->stmt);
+  stmt->owner->perf.taosc_us += tod_now_us() - t0;
+  stmt->owner->perf.batches  += 1;
   if (r) {
     stmt_append_err_format(stmt->owner, "HY000", r, "General error:[taosc]%s", CALL_taos_stmt_errstr(stmt->stmt));
     return SQL_ERROR;
@@ -646,6 +972,7 @@ static SQLRETURN _execute(stmt_base_t *base)
 
   res->res = CALL_taos_stmt_use_result(stmt->stmt);
   res->res_is_from_taos_query = 0;
+  stmt_set_running_res(stmt->owner, res->res);
 
   int e = CALL_taos_errno(res->res);
   if (e) {
@@ -668,19 +995,173 @@ static SQLRETURN _get_col_fields(stmt_base_t *base, TAOS_FIELD **fields, size_t
   return SQL_SUCCESS;
 }
 
+static SQLRETURN _tsdb_stmt_cache_block(tsdb_stmt_t *stmt)
+{
+  tsdb_res_t           *res          = &stmt->res;
+  tsdb_rows_block_t    *rows_block   = &res->rows_block;
+
+  if (!res->cached) return SQL_SUCCESS;
+
+  int n = cursor_cache_append(&res->cache, res->res, res->fields.fields, res->fields.nr,
+      rows_block->rows, rows_block->offsets, rows_block->nr);
+  // NOTE: rows are read from the cache from now on
+  rows_block->pos = rows_block->nr;
+  if (n < 0) {
+    stmt_oom(stmt->owner);
+    return SQL_ERROR;
+  }
+  if (cursor_cache_is_full(&res->cache)) tsdb_stmt_stop(stmt);
+
+  return SQL_SUCCESS;
+}
+
+static SQLRETURN _tsdb_stmt_fetch_scan_block(tsdb_stmt_t *stmt)
+{
+  tsdb_res_t           *res          = &stmt->res;
+
+  int64_t t0 = tod_now_us();
+  int r = tsdb_scan_next_block(res->scan, &res->cache);
+  stmt->owner->perf.taosc_us += tod_now_us() - t0;
+  if (r < 0) {
+    int e = 0;
+    const char *estr = tsdb_scan_error(res->scan, &e);
+    stmt_append_err_format(stmt->owner, "HY000", e, "General error:[taosc]%s", estr);
+    return SQL_ERROR;
+  }
+  if (r == 0) {
+    res->eof = 1;
+    return SQL_NO_DATA;
+  }
+
+  stmt->owner->perf.blocks_fetched += 1;
+  res->cache_pos = 0;
+  return SQL_SUCCESS;
+}
+
 static SQLRETURN _tsdb_stmt_fetch_rows_block(tsdb_stmt_t *stmt)
 {
   tsdb_res_t           *res          = &stmt->res;
   tsdb_rows_block_t    *rows_block   = &res->rows_block;
 
-  _tsdb_rows_block_reset(rows_block);
+  // NOTE: the cancel flag is checked between blocks, taos_stop_query takes care of the block in flight
+  if (stmt_is_cancelled(stmt->owner)) return SQL_ERROR;
+  if (res->eof) return SQL_NO_DATA;
+  if (res->scan) return _tsdb_stmt_fetch_scan_block(stmt);
 
-  TAOS_ROW rows = NULL;
-  int nr_rows = CALL_taos_fetch_block(res->res, &rows);
-  if (nr_rows == 0) return SQL_NO_DATA;
-  rows_block->rows   = rows;
-  rows_block->nr     = nr_rows;
-  rows_block->pos    = 0;
+  int64_t t0 = tod_now_us();
+  int nr_rows = tsdb_rows_block_fetch(rows_block, res->res, res->fields.fields, res->fields.nr);
+  stmt->owner->perf.taosc_us += tod_now_us() - t0;
+  if (nr_rows > 0) stmt->owner->perf.blocks_fetched += 1;
+  if (nr_rows < 0) {
+    stmt_oom(stmt->owner);
+    return SQL_ERROR;
+  }
+  if (nr_rows == 0) {
+    res->eof = 1;
+    _tsdb_stmt_publish_record(stmt);
+    return SQL_NO_DATA;
+  }
+
+  _tsdb_stmt_record_block(stmt);
+  return _tsdb_stmt_cache_block(stmt);
+}
+
+static SQLRETURN _tsdb_stmt_fetch_cached_row(tsdb_stmt_t *stmt)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+
+  tsdb_res_t           *res          = &stmt->res;
+  cursor_cache_t       *cache        = &res->cache;
+
+  while (res->cache_pos >= cache->nr_rows) {
+    sr = _tsdb_stmt_fetch_rows_block(stmt);
+    if (sr == SQL_NO_DATA) {
+      res->cache_pos = cache->nr_rows + 1;
+      return SQL_NO_DATA;
+    }
+    if (sr != SQL_SUCCESS) return SQL_ERROR;
+  }
+
+  if (cursor_cache_seek(cache, res->cache_pos)) {
+    stmt_append_err_format(stmt->owner, "HY000", 0, "General error:failed to load row #%zd of static cursor", res->cache_pos + 1);
+    return SQL_ERROR;
+  }
+  ++res->cache_pos;
+
+  return SQL_SUCCESS;
+}
+
+int tsdb_stmt_is_cached(tsdb_stmt_t *stmt)
+{
+  return stmt->res.cached;
+}
+
+int tsdb_stmt_rows_in_block(tsdb_stmt_t *stmt)
+{
+  tsdb_res_t           *res          = &stmt->res;
+  tsdb_rows_block_t    *rows_block   = &res->rows_block;
+
+  if (res->cached || res->hit || res->scan) return -1;
+
+  return (int)(rows_block->nr - rows_block->pos);
+}
+
+SQLRETURN tsdb_stmt_cache_rows(tsdb_stmt_t *stmt, size_t nr_rows, size_t *cached)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+
+  tsdb_res_t           *res          = &stmt->res;
+
+  while (res->cache.nr_rows < nr_rows) {
+    sr = _tsdb_stmt_fetch_rows_block(stmt);
+    if (sr == SQL_NO_DATA) break;
+    if (sr != SQL_SUCCESS) return SQL_ERROR;
+  }
+
+  *cached = res->cache.nr_rows;
+  return SQL_SUCCESS;
+}
+
+void tsdb_stmt_cache_rewind(tsdb_stmt_t *stmt, size_t i_row)
+{
+  stmt->res.cache_pos = i_row;
+}
+
+SQLRETURN tsdb_stmt_export_arrow(tsdb_stmt_t *stmt, struct ArrowArrayStream *stream)
+{
+  tsdb_res_t           *res          = &stmt->res;
+
+  if (res->cached || res->hit || res->scan) {
+    stmt_append_err(stmt->owner, "HYC00", 0, "Optional feature not implemented:arrow stream only for forward-only cursor fetched directly from taosc");
+    return SQL_ERROR;
+  }
+  if (!res->res || res->fields.nr == 0) {
+    stmt_append_err(stmt->owner, "HY010", 0, "Function sequence error:no result set to export as arrow stream");
+    return SQL_ERROR;
+  }
+  if (!res->res_is_from_taos_query) {
+    stmt_append_err(stmt->owner, "HYC00", 0, "Optional feature not implemented:arrow stream for prepared statement");
+    return SQL_ERROR;
+  }
+  if (res->rows_block.nr || res->eof) {
+    stmt_append_err(stmt->owner, "HY010", 0, "Function sequence error:rows already fetched from the result set");
+    return SQL_ERROR;
+  }
+
+  char err[1024]; err[0] = '\0';
+  if (tsdb_arrow_export(res->res, stream, err, sizeof(err))) {
+    stmt_append_err_format(stmt->owner, "HYC00", 0, "Optional feature not implemented:%s", err);
+    return SQL_ERROR;
+  }
+
+  // NOTE: the result set is now owned by `stream`, and this statement is left with no more rows
+  stmt_set_running_res(stmt->owner, NULL);
+  res->recording = 0;
+  cursor_cache_reset(&res->record);
+  res->res = NULL;
+  res->res_is_from_taos_query = 0;
+  tsdb_res_reset(res);
+  res->eof = 1;
 
   return SQL_SUCCESS;
 }
@@ -693,6 +1174,8 @@ static SQLRETURN _fetch_row(stmt_base_t *base)
   tsdb_res_t           *res          = &stmt->res;
   tsdb_rows_block_t    *rows_block   = &res->rows_block;
 
+  if (res->cached) return _tsdb_stmt_fetch_cached_row(stmt);
+
 again:
   // TODO: before and after
   if (rows_block->pos >= rows_block->nr) {
@@ -836,7 +1319,9 @@ static SQLRETURN _row_count(stmt_base_t *base, SQLLEN *row_count_ptr)
   tsdb_stmt_t *stmt = (tsdb_stmt_t*)base;
   tsdb_res_t           *res          = &stmt->res;
 
-  if (row_count_ptr) *row_count_ptr = res->affected_row_count;
+  if (row_count_ptr) {
+    *row_count_ptr = (res->affected_row_count == TSDB_ROW_COUNT_UNKNOWN) ? -1 : (SQLLEN)res->affected_row_count;
+  }
   return SQL_SUCCESS;
 }
 
@@ -865,7 +1350,12 @@ static SQLRETURN _get_data(stmt_base_t *base, SQLUSMALLINT Col_or_Param_Num, tsd
   TAOS_ROW     rows       = rows_block->rows;
 
   char buf[4096];
-  int r = helper_get_tsdb(res->res, 1, fields->fields, res->time_precision, rows, i_row, i_col, tsdb, buf, sizeof(buf));
+  int r = 0;
+  if (res->cached) {
+    r = cursor_cache_get_data(&res->cache, fields->fields, res->time_precision, i_col, tsdb, buf, sizeof(buf));
+  } else {
+    r = helper_get_tsdb_block(res->res, rows_block->offsets, fields->fields, res->time_precision, rows, i_row, i_col, tsdb, buf, sizeof(buf));
+  }
   if (r) {
     stmt_append_err_format(stmt->owner, "HY000", 0, "General error:%.*s", (int)strlen(buf), buf);
     return SQL_ERROR;
@@ -899,13 +1389,14 @@ void tsdb_stmt_unprepare(tsdb_stmt_t *stmt)
   stmt->current_sql = NULL;
   _tsdb_params_reset(&stmt->params);
   stmt->prepared = 0;
-  stmt->is_topic = 0;
+  stmt->is_ext = 0;
   stmt->is_insert_stmt = 0;
   _tsdb_binds_reset(&stmt->owner->tsdb_binds);
 }
 
 static void _tsdb_stmt_close_result(tsdb_stmt_t *stmt)
 {
+  if (stmt->res.res) stmt_set_running_res(stmt->owner, NULL);
   tsdb_res_reset(&stmt->res);
 }
 
@@ -913,6 +1404,14 @@ void tsdb_stmt_reset(tsdb_stmt_t *stmt)
 {
   if (!stmt) return;
   _tsdb_stmt_close_result(stmt);
+  if (stmt->deferred_rows) {
+    size_t rows = stmt->deferred_rows;
+    SQLRETURN sr = tsdb_stmt_flush(stmt);
+    // NOTE: SQLFreeStmt/SQLFreeHandle/SQLDisconnect have flushed and reported already, only a statement torn down otherwise gets here
+    if (sr != SQL_SUCCESS) {
+      OW("[%zd] deferred rows failed to be inserted when closing statement", rows);
+    }
+  }
   if (stmt->stmt) {
     int r = CALL_taos_stmt_close(stmt->stmt);
     OA_NIY(r == 0);
@@ -940,6 +1439,83 @@ SQLRETURN tsdb_stmt_query(tsdb_stmt_t *stmt, const sqlc_tsdb_t *sqlc_tsdb)
   return _execute(&stmt->base);
 }
 
+// NOTE: taosc rejects sql-statement longer than 1M bytes, keep buffered batch well below
+#define WRITE_BEHIND_MAX_BYTES          (512 * 1024)
+
+static int64_t _tsdb_now_ms(void)
+{
+  struct timeval tv = {0};
+  gettimeofday(&tv, NULL);
+  return (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+int tsdb_stmt_write_behind_enabled(tsdb_stmt_t *stmt)
+{
+  if (stmt->owner->conn->cfg.write_behind <= 0) return 0;
+  if (!stmt->is_insert_stmt) return 0;
+  // NOTE: keep it simple, subtbl and tags might change from row to row
+  if (stmt->params.subtbl_required) return 0;
+  if (stmt->params.nr_tag_fields) return 0;
+  return 1;
+}
+
+SQLRETURN tsdb_stmt_flush(tsdb_stmt_t *stmt)
+{
+  if (stmt->deferred_rows == 0) return SQL_SUCCESS;
+
+  size_t rows = stmt->deferred_rows;
+  stmt->deferred_rows  = 0;
+  stmt->deferred_bytes = 0;
+  stmt->deferred_since = 0;
+
+  int64_t t0 = tod_now_us();
+  int r = CALL_taos_stmt_execute(stmt->stmt);
+  stmt->owner->perf.taosc_us += tod_now_us() - t0;
+  stmt->owner->perf.batches  += 1;
+  if (r) {
+    stmt_append_err_format(stmt->owner, "HY000", r, "General error:[taosc]%s, when executing [%zd] deferred rows",
+        CALL_taos_stmt_errstr(stmt->stmt), rows);
+    return SQL_ERROR;
+  }
+
+  return SQL_SUCCESS;
+}
+
+SQLRETURN tsdb_stmt_execute_deferred(tsdb_stmt_t *stmt, size_t rows)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+
+  const conn_cfg_t *cfg = &stmt->owner->conn->cfg;
+  tsdb_binds_t *tsdb_binds = &stmt->owner->tsdb_binds;
+
+  tsdb_res_reset(&stmt->res);
+  if (stmt->current_sql) {
+    _tsdb_stmt_invalidate_result_cache(stmt, stmt->current_sql->tsdb, stmt->current_sql->tsdb_bytes);
+  }
+
+  int64_t now = _tsdb_now_ms();
+  if (stmt->deferred_rows == 0) stmt->deferred_since = now;
+
+  stmt->deferred_rows += rows;
+  for (int i=0; i<tsdb_binds->nr; ++i) {
+    TAOS_MULTI_BIND *mb = tsdb_binds->mbs + i;
+    stmt->deferred_bytes += mb->buffer_length * rows;
+  }
+
+  if (stmt->deferred_rows >= (size_t)cfg->write_behind ||
+      stmt->deferred_bytes >= WRITE_BEHIND_MAX_BYTES ||
+      (cfg->write_behind_ms > 0 && now - stmt->deferred_since >= cfg->write_behind_ms))
+  {
+    sr = tsdb_stmt_flush(stmt);
+    if (sr != SQL_SUCCESS) return SQL_ERROR;
+  }
+
+  // NOTE: rows accepted by this call, not necessarily those already in the database
+  stmt->res.affected_row_count = rows;
+
+  return SQL_SUCCESS;
+}
+
 SQLRETURN tsdb_stmt_rebind_subtbl(tsdb_stmt_t *stmt)
 {
   SQLRETURN sr = SQL_SUCCESS;
@@ -31,6 +31,7 @@
 #include "utils.h"
 
 #include <sql.h>
+#include <taos.h>
 
 EXTERN_C_BEGIN
 
@@ -52,7 +53,7 @@ SQLRETURN conn_driver_connect(
     SQLSMALLINT    *StringLength2Ptr,
     SQLUSMALLINT    DriverCompletion) FA_HIDDEN;
 
-void conn_disconnect(conn_t *conn) FA_HIDDEN;
+SQLRETURN conn_disconnect(conn_t *conn) FA_HIDDEN;
 
 SQLRETURN conn_get_diag_rec(
     conn_t         *conn,
@@ -135,6 +136,21 @@ const char* conn_get_tsdb_charset(conn_t *conn) FA_HIDDEN;
 const char* conn_get_sqlc_charset_for_col_bind(conn_t *conn) FA_HIDDEN;
 const char* conn_get_sqlc_charset_for_param_bind(conn_t *conn) FA_HIDDEN;
 
+// arm the per-connection timer to stmt_cancel_with(stmt, STMT_CANCEL_TIMEOUT) once `timeout_us` has elapsed
+int conn_timer_arm(conn_t *conn, stmt_t *stmt, int64_t timeout_us) FA_HIDDEN;
+void conn_timer_disarm(conn_t *conn, stmt_t *stmt) FA_HIDDEN;
+
+// bookkeeping of statements which have taosc work in flight, called with stmt->cancel_mutex held
+void conn_set_busy(conn_t *conn, int busy) FA_HIDDEN;
+// taos_kill_query applies to every query on the connection, thus only if the caller is the one and only busy statement
+// returns 1 if issued
+int conn_kill_query_if_alone(conn_t *conn) FA_HIDDEN;
+
+// an idle internal connection with the same configuration as `conn`, or a new one, NULL on failure
+// thread-safe, as it's called from within scan threads
+TAOS* conn_pool_get(conn_t *conn) FA_HIDDEN;
+void conn_pool_put(conn_t *conn, TAOS *taos) FA_HIDDEN;
+
 EXTERN_C_END
 
 #endif //  _conn_h_
@@ -0,0 +1,58 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022-2023 freemine <freemine@yeah.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _cursor_h_
+#define _cursor_h_
+
+#include "macros.h"
+#include "typedefs.h"
+
+#include "taos_helpers.h"
+
+EXTERN_C_BEGIN
+
+void cursor_cache_reset(cursor_cache_t *cache) FA_HIDDEN;
+void cursor_cache_release(cursor_cache_t *cache) FA_HIDDEN;
+
+// memory budget in bytes before spilling, 0 for the default
+void cursor_cache_init(cursor_cache_t *cache, size_t mem_budget, size_t limit) FA_HIDDEN;
+
+// copy the current block of `res` into the cache, truncated at `limit` if any
+// return the number of rows kept, or -1 on failure
+int cursor_cache_append(cursor_cache_t *cache, TAOS_RES *res, const TAOS_FIELD *fields, size_t nr_fields,
+    TAOS_ROW rows, int * const *offsets, size_t nr_rows) FA_HIDDEN;
+int cursor_cache_is_full(cursor_cache_t *cache) FA_HIDDEN;
+
+// read-only view of the in-memory blocks of `src`, which shall outlive `cache` or the next reset thereof
+int cursor_cache_borrow(cursor_cache_t *cache, const cursor_cache_t *src, size_t limit) FA_HIDDEN;
+
+// make 0-based `i_row` the row that cursor_cache_get_data reads from, -1 on failure
+int cursor_cache_seek(cursor_cache_t *cache, size_t i_row) FA_HIDDEN;
+int cursor_cache_get_data(cursor_cache_t *cache, TAOS_FIELD *fields, int time_precision, int i_col,
+    tsdb_data_t *tsdb, char *buf, size_t len) FA_HIDDEN;
+
+EXTERN_C_END
+
+#endif //  _cursor_h_
+
@@ -37,6 +37,13 @@ void errs_append_x(errs_t *errs, const char *file, int line, const char *func, c
 void errs_clr_x(errs_t *errs) FA_HIDDEN;
 void errs_release_x(errs_t *errs) FA_HIDDEN;
 
+// the most recently appended record, NULL if none
+err_t* errs_last(errs_t *errs) FA_HIDDEN;
+// the record following `prev`, or the first one if `prev` is NULL, NULL if none
+err_t* errs_next(errs_t *errs, err_t *prev) FA_HIDDEN;
+// move `n` consecutive records of `src` starting from `first` to the tail of `dst`, or discard them if `dst` is NULL
+void errs_move(errs_t *dst, errs_t *src, err_t *first, size_t n) FA_HIDDEN;
+
 SQLRETURN errs_get_diag_rec_x(
     errs_t         *errs,
     SQLSMALLINT     RecNumber,
@@ -0,0 +1,50 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022-2023 freemine <freemine@yeah.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _fetch_pool_h_
+#define _fetch_pool_h_
+
+#include "macros.h"
+#include "typedefs.h"
+
+#include <stddef.h>
+
+EXTERN_C_BEGIN
+
+#define FETCH_POOL_MAX_THREADS        32
+
+fetch_pool_t* fetch_pool_create(size_t nr_threads) FA_HIDDEN;
+void fetch_pool_destroy(fetch_pool_t *pool) FA_HIDDEN;
+
+// number of worker threads, not counting the calling thread
+size_t fetch_pool_threads(fetch_pool_t *pool) FA_HIDDEN;
+
+// call `run(arg, i)` once for each `i` in [0, nr), on worker threads and the calling thread alike
+// return after all of them have returned, jobs of concurrent callers are served in FIFO order
+void fetch_pool_run(fetch_pool_t *pool, void (*run)(void *arg, size_t i), void *arg, size_t nr) FA_HIDDEN;
+
+EXTERN_C_END
+
+#endif //  _fetch_pool_h_
+
@@ -0,0 +1,89 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022-2023 freemine <freemine@yeah.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN tlsECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _profile_h_
+#define _profile_h_
+
+#include "macros.h"
+#include "typedefs.h"
+
+#include "os_port.h"
+
+EXTERN_C_BEGIN
+
+// ODBC entry points being profiled, with TAOS_ODBC_PROFILE=1
+#define PROFILE_APIS(X)                                                              \
+  X(SQLAllocHandle)      X(SQLFreeHandle)       X(SQLDriverConnect)                  \
+  X(SQLDisconnect)       X(SQLExecDirect)       X(SQLSetEnvAttr)                     \
+  X(SQLGetInfo)          X(SQLEndTran)          X(SQLSetConnectAttr)                 \
+  X(SQLSetStmtAttr)      X(SQLRowCount)         X(SQLNumResultCols)                  \
+  X(SQLDescribeCol)      X(SQLBindCol)          X(SQLFetch)                          \
+  X(SQLFetchScroll)      X(SQLFreeStmt)         X(SQLGetDiagRec)                     \
+  X(SQLGetDiagField)     X(SQLGetData)          X(SQLPrepare)                        \
+  X(SQLNumParams)        X(SQLDescribeParam)    X(SQLBindParameter)                  \
+  X(SQLExecute)          X(SQLConnect)          X(SQLColAttribute)                   \
+  X(SQLTables)           X(SQLBulkOperations)   X(SQLCloseCursor)                    \
+  X(SQLColumnPrivileges) X(SQLColumns)          X(SQLCopyDesc)                       \
+  X(SQLExtendedFetch)    X(SQLForeignKeys)      X(SQLGetConnectAttr)                 \
+  X(SQLGetCursorName)    X(SQLGetDescField)     X(SQLGetDescRec)                     \
+  X(SQLGetEnvAttr)       X(SQLGetStmtAttr)      X(SQLGetTypeInfo)                    \
+  X(SQLMoreResults)      X(SQLNativeSql)        X(SQLParamData)                      \
+  X(SQLPrimaryKeys)      X(SQLProcedureColumns) X(SQLProcedures)                     \
+  X(SQLPutData)          X(SQLSetCursorName)    X(SQLSetDescField)                   \
+  X(SQLSetDescRec)       X(SQLSetPos)           X(SQLSpecialColumns)                 \
+  X(SQLStatistics)       X(SQLTablePrivileges)  X(SQLBrowseConnect)                  \
+  X(SQLCompleteAsync)    X(SQLCancel)
+
+#define PROFILE_API_ENUM(_api)     PROFILE_API_##_api,
+typedef enum profile_api_e {
+  PROFILE_APIS(PROFILE_API_ENUM)
+  PROFILE_API_NR,
+} profile_api_t;
+#undef PROFILE_API_ENUM
+
+// NOTE: written once during library initialization, read-only afterwards
+extern int profile_enabled FA_HIDDEN;
+
+void profile_init(int enabled) FA_HIDDEN;
+void profile_record(profile_api_t api, int64_t t0) FA_HIDDEN;
+// merge histograms of all threads, alive or gone, and log p50/p99/p999 of each entry point
+void profile_dump(void) FA_HIDDEN;
+void profile_thread_release(profile_thread_t *profile) FA_HIDDEN;
+
+static inline int64_t profile_begin(void)
+{
+  return profile_enabled ? tod_now_ns() : 0;
+}
+
+// NOTE: one predictable branch per entry point when profiling is off
+#define ODBC_PROFILE(_api, _statement) do {                         \
+  int64_t _profile_t0 = profile_begin();                            \
+  _statement;                                                       \
+  if (_profile_t0) profile_record(PROFILE_API_##_api, _profile_t0); \
+} while (0)
+
+EXTERN_C_END
+
+#endif //  _profile_h_
+
@@ -0,0 +1,63 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022-2023 freemine <freemine@yeah.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _result_cache_h_
+#define _result_cache_h_
+
+#include "macros.h"
+#include "typedefs.h"
+
+#include "utils.h"
+
+#include <taos.h>
+
+EXTERN_C_BEGIN
+
+result_cache_t* result_cache_create(void) FA_HIDDEN;
+void result_cache_destroy(result_cache_t *rc) FA_HIDDEN;
+
+// compose into `key` the scope, the normalized `sql` and the values of single-row parameters `mbs` if any
+// return -1 if parameters are not cacheable, or out of memory
+int result_cache_make_key(mem_t *key, const char *scope, const char *sql, size_t len,
+    const TAOS_MULTI_BIND *mbs, int nr_mbs) FA_HIDDEN;
+
+// return the referenced entry of `key`, NULL if none or expired
+result_cache_entry_t* result_cache_get(result_cache_t *rc, const mem_t *key) FA_HIDDEN;
+void result_cache_entry_unref(result_cache_entry_t *entry) FA_HIDDEN;
+
+// entries larger than this are not kept at all
+size_t result_cache_max_entry_bytes(result_cache_t *rc) FA_HIDDEN;
+
+// move `blocks` into a new entry of `key`, which expires `ttl_ms` milliseconds later
+// nothing happens but `blocks` being reset, if no room for it
+void result_cache_put(result_cache_t *rc, const mem_t *key, int ttl_ms,
+    const TAOS_FIELD *fields, size_t nr_fields, int time_precision, cursor_cache_t *blocks) FA_HIDDEN;
+
+// drop entries whose sql-statement refers to table `[tbl, tbl+len)`, or every entry if `tbl` is NULL
+void result_cache_invalidate(result_cache_t *rc, const char *tbl, size_t len) FA_HIDDEN;
+
+EXTERN_C_END
+
+#endif //  _result_cache_h_
+
@@ -0,0 +1,53 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022-2023 freemine <freemine@yeah.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _scan_h_
+#define _scan_h_
+
+#include "macros.h"
+#include "typedefs.h"
+
+#include <taos.h>
+
+EXTERN_C_BEGIN
+
+#define TSDB_SCAN_MAX_LANES              16
+
+// split `sql` into at most `nr_lanes` sub-range queries, each run on a pooled connection of `conn`
+// return 0 if started, with fields of the result known, 1 if `sql` is not eligible, -1 on failure
+// on failure, `*scan` is left for tsdb_scan_error if not NULL, which is out of memory otherwise
+int tsdb_scan_start(tsdb_scan_t **scan, conn_t *conn, const char *sql, size_t len, size_t nr_lanes) FA_HIDDEN;
+// stop and join all lanes, and free `scan`
+void tsdb_scan_destroy(tsdb_scan_t *scan) FA_HIDDEN;
+void tsdb_scan_stop(tsdb_scan_t *scan) FA_HIDDEN;
+
+// swap the next block in timestamp order into `cache`
+// return 1 if one is there, 0 if no more, -1 if the lane failed, see tsdb_scan_error
+int tsdb_scan_next_block(tsdb_scan_t *scan, cursor_cache_t *cache) FA_HIDDEN;
+const char* tsdb_scan_error(tsdb_scan_t *scan, int *code) FA_HIDDEN;
+
+EXTERN_C_END
+
+#endif //  _scan_h_
+
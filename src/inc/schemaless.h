@@ -0,0 +1,56 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022-2023 freemine <freemine@yeah.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef _schemaless_h_
+#define _schemaless_h_
+
+#include "macros.h"
+#include "typedefs.h"
+
+#include <taos.h>
+
+EXTERN_C_BEGIN
+
+void schemaless_cfg_release(schemaless_cfg_t *cfg) FA_HIDDEN;
+void schemaless_cfg_transfer(schemaless_cfg_t *from, schemaless_cfg_t *to) FA_HIDDEN;
+int schemaless_cfg_set_protocol(schemaless_cfg_t *cfg, const char *protocol, size_t len) FA_HIDDEN;
+int schemaless_cfg_append_kv(schemaless_cfg_t *cfg, const char *k, size_t kn, const char *v, size_t vn) FA_HIDDEN;
+
+void schemaless_reset(schemaless_t *schemaless) FA_HIDDEN;
+void schemaless_release(schemaless_t *schemaless) FA_HIDDEN;
+
+void schemaless_init(schemaless_t *schemaless, stmt_t *stmt) FA_HIDDEN;
+
+SQLRETURN schemaless_open(
+    schemaless_t        *schemaless,
+    const sqlc_tsdb_t   *sql,
+    schemaless_cfg_t    *cfg) FA_HIDDEN;
+
+// NOTE: discard lines pending and zero out total rows, called before each execution
+void schemaless_rewind(schemaless_t *schemaless) FA_HIDDEN;
+// NOTE: `payload` is expected in tsdb charset, lines are accumulated until base->execute
+SQLRETURN schemaless_append(schemaless_t *schemaless, const char *payload, size_t len) FA_HIDDEN;
+
+EXTERN_C_END
+
+#endif //  _schemaless_h_
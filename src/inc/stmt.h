@@ -27,6 +27,9 @@
 
 #include "macros.h"
 #include "typedefs.h"
+#include "taos_odbc_ext.h"
+
+#include <taos.h>
 
 EXTERN_C_BEGIN
 
@@ -35,6 +38,7 @@ stmt_t* stmt_ref(stmt_t *stmt) FA_HIDDEN;
 stmt_t* stmt_unref(stmt_t *stmt) FA_HIDDEN;
 SQLRETURN stmt_free(stmt_t *stmt) FA_HIDDEN;
 void stmt_clr_errs(stmt_t *stmt) FA_HIDDEN;
+SQLRETURN stmt_flush_deferred(stmt_t *stmt) FA_HIDDEN;
 
 descriptor_t* stmt_APD(stmt_t *stmt) FA_HIDDEN;
 descriptor_t* stmt_IPD(stmt_t *stmt) FA_HIDDEN;
@@ -290,6 +294,29 @@ SQLRETURN stmt_complete_async(
     stmt_t      *stmt,
     RETCODE     *AsyncRetCodePtr) FA_HIDDEN;
 
+// performance counters, shared by statement and connection
+void stmt_perf_add(taos_odbc_perf_t *dst, const taos_odbc_perf_t *src) FA_HIDDEN;
+int stmt_perf_is_attr(SQLINTEGER Attribute) FA_HIDDEN;
+// 0: success; -1: BufferLength too small for `SQL_ATTR_TAOS_PERF`
+int stmt_perf_get_attr(const taos_odbc_perf_t *perf,
+    SQLINTEGER Attribute, SQLPOINTER Value,
+    SQLINTEGER BufferLength, SQLINTEGER *StringLength) FA_HIDDEN;
+void stmt_perf_dump(const char *who, const void *handle, const taos_odbc_perf_t *perf) FA_HIDDEN;
+
+SQLRETURN stmt_cancel(stmt_t *stmt) FA_HIDDEN;
+// called from any thread, no effect unless a cancelable call is in progress on `stmt`
+void stmt_cancel_with(stmt_t *stmt, stmt_cancel_reason_t reason) FA_HIDDEN;
+// the result set of the cancelable call in progress, for taos_stop_query
+void stmt_set_running_res(stmt_t *stmt, TAOS_RES *res) FA_HIDDEN;
+int stmt_is_cancelled(stmt_t *stmt) FA_HIDDEN;
+
+// sql to send to taosc for `sqlc_tsdb`, with `LIMIT` injected or tightened according to SQL_ATTR_MAX_ROWS
+const char* stmt_max_rows_sql(stmt_t *stmt, const sqlc_tsdb_t *sqlc_tsdb) FA_HIDDEN;
+
+int stmt_async_enabled(stmt_t *stmt) FA_HIDDEN;
+// issue taos_query_a on behalf of `stmt`, returns SQL_STILL_EXECUTING
+SQLRETURN stmt_async_query(stmt_t *stmt, const char *sql) FA_HIDDEN;
+
 EXTERN_C_END
 
 #endif //  _stmt_h_
@@ -45,6 +45,8 @@ static inline int tls_iconv(const char *fromcode, const char *tocode, const char
 
 charset_conv_t* tls_get_charset_conv(const char *fromcode, const char *tocode) FA_HIDDEN;
 
+tz_cache_t* tls_get_tz_cache(void) FA_HIDDEN;
+
 
 // debug leakage only
 int tls_leakage_potential(void) FA_HIDDEN;
@@ -27,6 +27,7 @@
 
 #include "macros.h"
 #include "typedefs.h"
+#include "taos_odbc_ext.h"
 
 #include <taos.h>
 
@@ -41,6 +42,10 @@ void topic_reset(topic_t *topic) FA_HIDDEN;
 void topic_release(topic_t *topic) FA_HIDDEN;
 
 void topic_init(topic_t *topic, stmt_t *stmt) FA_HIDDEN;
+void topic_destroy(topic_t *topic) FA_HIDDEN;
+void topic_fetch_begin(topic_t *topic) FA_HIDDEN;
+void topic_perf_add(topic_t *topic, taos_odbc_perf_t *perf) FA_HIDDEN;
+void topic_perf_reset(topic_t *topic) FA_HIDDEN;
 
 SQLRETURN topic_open(
     topic_t             *topic,
@@ -28,6 +28,8 @@
 #include "macros.h"
 #include "typedefs.h"
 
+#include "taos_odbc_ext.h"
+
 #include <taos.h>
 
 EXTERN_C_BEGIN
@@ -42,6 +44,10 @@ void tsdb_paramset_release(tsdb_paramset_t *paramset) FA_HIDDEN;
 void tsdb_binds_release(tsdb_binds_t *tsdb_binds) FA_HIDDEN;
 void tsdb_res_reset(tsdb_res_t *res) FA_HIDDEN;
 void tsdb_res_release(tsdb_res_t *res) FA_HIDDEN;
+void tsdb_rows_block_reset(tsdb_rows_block_t *rows_block) FA_HIDDEN;
+void tsdb_rows_block_release(tsdb_rows_block_t *rows_block) FA_HIDDEN;
+// return # of rows fetched, 0 if no more rows, -1 if out of memory
+int tsdb_rows_block_fetch(tsdb_rows_block_t *rows_block, TAOS_RES *res, const TAOS_FIELD *fields, size_t nr_fields) FA_HIDDEN;
 
 void tsdb_stmt_init(tsdb_stmt_t *stmt, stmt_t *owner) FA_HIDDEN;
 void tsdb_stmt_unprepare(tsdb_stmt_t *stmt) FA_HIDDEN;
@@ -49,6 +55,31 @@ void tsdb_stmt_unprepare(tsdb_stmt_t *stmt) FA_HIDDEN;
 SQLRETURN tsdb_stmt_query(tsdb_stmt_t *stmt, const sqlc_tsdb_t *sqlc_tsdb) FA_HIDDEN;
 SQLRETURN tsdb_stmt_rebind_subtbl(tsdb_stmt_t *stmt) FA_HIDDEN;
 
+int tsdb_stmt_write_behind_enabled(tsdb_stmt_t *stmt) FA_HIDDEN;
+SQLRETURN tsdb_stmt_execute_deferred(tsdb_stmt_t *stmt, size_t rows) FA_HIDDEN;
+SQLRETURN tsdb_stmt_flush(tsdb_stmt_t *stmt) FA_HIDDEN;
+
+// completion of taos_query_a/taos_fetch_rows_a issued on behalf of the owner statement in async mode
+SQLRETURN tsdb_stmt_query_done(tsdb_stmt_t *stmt, TAOS_RES *taos_res, int code) FA_HIDDEN;
+// the result set to taos_fetch_rows_a from, NULL if the current block is not used up or no more rows
+TAOS_RES* tsdb_stmt_block_needed(tsdb_stmt_t *stmt) FA_HIDDEN;
+SQLRETURN tsdb_stmt_block_done(tsdb_stmt_t *stmt, int nr_rows) FA_HIDDEN;
+// taos_stop_query the result set once no more rows are wanted, fields are kept
+void tsdb_stmt_stop(tsdb_stmt_t *stmt) FA_HIDDEN;
+
+// SQL_CURSOR_STATIC, rows are kept once fetched
+int tsdb_stmt_is_cached(tsdb_stmt_t *stmt) FA_HIDDEN;
+// rows yet to fetch from the current block of taosc, whose data remain valid until then
+// -1 if rows are not read from taosc blocks directly, such as being cached
+int tsdb_stmt_rows_in_block(tsdb_stmt_t *stmt) FA_HIDDEN;
+// fetch blocks until at least `nr_rows` rows cached or no more rows, `*cached` is the number of rows cached then
+SQLRETURN tsdb_stmt_cache_rows(tsdb_stmt_t *stmt, size_t nr_rows, size_t *cached) FA_HIDDEN;
+// position before 0-based `i_row`, so that the next fetch_row reads it
+void tsdb_stmt_cache_rewind(tsdb_stmt_t *stmt, size_t i_row) FA_HIDDEN;
+
+// SQL_ATTR_TAOS_ARROW_STREAM, the result set is handed over to `stream` as a whole
+SQLRETURN tsdb_stmt_export_arrow(tsdb_stmt_t *stmt, struct ArrowArrayStream *stream) FA_HIDDEN;
+
 EXTERN_C_END
 
 #endif //  _tsdb_h_
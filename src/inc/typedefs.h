@@ -35,10 +35,27 @@ typedef struct col_bind_map_s           col_bind_map_t;
 typedef struct columns_args_s           columns_args_t;
 typedef struct columns_s                columns_t;
 
+typedef struct coalesced_inserts_s      coalesced_inserts_t;
+
 typedef struct conn_cfg_s               conn_cfg_t;
 
 typedef struct conn_parser_param_s      conn_parser_param_t;
 typedef struct conn_s                   conn_t;
+typedef struct conn_timer_s             conn_timer_t;
+typedef struct conn_timer_entry_s       conn_timer_entry_t;
+typedef struct conn_pool_s              conn_pool_t;
+
+typedef struct cursor_block_s           cursor_block_t;
+typedef struct cursor_cache_s           cursor_cache_t;
+typedef struct fetch_job_s              fetch_job_t;
+typedef struct fetch_pool_s             fetch_pool_t;
+typedef struct result_cache_entry_s     result_cache_entry_t;
+typedef struct result_cache_s           result_cache_t;
+typedef struct tsdb_scan_lane_s         tsdb_scan_lane_t;
+typedef struct tsdb_scan_s              tsdb_scan_t;
+typedef struct tsdb_arrow_s             tsdb_arrow_t;
+typedef struct tsdb_arrow_batch_s       tsdb_arrow_batch_t;
+typedef struct tsdb_arrow_col_s         tsdb_arrow_col_t;
 
 typedef struct descriptor_s             descriptor_t;
 typedef struct desc_s                   desc_t;
@@ -69,7 +86,13 @@ typedef struct primarykeys_args_s       primarykeys_args_t;
 typedef struct primarykeys_s            primarykeys_t;
 
 typedef struct stmt_s                   stmt_t;
+typedef enum stmt_cancel_reason_e       stmt_cancel_reason_t;
+typedef enum stmt_async_op_e            stmt_async_op_t;
+typedef struct stmt_async_s             stmt_async_t;
 typedef struct stmt_get_data_args_s     stmt_get_data_args_t;
+typedef struct stmt_fetch_cell_s        stmt_fetch_cell_t;
+typedef struct stmt_fetch_unit_s        stmt_fetch_unit_t;
+typedef struct stmt_fetch_s             stmt_fetch_t;
 
 typedef struct stmt_base_s              stmt_base_t;
 
@@ -77,6 +100,9 @@ typedef struct sqlc_tsdb_s              sqlc_tsdb_t;
 typedef struct sqlc_data_s              sqlc_data_t;
 typedef struct sql_data_s               sql_data_t;
 
+typedef struct schemaless_s             schemaless_t;
+typedef struct schemaless_cfg_s         schemaless_cfg_t;
+
 typedef struct sqlc_sql_map_s           sqlc_sql_map_t;
 
 typedef struct sqls_s                   sqls_t;
@@ -86,11 +112,15 @@ typedef struct tables_args_s            tables_args_t;
 typedef struct tables_s                 tables_t;
 
 typedef struct tls_s                    tls_t;
+typedef struct profile_thread_s         profile_thread_t;
 
 typedef enum tables_type_e              tables_type_t;
 
 typedef struct topic_s                  topic_t;
 typedef struct topic_cfg_s              topic_cfg_t;
+typedef struct topic_consumer_s         topic_consumer_t;
+typedef struct topic_commit_ctx_s       topic_commit_ctx_t;
+typedef enum topic_commit_mode_e        topic_commit_mode_t;
 
 typedef struct tsdb_stmt_s              tsdb_stmt_t;
 typedef struct tsdb_params_s            tsdb_params_t;
@@ -30,6 +30,7 @@
 #include <iconv.h>
 
 #include <stdarg.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -201,6 +202,82 @@ void hash_table_release(hash_table_t *hash_table) FA_HIDDEN;
 int hash_table_set(hash_table_t *hash_table, const char *key, void *val) FA_HIDDEN;
 void hash_table_get(hash_table_t *hash_table, const char *key, void **val) FA_HIDDEN;
 
+#define TZ_CACHE_SLOTS               64
+
+typedef struct tz_cache_s                tz_cache_t;
+struct tz_cache_s {
+  // NOTE: keyed by local wall-clock hour, only hours without utc-offset-transition are cached
+  struct {
+    int64_t             hour;
+    int32_t             offset;          // local - utc, in seconds
+    int32_t             valid;
+  }                     slots[TZ_CACHE_SLOTS];
+};
+
+// NOTE: `local` is local wall-clock seconds counted as if it were utc, cache is optional
+int tod_local_to_utc(tz_cache_t *cache, int64_t local, int64_t *utc) FA_HIDDEN;
+
+typedef struct tod_ts_s                  tod_ts_t;
+struct tod_ts_s {
+  int64_t               sec;             // seconds since epoch
+  int32_t               nsec;
+  int8_t                frac_digits;     // number of digits following '.', 0 if absent
+  int8_t                has_tz;          // 1: `Z` or `+hh:mm`/`-hh:mm` suffix present
+};
+
+// YYYY-MM-DD[ T]HH:MM:SS[.f{1,9}][Z|+hh[:mm]|-hh[:mm]], local time if no tz suffix
+// return 0 on success
+// return -1 if `s` does not start with date and time at all
+// return -2 if date and time found, but either invalid or followed by garbage
+int tod_parse_iso8601(const char *s, size_t len, tz_cache_t *cache, tod_ts_t *ts) FA_HIDDEN;
+
+// locale-independent, length-bounded counterparts of strtoll/strtoull/strtod/strtof
+// leading blanks, sign and `0x`/`0` prefixes are accepted as strtoll(..., 0) does
+// return 0 on success
+// return -1 if invalid character found or no digits at all, `*end` points to where conversion stops
+// return -2 if overflow or underflow occurs
+int tod_str_to_i64(const char *s, size_t len, int64_t *v, const char **end) FA_HIDDEN;
+int tod_str_to_u64(const char *s, size_t len, uint64_t *v, const char **end) FA_HIDDEN;
+int tod_str_to_dbl(const char *s, size_t len, double *v, const char **end) FA_HIDDEN;
+int tod_str_to_flt(const char *s, size_t len, float *v, const char **end) FA_HIDDEN;
+
+// recognize `INSERT INTO tbl [(col, ...)] VALUES (...) [(...)]*`, nothing else allowed
+// return 0 on success, `*tail` is offset of `tbl`, `*rows` is number of value tuples
+// return -1 if not such a plain insert statement
+int tod_parse_plain_insert(const char *s, size_t len, size_t *tail, size_t *rows) FA_HIDDEN;
+
+// recognize a single `SELECT ...` with no top-level UNION or PARTITION BY
+// return 0 on success,
+//   if a top-level `LIMIT` exists, `[*start, *end)` is the row count therein, whose value is `*rows`
+//   otherwise, `*start` == `*end` is where a `LIMIT` clause could be appended, and `*rows` is -1
+// return -1 if not such a plain select statement
+int tod_parse_plain_select(const char *s, size_t len, size_t *start, size_t *end, int64_t *rows) FA_HIDDEN;
+
+// trim and collapse blanks into a single space, and lower-case, all outside of quotes
+// `buf` shall hold at least `len + 1` bytes, return the length of the null-terminated result
+size_t tod_normalize_sql(const char *s, size_t len, char *buf) FA_HIDDEN;
+
+// return 0 if `s` is SELECT/SHOW/DESCRIBE/USE, which modifies no table
+// return 1 if `s` is a plain `INSERT INTO tbl ...` or `DELETE FROM tbl ...`, `[*start, *end)` is `tbl`
+// return 2 otherwise, which might modify any table
+int tod_sql_write_target(const char *s, size_t len, size_t *start, size_t *end) FA_HIDDEN;
+
+typedef struct tod_ts_range_s            tod_ts_range_t;
+struct tod_ts_range_s {
+  size_t                col;             // offset of the timestamp column, as written
+  size_t                col_len;
+  size_t                end;             // offset where more predicates could be appended with `AND`
+  int64_t               lo;              // bounds, as written if integers, or nanoseconds since epoch if strings
+  int64_t               hi;
+  int8_t                is_str;
+};
+
+// recognize `SELECT cols FROM tbl WHERE ...`, whose top-level `AND`-ed predicates bound `ts` (or `_rowts`/`_c0`)
+// from both sides with literals, and which has neither function call in `cols`, nor ORDER/GROUP/PARTITION/
+// LIMIT/INTERVAL/JOIN/UNION and alike, nor top-level `OR`
+// return 0 on success, -1 otherwise
+int tod_parse_ts_range(const char *s, size_t len, tod_ts_range_t *range) FA_HIDDEN;
+
 EXTERN_C_END
 
 #endif // _utils_h_
@@ -35,6 +35,7 @@
 #include "env.h"
 #include "errs.h"
 #include "log.h"
+#include "profile.h"
 #include "setup.h"
 #include "stmt.h"
 #include "tls.h"
@@ -152,6 +153,7 @@ static void _init_once(void)
   _global.taos_odbc_debug_flex  = check_env_bool("TAOS_ODBC_DEBUG_FLEX");
   _global.taos_odbc_debug_bison = check_env_bool("TAOS_ODBC_DEBUG_BISON");
   _init_charsets();
+  profile_init(check_env_bool("TAOS_ODBC_PROFILE"));
 }
 
 int tod_get_debug_flex(void)
@@ -422,7 +424,8 @@ SQLRETURN SQL_API SQLAllocHandle(
 
   switch (HandleType) {
     case SQL_HANDLE_ENV:
-      return do_alloc_env(OutputHandle);
+      ODBC_PROFILE(SQLAllocHandle, sr = do_alloc_env(OutputHandle));
+      return sr;
     case SQL_HANDLE_DBC:
       if (InputHandle == SQL_NULL_HANDLE) return SQL_INVALID_HANDLE;
       if (!OutputHandle)                  return SQL_INVALID_HANDLE;
@@ -430,7 +433,7 @@ SQLRETURN SQL_API SQLAllocHandle(
       env = (env_t*)InputHandle;
       env_ref(env);
       env_clr_errs(env);
-      sr = env_alloc_conn(env, OutputHandle);
+      ODBC_PROFILE(SQLAllocHandle, sr = env_alloc_conn(env, OutputHandle));
       env_unref(env);
       return sr;
     case SQL_HANDLE_STMT:
@@ -440,7 +443,7 @@ SQLRETURN SQL_API SQLAllocHandle(
       conn = (conn_t*)InputHandle;
       conn_ref(conn);
       conn_clr_errs(conn);
-      sr = conn_alloc_stmt(conn, OutputHandle);
+      ODBC_PROFILE(SQLAllocHandle, sr = conn_alloc_stmt(conn, OutputHandle));
       conn_unref(conn);
       return sr;
     case SQL_HANDLE_DESC:
@@ -450,7 +453,7 @@ SQLRETURN SQL_API SQLAllocHandle(
       conn = (conn_t*)InputHandle;
       conn_ref(conn);
       conn_clr_errs(conn);
-      sr = conn_alloc_desc(conn, OutputHandle);
+      ODBC_PROFILE(SQLAllocHandle, sr = conn_alloc_desc(conn, OutputHandle));
       conn_unref(conn);
       return sr;
     default:
@@ -474,7 +477,7 @@ SQLRETURN SQL_API SQLFreeHandle(
       env_t *env = (env_t*)Handle;
       env_ref(env);
       env_clr_errs(env);
-      sr = env_free(env);
+      ODBC_PROFILE(SQLFreeHandle, sr = env_free(env));
       env_unref(env);
       return sr;
     }
@@ -482,7 +485,7 @@ SQLRETURN SQL_API SQLFreeHandle(
       conn_t *conn = (conn_t*)Handle;
       conn_ref(conn);
       conn_clr_errs(conn);
-      sr = conn_free(conn);
+      ODBC_PROFILE(SQLFreeHandle, sr = conn_free(conn));
       conn_unref(conn);
       return sr;
     }
@@ -490,7 +493,7 @@ SQLRETURN SQL_API SQLFreeHandle(
       stmt_t *stmt = (stmt_t*)Handle;
       stmt_ref(stmt);
       stmt_clr_errs(stmt);
-      sr = stmt_free(stmt);
+      ODBC_PROFILE(SQLFreeHandle, sr = stmt_free(stmt));
       stmt_unref(stmt);
       return sr;
     }
@@ -498,7 +501,7 @@ SQLRETURN SQL_API SQLFreeHandle(
       desc_t *desc = (desc_t*)Handle;
       desc_ref(desc);
       desc_clr_errs(desc);
-      sr = desc_free(desc);
+      ODBC_PROFILE(SQLFreeHandle, sr = desc_free(desc));
       desc_unref(desc);
       return sr;
     }
@@ -527,7 +530,7 @@ SQLRETURN SQL_API SQLDriverConnect(
 
   conn_ref(conn);
   conn_clr_errs(conn);
-  sr = conn_driver_connect(conn, WindowHandle, InConnectionString, StringLength1, OutConnectionString, BufferLength, StringLength2Ptr, DriverCompletion);
+  ODBC_PROFILE(SQLDriverConnect, sr = conn_driver_connect(conn, WindowHandle, InConnectionString, StringLength1, OutConnectionString, BufferLength, StringLength2Ptr, DriverCompletion));
   conn_unref(conn);
 
   return sr;
@@ -541,12 +544,14 @@ SQLRETURN SQL_API SQLDisconnect(
 
   conn_t *conn = (conn_t*)ConnectionHandle;
 
+  SQLRETURN sr = SQL_SUCCESS;
+
   conn_ref(conn);
   conn_clr_errs(conn);
-  conn_disconnect(conn);
+  ODBC_PROFILE(SQLDisconnect, sr = conn_disconnect(conn));
   conn_unref(conn);
 
-  return SQL_SUCCESS;
+  return sr;
 }
 
 SQLRETURN SQL_API SQLExecDirect(
@@ -563,7 +568,7 @@ SQLRETURN SQL_API SQLExecDirect(
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_exec_direct(stmt, StatementText, TextLength);
+  ODBC_PROFILE(SQLExecDirect, sr = stmt_exec_direct(stmt, StatementText, TextLength));
   stmt_unref(stmt);
   return sr;
 }
@@ -583,7 +588,7 @@ SQLRETURN SQL_API SQLSetEnvAttr(
 
   env_ref(env);
   env_clr_errs(env);
-  sr = env_set_attr(env, Attribute, ValuePtr, StringLength);
+  ODBC_PROFILE(SQLSetEnvAttr, sr = env_set_attr(env, Attribute, ValuePtr, StringLength));
   env_unref(env);
 
   return sr;
@@ -605,7 +610,7 @@ SQLRETURN SQL_API SQLGetInfo(
 
   conn_ref(conn);
   conn_clr_errs(conn);
-  sr = conn_get_info(conn, InfoType, InfoValuePtr, BufferLength, StringLengthPtr);
+  ODBC_PROFILE(SQLGetInfo, sr = conn_get_info(conn, InfoType, InfoValuePtr, BufferLength, StringLengthPtr));
   conn_unref(conn);
 
   return sr;
@@ -626,7 +631,7 @@ SQLRETURN SQL_API SQLEndTran(
       env_t *env = (env_t*)Handle;
       env_ref(env);
       env_clr_errs(env);
-      sr = env_end_tran(env, CompletionType);
+      ODBC_PROFILE(SQLEndTran, sr = env_end_tran(env, CompletionType));
       env_unref(env);
       return sr;
     }
@@ -634,7 +639,7 @@ SQLRETURN SQL_API SQLEndTran(
       conn_t *conn = (conn_t*)Handle;
       conn_ref(conn);
       conn_clr_errs(conn);
-      sr = conn_end_tran(conn, CompletionType);
+      ODBC_PROFILE(SQLEndTran, sr = conn_end_tran(conn, CompletionType));
       conn_unref(conn);
       return sr;
     }
@@ -660,7 +665,7 @@ SQLRETURN SQL_API SQLSetConnectAttr(
 
   conn_ref(conn);
   conn_clr_errs(conn);
-  sr = conn_set_attr(conn, Attribute, ValuePtr, StringLength);
+  ODBC_PROFILE(SQLSetConnectAttr, sr = conn_set_attr(conn, Attribute, ValuePtr, StringLength));
   conn_unref(conn);
 
   return sr;
@@ -682,7 +687,7 @@ SQLRETURN SQL_API SQLSetStmtAttr(
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_set_attr(stmt, Attribute, ValuePtr, StringLength);
+  ODBC_PROFILE(SQLSetStmtAttr, sr = stmt_set_attr(stmt, Attribute, ValuePtr, StringLength));
   stmt_unref(stmt);
 
   return sr;
@@ -701,7 +706,7 @@ SQLRETURN SQL_API SQLRowCount(
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_get_row_count((stmt_t*)StatementHandle, RowCountPtr);
+  ODBC_PROFILE(SQLRowCount, sr = stmt_get_row_count((stmt_t*)StatementHandle, RowCountPtr));
   stmt_unref(stmt);
 
   return sr;
@@ -720,7 +725,7 @@ SQLRETURN SQL_API SQLNumResultCols(
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_get_col_count((stmt_t*)StatementHandle, ColumnCountPtr);
+  ODBC_PROFILE(SQLNumResultCols, sr = stmt_get_col_count((stmt_t*)StatementHandle, ColumnCountPtr));
   stmt_unref(stmt);
 
   return sr;
@@ -746,7 +751,7 @@ SQLRETURN SQL_API SQLDescribeCol(
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_describe_col(stmt,
+  ODBC_PROFILE(SQLDescribeCol, sr = stmt_describe_col(stmt,
       ColumnNumber,
       ColumnName,
       BufferLength,
@@ -754,7 +759,7 @@ SQLRETURN SQL_API SQLDescribeCol(
       DataTypePtr,
       ColumnSizePtr,
       DecimalDigitsPtr,
-      NullablePtr);
+      NullablePtr));
   stmt_unref(stmt);
 
   return sr;
@@ -777,12 +782,12 @@ SQLRETURN SQL_API SQLBindCol(
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_bind_col(stmt,
+  ODBC_PROFILE(SQLBindCol, sr = stmt_bind_col(stmt,
       ColumnNumber,
       TargetType,
       TargetValuePtr,
       BufferLength,
-      StrLen_or_IndPtr);
+      StrLen_or_IndPtr));
   stmt_unref(stmt);
 
   return sr;
@@ -800,7 +805,7 @@ SQLRETURN SQL_API SQLFetch(
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_fetch(stmt);
+  ODBC_PROFILE(SQLFetch, sr = stmt_fetch(stmt));
   stmt_unref(stmt);
 
   return sr;
@@ -820,7 +825,7 @@ SQLRETURN SQL_API SQLFetchScroll(
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_fetch_scroll(stmt, FetchOrientation, FetchOffset);
+  ODBC_PROFILE(SQLFetchScroll, sr = stmt_fetch_scroll(stmt, FetchOrientation, FetchOffset));
   stmt_unref(stmt);
 
   return sr;
@@ -839,7 +844,7 @@ SQLRETURN SQL_API SQLFreeStmt(
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_free_stmt(stmt, Option);
+  ODBC_PROFILE(SQLFreeStmt, sr = stmt_free_stmt(stmt, Option));
   stmt_unref(stmt);
 
   return sr;
@@ -864,28 +869,28 @@ SQLRETURN SQL_API SQLGetDiagRec(
     case SQL_HANDLE_ENV: {
       env_t *env = (env_t*)Handle;
       env_ref(env);
-      sr = env_get_diag_rec(env, RecNumber, SQLState, NativeErrorPtr, MessageText, BufferLength, TextLengthPtr);
+      ODBC_PROFILE(SQLGetDiagRec, sr = env_get_diag_rec(env, RecNumber, SQLState, NativeErrorPtr, MessageText, BufferLength, TextLengthPtr));
       env_unref(env);
       return sr;
     }
     case SQL_HANDLE_DBC: {
       conn_t *conn = (conn_t*)Handle;
       conn_ref(conn);
-      sr = conn_get_diag_rec(conn, RecNumber, SQLState, NativeErrorPtr, MessageText, BufferLength, TextLengthPtr);
+      ODBC_PROFILE(SQLGetDiagRec, sr = conn_get_diag_rec(conn, RecNumber, SQLState, NativeErrorPtr, MessageText, BufferLength, TextLengthPtr));
       conn_unref(conn);
       return sr;
     }
     case SQL_HANDLE_STMT: {
       stmt_t *stmt = (stmt_t*)Handle;
       stmt_ref(stmt);
-      sr = stmt_get_diag_rec(stmt, RecNumber, SQLState, NativeErrorPtr, MessageText, BufferLength, TextLengthPtr);
+      ODBC_PROFILE(SQLGetDiagRec, sr = stmt_get_diag_rec(stmt, RecNumber, SQLState, NativeErrorPtr, MessageText, BufferLength, TextLengthPtr));
       stmt_unref(stmt);
       return sr;
     }
     case SQL_HANDLE_DESC: {
       desc_t *desc = (desc_t*)Handle;
       desc_ref(desc);
-      sr = desc_get_diag_rec(desc, RecNumber, SQLState, NativeErrorPtr, MessageText, BufferLength, TextLengthPtr);
+      ODBC_PROFILE(SQLGetDiagRec, sr = desc_get_diag_rec(desc, RecNumber, SQLState, NativeErrorPtr, MessageText, BufferLength, TextLengthPtr));
       desc_unref(desc);
       return sr;
     }
@@ -913,26 +918,27 @@ SQLRETURN SQL_API SQLGetDiagField(
     case SQL_HANDLE_DBC: {
       conn_t *conn = (conn_t*)Handle;
       conn_ref(conn);
-      sr = conn_get_diag_field(conn, RecNumber, DiagIdentifier, DiagInfoPtr, BufferLength, StringLengthPtr);
+      ODBC_PROFILE(SQLGetDiagField, sr = conn_get_diag_field(conn, RecNumber, DiagIdentifier, DiagInfoPtr, BufferLength, StringLengthPtr));
       conn_unref(conn);
       return sr;
     }
     case SQL_HANDLE_STMT: {
       stmt_t *stmt = (stmt_t*)Handle;
       stmt_ref(stmt);
-      sr = stmt_get_diag_field(stmt, RecNumber, DiagIdentifier, DiagInfoPtr, BufferLength, StringLengthPtr);
+      ODBC_PROFILE(SQLGetDiagField, sr = stmt_get_diag_field(stmt, RecNumber, DiagIdentifier, DiagInfoPtr, BufferLength, StringLengthPtr));
       stmt_unref(stmt);
       return sr;
     }
     case SQL_HANDLE_ENV: {
       env_t *env = (env_t*)Handle;
       env_ref(env);
-      sr = env_get_diag_field(env, RecNumber, DiagIdentifier, DiagInfoPtr, BufferLength, StringLengthPtr);
+      ODBC_PROFILE(SQLGetDiagField, sr = env_get_diag_field(env, RecNumber, DiagIdentifier, DiagInfoPtr, BufferLength, StringLengthPtr));
       env_unref(env);
       return sr;
     }
     case SQL_HANDLE_DESC:
-      return desc_get_diag_field((desc_t*)Handle, RecNumber, DiagIdentifier, DiagInfoPtr, BufferLength, StringLengthPtr);
+      ODBC_PROFILE(SQLGetDiagField, sr = desc_get_diag_field((desc_t*)Handle, RecNumber, DiagIdentifier, DiagInfoPtr, BufferLength, StringLengthPtr));
+      return sr;
     default:
       OW("`%s` not implemented yet", sql_handle_type(HandleType));
       OA_NIY(0);
@@ -957,7 +963,7 @@ SQLRETURN SQL_API SQLGetData(
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_get_data(stmt, Col_or_Param_Num, TargetType, TargetValuePtr, BufferLength, StrLen_or_IndPtr);
+  ODBC_PROFILE(SQLGetData, sr = stmt_get_data(stmt, Col_or_Param_Num, TargetType, TargetValuePtr, BufferLength, StrLen_or_IndPtr));
   stmt_unref(stmt);
 
   return sr;
@@ -977,7 +983,7 @@ SQLRETURN SQL_API SQLPrepare(
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_prepare(stmt, StatementText, TextLength);
+  ODBC_PROFILE(SQLPrepare, sr = stmt_prepare(stmt, StatementText, TextLength));
   stmt_unref(stmt);
 
   return sr;
@@ -996,7 +1002,7 @@ SQLRETURN SQL_API SQLNumParams(
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_get_num_params(stmt, ParameterCountPtr);
+  ODBC_PROFILE(SQLNumParams, sr = stmt_get_num_params(stmt, ParameterCountPtr));
   stmt_unref(stmt);
 
   return sr;
@@ -1019,13 +1025,13 @@ SQLRETURN SQL_API SQLDescribeParam(
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_describe_param(
+  ODBC_PROFILE(SQLDescribeParam, sr = stmt_describe_param(
       stmt,
       ParameterNumber,
       DataTypePtr,
       ParameterSizePtr,
       DecimalDigitsPtr,
-      NullablePtr);
+      NullablePtr));
   stmt_unref(stmt);
 
   return sr;
@@ -1052,7 +1058,7 @@ SQLRETURN SQL_API SQLBindParameter(
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_bind_param(stmt,
+  ODBC_PROFILE(SQLBindParameter, sr = stmt_bind_param(stmt,
     ParameterNumber,
     InputOutputType,
     ValueType,
@@ -1061,7 +1067,7 @@ SQLRETURN SQL_API SQLBindParameter(
     DecimalDigits,
     ParameterValuePtr,
     BufferLength,
-    StrLen_or_IndPtr);
+    StrLen_or_IndPtr));
   stmt_unref(stmt);
 
   return sr;
@@ -1079,7 +1085,7 @@ SQLRETURN SQL_API SQLExecute(
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_execute(stmt);
+  ODBC_PROFILE(SQLExecute, sr = stmt_execute(stmt));
   stmt_unref(stmt);
 
   return sr;
@@ -1103,11 +1109,11 @@ SQLRETURN SQL_API SQLConnect(
 
   conn_ref(conn);
   conn_clr_errs(conn);
-  sr = conn_connect(
+  ODBC_PROFILE(SQLConnect, sr = conn_connect(
       conn,
       ServerName, NameLength1,
       UserName, NameLength2,
-      Authentication, NameLength3);
+      Authentication, NameLength3));
   conn_unref(conn);
 
   return sr;
@@ -1131,7 +1137,7 @@ SQLRETURN SQL_API SQLColAttribute(
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_col_attribute(stmt, ColumnNumber, FieldIdentifier, CharacterAttributePtr, BufferLength, StringLengthPtr, NumericAttributePtr);
+  ODBC_PROFILE(SQLColAttribute, sr = stmt_col_attribute(stmt, ColumnNumber, FieldIdentifier, CharacterAttributePtr, BufferLength, StringLengthPtr, NumericAttributePtr));
   stmt_unref(stmt);
 
   return sr;
@@ -1157,11 +1163,11 @@ SQLRETURN SQL_API SQLTables(
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_tables(stmt,
+  ODBC_PROFILE(SQLTables, sr = stmt_tables(stmt,
     CatalogName, NameLength1,
     SchemaName, NameLength2,
     TableName, NameLength3,
-    TableType, NameLength4);
+    TableType, NameLength4));
   stmt_unref(stmt);
 
   return sr;
@@ -1181,23 +1187,29 @@ SQLRETURN SQL_API SQLBulkOperations(
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_bulk_operations(stmt, Operation);
+  ODBC_PROFILE(SQLBulkOperations, sr = stmt_bulk_operations(stmt, Operation));
   stmt_unref(stmt);
 
   return sr;
 }
 #endif                                   /* } */
 
-#if 0                          /* { */
 SQLRETURN SQL_API SQLCancel(SQLHSTMT StatementHandle)
 {
   SQLRETURN sr = SQL_SUCCESS;
 
   OOW("===");
-  (void)StatementHandle;
-  OA_NIY(0);
+  if (StatementHandle == SQL_NULL_HANDLE) return SQL_INVALID_HANDLE;
+
+  stmt_t *stmt = (stmt_t*)StatementHandle;
+
+  // NOTE: typically called from another thread, thus leave diagnostics of the running function intact
+  stmt_ref(stmt);
+  ODBC_PROFILE(SQLCancel, sr = stmt_cancel(stmt));
+  stmt_unref(stmt);
+
+  return sr;
 }
-#endif                         /* } */
 
 #if (ODBCVER >= 0x0300)                  /* { */
 SQLRETURN SQL_API SQLCloseCursor(SQLHSTMT StatementHandle)
@@ -1213,7 +1225,7 @@ SQLRETURN SQL_API SQLCloseCursor(SQLHSTMT StatementHandle)
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_close_cursor(stmt);
+  ODBC_PROFILE(SQLCloseCursor, sr = stmt_close_cursor(stmt));
   stmt_unref(stmt);
 
   return sr;
@@ -1240,7 +1252,7 @@ SQLRETURN SQL_API SQLColumnPrivileges(
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_column_privileges(stmt, CatalogName, NameLength1, SchemaName, NameLength2, TableName, NameLength3, ColumnName, NameLength4);
+  ODBC_PROFILE(SQLColumnPrivileges, sr = stmt_column_privileges(stmt, CatalogName, NameLength1, SchemaName, NameLength2, TableName, NameLength3, ColumnName, NameLength4));
   stmt_unref(stmt);
 
   return sr;
@@ -1261,7 +1273,7 @@ SQLRETURN SQL_API SQLColumns(SQLHSTMT StatementHandle,
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_columns(stmt, CatalogName, NameLength1, SchemaName, NameLength2, TableName, NameLength3, ColumnName, NameLength4);
+  ODBC_PROFILE(SQLColumns, sr = stmt_columns(stmt, CatalogName, NameLength1, SchemaName, NameLength2, TableName, NameLength3, ColumnName, NameLength4));
   stmt_unref(stmt);
 
   return sr;
@@ -1286,7 +1298,7 @@ SQLRETURN SQL_API SQLCopyDesc(SQLHDESC SourceDescHandle,
   desc_clr_errs(src);
   desc_clr_errs(tgt);
 
-  sr = desc_copy(src, tgt);
+  ODBC_PROFILE(SQLCopyDesc, sr = desc_copy(src, tgt));
 
   desc_unref(tgt);
   desc_unref(src);
@@ -1311,7 +1323,7 @@ SQLRETURN SQL_API SQLExtendedFetch(
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_extended_fetch(stmt, FetchOrientation, FetchOffset, RowCountPtr, RowStatusArray);
+  ODBC_PROFILE(SQLExtendedFetch, sr = stmt_extended_fetch(stmt, FetchOrientation, FetchOffset, RowCountPtr, RowStatusArray));
   stmt_unref(stmt);
 
   return sr;
@@ -1341,8 +1353,8 @@ SQLRETURN SQL_API SQLForeignKeys(
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_foreign_keys(stmt, PKCatalogName, NameLength1, PKSchemaName, NameLength2,
-      PKTableName, NameLength3, FKCatalogName, NameLength4, FKSchemaName, NameLength5, FKTableName, NameLength6);
+  ODBC_PROFILE(SQLForeignKeys, sr = stmt_foreign_keys(stmt, PKCatalogName, NameLength1, PKSchemaName, NameLength2,
+      PKTableName, NameLength3, FKCatalogName, NameLength4, FKSchemaName, NameLength5, FKTableName, NameLength6));
   stmt_unref(stmt);
 
   return sr;
@@ -1362,7 +1374,7 @@ SQLRETURN SQL_API SQLGetConnectAttr(SQLHDBC ConnectionHandle,
 
   conn_ref(conn);
   conn_clr_errs(conn);
-  sr = conn_get_attr(conn, Attribute, Value, BufferLength, StringLengthPtr);
+  ODBC_PROFILE(SQLGetConnectAttr, sr = conn_get_attr(conn, Attribute, Value, BufferLength, StringLengthPtr));
   conn_unref(conn);
 
   return sr;
@@ -1384,7 +1396,7 @@ SQLRETURN SQL_API SQLGetCursorName(
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_get_cursor_name(stmt, CursorName, BufferLength, NameLengthPtr);
+  ODBC_PROFILE(SQLGetCursorName, sr = stmt_get_cursor_name(stmt, CursorName, BufferLength, NameLengthPtr));
   stmt_unref(stmt);
 
   return sr;
@@ -1405,7 +1417,7 @@ SQLRETURN SQL_API SQLGetDescField(SQLHDESC DescriptorHandle,
 
   desc_ref(desc);
   desc_clr_errs(desc);
-  sr = desc_get_field(desc, RecNumber, FieldIdentifier, Value, BufferLength, StringLength);
+  ODBC_PROFILE(SQLGetDescField, sr = desc_get_field(desc, RecNumber, FieldIdentifier, Value, BufferLength, StringLength));
   desc_unref(desc);
 
   return sr;
@@ -1427,13 +1439,13 @@ SQLRETURN SQL_API SQLGetDescRec(SQLHDESC DescriptorHandle,
 
   desc_ref(desc);
   desc_clr_errs(desc);
-  sr = desc_get_rec(
+  ODBC_PROFILE(SQLGetDescRec, sr = desc_get_rec(
       desc,
       RecNumber, Name,
       BufferLength, StringLengthPtr,
       TypePtr, SubTypePtr,
       LengthPtr, PrecisionPtr,
-      ScalePtr, NullablePtr);
+      ScalePtr, NullablePtr));
   desc_unref(desc);
 
   return sr;
@@ -1452,7 +1464,7 @@ SQLRETURN SQL_API SQLGetEnvAttr(SQLHENV EnvironmentHandle,
 
   env_ref(env);
   env_clr_errs(env);
-  sr = env_get_attr(env, Attribute, Value, BufferLength, StringLength);
+  ODBC_PROFILE(SQLGetEnvAttr, sr = env_get_attr(env, Attribute, Value, BufferLength, StringLength));
   env_unref(env);
 
   return sr;
@@ -1488,7 +1500,7 @@ SQLRETURN SQL_API SQLGetStmtAttr(SQLHSTMT StatementHandle,
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_get_attr(stmt, Attribute, Value, BufferLength, StringLength);
+  ODBC_PROFILE(SQLGetStmtAttr, sr = stmt_get_attr(stmt, Attribute, Value, BufferLength, StringLength));
   stmt_unref(stmt);
 
   return sr;
@@ -1507,7 +1519,7 @@ SQLRETURN SQL_API SQLGetTypeInfo(SQLHSTMT StatementHandle,
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_get_type_info(stmt, DataType);
+  ODBC_PROFILE(SQLGetTypeInfo, sr = stmt_get_type_info(stmt, DataType));
   stmt_unref(stmt);
 
   return sr;
@@ -1525,7 +1537,7 @@ SQLRETURN SQL_API SQLMoreResults(
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_more_results(stmt);
+  ODBC_PROFILE(SQLMoreResults, sr = stmt_more_results(stmt));
   stmt_unref(stmt);
 
   return sr;
@@ -1548,7 +1560,7 @@ SQLRETURN SQL_API SQLNativeSql(
 
   conn_ref(conn);
   conn_clr_errs(conn);
-  sr = conn_native_sql((conn_t*)ConnectionHandle, InStatementText, TextLength1, OutStatementText, BufferLength, TextLength2Ptr);
+  ODBC_PROFILE(SQLNativeSql, sr = conn_native_sql((conn_t*)ConnectionHandle, InStatementText, TextLength1, OutStatementText, BufferLength, TextLength2Ptr));
   conn_unref(conn);
 
   return sr;
@@ -1566,7 +1578,7 @@ SQLRETURN SQL_API SQLParamData(SQLHSTMT StatementHandle,
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_param_data(stmt, Value);
+  ODBC_PROFILE(SQLParamData, sr = stmt_param_data(stmt, Value));
   stmt_unref(stmt);
 
   return sr;
@@ -1590,7 +1602,7 @@ SQLRETURN SQL_API SQLPrimaryKeys(
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_primary_keys(stmt, CatalogName, NameLength1, SchemaName, NameLength2, TableName, NameLength3);
+  ODBC_PROFILE(SQLPrimaryKeys, sr = stmt_primary_keys(stmt, CatalogName, NameLength1, SchemaName, NameLength2, TableName, NameLength3));
   stmt_unref(stmt);
 
   return sr;
@@ -1616,7 +1628,7 @@ SQLRETURN SQL_API SQLProcedureColumns(
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_procedure_columns(stmt, CatalogName, NameLength1, SchemaName, NameLength2, ProcName, NameLength3, ColumnName, NameLength4);
+  ODBC_PROFILE(SQLProcedureColumns, sr = stmt_procedure_columns(stmt, CatalogName, NameLength1, SchemaName, NameLength2, ProcName, NameLength3, ColumnName, NameLength4));
   stmt_unref(stmt);
 
   return sr;
@@ -1640,7 +1652,7 @@ SQLRETURN SQL_API SQLProcedures(
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_procedures(stmt, CatalogName, NameLength1, SchemaName, NameLength2, ProcName, NameLength3);
+  ODBC_PROFILE(SQLProcedures, sr = stmt_procedures(stmt, CatalogName, NameLength1, SchemaName, NameLength2, ProcName, NameLength3));
   stmt_unref(stmt);
 
   return sr;
@@ -1658,7 +1670,7 @@ SQLRETURN SQL_API SQLPutData(SQLHSTMT StatementHandle,
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_put_data(stmt, Data, StrLen_or_Ind);
+  ODBC_PROFILE(SQLPutData, sr = stmt_put_data(stmt, Data, StrLen_or_Ind));
   stmt_unref(stmt);
 
   return sr;
@@ -1678,7 +1690,7 @@ SQLRETURN SQL_API SQLSetCursorName(
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_set_cursor_name(stmt, CursorName, NameLength);
+  ODBC_PROFILE(SQLSetCursorName, sr = stmt_set_cursor_name(stmt, CursorName, NameLength));
   stmt_unref(stmt);
 
   return sr;
@@ -1698,7 +1710,7 @@ SQLRETURN SQL_API SQLSetDescField(SQLHDESC DescriptorHandle,
 
   desc_ref(desc);
   desc_clr_errs(desc);
-  sr = desc_set_field(desc, RecNumber, FieldIdentifier, Value, BufferLength);
+  ODBC_PROFILE(SQLSetDescField, sr = desc_set_field(desc, RecNumber, FieldIdentifier, Value, BufferLength));
   desc_unref(desc);
 
   return sr;
@@ -1720,13 +1732,13 @@ SQLRETURN SQL_API SQLSetDescRec(SQLHDESC DescriptorHandle,
 
   desc_ref(desc);
   desc_clr_errs(desc);
-  sr =desc_set_rec(
+  ODBC_PROFILE(SQLSetDescRec, sr = desc_set_rec(
       desc,
       RecNumber, Type,
       SubType, Length,
       Precision, Scale,
       Data, StringLength,
-      Indicator);
+      Indicator));
   desc_unref(desc);
 
   return sr;
@@ -1748,7 +1760,7 @@ SQLRETURN SQL_API SQLSetPos(
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_set_pos(stmt, RowNumber, Operation, LockType);
+  ODBC_PROFILE(SQLSetPos, sr = stmt_set_pos(stmt, RowNumber, Operation, LockType));
   stmt_unref(stmt);
 
   return sr;
@@ -1771,9 +1783,9 @@ SQLRETURN SQL_API SQLSpecialColumns(
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_special_columns(
+  ODBC_PROFILE(SQLSpecialColumns, sr = stmt_special_columns(
       stmt, IdentifierType, CatalogName, NameLength1,
-      SchemaName, NameLength2, TableName, NameLength3, Scope, Nullable);
+      SchemaName, NameLength2, TableName, NameLength3, Scope, Nullable));
   stmt_unref(stmt);
 
   return sr;
@@ -1795,12 +1807,12 @@ SQLRETURN SQL_API SQLStatistics(
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_statistics(
+  ODBC_PROFILE(SQLStatistics, sr = stmt_statistics(
       stmt,
       CatalogName, NameLength1,
       SchemaName, NameLength2,
       TableName, NameLength3,
-      Unique, Reserved);
+      Unique, Reserved));
   stmt_unref(stmt);
 
   return sr;
@@ -1824,11 +1836,11 @@ SQLRETURN SQL_API SQLTablePrivileges(
 
   stmt_ref(stmt);
   stmt_clr_errs(stmt);
-  sr = stmt_table_privileges(
+  ODBC_PROFILE(SQLTablePrivileges, sr = stmt_table_privileges(
       stmt,
       CatalogName, NameLength1,
       SchemaName, NameLength2,
-      TableName, NameLength3);
+      TableName, NameLength3));
   stmt_unref(stmt);
 
   return sr;
@@ -1851,10 +1863,10 @@ SQLRETURN SQL_API SQLBrowseConnect(
 
   conn_ref(conn);
   conn_clr_errs(conn);
-  sr = conn_browse_connect(
+  ODBC_PROFILE(SQLBrowseConnect, sr = conn_browse_connect(
       conn,
       InConnectionString, StringLength1,
-      OutConnectionString, BufferLength, StringLength2Ptr);
+      OutConnectionString, BufferLength, StringLength2Ptr));
   conn_unref(conn);
 
   return sr;
@@ -1875,7 +1887,7 @@ SQLRETURN SQL_API SQLCompleteAsync(
       conn_t *conn = (conn_t*)Handle;
       conn_ref(conn);
       conn_clr_errs(conn);
-      sr = conn_complete_async(conn, AsyncRetCodePtr);
+      ODBC_PROFILE(SQLCompleteAsync, sr = conn_complete_async(conn, AsyncRetCodePtr));
       conn_unref(conn);
       return sr;
     }
@@ -1883,7 +1895,7 @@ SQLRETURN SQL_API SQLCompleteAsync(
       stmt_t *stmt = (stmt_t*)Handle;
       stmt_ref(stmt);
       stmt_clr_errs(stmt);
-      sr = stmt_complete_async(stmt, AsyncRetCodePtr);
+      ODBC_PROFILE(SQLCompleteAsync, sr = stmt_complete_async(stmt, AsyncRetCodePtr));
       stmt_unref(stmt);
       return sr;
     }
@@ -21,3 +21,46 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
  * SOFTWARE.
  */
+
+#include "os_port.h"
+
+#ifndef _WIN32           /* { */
+#include <errno.h>
+
+void tod_sleep_ms(int ms)
+{
+  if (ms <= 0) return;
+  struct timespec req = {
+    .tv_sec            = ms / 1000,
+    .tv_nsec           = (long)(ms % 1000) * 1000000,
+  };
+  while (nanosleep(&req, &req) && errno == EINTR) ;
+}
+
+int64_t tod_now_us(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+int64_t tod_now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+int tod_cond_timedwait_ms(pthread_cond_t *cond, pthread_mutex_t *mutex, int ms)
+{
+  struct timespec abstime;
+  clock_gettime(CLOCK_REALTIME, &abstime);
+  abstime.tv_sec  += ms / 1000;
+  abstime.tv_nsec += (long)(ms % 1000) * 1000000;
+  if (abstime.tv_nsec >= 1000000000) {
+    abstime.tv_sec  += 1;
+    abstime.tv_nsec -= 1000000000;
+  }
+  return pthread_cond_timedwait(cond, mutex, &abstime);
+}
+#endif                   /* } */
@@ -27,6 +27,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #ifdef _WIN32
+#include <process.h>
 #include <psapi.h>
 #pragma comment(lib, "psapi.lib")
 #endif
@@ -90,6 +91,130 @@ char* tod_getenv(const char *name)
   return getenv(name);
 }
 
+void tod_sleep_ms(int ms)
+{
+  if (ms <= 0) return;
+  Sleep((DWORD)ms);
+}
+
+int64_t tod_now_us(void)
+{
+  static LARGE_INTEGER freq;
+  LARGE_INTEGER now;
+  if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&now);
+  return (int64_t)(now.QuadPart / freq.QuadPart * 1000000 + now.QuadPart % freq.QuadPart * 1000000 / freq.QuadPart);
+}
+
+int64_t tod_now_ns(void)
+{
+  static LARGE_INTEGER freq;
+  LARGE_INTEGER now;
+  if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&now);
+  return (int64_t)(now.QuadPart / freq.QuadPart * 1000000000 + now.QuadPart % freq.QuadPart * 1000000000 / freq.QuadPart);
+}
+
+typedef struct thread_start_s          thread_start_t;
+struct thread_start_s {
+  void *(*start_routine)(void*);
+  void  *arg;
+};
+
+static unsigned __stdcall _thread_start(void *arg)
+{
+  thread_start_t start = *(thread_start_t*)arg;
+  free(arg);
+  start.start_routine(start.arg);
+  return 0;
+}
+
+int pthread_create(pthread_t *thread, const void *attr, void *(*start_routine)(void*), void *arg)
+{
+  (void)attr;
+  thread_start_t *start = (thread_start_t*)malloc(sizeof(*start));
+  if (!start) return ENOMEM;
+  start->start_routine = start_routine;
+  start->arg           = arg;
+  uintptr_t h = _beginthreadex(NULL, 0, _thread_start, start, 0, NULL);
+  if (h == 0) {
+    int e = errno;
+    free(start);
+    return e ? e : EAGAIN;
+  }
+  *thread = (HANDLE)h;
+  return 0;
+}
+
+int pthread_join(pthread_t thread, void **retval)
+{
+  if (retval) *retval = NULL;
+  if (WaitForSingleObject(thread, INFINITE) != WAIT_OBJECT_0) return EINVAL;
+  CloseHandle(thread);
+  return 0;
+}
+
+int pthread_mutex_init(pthread_mutex_t *mutex, const void *attr)
+{
+  (void)attr;
+  InitializeCriticalSection(mutex);
+  return 0;
+}
+
+int pthread_mutex_destroy(pthread_mutex_t *mutex)
+{
+  DeleteCriticalSection(mutex);
+  return 0;
+}
+
+int pthread_mutex_lock(pthread_mutex_t *mutex)
+{
+  EnterCriticalSection(mutex);
+  return 0;
+}
+
+int pthread_mutex_unlock(pthread_mutex_t *mutex)
+{
+  LeaveCriticalSection(mutex);
+  return 0;
+}
+
+int pthread_cond_init(pthread_cond_t *cond, const void *attr)
+{
+  (void)attr;
+  InitializeConditionVariable(cond);
+  return 0;
+}
+
+int pthread_cond_destroy(pthread_cond_t *cond)
+{
+  (void)cond;
+  return 0;
+}
+
+int pthread_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mutex)
+{
+  return SleepConditionVariableCS(cond, mutex, INFINITE) ? 0 : EINVAL;
+}
+
+int pthread_cond_signal(pthread_cond_t *cond)
+{
+  WakeConditionVariable(cond);
+  return 0;
+}
+
+int pthread_cond_broadcast(pthread_cond_t *cond)
+{
+  WakeAllConditionVariable(cond);
+  return 0;
+}
+
+int tod_cond_timedwait_ms(pthread_cond_t *cond, pthread_mutex_t *mutex, int ms)
+{
+  if (SleepConditionVariableCS(cond, mutex, (DWORD)(ms < 0 ? 0 : ms))) return 0;
+  return (GetLastError() == ERROR_TIMEOUT) ? ETIMEDOUT : EINVAL;
+}
+
 static BOOL CALLBACK InitHandleFunction(PINIT_ONCE InitOnce, PVOID Parameter, PVOID *lpContext)
 {
   (void)InitOnce;
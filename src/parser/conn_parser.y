@@ -169,6 +169,26 @@
       OA_NIY(_s[_n] == '\0');                                                                   \
       param->conn_cfg->timestamp_as_is = !!(atoi(_s));                                          \
     } while (0)
+    #define SET_WRITE_BEHIND(_s, _n, _loc) do {                                                 \
+      if (!param) break;                                                                        \
+      OA_NIY(_s[_n] == '\0');                                                                   \
+      param->conn_cfg->write_behind = atoi(_s);                                                 \
+    } while (0)
+    #define SET_WRITE_BEHIND_MS(_s, _n, _loc) do {                                              \
+      if (!param) break;                                                                        \
+      OA_NIY(_s[_n] == '\0');                                                                   \
+      param->conn_cfg->write_behind_ms = atoi(_s);                                              \
+    } while (0)
+    #define SET_STATIC_CURSOR_KB(_s, _n, _loc) do {                                             \
+      if (!param) break;                                                                        \
+      OA_NIY(_s[_n] == '\0');                                                                   \
+      param->conn_cfg->static_cursor_kb = atoi(_s);                                             \
+    } while (0)
+    #define SET_RESULT_CACHE_TTL_MS(_s, _n, _loc) do {                                          \
+      if (!param) break;                                                                        \
+      OA_NIY(_s[_n] == '\0');                                                                   \
+      param->conn_cfg->result_cache_ttl_ms = atoi(_s);                                          \
+    } while (0)
 
     void conn_parser_param_release(conn_parser_param_t *param)
     {
@@ -197,6 +217,7 @@
 %union { char c; }
 
 %token DSN UID PWD DRIVER SERVER DATABASE UNSIGNED_PROMOTION TIMESTAMP_AS_IS DB
+%token WRITE_BEHIND WRITE_BEHIND_MS STATIC_CURSOR_KB RESULT_CACHE_TTL_MS
 %token CHARSET CHARSET_FOR_COL_BIND CHARSET_FOR_PARAM_BIND
 %token TOPIC
 %token <token> ID VALUE FQDN DIGITS
@@ -257,6 +278,10 @@ attribute:
 | DATABASE '=' VALUE              { SET_DATABASE($3, @$); }
 | UNSIGNED_PROMOTION '=' DIGITS   { SET_UNSIGNED_PROMOTION($3.text, $3.leng, @$); }
 | TIMESTAMP_AS_IS '=' DIGITS      { SET_TIMESTAMP_AS_IS($3.text, $3.leng, @$); }
+| WRITE_BEHIND '=' DIGITS         { SET_WRITE_BEHIND($3.text, $3.leng, @$); }
+| WRITE_BEHIND_MS '=' DIGITS      { SET_WRITE_BEHIND_MS($3.text, $3.leng, @$); }
+| STATIC_CURSOR_KB '=' DIGITS     { SET_STATIC_CURSOR_KB($3.text, $3.leng, @$); }
+| RESULT_CACHE_TTL_MS '=' DIGITS  { SET_RESULT_CACHE_TTL_MS($3.text, $3.leng, @$); }
 | CHARSET '=' VALUE               { SET_CHARSET($3, @$); }
 | CHARSET_FOR_COL_BIND '=' VALUE               { SET_CHARSET_FOR_COL_BIND($3, @$); }
 | CHARSET_FOR_PARAM_BIND '=' VALUE             { SET_CHARSET_FOR_PARAM_BIND($3, @$); }
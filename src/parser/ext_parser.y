@@ -59,6 +59,8 @@
 
     static int ext_parser_param_append_topic_name(ext_parser_param_t *param, const char *name, size_t len);
     static int ext_parser_param_append_topic_conf(ext_parser_param_t *param, const char *k, size_t kn, const char *v, size_t vn);
+    static int ext_parser_param_set_schemaless(ext_parser_param_t *param, const char *protocol, size_t len);
+    static int ext_parser_param_append_schemaless_conf(ext_parser_param_t *param, const char *k, size_t kn, const char *v, size_t vn);
 
     #define SET_TOPIC(_v, _loc) do {                                                            \
       if (!param) break;                                                                        \
@@ -84,10 +86,36 @@
       }                                                                                         \
     } while (0)
 
+    #define SET_SCHEMALESS(_v, _loc) do {                                                       \
+      if (!param) break;                                                                        \
+      if (ext_parser_param_set_schemaless(param, _v.text, _v.leng)) {                           \
+        _yyerror_impl(&_loc, arg, param, "runtime error:out of memory");                        \
+        return -1;                                                                              \
+      }                                                                                         \
+    } while (0)
+
+    #define SET_SCHEMALESS_KEY(_k, _loc) do {                                                   \
+      if (!param) break;                                                                        \
+      if (ext_parser_param_append_schemaless_conf(param, _k.text, _k.leng, NULL, 0)) {          \
+        _yyerror_impl(&_loc, arg, param, "runtime error:out of memory");                        \
+        return -1;                                                                              \
+      }                                                                                         \
+    } while (0)
+
+    #define SET_SCHEMALESS_KEY_VAL(_k, _v, _loc) do {                                           \
+      if (!param) break;                                                                        \
+      if (ext_parser_param_append_schemaless_conf(param, _k.text, _k.leng, _v.text, _v.leng)) { \
+        _yyerror_impl(&_loc, arg, param, "runtime error:out of memory");                        \
+        return -1;                                                                              \
+      }                                                                                         \
+    } while (0)
+
     void ext_parser_param_release(ext_parser_param_t *param)
     {
       if (!param) return;
       topic_cfg_release(&param->topic_cfg);
+      schemaless_cfg_release(&param->schemaless_cfg);
+      param->is_schemaless = 0;
       param->ctx.err_msg[0] = '\0';
       param->ctx.row0 = 0;
     }
@@ -111,7 +139,7 @@
 %union { parser_token_t token; }
 %union { char c; }
 
-%token TOPIC
+%token TOPIC SCHEMALESS
 %token <token> DIGITS
 %token <token> TNAME TKEY TVAL
 
@@ -124,6 +152,7 @@
 input:
   %empty
 | topic                     { (void)yynerrs; }
+| schemaless                { (void)yynerrs; }
 ;
 
 topic:
@@ -147,6 +176,26 @@ tconf:
 | TKEY '=' TVAL                  { SET_TOPIC_KEY_VAL($1, $3, @$); }
 ;
 
+schemaless:
+  '!' SCHEMALESS protocol
+| '!' SCHEMALESS protocol '{' sconfs '}'
+;
+
+protocol:
+  TNAME                     { SET_SCHEMALESS($1, @$); }
+;
+
+sconfs:
+  %empty
+| sconf
+| sconfs delimits sconf
+;
+
+sconf:
+  TKEY                           { SET_SCHEMALESS_KEY($1, @$); }
+| TKEY '=' TVAL                  { SET_SCHEMALESS_KEY_VAL($1, $3, @$); }
+;
+
 delimits:
   ';'
 | delimits ';'
@@ -217,6 +266,20 @@ static int ext_parser_param_append_topic_conf(ext_parser_param_t *param, const c
   return topic_cfg_append_kv(cfg, k, kn, v, vn);
 }
 
+static int ext_parser_param_set_schemaless(ext_parser_param_t *param, const char *protocol, size_t len)
+{
+  schemaless_cfg_t *cfg = &param->schemaless_cfg;
+  if (schemaless_cfg_set_protocol(cfg, protocol, len)) return -1;
+  param->is_schemaless = 1;
+  return 0;
+}
+
+static int ext_parser_param_append_schemaless_conf(ext_parser_param_t *param, const char *k, size_t kn, const char *v, size_t vn)
+{
+  schemaless_cfg_t *cfg = &param->schemaless_cfg;
+  return schemaless_cfg_append_kv(cfg, k, kn, v, vn);
+}
+
 int ext_parser_parse(const char *input, size_t len, ext_parser_param_t *param)
 {
   yyscan_t arg = {0};
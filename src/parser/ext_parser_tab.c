@@ -25,6 +25,7 @@
 #include "ext_parser.h"
 
 #include "../core/internal.h"        // FIXME:
+#include "schemaless.h"
 #include "topic.h"
 #include "log.h"
 
@@ -0,0 +1,267 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022-2023 freemine <freemine@yeah.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "logger.h"
+#include "odbc_helpers.h"
+#include "taos_odbc_ext.h"
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// NOTE: built with FAKE_TAOS only, `fake_wide:<n>` results are provided by the fake taosc
+//       the consumer below relies on nothing but the arrow c data interface
+
+#define ROWS             300
+
+static int _valid(const struct ArrowArray *array, int64_t i)
+{
+  const uint8_t *bitmap = (const uint8_t*)array->buffers[0];
+  if (!bitmap) return 1;
+  return !!(bitmap[i / 8] & (1 << (i % 8)));
+}
+
+static int _check_schema(struct ArrowArrayStream *stream)
+{
+  static const char *formats[] = {"tsm:", "i", "u", "b"};
+  static const char *names[]   = {"ts", "v", "name", "b"};
+
+  struct ArrowSchema schema = {0};
+  if (stream->get_schema(stream, &schema)) {
+    E("get_schema failed:%s", stream->get_last_error(stream));
+    return -1;
+  }
+
+  int r = -1;
+  if (strcmp(schema.format, "+s") || schema.n_children != 4) {
+    E("+s of 4 children expected, but got ==%s/%" PRId64 "==", schema.format, schema.n_children);
+    goto end;
+  }
+  for (int i=0; i<4; ++i) {
+    const struct ArrowSchema *child = schema.children[i];
+    if (strcmp(child->format, formats[i]) || strcmp(child->name, names[i])) {
+      E("column[%d] of %s/%s expected, but got ==%s/%s==", i + 1, names[i], formats[i], child->name, child->format);
+      goto end;
+    }
+  }
+
+  r = 0;
+
+end:
+  schema.release(&schema);
+  return r;
+}
+
+// check the `length` rows of `batch`, starting from row #first
+static int _check_batch(const struct ArrowArray *batch, int first)
+{
+  if (batch->n_children != 4) {
+    E("4 children expected, but got ==%" PRId64 "==", batch->n_children);
+    return -1;
+  }
+
+  const struct ArrowArray *ts = batch->children[0];
+  const struct ArrowArray *v  = batch->children[1];
+  const struct ArrowArray *s  = batch->children[2];
+  const struct ArrowArray *b  = batch->children[3];
+
+  for (int64_t i=0; i<batch->length; ++i) {
+    int r = first + (int)i;
+
+    int64_t tv = ((const int64_t*)ts->buffers[1])[i];
+    if (!_valid(ts, i) || tv != 1600000000000LL + r * 1000LL) {
+      E("row #%d:ts of %" PRId64 " expected, but got ==%" PRId64 "==", r, (int64_t)(1600000000000LL + r * 1000LL), tv);
+      return -1;
+    }
+
+    if (_valid(v, i) != (r % 3 != 2)) {
+      E("row #%d:v of null:%d expected", r, r % 3 == 2);
+      return -1;
+    }
+    if (_valid(v, i) && ((const int32_t*)v->buffers[1])[i] != r) {
+      E("row #%d:v of %d expected, but got ==%d==", r, r, ((const int32_t*)v->buffers[1])[i]);
+      return -1;
+    }
+
+    const int32_t *offsets = (const int32_t*)s->buffers[1];
+    const char    *data    = (const char*)s->buffers[2];
+    char expected[64];
+    snprintf(expected, sizeof(expected), "n%d", r);
+    if (_valid(s, i) != (r % 5 != 4)) {
+      E("row #%d:name of null:%d expected", r, r % 5 == 4);
+      return -1;
+    }
+    int32_t len = offsets[i + 1] - offsets[i];
+    if (!_valid(s, i) && len) {
+      E("row #%d:name of null with length 0 expected, but got ==%d==", r, len);
+      return -1;
+    }
+    if (_valid(s, i) && (len != (int32_t)strlen(expected) || strncmp(data + offsets[i], expected, (size_t)len))) {
+      E("row #%d:name of %s expected, but got ==%.*s==", r, expected, (int)len, data + offsets[i]);
+      return -1;
+    }
+
+    int bv = !!(((const uint8_t*)b->buffers[1])[i / 8] & (1 << (i % 8)));
+    if (!_valid(b, i) || bv != r % 2) {
+      E("row #%d:b of %d expected, but got ==%d==", r, r % 2, bv);
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+// NOTE: a child moved out of its parent might outlive the parent, or be released before it
+static int _check_moved(struct ArrowArray *batch, int base, int child_first)
+{
+  int r = 0;
+
+  struct ArrowArray v = *batch->children[1];
+  batch->children[1]->release = NULL;
+  if (!child_first) batch->release(batch);
+
+  for (int64_t i=0; i<v.length; ++i) {
+    if (!_valid(&v, i)) continue;
+    if (((const int32_t*)v.buffers[1])[i] == base + (int)i) continue;
+    E("row #%d:v of %d expected, but got ==%d==", base + (int)i, base + (int)i, ((const int32_t*)v.buffers[1])[i]);
+    r = -1;
+    break;
+  }
+
+  v.release(&v);
+  if (child_first) batch->release(batch);
+
+  return r;
+}
+
+static int _consume(struct ArrowArrayStream *stream)
+{
+  if (_check_schema(stream)) return -1;
+
+  int r = -1;
+  int rows = 0;
+  int batches = 0;
+
+  // NOTE: the first batch is kept alive across the next get_next, whose zero-copy buffers are overwritten by then
+  struct ArrowArray first = {0};
+
+  while (1) {
+    struct ArrowArray batch = {0};
+    if (stream->get_next(stream, &batch)) {
+      E("get_next failed:%s", stream->get_last_error(stream));
+      goto end;
+    }
+    if (!batch.release) break;
+
+    if (_check_batch(&batch, rows)) {
+      batch.release(&batch);
+      goto end;
+    }
+    int base = rows;
+    rows += (int)batch.length;
+    ++batches;
+
+    if (!first.release) {
+      first = batch;
+      continue;
+    }
+
+    if (_check_moved(&batch, base, batches % 2)) goto end;
+  }
+
+  if (rows != ROWS || batches < 2) {
+    E("%d rows in more than one batch expected, but got ==%d/%d==", ROWS, rows, batches);
+    goto end;
+  }
+  if (first.release && _check_batch(&first, 0)) goto end;
+
+  r = 0;
+
+end:
+  if (first.release) first.release(&first);
+  return r;
+}
+
+static int test_case1(SQLHANDLE hconn)
+{
+  int r = -1;
+  SQLHANDLE hstmt = SQL_NULL_HANDLE;
+  struct ArrowArrayStream stream = {0};
+  char sql[64];
+
+  if (FAILED(CALL_SQLAllocHandle(SQL_HANDLE_STMT, hconn, &hstmt))) return -1;
+
+  snprintf(sql, sizeof(sql), "select 'fake_wide:%d'", ROWS);
+  if (FAILED(CALL_SQLExecDirect(hstmt, (SQLCHAR*)sql, SQL_NTS))) goto end;
+
+  SQLRETURN sr = CALL_SQLGetStmtAttr(hstmt, SQL_ATTR_TAOS_ARROW_STREAM, &stream, sizeof(stream), NULL);
+  if (FAILED(sr)) goto end;
+
+  // NOTE: the result set is handed over as a whole
+  sr = CALL_SQLFetch(hstmt);
+  if (sr != SQL_NO_DATA) {
+    E("SQL_NO_DATA expected after the result set is exported, but got ==%d==", sr);
+    goto end;
+  }
+
+  r = _consume(&stream);
+
+end:
+  if (stream.release) stream.release(&stream);
+  CALL_SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+  return r;
+}
+
+static int test(void)
+{
+  int r = -1;
+  SQLHANDLE henv = SQL_NULL_HANDLE, hconn = SQL_NULL_HANDLE;
+
+  if (FAILED(CALL_SQLAllocHandle(SQL_HANDLE_ENV, SQL_NULL_HANDLE, &henv))) return -1;
+  if (FAILED(CALL_SQLSetEnvAttr(henv, SQL_ATTR_ODBC_VERSION, (SQLPOINTER)SQL_OV_ODBC3, 0))) goto end;
+  if (FAILED(CALL_SQLAllocHandle(SQL_HANDLE_DBC, henv, &hconn))) goto end;
+
+  SQLRETURN sr = CALL_SQLDriverConnect(hconn, NULL, (SQLCHAR*)"DRIVER={TAOS_ODBC_DRIVER}", SQL_NTS, NULL, 0, NULL, SQL_DRIVER_NOPROMPT);
+  if (FAILED(sr)) goto end;
+
+  r = test_case1(hconn);
+
+  CALL_SQLDisconnect(hconn);
+
+end:
+  if (hconn != SQL_NULL_HANDLE) CALL_SQLFreeHandle(SQL_HANDLE_DBC, hconn);
+  CALL_SQLFreeHandle(SQL_HANDLE_ENV, henv);
+  return r;
+}
+
+int main(void)
+{
+  int r = 0;
+  r = test();
+
+  fprintf(stderr,"==%s==\n", r ? "failure" : "success");
+
+  return !!r;
+}
@@ -27,6 +27,7 @@
 #include "conn.h"
 #include "env.h"
 #include "errs.h"
+#include "fetch_pool.h"
 #include "helpers.h"
 #include "logger.h"
 #include "conn_parser.h"
@@ -160,6 +161,28 @@ static int test_conn_parser(void)
         .db                     = "lmdb",
         .port                   = 378378378,
       },
+    },{
+      __LINE__,
+      "DSN=TAOS_ODBC_DSN;WRITE_BEHIND=1000;WRITE_BEHIND_MS=200",
+      {
+        .dsn                    = "TAOS_ODBC_DSN",
+        .write_behind           = 1000,
+        .write_behind_ms        = 200,
+      },
+    },{
+      __LINE__,
+      "DSN=TAOS_ODBC_DSN;STATIC_CURSOR_KB=4096",
+      {
+        .dsn                    = "TAOS_ODBC_DSN",
+        .static_cursor_kb       = 4096,
+      },
+    },{
+      __LINE__,
+      "DSN=TAOS_ODBC_DSN;RESULT_CACHE_TTL_MS=30000",
+      {
+        .dsn                    = "TAOS_ODBC_DSN",
+        .result_cache_ttl_ms    = 30000,
+      },
     },
   };
 
@@ -203,6 +226,22 @@ static int test_conn_parser(void)
       E("parsing[@line:%d]:%s", line, s);
       E("port expected to be `%d`, but got ==%d==", expected->port, param.conn_cfg->port);
       r = -1;
+    } else if (expected->write_behind != param.conn_cfg->write_behind) {
+      E("parsing[@line:%d]:%s", line, s);
+      E("write_behind expected to be `%d`, but got ==%d==", expected->write_behind, param.conn_cfg->write_behind);
+      r = -1;
+    } else if (expected->write_behind_ms != param.conn_cfg->write_behind_ms) {
+      E("parsing[@line:%d]:%s", line, s);
+      E("write_behind_ms expected to be `%d`, but got ==%d==", expected->write_behind_ms, param.conn_cfg->write_behind_ms);
+      r = -1;
+    } else if (expected->static_cursor_kb != param.conn_cfg->static_cursor_kb) {
+      E("parsing[@line:%d]:%s", line, s);
+      E("static_cursor_kb expected to be `%d`, but got ==%d==", expected->static_cursor_kb, param.conn_cfg->static_cursor_kb);
+      r = -1;
+    } else if (expected->result_cache_ttl_ms != param.conn_cfg->result_cache_ttl_ms) {
+      E("parsing[@line:%d]:%s", line, s);
+      E("result_cache_ttl_ms expected to be `%d`, but got ==%d==", expected->result_cache_ttl_ms, param.conn_cfg->result_cache_ttl_ms);
+      r = -1;
     }
     conn_parser_param_release(&param);
     conn_cfg_release(&parsed);
@@ -236,6 +275,12 @@ static int test_ext_parser(void)
     " auto.offset.reset=earliest;"
     " experimental.snapshot.enable=false"
     "}",
+    "!topic demo {group.id=cgrpName; taos_odbc.seek=earliest; taos_odbc.seek.3=1024; taos_odbc.seek.4=latest}",
+    // !schemaless
+    "!schemaless influx",
+    "!schemaless telnet {}",
+    "!schemaless json {precision=ms}",
+    "!schemaless influx {precision=ns; helloworld}",
   };
   for (size_t i=0; i<sizeof(text)/sizeof(text[0]); ++i) {
     const char *s = text[i];
@@ -758,6 +803,29 @@ static int test_pthread_once(void)
   return 0;
 }
 
+static int test_trace(void)
+{
+  for (int i=0; i<TOD_TRACE_NR; ++i) {
+    int on = tod_trace_resolve((tod_trace_t)i);
+    if (tod_trace_flag(i) != on) return -1;
+
+    tod_trace_enable((tod_trace_t)i, 0);
+    if (TOD_TRACE_ON(i)) return -1;
+    TOD_TRACEF(i, "shall not be traced");
+
+    tod_trace_enable((tod_trace_t)i, 1);
+#ifdef TODBC_NO_TRACE       /* { */
+    if (TOD_TRACE_ON(i)) return -1;
+#else                       /* }{ */
+    if (!TOD_TRACE_ON(i)) return -1;
+#endif                      /* } */
+
+    tod_trace_enable((tod_trace_t)i, on);
+  }
+
+  return 0;
+}
+
 static int test_iconv(void)
 {
   int r = 0;
@@ -989,6 +1057,367 @@ static int test_gettimeofday(void)
   return 0;
 }
 
+static int test_iso8601(void)
+{
+  const struct {
+    int                 line;
+    const char         *s;
+    int                 r;
+    int64_t             sec;
+    int32_t             nsec;
+  } _cases[] = {
+    {__LINE__, "1970-01-01T00:00:00Z",                  0,  0,          0},
+    {__LINE__, "2023-03-15 08:30:45.123+08:00",         0,  1678840245, 123000000},
+    {__LINE__, "2023-03-15T00:30:45.123456789z",        0,  1678840245, 123456789},
+    {__LINE__, "2023-03-15T02:30:45.1+0200",            0,  1678840245, 100000000},
+    {__LINE__, "2024-02-29T23:59:59-01",                0,  1709254799, 0},
+    {__LINE__, "1969-12-31T23:59:59Z",                  0,  -1,         0},
+    {__LINE__, "1234567",                               -1, 0,          0},
+    {__LINE__, "2023-03-15",                            -1, 0,          0},
+    {__LINE__, "2023-02-29 00:00:00",                   -2, 0,          0},
+    {__LINE__, "2023-03-15 24:00:00",                   -2, 0,          0},
+    {__LINE__, "2023-03-15 00:00:00.",                  -2, 0,          0},
+    {__LINE__, "2023-03-15 00:00:00.1234567890",        -2, 0,          0},
+    {__LINE__, "2023-03-15 00:00:00 ",                  -2, 0,          0},
+    {__LINE__, "2023-03-15 00:00:00+8",                 -2, 0,          0},
+  };
+
+  for (size_t i=0; i<sizeof(_cases)/sizeof(_cases[0]); ++i) {
+    int line = _cases[i].line;
+    const char *s = _cases[i].s;
+    tod_ts_t ts = {0};
+    int r = tod_parse_iso8601(s, strlen(s), NULL, &ts);
+    if (r != _cases[i].r) {
+      DUMP("@%d:[%s]:expecting %d, but got ==%d==", line, s, _cases[i].r, r);
+      return -1;
+    }
+    if (r) continue;
+    if (ts.sec != _cases[i].sec || ts.nsec != _cases[i].nsec) {
+      DUMP("@%d:[%s]:expecting %" PRId64 ".%09d, but got ==%" PRId64 ".%09d==",
+          line, s, _cases[i].sec, _cases[i].nsec, ts.sec, ts.nsec);
+      return -1;
+    }
+  }
+
+  tz_cache_t cache = {0};
+  const char *locals[] = {
+    "2023-01-01 00:00:00",
+    "2023-07-01 12:34:56",
+    "2023-07-01 12:34:57",
+    "1999-12-31 23:59:59",
+  };
+  for (size_t i=0; i<sizeof(locals)/sizeof(locals[0]); ++i) {
+    const char *s = locals[i];
+    struct tm tm = {0};
+    tod_strptime(s, "%Y-%m-%d %H:%M:%S", &tm);
+    tm.tm_isdst = -1;
+    int64_t expected = (int64_t)mktime(&tm);
+    for (int j=0; j<2; ++j) {
+      tod_ts_t ts = {0};
+      int r = tod_parse_iso8601(s, strlen(s), &cache, &ts);
+      if (r || ts.sec != expected) {
+        DUMP("[%s]:expecting %" PRId64 ", but got ==%" PRId64 "==", s, expected, ts.sec);
+        return -1;
+      }
+    }
+  }
+
+  return 0;
+}
+
+static int test_str_to_num(void)
+{
+  const struct {
+    int                 line;
+    const char         *s;
+    int                 r;
+    int64_t             i64;
+  } _i64_cases[] = {
+    {__LINE__, "0",                         0,  0},
+    {__LINE__, "  -123",                    0,  -123},
+    {__LINE__, "0x1f",                      0,  31},
+    {__LINE__, "9223372036854775807",       0,  INT64_MAX},
+    {__LINE__, "-9223372036854775808",      0,  INT64_MIN},
+    {__LINE__, "9223372036854775808",       -2, 0},
+    {__LINE__, "12a",                       -1, 0},
+    {__LINE__, "",                          -1, 0},
+    {__LINE__, "-",                         -1, 0},
+  };
+
+  for (size_t i=0; i<sizeof(_i64_cases)/sizeof(_i64_cases[0]); ++i) {
+    int line = _i64_cases[i].line;
+    const char *s = _i64_cases[i].s;
+    int64_t v = 0;
+    const char *end = NULL;
+    int r = tod_str_to_i64(s, strlen(s), &v, &end);
+    if (r != _i64_cases[i].r || (r == 0 && v != _i64_cases[i].i64)) {
+      DUMP("@%d:[%s]:expecting %d/%" PRId64 ", but got ==%d/%" PRId64 "==", line, s, _i64_cases[i].r, _i64_cases[i].i64, r, v);
+      return -1;
+    }
+  }
+
+  const char *dbls[] = {
+    "0", "-0.5", "3.14159", "1e10", "  2.5e-3", "123456789012345678901234567890", "1.7976931348623157e308", "4.9e-324", "0.1",
+  };
+  for (size_t i=0; i<sizeof(dbls)/sizeof(dbls[0]); ++i) {
+    const char *s = dbls[i];
+    double v = 0;
+    float flt = 0;
+    const char *end = NULL;
+    int r = tod_str_to_dbl(s, strlen(s), &v, &end);
+    if (r || v != strtod(s, NULL)) {
+      DUMP("[%s]:expecting %.17g, but got ==%d/%.17g==", s, strtod(s, NULL), r, v);
+      return -1;
+    }
+    r = tod_str_to_flt(s, strlen(s), &flt, &end);
+    if (r == 0 && flt != strtof(s, NULL)) {
+      DUMP("[%s]:expecting %.9g, but got ==%.9g==", s, strtof(s, NULL), flt);
+      return -1;
+    }
+  }
+
+  const char *bads[] = {"1e400", "1.5x", "", "1e"};
+  for (size_t i=0; i<sizeof(bads)/sizeof(bads[0]); ++i) {
+    const char *s = bads[i];
+    double v = 0;
+    const char *end = NULL;
+    int r = tod_str_to_dbl(s, strlen(s), &v, &end);
+    if (r == 0) {
+      DUMP("[%s]:expecting failure, but got ==%.17g==", s, v);
+      return -1;
+    }
+  }
+
+  // NOTE: conversion stops at `len`, no NUL-terminator required
+  int64_t v = 0;
+  const char *end = NULL;
+  if (tod_str_to_i64("12345", 3, &v, &end) || v != 123) {
+    DUMP("expecting 123, but got ==%" PRId64 "==", v);
+    return -1;
+  }
+
+  return 0;
+}
+
+static int test_plain_insert(void)
+{
+  const struct {
+    int                 line;
+    const char         *s;
+    int                 r;
+    size_t              tail;
+    size_t              rows;
+  } _cases[] = {
+    {__LINE__, "insert into t values (now, 1)",                               0,  12, 1},
+    {__LINE__, " INSERT INTO db.t (ts, v) VALUES (now, 'a)(b') (now+1s, \"c\")",  0,  13, 2},
+    {__LINE__, "insert into `t 1` values (now, 1),(now+1s, 2)",               0,  12, 2},
+    {__LINE__, "insert into t values (now, 'it\\'s')",                      0,  12, 1},
+    {__LINE__, "insert into t using st tags (1) values (now, 1)",             -1, 0,  0},
+    {__LINE__, "insert into t values (now, 1) t2 values (now, 2)",            -1, 0,  0},
+    {__LINE__, "insert into t select * from s",                               -1, 0,  0},
+    {__LINE__, "insert into t file '/tmp/a.csv'",                             -1, 0,  0},
+    {__LINE__, "insert into t values",                                        -1, 0,  0},
+    {__LINE__, "insert into t values (now, 'a'",                              -1, 0,  0},
+    {__LINE__, "inserting into t values (now, 1)",                            -1, 0,  0},
+    {__LINE__, "select * from t",                                             -1, 0,  0},
+  };
+
+  for (size_t i=0; i<sizeof(_cases)/sizeof(_cases[0]); ++i) {
+    int line = _cases[i].line;
+    const char *s = _cases[i].s;
+    size_t tail = 0, rows = 0;
+    int r = tod_parse_plain_insert(s, strlen(s), &tail, &rows);
+    if (r != _cases[i].r || (r == 0 && (tail != _cases[i].tail || rows != _cases[i].rows))) {
+      DUMP("@%d:[%s]:expecting %d/%zd/%zd, but got ==%d/%zd/%zd==", line, s,
+          _cases[i].r, _cases[i].tail, _cases[i].rows, r, tail, rows);
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+static int test_plain_select(void)
+{
+  const struct {
+    int                 line;
+    const char         *s;
+    int                 r;
+    size_t              start;
+    size_t              end;
+    int64_t             rows;
+  } _cases[] = {
+    {__LINE__, "select * from t",                                 0,  15, 15, -1},
+    {__LINE__, "select * from t limit 10",                        0,  22, 24, 10},
+    {__LINE__, "SELECT * FROM t LIMIT 5 OFFSET 3",                0,  22, 23, 5},
+    {__LINE__, "select * from t limit 3, 7  ",                    0,  25, 26, 7},
+    {__LINE__, "select * from (select * from t limit 1) ",        0,  39, 39, -1},
+    {__LINE__, "select 'limit 3' from t   ",                      0,  23, 23, -1},
+    {__LINE__, "select limits from t",                            0,  20, 20, -1},
+    {__LINE__, "select * from t partition by tbname limit 2",     -1, 0,  0,  0},
+    {__LINE__, "select * from t union all select * from s",       -1, 0,  0,  0},
+    {__LINE__, "select * from t; select 1",                       -1, 0,  0,  0},
+    {__LINE__, "select * from t limit 1 limit 2",                 -1, 0,  0,  0},
+    {__LINE__, "select * from t limit x",                         -1, 0,  0,  0},
+    {__LINE__, "select * from t -- limit 1",                      -1, 0,  0,  0},
+    {__LINE__, "insert into t values (now, 1)",                   -1, 0,  0,  0},
+  };
+
+  for (size_t i=0; i<sizeof(_cases)/sizeof(_cases[0]); ++i) {
+    int line = _cases[i].line;
+    const char *s = _cases[i].s;
+    size_t start = 0, end = 0;
+    int64_t rows = 0;
+    int r = tod_parse_plain_select(s, strlen(s), &start, &end, &rows);
+    if (r != _cases[i].r || (r == 0 && (start != _cases[i].start || end != _cases[i].end || rows != _cases[i].rows))) {
+      DUMP("@%d:[%s]:expecting %d/%zd/%zd/%" PRId64 ", but got ==%d/%zd/%zd/%" PRId64 "==", line, s,
+          _cases[i].r, _cases[i].start, _cases[i].end, _cases[i].rows, r, start, end, rows);
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+static int test_result_cache_sql(void)
+{
+  const struct {
+    int                 line;
+    const char         *s;
+    const char         *normalized;
+    int                 r;
+    const char         *tbl;
+  } _cases[] = {
+    {__LINE__, "  SELECT *\n  FROM\tT  ",                        "select * from t",                        0, NULL},
+    {__LINE__, "select 'A  B' from `Tb` ",                      "select 'A  B' from `Tb`",                0, NULL},
+    {__LINE__, "show databases",                                "show databases",                         0, NULL},
+    {__LINE__, "insert into db.t values (now, 1)",              "insert into db.t values (now, 1)",       1, "db.t"},
+    {__LINE__, "insert into `t1` (ts, v) values (?, ?)",        "insert into `t1` (ts, v) values (?, ?)", 1, "`t1`"},
+    {__LINE__, "delete from t where ts < now",                  "delete from t where ts < now",           1, "t"},
+    {__LINE__, "insert into ? using st tags (?) values (?)",    "insert into ? using st tags (?) values (?)", 2, NULL},
+    {__LINE__, "drop table t",                                  "drop table t",                           2, NULL},
+  };
+
+  char buf[1024];
+  for (size_t i=0; i<sizeof(_cases)/sizeof(_cases[0]); ++i) {
+    int line = _cases[i].line;
+    const char *s = _cases[i].s;
+    size_t n = tod_normalize_sql(s, strlen(s), buf);
+    if (n != strlen(buf) || strcmp(buf, _cases[i].normalized)) {
+      DUMP("@%d:[%s]:expecting normalized as [%s], but got ==[%s]==", line, s, _cases[i].normalized, buf);
+      return -1;
+    }
+    size_t start = 0, end = 0;
+    int r = tod_sql_write_target(s, strlen(s), &start, &end);
+    if (r != _cases[i].r || (r == 1 && (end - start != strlen(_cases[i].tbl) || strncmp(s + start, _cases[i].tbl, end - start)))) {
+      DUMP("@%d:[%s]:expecting %d/[%s], but got ==%d/[%.*s]==", line, s,
+          _cases[i].r, _cases[i].tbl ? _cases[i].tbl : "", r, (int)(end - start), s + start);
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+static int test_ts_range(void)
+{
+  const struct {
+    int                 line;
+    const char         *s;
+    int                 r;
+    const char         *col;
+    int64_t             lo;
+    int64_t             hi;
+    int8_t              is_str;
+  } _cases[] = {
+    {__LINE__, "select * from t where ts >= 1000 and ts < 2000",                0, "ts",     1000, 2000, 0},
+    {__LINE__, "select ts, v from db.t where v > 3 and `ts` between 10 and 20 ", 0, "`ts`",   10,   20,   0},
+    {__LINE__, "select * from t where _rowts > 5 and _rowts <= 9 and ts < 7",   0, "ts",     5,    7,    0},
+    {__LINE__, "select * from t where ts >= '1970-01-01T00:00:01Z' and ts < '1970-01-01T00:00:02Z'",
+                                                                                0, "ts",     1000000000, 2000000000, 1},
+    {__LINE__, "select * from t where ts >= 1000 and ts < 2000 order by ts",    -1, NULL, 0, 0, 0},
+    {__LINE__, "select count(*) from t where ts >= 1000 and ts < 2000",         -1, NULL, 0, 0, 0},
+    {__LINE__, "select * from t where ts >= 1000 or ts < 2000",                 -1, NULL, 0, 0, 0},
+    {__LINE__, "select * from t where ts >= 1000",                              -1, NULL, 0, 0, 0},
+    {__LINE__, "select * from t where ts >= now - 1h and ts < now",             -1, NULL, 0, 0, 0},
+    {__LINE__, "select * from t where ts >= 1000 and ts < '1970-01-01T00:00:02Z'", -1, NULL, 0, 0, 0},
+    {__LINE__, "select * from t where ts >= 2000 and ts < 1000",                -1, NULL, 0, 0, 0},
+  };
+
+  for (size_t i=0; i<sizeof(_cases)/sizeof(_cases[0]); ++i) {
+    int line = _cases[i].line;
+    const char *s = _cases[i].s;
+    tod_ts_range_t range = {0};
+    int r = tod_parse_ts_range(s, strlen(s), &range);
+    if (r != _cases[i].r) {
+      DUMP("@%d:[%s]:expecting %d, but got ==%d==", line, s, _cases[i].r, r);
+      return -1;
+    }
+    if (r) continue;
+    const char *col = _cases[i].col;
+    if (range.col_len != strlen(col) || strncmp(s + range.col, col, range.col_len) ||
+        range.lo != _cases[i].lo || range.hi != _cases[i].hi || range.is_str != _cases[i].is_str)
+    {
+      DUMP("@%d:[%s]:expecting [%s]/%" PRId64 "/%" PRId64 "/%d, but got ==[%.*s]/%" PRId64 "/%" PRId64 "/%d==", line, s,
+          col, _cases[i].lo, _cases[i].hi, _cases[i].is_str,
+          (int)range.col_len, s + range.col, range.lo, range.hi, range.is_str);
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+static atomic_int _fetch_pool_hits[1000];
+
+static void _test_fetch_pool_run(void *arg, size_t i)
+{
+  (void)arg;
+  atomic_fetch_add(&_fetch_pool_hits[i], 1);
+}
+
+static void* _test_fetch_pool_routine(void *arg)
+{
+  fetch_pool_t *pool = (fetch_pool_t*)arg;
+  for (int i=0; i<100; ++i) {
+    fetch_pool_run(pool, _test_fetch_pool_run, NULL, sizeof(_fetch_pool_hits)/sizeof(_fetch_pool_hits[0]));
+  }
+  return NULL;
+}
+
+static int test_fetch_pool(void)
+{
+  fetch_pool_t *pool = fetch_pool_create(3);
+  if (!pool) {
+    DUMP("failed to create fetch pool");
+    return -1;
+  }
+
+  // NOTE: jobs of concurrent callers share the very workers
+  pthread_t thread;
+  int r = pthread_create(&thread, NULL, _test_fetch_pool_routine, pool);
+  if (r == 0) {
+    _test_fetch_pool_routine(pool);
+    pthread_join(thread, NULL);
+  }
+
+  fetch_pool_destroy(pool);
+  if (r) {
+    DUMP("failed to create thread");
+    return -1;
+  }
+
+  for (size_t i=0; i<sizeof(_fetch_pool_hits)/sizeof(_fetch_pool_hits[0]); ++i) {
+    int hits = atomic_load(&_fetch_pool_hits[i]);
+    if (hits != 200) {
+      DUMP("task #%zd:expecting 200 runs, but got ==%d==", i, hits);
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
 typedef int (*test_case_f)(void);
 
 #define RECORD(x) {x, #x}
@@ -1004,12 +1433,20 @@ static struct {
   RECORD(test_wildmatch),
   RECORD(test_basename_dirname),
   RECORD(test_pthread_once),
+  RECORD(test_trace),
   RECORD(test_iconv),
   RECORD(test_iconv_perf_reuse),
   RECORD(test_iconv_perf_on_the_fly),
   RECORD(test_buffer),
   RECORD(test_trim),
   RECORD(test_gettimeofday),
+  RECORD(test_iso8601),
+  RECORD(test_str_to_num),
+  RECORD(test_plain_insert),
+  RECORD(test_plain_select),
+  RECORD(test_result_cache_sql),
+  RECORD(test_ts_range),
+  RECORD(test_fetch_pool),
 };
 
 static void usage(const char *arg0)
@@ -0,0 +1,936 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022-2023 freemine <freemine@yeah.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "logger.h"
+#include "odbc_helpers.h"
+#include "os_port.h"
+#include "taos_odbc_ext.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// NOTE: built with FAKE_TAOS only, `fake_rows:<n>`/`fake_wide:<n>` results are provided by the fake taosc
+
+#define THREADS          8
+#define ROUNDS           50
+#define ROWS_A           500
+#define ROWS_B           300
+
+#define ROWS_WIDE        300
+#define ROWS_ASYNC       200              // spans several blocks, each fetched by taos_fetch_rows_a
+#define ROWSET           100              // above the threshold of converting in parallel
+
+static int _exec(SQLHANDLE hstmt, const char *sql)
+{
+  SQLRETURN sr = CALL_SQLExecDirect(hstmt, (SQLCHAR*)sql, SQL_NTS);
+  return FAILED(sr) ? -1 : 0;
+}
+
+// return 1 if a row is fetched and checked against `*next`, 0 if no more rows, -1 on failure
+static int _fetch_one(SQLHANDLE hstmt, int32_t *next)
+{
+  SQLRETURN sr = CALL_SQLFetch(hstmt);
+  if (sr == SQL_NO_DATA) return 0;
+  if (FAILED(sr)) return -1;
+
+  int32_t v = -1;
+  SQLLEN ind = 0;
+  sr = CALL_SQLGetData(hstmt, 1, SQL_C_SLONG, &v, sizeof(v), &ind);
+  if (FAILED(sr)) return -1;
+  if (v != *next) {
+    E("%d expected, but got ==%d==", *next, v);
+    return -1;
+  }
+  *next += 1;
+
+  return 1;
+}
+
+// two live result sets on the same connection, fetched in turn
+static int _interleave(SQLHANDLE hconn)
+{
+  int r = -1;
+  SQLHANDLE a = SQL_NULL_HANDLE, b = SQL_NULL_HANDLE;
+  char sql[64];
+
+  if (FAILED(CALL_SQLAllocHandle(SQL_HANDLE_STMT, hconn, &a))) return -1;
+  if (FAILED(CALL_SQLAllocHandle(SQL_HANDLE_STMT, hconn, &b))) goto end;
+
+  snprintf(sql, sizeof(sql), "select 'fake_rows:%d'", ROWS_A);
+  if (_exec(a, sql)) goto end;
+  snprintf(sql, sizeof(sql), "select 'fake_rows:%d'", ROWS_B);
+  if (_exec(b, sql)) goto end;
+
+  int32_t next_a = 0, next_b = 0;
+  int more_a = 1, more_b = 1;
+  while (more_a || more_b) {
+    if (more_a) more_a = _fetch_one(a, &next_a);
+    if (more_b) more_b = _fetch_one(b, &next_b);
+    if (more_a < 0 || more_b < 0) goto end;
+  }
+  if (next_a != ROWS_A || next_b != ROWS_B) {
+    E("%d/%d rows expected, but got ==%d/%d==", ROWS_A, ROWS_B, next_a, next_b);
+    goto end;
+  }
+
+  r = 0;
+
+end:
+  if (b != SQL_NULL_HANDLE) CALL_SQLFreeHandle(SQL_HANDLE_STMT, b);
+  CALL_SQLFreeHandle(SQL_HANDLE_STMT, a);
+  return r;
+}
+
+static void* _test_case1_routine(void *arg)
+{
+  SQLHANDLE hconn = (SQLHANDLE)arg;
+
+  for (int i=0; i<ROUNDS; ++i) {
+    if (_interleave(hconn)) return (void*)(uintptr_t)-1;
+  }
+
+  return NULL;
+}
+
+static int test_case1(SQLHANDLE hconn)
+{
+  int ok = 1;
+
+  SQLUSMALLINT activities = 1;
+  SQLRETURN sr = CALL_SQLGetInfo(hconn, SQL_MAX_CONCURRENT_ACTIVITIES, &activities, sizeof(activities), NULL);
+  if (FAILED(sr) || activities != 0) {
+    E("SQL_MAX_CONCURRENT_ACTIVITIES:0 expected, but got ==%d==", activities);
+    return -1;
+  }
+
+  pthread_t threads[THREADS];
+  size_t i = 0;
+
+  for (i=0; i<sizeof(threads)/sizeof(threads[0]); ++i) {
+    int r = pthread_create(threads + i, NULL, _test_case1_routine, hconn);
+    if (r) {
+      E("pthread_create failed:[%d]%s", r, strerror(r));
+      ok = 0;
+      break;
+    }
+  }
+  size_t started = i;
+  while (i>0) {
+    void *p = NULL;
+    int r = pthread_join(threads[i-1], &p);
+    if (r) {
+      E("pthread_join failed");
+      ok = 0;
+    }
+    if (p) {
+      E("_test_case1_routine failed");
+      ok = 0;
+    }
+    --i;
+  }
+
+  if (!ok) return -1;
+
+  // NOTE: counters of freed statements are merged into the connection from all threads
+  SQLBIGINT rows = 0;
+  sr = CALL_SQLGetConnectAttr(hconn, SQL_ATTR_TAOS_PERF_ROWS_FETCHED, &rows, sizeof(rows), NULL);
+  if (FAILED(sr)) return -1;
+  int64_t expected = (int64_t)started * ROUNDS * (ROWS_A + ROWS_B);
+  if (rows != expected) {
+    E("%" PRId64 " rows fetched expected, but got ==%" PRId64 "==", expected, (int64_t)rows);
+    return -1;
+  }
+
+  return 0;
+}
+
+// sqlstate of the first diagnostic record of `hstmt`
+static void _first_state(SQLHANDLE hstmt, char *sqlState)
+{
+  SQLINTEGER nativeErrno = 0;
+  SQLCHAR messageText[1024] = {0};
+  SQLSMALLINT textLength = 0;
+  sqlState[0] = '\0';
+  SQLGetDiagRec(SQL_HANDLE_STMT, hstmt, 1, (SQLCHAR*)sqlState, &nativeErrno, messageText, sizeof(messageText), &textLength);
+}
+
+typedef struct blocking_call_s          blocking_call_t;
+struct blocking_call_s {
+  SQLHANDLE             hstmt;
+  const char           *sql;                // executed if not NULL, fetched otherwise
+  SQLRETURN             sr;
+  char                  sqlState[6];
+  atomic_int            done;
+};
+
+static void* _blocking_call_routine(void *arg)
+{
+  blocking_call_t *call = (blocking_call_t*)arg;
+  if (call->sql) call->sr = SQLExecDirect(call->hstmt, (SQLCHAR*)call->sql, SQL_NTS);
+  else           call->sr = SQLFetch(call->hstmt);
+  _first_state(call->hstmt, call->sqlState);
+  atomic_store(&call->done, 1);
+  return NULL;
+}
+
+// SQLCancel from another thread, while `hstmt` is blocked in taos_query or taos_fetch_block
+static int _cancel_blocking(SQLHANDLE hstmt, const char *sql)
+{
+  blocking_call_t call = {0};
+  call.hstmt = hstmt;
+  call.sql   = sql;
+
+  pthread_t thread;
+  int r = pthread_create(&thread, NULL, _blocking_call_routine, &call);
+  if (r) {
+    E("pthread_create failed:[%d]%s", r, strerror(r));
+    return -1;
+  }
+
+  // NOTE: a cancel issued before the call blocks has no effect, thus keep on until it returns
+  while (!atomic_load(&call.done)) {
+    tod_sleep_ms(50);
+    if (FAILED(CALL_SQLCancel(hstmt))) break;
+  }
+  pthread_join(thread, NULL);
+
+  if (call.sr != SQL_ERROR || strcmp(call.sqlState, "HY008")) {
+    E("%s:SQL_ERROR/HY008 expected, but got ==%d/%s==", sql ? sql : "SQLFetch", call.sr, call.sqlState);
+    return -1;
+  }
+
+  return 0;
+}
+
+// SQL_ATTR_QUERY_TIMEOUT expires while `hstmt` is blocked in taos_query or taos_fetch_block
+static int _timeout_blocking(SQLHANDLE hstmt, const char *sql)
+{
+  blocking_call_t call = {0};
+  call.hstmt = hstmt;
+  call.sql   = sql;
+
+  _blocking_call_routine(&call);
+
+  if (call.sr != SQL_ERROR || strcmp(call.sqlState, "HYT00")) {
+    E("%s:SQL_ERROR/HYT00 expected, but got ==%d/%s==", sql ? sql : "SQLFetch", call.sr, call.sqlState);
+    return -1;
+  }
+
+  return 0;
+}
+
+static int test_case3(SQLHANDLE hconn)
+{
+  int r = -1;
+  SQLHANDLE hstmt = SQL_NULL_HANDLE;
+
+  if (FAILED(CALL_SQLAllocHandle(SQL_HANDLE_STMT, hconn, &hstmt))) return -1;
+
+  if (_cancel_blocking(hstmt, "select 'fake_blocking_query'")) goto end;
+  CALL_SQLFreeStmt(hstmt, SQL_CLOSE);
+
+  if (_exec(hstmt, "select 'fake_blocking_fetch'")) goto end;
+  if (_cancel_blocking(hstmt, NULL)) goto end;
+  CALL_SQLFreeStmt(hstmt, SQL_CLOSE);
+
+  if (FAILED(CALL_SQLSetStmtAttr(hstmt, SQL_ATTR_QUERY_TIMEOUT, (SQLPOINTER)1, 0))) goto end;
+
+  if (_timeout_blocking(hstmt, "select 'fake_blocking_query'")) goto end;
+  CALL_SQLFreeStmt(hstmt, SQL_CLOSE);
+
+  // NOTE: the timer is armed per call, the one of SQLExecDirect is gone once it returns
+  if (_exec(hstmt, "select 'fake_blocking_fetch'")) goto end;
+  if (_timeout_blocking(hstmt, NULL)) goto end;
+  CALL_SQLFreeStmt(hstmt, SQL_CLOSE);
+
+  r = 0;
+
+end:
+  CALL_SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+  return r;
+}
+
+static int _setenv(const char *name, const char *value)
+{
+#ifdef _WIN32
+  return _putenv_s(name, value ? value : "");
+#else
+  return value ? setenv(name, value, 1) : unsetenv(name);
+#endif
+}
+
+// the connection of an env of its own, since TAOS_ODBC_FETCH_THREADS is resolved when the env is created
+static int _connect(SQLHANDLE *henv, SQLHANDLE *hconn, const char *connstr, const char *fetch_threads)
+{
+  *henv = SQL_NULL_HANDLE;
+  *hconn = SQL_NULL_HANDLE;
+
+  if (_setenv("TAOS_ODBC_FETCH_THREADS", fetch_threads)) return -1;
+
+  if (FAILED(CALL_SQLAllocHandle(SQL_HANDLE_ENV, SQL_NULL_HANDLE, henv))) return -1;
+  if (FAILED(CALL_SQLSetEnvAttr(*henv, SQL_ATTR_ODBC_VERSION, (SQLPOINTER)SQL_OV_ODBC3, 0))) return -1;
+  if (FAILED(CALL_SQLAllocHandle(SQL_HANDLE_DBC, *henv, hconn))) return -1;
+
+  SQLRETURN sr = CALL_SQLDriverConnect(*hconn, NULL, (SQLCHAR*)connstr, SQL_NTS, NULL, 0, NULL, SQL_DRIVER_NOPROMPT);
+  if (FAILED(sr)) return -1;
+
+  return 0;
+}
+
+static void _disconnect(SQLHANDLE henv, SQLHANDLE hconn)
+{
+  if (hconn != SQL_NULL_HANDLE) {
+    CALL_SQLDisconnect(hconn);
+    CALL_SQLFreeHandle(SQL_HANDLE_DBC, hconn);
+  }
+  if (henv != SQL_NULL_HANDLE) CALL_SQLFreeHandle(SQL_HANDLE_ENV, henv);
+}
+
+// `fake_wide:<n>` bound column-wise, such that:
+//   v without indicator, thus rows with null v fail with 22002
+//   name as SQL_C_WCHAR with room for 3 characters, thus `n100` and beyond are truncated with 01004
+typedef struct wide_rowset_s          wide_rowset_t;
+struct wide_rowset_s {
+  SQLHANDLE             hstmt;
+
+  char                  ts[ROWSET][32];
+  SQLLEN                ts_ind[ROWSET];
+  int32_t               v[ROWSET];
+  SQLWCHAR              name[ROWSET][4];
+  SQLLEN                name_ind[ROWSET];
+  char                  b[ROWSET][8];
+  SQLLEN                b_ind[ROWSET];
+
+  SQLUSMALLINT          status[ROWSET];
+  SQLULEN               fetched;
+
+  SQLRETURN             sr;
+  char                  diags[16384];
+};
+
+static int _wide_prepare(wide_rowset_t *rs, SQLHANDLE hconn)
+{
+  if (FAILED(CALL_SQLAllocHandle(SQL_HANDLE_STMT, hconn, &rs->hstmt))) return -1;
+
+  SQLHANDLE hstmt = rs->hstmt;
+  if (FAILED(CALL_SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)(uintptr_t)ROWSET, 0))) return -1;
+  if (FAILED(CALL_SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_STATUS_PTR, rs->status, 0))) return -1;
+  if (FAILED(CALL_SQLSetStmtAttr(hstmt, SQL_ATTR_ROWS_FETCHED_PTR, &rs->fetched, 0))) return -1;
+
+  char sql[64];
+  snprintf(sql, sizeof(sql), "select 'fake_wide:%d'", ROWS_WIDE);
+  if (_exec(hstmt, sql)) return -1;
+
+  if (FAILED(CALL_SQLBindCol(hstmt, 1, SQL_C_CHAR, rs->ts[0], sizeof(rs->ts[0]), rs->ts_ind))) return -1;
+  if (FAILED(CALL_SQLBindCol(hstmt, 2, SQL_C_SLONG, rs->v, sizeof(rs->v[0]), NULL))) return -1;
+  if (FAILED(CALL_SQLBindCol(hstmt, 3, SQL_C_WCHAR, rs->name[0], sizeof(rs->name[0]), rs->name_ind))) return -1;
+  if (FAILED(CALL_SQLBindCol(hstmt, 4, SQL_C_CHAR, rs->b[0], sizeof(rs->b[0]), rs->b_ind))) return -1;
+
+  return 0;
+}
+
+static void _wide_fetch(wide_rowset_t *rs)
+{
+  memset(rs->ts, 0, sizeof(rs->ts));
+  memset(rs->ts_ind, 0, sizeof(rs->ts_ind));
+  memset(rs->v, 0, sizeof(rs->v));
+  memset(rs->name, 0, sizeof(rs->name));
+  memset(rs->name_ind, 0, sizeof(rs->name_ind));
+  memset(rs->b, 0, sizeof(rs->b));
+  memset(rs->b_ind, 0, sizeof(rs->b_ind));
+  memset(rs->status, 0, sizeof(rs->status));
+  rs->fetched = 0;
+
+  // NOTE: SQLGetDiagRec directly, as diagnostics are what to compare
+  rs->sr = SQLFetch(rs->hstmt);
+
+  size_t n = 0;
+  rs->diags[0] = '\0';
+  for (SQLSMALLINT i=1; n < sizeof(rs->diags); ++i) {
+    SQLCHAR sqlState[6] = {0};
+    SQLINTEGER nativeErrno = 0;
+    SQLCHAR messageText[1024] = {0};
+    SQLSMALLINT textLength = 0;
+    SQLRETURN sr = SQLGetDiagRec(SQL_HANDLE_STMT, rs->hstmt, i, sqlState, &nativeErrno, messageText, sizeof(messageText), &textLength);
+    if (sr != SQL_SUCCESS && sr != SQL_SUCCESS_WITH_INFO) break;
+    n += snprintf(rs->diags + n, sizeof(rs->diags) - n, "[%s]%s\n", (const char*)sqlState, (const char*)messageText);
+  }
+}
+
+static int _wide_compare(const wide_rowset_t *serial, const wide_rowset_t *parallel, int *errors, int *infos)
+{
+  if (serial->sr != parallel->sr || serial->fetched != parallel->fetched) {
+    E("%d/%zd rows expected, but got ==%d/%zd==", serial->sr, (size_t)serial->fetched, parallel->sr, (size_t)parallel->fetched);
+    return -1;
+  }
+  if (strcmp(serial->diags, parallel->diags)) {
+    E("diagnostics differ:\n%s\nvs\n%s", serial->diags, parallel->diags);
+    return -1;
+  }
+
+  for (size_t i=0; i<ROWSET; ++i) {
+    if (serial->status[i] != parallel->status[i]) {
+      E("row[%zd]:status %d expected, but got ==%d==", i, serial->status[i], parallel->status[i]);
+      return -1;
+    }
+    if (serial->status[i] == SQL_ROW_ERROR) ++*errors;
+    if (serial->status[i] == SQL_ROW_SUCCESS_WITH_INFO) ++*infos;
+    // NOTE: buffers of rows in error are undefined
+    if (serial->status[i] != SQL_ROW_SUCCESS && serial->status[i] != SQL_ROW_SUCCESS_WITH_INFO) continue;
+    if (strcmp(serial->ts[i], parallel->ts[i]) || serial->ts_ind[i] != parallel->ts_ind[i] ||
+        serial->v[i] != parallel->v[i] ||
+        memcmp(serial->name[i], parallel->name[i], sizeof(serial->name[i])) || serial->name_ind[i] != parallel->name_ind[i] ||
+        strcmp(serial->b[i], parallel->b[i]) || serial->b_ind[i] != parallel->b_ind[i])
+    {
+      E("row[%zd]:buffers differ", i);
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+// the same rowsets converted serially and in parallel shall end up the same, row status and diagnostics included
+static int test_case2(void)
+{
+  int r = -1;
+  SQLHANDLE henv_s = SQL_NULL_HANDLE, hconn_s = SQL_NULL_HANDLE;
+  SQLHANDLE henv_p = SQL_NULL_HANDLE, hconn_p = SQL_NULL_HANDLE;
+  static wide_rowset_t serial, parallel;
+
+  memset(&serial, 0, sizeof(serial));
+  memset(&parallel, 0, sizeof(parallel));
+
+  if (_connect(&henv_s, &hconn_s, "DRIVER={TAOS_ODBC_DRIVER}", NULL)) goto end;
+  if (_connect(&henv_p, &hconn_p, "DRIVER={TAOS_ODBC_DRIVER}", "3")) goto end;
+  _setenv("TAOS_ODBC_FETCH_THREADS", NULL);
+
+  if (_wide_prepare(&serial, hconn_s)) goto end;
+  if (_wide_prepare(&parallel, hconn_p)) goto end;
+
+  int rows = 0, errors = 0, infos = 0;
+  while (1) {
+    _wide_fetch(&serial);
+    _wide_fetch(&parallel);
+    if (_wide_compare(&serial, &parallel, &errors, &infos)) goto end;
+    if (serial.sr == SQL_NO_DATA || FAILED(serial.sr)) break;
+    rows += (int)serial.fetched;
+  }
+
+  if (serial.sr != SQL_NO_DATA || rows != ROWS_WIDE) {
+    E("%d rows expected, but got ==%d/%d==", ROWS_WIDE, rows, serial.sr);
+    goto end;
+  }
+  if (errors == 0 || infos == 0) {
+    E("rows in error as well as truncated expected, but got ==%d/%d==", errors, infos);
+    goto end;
+  }
+
+  r = 0;
+
+end:
+  if (parallel.hstmt) CALL_SQLFreeHandle(SQL_HANDLE_STMT, parallel.hstmt);
+  if (serial.hstmt) CALL_SQLFreeHandle(SQL_HANDLE_STMT, serial.hstmt);
+  _disconnect(henv_p, hconn_p);
+  _disconnect(henv_s, hconn_s);
+  _setenv("TAOS_ODBC_FETCH_THREADS", NULL);
+  return r;
+}
+
+// SQL_ATTR_TAOS_PERF_BATCHES of `hstmt`, -1 on failure
+static SQLBIGINT _batches(SQLHANDLE hstmt)
+{
+  SQLBIGINT batches = -1;
+  if (FAILED(CALL_SQLGetStmtAttr(hstmt, SQL_ATTR_TAOS_PERF_BATCHES, &batches, sizeof(batches), NULL))) return -1;
+  return batches;
+}
+
+// prepare and execute a parameterized insert of ROWS_DEFERRED rows, which is deferred by WRITE_BEHIND
+#define ROWS_DEFERRED    10
+static int _insert_deferred(SQLHANDLE hstmt, const char *sql)
+{
+  int32_t vals[ROWS_DEFERRED];
+  for (int i=0; i<ROWS_DEFERRED; ++i) vals[i] = i;
+
+  if (FAILED(CALL_SQLPrepare(hstmt, (SQLCHAR*)sql, SQL_NTS))) return -1;
+  if (FAILED(CALL_SQLSetStmtAttr(hstmt, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER)ROWS_DEFERRED, 0))) return -1;
+  if (FAILED(CALL_SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_SLONG, SQL_INTEGER, 0, 0, vals, sizeof(vals[0]), NULL))) return -1;
+  if (FAILED(CALL_SQLExecute(hstmt))) return -1;
+  // NOTE: `vals` may go out of scope once SQLExecute returns, taosc has taken a copy by taos_stmt_add_batch
+
+  SQLBIGINT batches = _batches(hstmt);
+  if (batches != 0) {
+    E("%s:rows expected to be deferred, but ==%" PRId64 "== batches executed", sql, (int64_t)batches);
+    return -1;
+  }
+
+  return 0;
+}
+
+// whether the first diagnostic record of `handle` refers to the deferred rows
+static int _deferred_failure_reported(SQLSMALLINT HandleType, SQLHANDLE handle)
+{
+  char buf[4096];
+  size_t n = 0;
+  buf[0] = '\0';
+  for (SQLSMALLINT i=1; n < sizeof(buf); ++i) {
+    SQLCHAR sqlState[6] = {0};
+    SQLINTEGER nativeErrno = 0;
+    SQLCHAR messageText[1024] = {0};
+    SQLSMALLINT textLength = 0;
+    SQLRETURN sr = SQLGetDiagRec(HandleType, handle, i, sqlState, &nativeErrno, messageText, sizeof(messageText), &textLength);
+    if (sr != SQL_SUCCESS && sr != SQL_SUCCESS_WITH_INFO) break;
+    n += snprintf(buf + n, sizeof(buf) - n, "[%s]%s\n", (const char*)sqlState, (const char*)messageText);
+  }
+  if (strstr(buf, "fake_insert_fail") && strstr(buf, "deferred rows")) return 1;
+  E("diagnostics of the failed deferred rows expected, but got ==%s==", buf);
+  return 0;
+}
+
+// rows deferred by WRITE_BEHIND are flushed by SQLFreeStmt(SQL_CLOSE)/SQLDisconnect, and failures are reported by them
+static int test_case4(void)
+{
+  int r = -1;
+  SQLHANDLE henv = SQL_NULL_HANDLE, hconn = SQL_NULL_HANDLE, hstmt = SQL_NULL_HANDLE;
+  SQLRETURN sr = SQL_SUCCESS;
+
+  if (_connect(&henv, &hconn, "DRIVER={TAOS_ODBC_DRIVER};WRITE_BEHIND=1000", NULL)) goto end;
+  if (FAILED(CALL_SQLAllocHandle(SQL_HANDLE_STMT, hconn, &hstmt))) goto end;
+
+  if (_insert_deferred(hstmt, "insert into fake_insert (v) values (?)")) goto end;
+  if (FAILED(CALL_SQLFreeStmt(hstmt, SQL_CLOSE))) goto end;
+  if (_batches(hstmt) != 1) {
+    E("deferred rows expected to be flushed by SQLFreeStmt(SQL_CLOSE), but ==%" PRId64 "== batches executed", (int64_t)_batches(hstmt));
+    goto end;
+  }
+
+  if (FAILED(CALL_SQLSetStmtAttr(hstmt, SQL_ATTR_TAOS_PERF_RESET, (SQLPOINTER)1, 0))) goto end;
+  if (_insert_deferred(hstmt, "insert into fake_insert_fail (v) values (?)")) goto end;
+  sr = SQLFreeStmt(hstmt, SQL_CLOSE);
+  if (sr != SQL_ERROR) {
+    E("SQLFreeStmt(SQL_CLOSE):SQL_ERROR expected, but got ==%d==", sr);
+    goto end;
+  }
+  if (!_deferred_failure_reported(SQL_HANDLE_STMT, hstmt)) goto end;
+
+  if (FAILED(CALL_SQLSetStmtAttr(hstmt, SQL_ATTR_TAOS_PERF_RESET, (SQLPOINTER)1, 0))) goto end;
+  if (_insert_deferred(hstmt, "insert into fake_insert_fail (v) values (?)")) goto end;
+  sr = SQLDisconnect(hconn);
+  if (sr != SQL_ERROR) {
+    E("SQLDisconnect:SQL_ERROR expected, but got ==%d==", sr);
+    goto end;
+  }
+  if (!_deferred_failure_reported(SQL_HANDLE_DBC, hconn)) goto end;
+
+  // NOTE: the connection stays open after the failed SQLDisconnect, and the rows are no longer pending
+  if (FAILED(CALL_SQLFreeHandle(SQL_HANDLE_STMT, hstmt))) goto end;
+  hstmt = SQL_NULL_HANDLE;
+
+  r = 0;
+
+end:
+  if (hstmt != SQL_NULL_HANDLE) CALL_SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+  _disconnect(henv, hconn);
+  return r;
+}
+
+// SQLRowCount of the current result, followed by SQLMoreResults, of each statement of the script just executed
+// `expected` ends with -2, and an entry of INT_MIN expects the statement to fail
+static int _check_row_counts(SQLHANDLE hstmt, SQLRETURN sr, const char *script, const SQLLEN *expected)
+{
+  for (size_t i=0; expected[i] != -2; ++i) {
+    if (i && sr == SQL_NO_DATA) {
+      E("%s:statement #%zd expected, but got ==SQL_NO_DATA==", script, i+1);
+      return -1;
+    }
+    if (expected[i] == INT_MIN) {
+      char sqlState[6];
+      _first_state(hstmt, sqlState);
+      if (sr != SQL_ERROR || strcmp(sqlState, "HY000")) {
+        E("%s:statement #%zd expected to fail, but got ==%d/%s==", script, i+1, sr, sqlState);
+        return -1;
+      }
+    } else {
+      if (FAILED(sr)) {
+        E("%s:statement #%zd expected to succeed, but got ==%d==", script, i+1, sr);
+        return -1;
+      }
+      SQLLEN n = 0;
+      if (FAILED(CALL_SQLRowCount(hstmt, &n))) return -1;
+      if (n != expected[i]) {
+        E("%s:statement #%zd:%" PRId64 " rows expected, but got ==%" PRId64 "==", script, i+1, (int64_t)expected[i], (int64_t)n);
+        return -1;
+      }
+    }
+    sr = SQLMoreResults(hstmt);
+  }
+
+  if (sr != SQL_NO_DATA) {
+    E("%s:SQL_NO_DATA expected at last, but got ==%d==", script, sr);
+    return -1;
+  }
+
+  return 0;
+}
+
+// plain inserts of a script are merged into one for taosc, which SQLRowCount/SQLMoreResults shall not tell
+static int test_case5(SQLHANDLE hconn)
+{
+  int r = -1;
+  SQLHANDLE hstmt = SQL_NULL_HANDLE;
+
+  if (FAILED(CALL_SQLAllocHandle(SQL_HANDLE_STMT, hconn, &hstmt))) return -1;
+
+  const char *ok =
+    "insert into fake_ins_ok_a values (1) (2);"
+    "insert into fake_ins_ok_b values (3);"
+    "insert into fake_ins_ok_c values (4) (5) (6)";
+  const SQLLEN ok_expected[] = {2, 1, 3, -2};
+  if (_check_row_counts(hstmt, SQLExecDirect(hstmt, (SQLCHAR*)ok, SQL_NTS), ok, ok_expected)) goto end;
+  CALL_SQLFreeStmt(hstmt, SQL_CLOSE);
+
+  // NOTE: the merged insert fails as a whole, reported once for all the statements it merged, never replayed
+  const char *bad =
+    "insert into fake_ins_ok_a values (1) (2);"
+    "insert into fake_ins_bad values (3);"
+    "insert into fake_ins_ok_c values (4) (5) (6);"
+    "select 'fake_rows:1';"
+    "insert into fake_ins_ok_d values (7)";
+  const SQLLEN bad_expected[] = {INT_MIN, 0, 1, -2};
+  if (_check_row_counts(hstmt, SQLExecDirect(hstmt, (SQLCHAR*)bad, SQL_NTS), bad, bad_expected)) goto end;
+  CALL_SQLFreeStmt(hstmt, SQL_CLOSE);
+
+  r = 0;
+
+end:
+  CALL_SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+  return r;
+}
+
+#if (ODBCVER < 0x0380)             /* { */
+// NOTE: declared by sqlext.h for ODBC 3.8 only, though exported by the driver
+SQLRETURN SQL_API SQLCompleteAsync(SQLSMALLINT HandleType, SQLHANDLE Handle, RETCODE *AsyncRetCodePtr);
+#endif                             /* } */
+
+// wait for the pending asynchronous function, either by SQLCompleteAsync, or by re-calling it thru `again`
+static SQLRETURN _async_wait(SQLHANDLE hstmt, SQLRETURN sr, int complete, SQLRETURN (*again)(SQLHANDLE hstmt, void *arg), void *arg, int *stills)
+{
+  if (sr != SQL_STILL_EXECUTING) return sr;
+  ++*stills;
+
+  if (complete) {
+    RETCODE rc = SQL_STILL_EXECUTING;
+    sr = SQLCompleteAsync(SQL_HANDLE_STMT, hstmt, &rc);
+    if (sr != SQL_SUCCESS) {
+      E("SQLCompleteAsync:SQL_SUCCESS expected, but got ==%d==", sr);
+      return SQL_ERROR;
+    }
+    if (rc == SQL_STILL_EXECUTING) {
+      E("SQLCompleteAsync:expected to block until completion, but still executing");
+      return SQL_ERROR;
+    }
+    return rc;
+  }
+
+  while (sr == SQL_STILL_EXECUTING) {
+    tod_sleep_ms(1);
+    sr = again(hstmt, arg);
+  }
+  return sr;
+}
+
+static SQLRETURN _async_exec(SQLHANDLE hstmt, void *arg)
+{
+  return SQLExecDirect(hstmt, (SQLCHAR*)arg, SQL_NTS);
+}
+
+static SQLRETURN _async_fetch(SQLHANDLE hstmt, void *arg)
+{
+  (void)arg;
+  return SQLFetch(hstmt);
+}
+
+static int _async_fetch_all(SQLHANDLE hstmt, int complete)
+{
+  char sql[64];
+  int stills = 0;
+  snprintf(sql, sizeof(sql), "select 'fake_rows:%d'", ROWS_ASYNC);
+
+  SQLRETURN sr = _async_wait(hstmt, SQLExecDirect(hstmt, (SQLCHAR*)sql, SQL_NTS), complete, _async_exec, sql, &stills);
+  if (FAILED(sr)) {
+    E("%s:failed", sql);
+    return -1;
+  }
+
+  int32_t next = 0;
+  while (1) {
+    sr = _async_wait(hstmt, SQLFetch(hstmt), complete, _async_fetch, NULL, &stills);
+    if (sr == SQL_NO_DATA) break;
+    if (FAILED(sr)) {
+      E("SQLFetch:failed at row #%d", next);
+      return -1;
+    }
+
+    int32_t v = -1;
+    SQLLEN ind = 0;
+    if (FAILED(CALL_SQLGetData(hstmt, 1, SQL_C_SLONG, &v, sizeof(v), &ind))) return -1;
+    if (v != next) {
+      E("%d expected, but got ==%d==", next, v);
+      return -1;
+    }
+    ++next;
+  }
+  CALL_SQLCloseCursor(hstmt);
+
+  if (next != ROWS_ASYNC) {
+    E("%d rows expected, but got ==%d==", ROWS_ASYNC, next);
+    return -1;
+  }
+  // NOTE: at least the query and each full block of FAKE_ROWS_PER_BLOCK(64) rows
+  if (stills < 1 + ROWS_ASYNC / 64) {
+    E("SQL_STILL_EXECUTING expected for the query and each block, but got ==%d times==", stills);
+    return -1;
+  }
+
+  return 0;
+}
+
+// SQL_ATTR_ASYNC_ENABLE in polling mode, completed by re-calling the function, or by SQLCompleteAsync
+static int test_case6(SQLHANDLE hconn)
+{
+  int r = -1;
+  SQLHANDLE hstmt = SQL_NULL_HANDLE;
+
+  SQLUINTEGER async_mode = 0;
+  if (FAILED(CALL_SQLGetInfo(hconn, SQL_ASYNC_MODE, &async_mode, sizeof(async_mode), NULL))) return -1;
+  if (async_mode != SQL_AM_STATEMENT) {
+    E("SQL_ASYNC_MODE:SQL_AM_STATEMENT expected, but got ==%u==", async_mode);
+    return -1;
+  }
+
+  if (FAILED(CALL_SQLAllocHandle(SQL_HANDLE_STMT, hconn, &hstmt))) return -1;
+  if (FAILED(CALL_SQLSetStmtAttr(hstmt, SQL_ATTR_ASYNC_ENABLE, (SQLPOINTER)SQL_ASYNC_ENABLE_ON, 0))) goto end;
+
+  if (_async_fetch_all(hstmt, 0)) goto end;
+  if (_async_fetch_all(hstmt, 1)) goto end;
+
+  r = 0;
+
+end:
+  CALL_SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+  return r;
+}
+
+#define SML_PAYLOADS     3
+#define SML_PAYLOAD_LEN  256
+
+// `payloads` bound as an array of SQL_C_CHAR to `!schemaless <protocol>`, executed twice, thus rows counted per execution
+static int _schemaless_rows(SQLHANDLE hconn, const char *sql, const char *payloads[SML_PAYLOADS], SQLLEN expected)
+{
+  int r = -1;
+  SQLHANDLE hstmt = SQL_NULL_HANDLE;
+  char buf[SML_PAYLOADS][SML_PAYLOAD_LEN];
+  SQLLEN inds[SML_PAYLOADS];
+  SQLUSMALLINT statuses[SML_PAYLOADS];
+
+  for (size_t i=0; i<SML_PAYLOADS; ++i) {
+    snprintf(buf[i], sizeof(buf[i]), "%s", payloads[i]);
+    inds[i] = SQL_NTS;
+  }
+
+  if (FAILED(CALL_SQLAllocHandle(SQL_HANDLE_STMT, hconn, &hstmt))) return -1;
+  if (FAILED(CALL_SQLPrepare(hstmt, (SQLCHAR*)sql, SQL_NTS))) goto end;
+  if (FAILED(CALL_SQLSetStmtAttr(hstmt, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER)SML_PAYLOADS, 0))) goto end;
+  if (FAILED(CALL_SQLSetStmtAttr(hstmt, SQL_ATTR_PARAM_STATUS_PTR, statuses, 0))) goto end;
+  if (FAILED(CALL_SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_CHAR, SQL_VARCHAR, SML_PAYLOAD_LEN, 0, buf, SML_PAYLOAD_LEN, inds))) goto end;
+
+  for (int round=0; round<3; ++round) {
+    // closing the cursor in between shall keep the statement prepared as `!schemaless`
+    // NOTE: DM might reject SQLCloseCursor with 24000 since no result set is pending, thus not checked
+    if (round == 1) CALL_SQLCloseCursor(hstmt);
+    if (round == 2 && FAILED(CALL_SQLFreeStmt(hstmt, SQL_CLOSE))) goto end;
+    SQLRETURN sr = CALL_SQLExecute(hstmt);
+    if (expected < 0) {
+      if (sr != SQL_ERROR) {
+        E("%s:SQL_ERROR expected, but got ==%d==", sql, sr);
+        goto end;
+      }
+    } else if (FAILED(sr)) {
+      goto end;
+    }
+    // NOTE: payloads are sent as a whole, thus each paramset shares the fate of all
+    SQLUSMALLINT status = (expected < 0) ? SQL_PARAM_DIAG_UNAVAILABLE : SQL_PARAM_SUCCESS;
+    for (size_t i=0; i<SML_PAYLOADS; ++i) {
+      if (statuses[i] == status) continue;
+      E("%s:round #%d:paramset #%zd:status %d expected, but got ==%d==", sql, round, i+1, status, statuses[i]);
+      goto end;
+    }
+    if (expected < 0) continue;
+    SQLLEN rows = -2;
+    if (FAILED(CALL_SQLRowCount(hstmt, &rows))) goto end;
+    if (rows != expected) {
+      E("%s:round #%d:%" PRId64 " rows expected, but got ==%" PRId64 "==", sql, round, (int64_t)expected, (int64_t)rows);
+      goto end;
+    }
+  }
+
+  r = 0;
+
+end:
+  CALL_SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+  return r;
+}
+
+// SQLRowCount of `!schemaless`, summing up rows of every payload, per protocol
+static int test_case7(SQLHANDLE hconn)
+{
+  const char *lines[SML_PAYLOADS] = {
+    "meters,location=a current=10.3,voltage=219i 1626006833639",
+    "meters,location=b current=10.5,voltage=220i 1626006833640\nmeters,location=c current=10.7,voltage=221i 1626006833641",
+    "meters,location=d current=10.9,voltage=222i 1626006833642\n",
+  };
+  const char *telnets[SML_PAYLOADS] = {
+    "meters.current 1626006833 10.3 location=a",
+    "meters.current 1626006834 10.5 location=b\nmeters.current 1626006835 10.7 location=c\nmeters.current 1626006836 10.9 location=d",
+    "meters.voltage 1626006833 219 location=a",
+  };
+  const char *jsons[SML_PAYLOADS] = {
+    "{\"metric\":\"meters.current\",\"timestamp\":1626006833,\"value\":10.3,\"tags\":{\"location\":\"a\"}}",
+    "[{\"metric\":\"meters.current\",\"timestamp\":1626006834,\"value\":10.5,\"tags\":{\"location\":\"{b}\"}},"
+     "{\"metric\":\"meters.current\",\"timestamp\":1626006835,\"value\":10.7,\"tags\":{\"location\":\"c\"}}]",
+    "{\"metric\":\"meters.voltage\",\"timestamp\":1626006833,\"value\":219,\"tags\":{\"location\":\"a\"}}",
+  };
+  const char *bads[SML_PAYLOADS] = {
+    "meters,location=a current=10.3 1626006833639",
+    "fake_sml_bad,location=b current=10.5 1626006833640",
+    "meters,location=c current=10.7 1626006833641",
+  };
+
+  if (_schemaless_rows(hconn, "!schemaless influx {precision=ms}", lines, 4)) return -1;
+  if (_schemaless_rows(hconn, "!schemaless telnet {precision=s}", telnets, 5)) return -1;
+  if (_schemaless_rows(hconn, "!schemaless json", jsons, 4)) return -1;
+  if (_schemaless_rows(hconn, "!schemaless influx", bads, -1)) return -1;
+
+  return 0;
+}
+
+// blocks fetched by the query, 0 if served from the result cache
+static int _cached_query(SQLHANDLE hstmt, SQLBIGINT *blocks)
+{
+  SQLBIGINT blocks0 = 0, blocks1 = 0;
+  if (FAILED(CALL_SQLGetStmtAttr(hstmt, SQL_ATTR_TAOS_PERF_BLOCKS_FETCHED, &blocks0, sizeof(blocks0), NULL))) return -1;
+
+  if (FAILED(CALL_SQLExecDirect(hstmt, (SQLCHAR*)"select 'fake_rows:3' from meters", SQL_NTS))) return -1;
+  // NOTE: the result set is kept in the result cache only if all rows are fetched
+  SQLRETURN sr = SQL_SUCCESS;
+  while ((sr = CALL_SQLFetch(hstmt)) == SQL_SUCCESS) ;
+  if (sr != SQL_NO_DATA) return -1;
+  CALL_SQLCloseCursor(hstmt);
+
+  if (FAILED(CALL_SQLGetStmtAttr(hstmt, SQL_ATTR_TAOS_PERF_BLOCKS_FETCHED, &blocks1, sizeof(blocks1), NULL))) return -1;
+  *blocks = blocks1 - blocks0;
+  return 0;
+}
+
+// `!schemaless` writes invalidate cached results, just as plain inserts do
+static int test_case8(void)
+{
+  int r = -1;
+  SQLHANDLE henv = SQL_NULL_HANDLE, hconn = SQL_NULL_HANDLE, hstmt = SQL_NULL_HANDLE;
+  SQLBIGINT blocks = 0;
+  const char *lines[SML_PAYLOADS] = {
+    "meters,location=a current=10.3,voltage=219i 1626006833639",
+    "meters,location=b current=10.5,voltage=220i 1626006833640",
+    "meters,location=c current=10.7,voltage=221i 1626006833641",
+  };
+
+  if (_connect(&henv, &hconn, "DRIVER={TAOS_ODBC_DRIVER};RESULT_CACHE_TTL_MS=60000", NULL)) goto end;
+  if (FAILED(CALL_SQLAllocHandle(SQL_HANDLE_STMT, hconn, &hstmt))) goto end;
+
+  if (_cached_query(hstmt, &blocks)) goto end;
+  if (_cached_query(hstmt, &blocks)) goto end;
+  if (blocks != 0) {
+    E("result cache hit expected, but got ==%" PRId64 "== blocks fetched", (int64_t)blocks);
+    goto end;
+  }
+
+  if (_schemaless_rows(hconn, "!schemaless influx {precision=ms}", lines, 3)) goto end;
+
+  if (_cached_query(hstmt, &blocks)) goto end;
+  if (blocks == 0) {
+    E("result cache miss expected after `!schemaless`, but served from the result cache");
+    goto end;
+  }
+
+  r = 0;
+
+end:
+  if (hstmt != SQL_NULL_HANDLE) CALL_SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+  _disconnect(henv, hconn);
+  return r;
+}
+
+static int test(void)
+{
+  int r = -1;
+  SQLHANDLE henv = SQL_NULL_HANDLE, hconn = SQL_NULL_HANDLE;
+
+  if (FAILED(CALL_SQLAllocHandle(SQL_HANDLE_ENV, SQL_NULL_HANDLE, &henv))) return -1;
+  if (FAILED(CALL_SQLSetEnvAttr(henv, SQL_ATTR_ODBC_VERSION, (SQLPOINTER)SQL_OV_ODBC3, 0))) goto end;
+  if (FAILED(CALL_SQLAllocHandle(SQL_HANDLE_DBC, henv, &hconn))) goto end;
+
+  SQLRETURN sr = CALL_SQLDriverConnect(hconn, NULL, (SQLCHAR*)"DRIVER={TAOS_ODBC_DRIVER}", SQL_NTS, NULL, 0, NULL, SQL_DRIVER_NOPROMPT);
+  if (FAILED(sr)) goto end;
+
+  r = test_case1(hconn);
+  if (r == 0) r = test_case3(hconn);
+  if (r == 0) r = test_case5(hconn);
+  if (r == 0) r = test_case6(hconn);
+  if (r == 0) r = test_case7(hconn);
+
+  CALL_SQLDisconnect(hconn);
+
+end:
+  if (hconn != SQL_NULL_HANDLE) CALL_SQLFreeHandle(SQL_HANDLE_DBC, hconn);
+  CALL_SQLFreeHandle(SQL_HANDLE_ENV, henv);
+  return r;
+}
+
+int main(void)
+{
+  int r = 0;
+  r = test();
+  if (r == 0) r = test_case2();
+  if (r == 0) r = test_case4();
+  if (r == 0) r = test_case8();
+
+  fprintf(stderr,"==%s==\n", r ? "failure" : "success");
+
+  return !!r;
+}
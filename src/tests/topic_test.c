@@ -0,0 +1,404 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022-2023 freemine <freemine@yeah.net>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "logger.h"
+#include "odbc_helpers.h"
+#include "os_port.h"
+#include "taos_odbc_ext.h"
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// NOTE: built with FAKE_TAOS only, messages of the topic are provided by the fake tmq, configured by `fake.*` keys,
+//       each of which is a one-column result of FAKE_TMQ_ROWS INTs, continuously numbered across messages
+
+#define FAKE_TMQ_ROWS    3
+#define MESSAGES         20
+#define MESSAGES_MANY    1000             // more than could be prefetched
+
+typedef struct consumed_s               consumed_t;
+struct consumed_s {
+  int                   rows;
+  int                   dups;
+  int64_t               committed;          // `_committed` of the last row
+  SQLRETURN             sr;                 // of the SQLFetch that ended the loop
+  char                  message[1024];      // of the first diagnostic record, if failed
+};
+
+static int _open(SQLHANDLE hstmt, int messages, int rows, const char *kvs)
+{
+  char sql[1024];
+  snprintf(sql, sizeof(sql), "!topic demo {group.id=cgrpName; fake.messages=%d; taos_odbc.limit.records=%d; %s}",
+      messages, rows, kvs);
+  SQLRETURN sr = CALL_SQLExecDirect(hstmt, (SQLCHAR*)sql, SQL_NTS);
+  if (FAILED(sr)) {
+    E("%s:failed", sql);
+    return -1;
+  }
+  return 0;
+}
+
+// fetch up to `max` rows, or until SQL_NO_DATA or failure
+static int _consume(SQLHANDLE hstmt, char *seen, int total, int max, consumed_t *consumed)
+{
+  memset(consumed, 0, sizeof(*consumed));
+  consumed->committed = -1;
+
+  while (consumed->rows < max) {
+    SQLRETURN sr = SQLFetch(hstmt);
+    consumed->sr = sr;
+    if (sr == SQL_NO_DATA) break;
+    if (FAILED(sr)) {
+      SQLCHAR sqlState[6] = {0};
+      SQLINTEGER nativeErrno = 0;
+      SQLSMALLINT textLength = 0;
+      SQLGetDiagRec(SQL_HANDLE_STMT, hstmt, 1, sqlState, &nativeErrno, (SQLCHAR*)consumed->message, sizeof(consumed->message), &textLength);
+      break;
+    }
+
+    int32_t v = -1;
+    SQLLEN ind = 0;
+    if (FAILED(CALL_SQLGetData(hstmt, 6, SQL_C_SLONG, &v, sizeof(v), &ind))) return -1;
+    if (ind == SQL_NULL_DATA || v < 0 || v >= total) {
+      E("v within [0, %d) expected, but got ==%d==", total, v);
+      return -1;
+    }
+    if (seen[v]) ++consumed->dups;
+    seen[v] = 1;
+
+    int64_t committed = -1;
+    if (FAILED(CALL_SQLGetData(hstmt, 5, SQL_C_SBIGINT, &committed, sizeof(committed), &ind))) return -1;
+    consumed->committed = (ind == SQL_NULL_DATA) ? -1 : committed;
+
+    ++consumed->rows;
+  }
+
+  return 0;
+}
+
+// every message is delivered exactly once, and `_committed` of the last message counts commits so far, if not negative
+static int _check_mode(SQLHANDLE hconn, const char *kvs, int64_t committed)
+{
+  int r = -1;
+  SQLHANDLE hstmt = SQL_NULL_HANDLE;
+  char seen[MESSAGES * FAKE_TMQ_ROWS] = {0};
+  const int total = MESSAGES * FAKE_TMQ_ROWS;
+  consumed_t consumed;
+
+  if (FAILED(CALL_SQLAllocHandle(SQL_HANDLE_STMT, hconn, &hstmt))) return -1;
+  if (_open(hstmt, MESSAGES, total, kvs)) goto end;
+  if (_consume(hstmt, seen, total, total + 1, &consumed)) goto end;
+
+  if (consumed.sr != SQL_NO_DATA || consumed.rows != total || consumed.dups) {
+    E("%s:%d rows expected, but got ==%d rows, %d dups, sr:%d, %s==", kvs, total, consumed.rows, consumed.dups, consumed.sr, consumed.message);
+    goto end;
+  }
+  if (committed >= 0 && consumed.committed != committed) {
+    E("%s:%" PRId64 " commits expected, but got ==%" PRId64 "==", kvs, committed, consumed.committed);
+    goto end;
+  }
+
+  r = 0;
+
+end:
+  CALL_SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+  return r;
+}
+
+// every commit fails, which shall be reported by SQLFetch rather than be lost
+static int _check_commit_failure(SQLHANDLE hconn, const char *kvs)
+{
+  int r = -1;
+  SQLHANDLE hstmt = SQL_NULL_HANDLE;
+  char seen[MESSAGES * FAKE_TMQ_ROWS] = {0};
+  const int total = MESSAGES * FAKE_TMQ_ROWS;
+  consumed_t consumed;
+
+  if (FAILED(CALL_SQLAllocHandle(SQL_HANDLE_STMT, hconn, &hstmt))) return -1;
+  if (_open(hstmt, MESSAGES, total, kvs)) goto end;
+  if (_consume(hstmt, seen, total, total + 1, &consumed)) goto end;
+
+  if (consumed.sr != SQL_ERROR || consumed.rows >= total || !strstr(consumed.message, "tmq_commit")) {
+    E("%s:SQL_ERROR of tmq_commit expected, but got ==%d rows, sr:%d, %s==", kvs, consumed.rows, consumed.sr, consumed.message);
+    goto end;
+  }
+
+  r = 0;
+
+end:
+  CALL_SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+  return r;
+}
+
+// commit after each message, or every 2 messages, thus 19 or 9 commits before the last message is polled
+static int test_case1(SQLHANDLE hconn)
+{
+  if (_check_mode(hconn, "taos_odbc.commit.mode=sync", MESSAGES - 1)) return -1;
+  if (_check_mode(hconn, "taos_odbc.commit.mode=async", MESSAGES - 1)) return -1;
+  if (_check_mode(hconn, "taos_odbc.commit.mode=async; fake.commit_delay_ms=5", -1)) return -1;
+  if (_check_mode(hconn, "taos_odbc.commit.mode=interval; taos_odbc.commit.every=2", (MESSAGES - 1) / 2)) return -1;
+  if (_check_mode(hconn, "taos_odbc.commit.mode=interval; taos_odbc.commit.every=10ms", -1)) return -1;
+  return 0;
+}
+
+static int test_case2(SQLHANDLE hconn)
+{
+  if (_check_commit_failure(hconn, "taos_odbc.commit.mode=sync; fake.commit_fail=1")) return -1;
+  if (_check_commit_failure(hconn, "taos_odbc.commit.mode=async; fake.commit_fail=1")) return -1;
+  if (_check_commit_failure(hconn, "taos_odbc.commit.mode=interval; taos_odbc.commit.every=1; fake.commit_fail=1")) return -1;
+  return 0;
+}
+
+// tmq_commit_async calls back long after the statement is freed, which valgrind or sanitizers would catch if it were
+// still referred to
+static int test_case3(SQLHANDLE hconn)
+{
+  int r = -1;
+  SQLHANDLE hstmt = SQL_NULL_HANDLE;
+  char seen[MESSAGES * FAKE_TMQ_ROWS] = {0};
+  const int total = MESSAGES * FAKE_TMQ_ROWS;
+  consumed_t consumed;
+
+  if (FAILED(CALL_SQLAllocHandle(SQL_HANDLE_STMT, hconn, &hstmt))) return -1;
+  if (_open(hstmt, MESSAGES, total, "taos_odbc.commit.mode=async; fake.commit_delay_ms=1500")) goto end;
+  if (_consume(hstmt, seen, total, FAKE_TMQ_ROWS * 3, &consumed)) goto end;
+  if (consumed.sr != SQL_SUCCESS) {
+    E("SQL_SUCCESS expected, but got ==%d, %s==", consumed.sr, consumed.message);
+    goto end;
+  }
+
+  r = 0;
+
+end:
+  CALL_SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+  tod_sleep_ms(2000);
+  return r;
+}
+
+// with prefetch, messages used up are handed over to their pollers, which commit them in the background
+static int _check_hand_over(SQLHANDLE hconn, const char *kvs)
+{
+  int r = -1;
+  SQLHANDLE hstmt = SQL_NULL_HANDLE;
+  char seen[MESSAGES * FAKE_TMQ_ROWS] = {0};
+  const int total = MESSAGES * FAKE_TMQ_ROWS;
+  consumed_t consumed;
+
+  if (FAILED(CALL_SQLAllocHandle(SQL_HANDLE_STMT, hconn, &hstmt))) return -1;
+  if (_open(hstmt, MESSAGES, total, kvs)) goto end;
+  if (_consume(hstmt, seen, total, FAKE_TMQ_ROWS * 2, &consumed)) goto end;
+  if (consumed.sr != SQL_SUCCESS) {
+    E("%s:SQL_SUCCESS expected, but got ==%d, %s==", kvs, consumed.sr, consumed.message);
+    goto end;
+  }
+  // NOTE: the first message has been handed over, give its poller time to commit it
+  tod_sleep_ms(300);
+  // NOTE: `_committed` is fetched by the poller along with each message, thus skip those polled before the commit,
+  //       i.e. the whole ring of taos_odbc.prefetch=4, plus one held by each of at most 2 pollers waiting for room
+  if (_consume(hstmt, seen, total, (4 + 2 + 1) * FAKE_TMQ_ROWS, &consumed)) goto end;
+  if (consumed.sr != SQL_SUCCESS || consumed.committed < 1) {
+    E("%s:the first message committed expected, but got ==%d, %" PRId64 " commits, %s==", kvs, consumed.sr, consumed.committed, consumed.message);
+    goto end;
+  }
+
+  r = 0;
+
+end:
+  CALL_SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+  return r;
+}
+
+// the prefetch ring, fed by one or more pollers, in each commit mode
+static int test_case4(SQLHANDLE hconn)
+{
+  if (_check_mode(hconn, "taos_odbc.prefetch=1; taos_odbc.commit.mode=sync", -1)) return -1;
+  if (_check_mode(hconn, "taos_odbc.prefetch=4; taos_odbc.commit.mode=sync", -1)) return -1;
+  if (_check_mode(hconn, "taos_odbc.prefetch=4; taos_odbc.consumers=3; taos_odbc.commit.mode=sync", -1)) return -1;
+  if (_check_mode(hconn, "taos_odbc.prefetch=4; taos_odbc.consumers=3; taos_odbc.commit.mode=async; fake.commit_delay_ms=5", -1)) return -1;
+  if (_check_mode(hconn, "taos_odbc.prefetch=4; taos_odbc.consumers=3; taos_odbc.commit.mode=interval; taos_odbc.commit.every=2", -1)) return -1;
+  if (_check_mode(hconn, "taos_odbc.prefetch=4; taos_odbc.consumers=3; taos_odbc.commit.mode=interval; taos_odbc.commit.every=10ms", -1)) return -1;
+  if (_check_hand_over(hconn, "taos_odbc.prefetch=4; taos_odbc.commit.mode=sync")) return -1;
+  if (_check_hand_over(hconn, "taos_odbc.prefetch=4; taos_odbc.consumers=2; taos_odbc.commit.mode=async")) return -1;
+  return 0;
+}
+
+// close while pollers are blocked on a full ring, then reopen on the same statement
+static int test_case5(SQLHANDLE hconn)
+{
+  int r = -1;
+  SQLHANDLE hstmt = SQL_NULL_HANDLE;
+  static char seen[MESSAGES_MANY * FAKE_TMQ_ROWS];
+  const int total = MESSAGES * FAKE_TMQ_ROWS;
+  const char *kvs = "taos_odbc.prefetch=2; taos_odbc.consumers=3; taos_odbc.commit.mode=async; fake.commit_delay_ms=5";
+  consumed_t consumed;
+
+  if (FAILED(CALL_SQLAllocHandle(SQL_HANDLE_STMT, hconn, &hstmt))) return -1;
+  memset(seen, 0, sizeof(seen));
+  if (_open(hstmt, MESSAGES_MANY, MESSAGES_MANY * FAKE_TMQ_ROWS, kvs)) goto end;
+  if (_consume(hstmt, seen, MESSAGES_MANY * FAKE_TMQ_ROWS, 5, &consumed)) goto end;
+  if (consumed.sr != SQL_SUCCESS) {
+    E("SQL_SUCCESS expected, but got ==%d, %s==", consumed.sr, consumed.message);
+    goto end;
+  }
+  // NOTE: let pollers fill up the ring and block
+  tod_sleep_ms(100);
+
+  int64_t t0 = tod_now_us();
+  if (FAILED(CALL_SQLFreeStmt(hstmt, SQL_CLOSE))) goto end;
+  int64_t elapsed = tod_now_us() - t0;
+  // NOTE: 1s at most is spent waiting for async commits to call back
+  if (elapsed > 1500 * 1000) {
+    E("pollers expected to stop promptly, but took ==%" PRId64 "us==", elapsed);
+    goto end;
+  }
+
+  memset(seen, 0, sizeof(seen));
+  if (_open(hstmt, MESSAGES, total, kvs)) goto end;
+  if (_consume(hstmt, seen, total, total + 1, &consumed)) goto end;
+  if (consumed.sr != SQL_NO_DATA || consumed.rows != total || consumed.dups) {
+    E("%d rows expected after reopen, but got ==%d rows, %d dups, sr:%d, %s==", total, consumed.rows, consumed.dups, consumed.sr, consumed.message);
+    goto end;
+  }
+
+  r = 0;
+
+end:
+  CALL_SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+  return r;
+}
+
+static SQLBIGINT _stmt_perf(SQLHANDLE hstmt, SQLINTEGER attr)
+{
+  SQLBIGINT v = -1;
+  if (FAILED(CALL_SQLGetStmtAttr(hstmt, attr, &v, sizeof(v), NULL))) return -1;
+  return v;
+}
+
+// poll stats thru SQL_ATTR_TAOS_PERF_TOPIC_*, of the open topic, and folded into the statement once closed
+static int test_case6(SQLHANDLE hconn)
+{
+  int r = -1;
+  SQLHANDLE hstmt = SQL_NULL_HANDLE;
+  char seen[MESSAGES * FAKE_TMQ_ROWS] = {0};
+  const int total = MESSAGES * FAKE_TMQ_ROWS;
+  consumed_t consumed;
+  SQLBIGINT polls, empty, us, data_us;
+
+  if (FAILED(CALL_SQLAllocHandle(SQL_HANDLE_STMT, hconn, &hstmt))) return -1;
+
+  // NOTE: polled inline, each returns a message, and no more polls once taos_odbc.limit.records is reached
+  if (_open(hstmt, MESSAGES, total, "")) goto end;
+  if (_consume(hstmt, seen, total, total + 1, &consumed)) goto end;
+  polls   = _stmt_perf(hstmt, SQL_ATTR_TAOS_PERF_TOPIC_POLLS);
+  empty   = _stmt_perf(hstmt, SQL_ATTR_TAOS_PERF_TOPIC_POLLS_EMPTY);
+  us      = _stmt_perf(hstmt, SQL_ATTR_TAOS_PERF_TOPIC_POLL_US);
+  data_us = _stmt_perf(hstmt, SQL_ATTR_TAOS_PERF_TOPIC_POLL_DATA_US);
+  if (polls != MESSAGES || empty != 0 || data_us < 0 || us < data_us) {
+    E("%d polls, none empty expected, but got ==polls:%" PRId64 ", empty:%" PRId64 ", us:%" PRId64 ", data_us:%" PRId64 "==",
+        MESSAGES, (int64_t)polls, (int64_t)empty, (int64_t)us, (int64_t)data_us);
+    goto end;
+  }
+
+  if (FAILED(CALL_SQLFreeStmt(hstmt, SQL_CLOSE))) goto end;
+  polls = _stmt_perf(hstmt, SQL_ATTR_TAOS_PERF_TOPIC_POLLS);
+  if (polls != MESSAGES) {
+    E("%d polls expected after close, but got ==%" PRId64 "==", MESSAGES, (int64_t)polls);
+    goto end;
+  }
+
+  if (FAILED(CALL_SQLSetStmtAttr(hstmt, SQL_ATTR_TAOS_PERF_RESET, NULL, 0))) goto end;
+  polls = _stmt_perf(hstmt, SQL_ATTR_TAOS_PERF_TOPIC_POLLS);
+  if (polls != 0) {
+    E("no polls expected after reset, but got ==%" PRId64 "==", (int64_t)polls);
+    goto end;
+  }
+
+  // NOTE: background pollers might poll ahead, or poll in vain once messages run out
+  memset(seen, 0, sizeof(seen));
+  if (_open(hstmt, MESSAGES, total, "taos_odbc.prefetch=4; taos_odbc.consumers=2")) goto end;
+  if (_consume(hstmt, seen, total, total + 1, &consumed)) goto end;
+  // NOTE: as a whole, since pollers keep on polling in the meantime
+  taos_odbc_perf_t perf = {0};
+  if (FAILED(CALL_SQLGetStmtAttr(hstmt, SQL_ATTR_TAOS_PERF, &perf, sizeof(perf), NULL))) goto end;
+  polls = perf.topic_polls;
+  empty = perf.topic_polls_empty;
+  if (polls < MESSAGES || polls - empty != MESSAGES) {
+    E("%d polls returning a message expected, but got ==polls:%" PRId64 ", empty:%" PRId64 "==", MESSAGES, (int64_t)polls, (int64_t)empty);
+    goto end;
+  }
+
+  r = 0;
+
+end:
+  CALL_SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+  if (r == 0) {
+    SQLBIGINT v = -1;
+    if (FAILED(CALL_SQLGetConnectAttr(hconn, SQL_ATTR_TAOS_PERF_TOPIC_POLLS, &v, sizeof(v), NULL))) return -1;
+    if (v < polls) {
+      E("at least %" PRId64 " polls of the connection expected, but got ==%" PRId64 "==", (int64_t)polls, (int64_t)v);
+      return -1;
+    }
+  }
+  return r;
+}
+
+static int test(void)
+{
+  int r = -1;
+  SQLHANDLE henv = SQL_NULL_HANDLE, hconn = SQL_NULL_HANDLE;
+
+  if (FAILED(CALL_SQLAllocHandle(SQL_HANDLE_ENV, SQL_NULL_HANDLE, &henv))) return -1;
+  if (FAILED(CALL_SQLSetEnvAttr(henv, SQL_ATTR_ODBC_VERSION, (SQLPOINTER)SQL_OV_ODBC3, 0))) goto end;
+  if (FAILED(CALL_SQLAllocHandle(SQL_HANDLE_DBC, henv, &hconn))) goto end;
+
+  SQLRETURN sr = CALL_SQLDriverConnect(hconn, NULL, (SQLCHAR*)"DRIVER={TAOS_ODBC_DRIVER}", SQL_NTS, NULL, 0, NULL, SQL_DRIVER_NOPROMPT);
+  if (FAILED(sr)) goto end;
+
+  r = test_case1(hconn);
+  if (r == 0) r = test_case2(hconn);
+  if (r == 0) r = test_case3(hconn);
+  if (r == 0) r = test_case4(hconn);
+  if (r == 0) r = test_case5(hconn);
+  if (r == 0) r = test_case6(hconn);
+
+  CALL_SQLDisconnect(hconn);
+
+end:
+  if (hconn != SQL_NULL_HANDLE) CALL_SQLFreeHandle(SQL_HANDLE_DBC, hconn);
+  CALL_SQLFreeHandle(SQL_HANDLE_ENV, henv);
+  return r;
+}
+
+int main(void)
+{
+  int r = 0;
+  r = test();
+
+  fprintf(stderr,"==%s==\n", r ? "failure" : "success");
+
+  return !!r;
+}
@@ -26,11 +26,15 @@
 #include "utils.h"
 
 #include "charset.h"
+#include "helpers.h"
 #include "list.h"
 #include "tls.h"
 
 #include <ctype.h>
 #include <errno.h>
+#include <float.h>
+#include <locale.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <string.h>
@@ -1144,3 +1148,904 @@ void hash_table_get(hash_table_t *hash_table, const char *key, void **val)
 
   *val = node ? node->val : NULL;
 }
+
+static int64_t _days_from_civil(int64_t y, int m, int d)
+{
+  // http://howardhinnant.github.io/date_algorithms.html#days_from_civil
+  y -= m <= 2;
+  const int64_t era = (y >= 0 ? y : y - 399) / 400;
+  const int64_t yoe = y - era * 400;
+  const int64_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+  const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+static int _days_of_month(int64_t y, int m)
+{
+  static const int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  if (m != 2) return days[m-1];
+  if ((y % 4 == 0 && y % 100 != 0) || y % 400 == 0) return 29;
+  return 28;
+}
+
+static int _utc_offset_at(int64_t utc, int32_t *offset)
+{
+  time_t t = (time_t)utc;
+  struct tm tm = {0};
+  if (!localtime_r(&t, &tm)) return -1;
+
+  int64_t local = _days_from_civil(tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday) * 86400;
+  local += tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec;
+  *offset = (int32_t)(local - utc);
+  return 0;
+}
+
+int tod_local_to_utc(tz_cache_t *cache, int64_t local, int64_t *utc)
+{
+  int64_t hour = local / 3600;
+  if (local % 3600 < 0) hour -= 1;
+  size_t idx = (size_t)((uint64_t)hour % TZ_CACHE_SLOTS);
+
+  if (cache && cache->slots[idx].valid && cache->slots[idx].hour == hour) {
+    *utc = local - cache->slots[idx].offset;
+    return 0;
+  }
+
+  int32_t off0 = 0, off1 = 0;
+  if (_utc_offset_at(local, &off0)) return -1;
+  if (_utc_offset_at(local - off0, &off1)) return -1;
+  *utc = local - off1;
+
+  if (!cache) return 0;
+
+  // NOTE: cache only when the whole wall-clock hour shares the same utc-offset
+  int32_t head = 0, tail = 0;
+  if (_utc_offset_at(hour * 3600 - off1, &head)) return 0;
+  if (_utc_offset_at(hour * 3600 + 3599 - off1, &tail)) return 0;
+  if (head != off1 || tail != off1) return 0;
+
+  cache->slots[idx].hour   = hour;
+  cache->slots[idx].offset = off1;
+  cache->slots[idx].valid  = 1;
+
+  return 0;
+}
+
+static int _parse_uint(const char **pp, const char *end, int min_digits, int max_digits, int *v)
+{
+  const char *p = *pp;
+  int x = 0;
+  int n = 0;
+  while (p < end && n < max_digits && *p >= '0' && *p <= '9') {
+    x = x * 10 + (*p - '0');
+    ++p;
+    ++n;
+  }
+  if (n < min_digits) return -1;
+  *pp = p;
+  *v = x;
+  return 0;
+}
+
+static int _parse_sep(const char **pp, const char *end, char sep)
+{
+  if (*pp >= end || **pp != sep) return -1;
+  *pp += 1;
+  return 0;
+}
+
+static int _parse_tz(const char **pp, const char *end, int32_t *offset)
+{
+  const char *p = *pp;
+  if (p >= end) return -1;
+
+  if (*p == 'Z' || *p == 'z') {
+    *offset = 0;
+    *pp = p + 1;
+    return 0;
+  }
+
+  int sign = 1;
+  if (*p == '+') sign = 1;
+  else if (*p == '-') sign = -1;
+  else return -1;
+  ++p;
+
+  int hh = 0, mm = 0;
+  if (_parse_uint(&p, end, 2, 2, &hh)) return -1;
+  if (p < end) {
+    if (*p == ':') ++p;
+    if (_parse_uint(&p, end, 2, 2, &mm)) return -1;
+  }
+  if (hh > 14 || mm > 59) return -1;
+
+  *offset = sign * (hh * 3600 + mm * 60);
+  *pp = p;
+  return 0;
+}
+
+int tod_parse_iso8601(const char *s, size_t len, tz_cache_t *cache, tod_ts_t *ts)
+{
+  const char *p   = s;
+  const char *end = s + len;
+
+  int Y = 0, M = 0, D = 0, h = 0, m = 0, sec = 0;
+
+  while (p < end && *p == ' ') ++p;
+
+  if (_parse_uint(&p, end, 1, 4, &Y)) return -1;
+  if (_parse_sep(&p, end, '-')) return -1;
+  if (_parse_uint(&p, end, 1, 2, &M)) return -1;
+  if (_parse_sep(&p, end, '-')) return -1;
+  if (_parse_uint(&p, end, 1, 2, &D)) return -1;
+  if (p < end && (*p == 'T' || *p == 't')) {
+    ++p;
+  } else {
+    if (p >= end || *p != ' ') return -1;
+    while (p < end && *p == ' ') ++p;
+  }
+  if (_parse_uint(&p, end, 1, 2, &h)) return -1;
+  if (_parse_sep(&p, end, ':')) return -1;
+  if (_parse_uint(&p, end, 1, 2, &m)) return -1;
+  if (_parse_sep(&p, end, ':')) return -1;
+  if (_parse_uint(&p, end, 1, 2, &sec)) return -1;
+
+  if (M < 1 || M > 12) return -2;
+  if (D < 1 || D > _days_of_month(Y, M)) return -2;
+  if (h > 23 || m > 59 || sec > 60) return -2;
+
+  int32_t nsec = 0;
+  int frac_digits = 0;
+  if (p < end && *p == '.') {
+    ++p;
+    while (p < end && *p >= '0' && *p <= '9') {
+      if (++frac_digits > 9) return -2;
+      nsec = nsec * 10 + (*p - '0');
+      ++p;
+    }
+    if (frac_digits == 0) return -2;
+    for (int i = frac_digits; i < 9; ++i) nsec *= 10;
+  }
+
+  int has_tz = 0;
+  int32_t offset = 0;
+  if (p < end) {
+    if (_parse_tz(&p, end, &offset)) return -2;
+    has_tz = 1;
+  }
+  if (p != end) return -2;
+
+  int64_t v = _days_from_civil(Y, M, D) * 86400 + h * 3600 + m * 60 + sec;
+  if (has_tz) {
+    v -= offset;
+  } else {
+    if (tod_local_to_utc(cache, v, &v)) return -2;
+  }
+
+  ts->sec         = v;
+  ts->nsec        = nsec;
+  ts->frac_digits = (int8_t)frac_digits;
+  ts->has_tz      = (int8_t)has_tz;
+
+  return 0;
+}
+
+static int _is_blank(char c)
+{
+  return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+static int _digit_value(char c)
+{
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'z') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'Z') return c - 'A' + 10;
+  return 36;
+}
+
+static int _str_to_mag(const char *s, size_t len, int *neg, uint64_t *mag, const char **end)
+{
+  const char *p = s;
+  const char *e = s + len;
+  int overflow = 0;
+  int base = 10;
+  uint64_t x = 0;
+
+  while (p < e && _is_blank(*p)) ++p;
+  *neg = 0;
+  if (p < e && (*p == '+' || *p == '-')) {
+    *neg = (*p == '-');
+    ++p;
+  }
+
+  if (p < e && *p == '0') {
+    if (p + 2 < e && (p[1] == 'x' || p[1] == 'X') && _digit_value(p[2]) < 16) {
+      base = 16;
+      p += 2;
+    } else {
+      base = 8;
+    }
+  }
+
+  const char *digits = p;
+  for (; p < e; ++p) {
+    int d = _digit_value(*p);
+    if (d >= base) break;
+    if (x > (UINT64_MAX - (uint64_t)d) / (uint64_t)base) {
+      overflow = 1;
+    } else {
+      x = x * (uint64_t)base + (uint64_t)d;
+    }
+  }
+
+  if (p == digits) {
+    *end = s;
+    return -1;
+  }
+  *end = p;
+  if (p != e) return -1;
+  if (overflow) return -2;
+
+  *mag = x;
+  return 0;
+}
+
+int tod_str_to_i64(const char *s, size_t len, int64_t *v, const char **end)
+{
+  int neg = 0;
+  uint64_t mag = 0;
+  int r = _str_to_mag(s, len, &neg, &mag, end);
+  if (r) return r;
+
+  if (neg) {
+    if (mag > (uint64_t)INT64_MAX + 1) return -2;
+    *v = (mag == (uint64_t)INT64_MAX + 1) ? INT64_MIN : -(int64_t)mag;
+  } else {
+    if (mag > (uint64_t)INT64_MAX) return -2;
+    *v = (int64_t)mag;
+  }
+
+  return 0;
+}
+
+int tod_str_to_u64(const char *s, size_t len, uint64_t *v, const char **end)
+{
+  int neg = 0;
+  uint64_t mag = 0;
+  int r = _str_to_mag(s, len, &neg, &mag, end);
+  if (r) return r;
+
+  if (neg && mag) return -2;
+
+  *v = mag;
+  return 0;
+}
+
+// decimal text split as `mantissa * 10^exp10`, only when mantissa fits in 19 digits
+static int _str_to_decimal(const char *s, size_t len, int *neg, uint64_t *mantissa, int *exp10)
+{
+  const char *p = s;
+  const char *e = s + len;
+  uint64_t m = 0;
+  int nr_digits = 0;
+  int any = 0;
+  int ex = 0;
+
+  while (p < e && _is_blank(*p)) ++p;
+  *neg = 0;
+  if (p < e && (*p == '+' || *p == '-')) {
+    *neg = (*p == '-');
+    ++p;
+  }
+
+  for (; p < e && *p >= '0' && *p <= '9'; ++p) {
+    any = 1;
+    if (m == 0 && *p == '0') continue;
+    if (++nr_digits > 19) return -1;
+    m = m * 10 + (uint64_t)(*p - '0');
+  }
+  if (p < e && *p == '.') {
+    for (++p; p < e && *p >= '0' && *p <= '9'; ++p) {
+      any = 1;
+      --ex;
+      if (m == 0 && *p == '0') continue;
+      if (++nr_digits > 19) return -1;
+      m = m * 10 + (uint64_t)(*p - '0');
+    }
+  }
+  if (!any) return -1;
+
+  if (p < e && (*p == 'e' || *p == 'E')) {
+    ++p;
+    int eneg = 0;
+    int x = 0;
+    if (p < e && (*p == '+' || *p == '-')) {
+      eneg = (*p == '-');
+      ++p;
+    }
+    if (p >= e || *p < '0' || *p > '9') return -1;
+    for (; p < e && *p >= '0' && *p <= '9'; ++p) {
+      if (x > 100000) return -1;
+      x = x * 10 + (*p - '0');
+    }
+    ex += eneg ? -x : x;
+  }
+  if (p != e) return -1;
+
+  *mantissa = m;
+  *exp10 = ex;
+  return 0;
+}
+
+// fallback for what the fast path does not cover: hex-float, inf/nan, long mantissa, huge exponent, or malformed input
+static int _str_to_dbl_slow(const char *s, size_t len, int as_float, double *v, const char **end)
+{
+  char buf[128];
+  char *p = buf;
+  if (len >= sizeof(buf)) {
+    p = (char*)malloc(len + 1);
+    if (!p) {
+      *end = s;
+      return -1;
+    }
+  }
+  memcpy(p, s, len);
+  p[len] = '\0';
+
+  // NOTE: strtod honors LC_NUMERIC, which might be altered by the application
+  const char *dp = localeconv()->decimal_point;
+  if (dp && dp[0] != '.' && dp[0] && !dp[1]) {
+    char *x = memchr(p, '.', len);
+    if (x) *x = dp[0];
+  }
+
+  int r = 0;
+  char *stop = NULL;
+  errno = 0;
+  if (as_float) {
+    float flt = strtof(p, &stop);
+    if (errno == ERANGE && (fpclassify(flt) == FP_ZERO || isinf(flt))) r = -2;
+    *v = flt;
+  } else {
+    double dbl = strtod(p, &stop);
+    if (errno == ERANGE && (fpclassify(dbl) == FP_ZERO || isinf(dbl))) r = -2;
+    *v = dbl;
+  }
+  if (stop == p) {
+    *end = s;
+    r = -1;
+  } else {
+    *end = s + (stop - p);
+    if (*end != s + len) r = -1;
+  }
+
+  if (p != buf) free(p);
+  return r;
+}
+
+int tod_str_to_dbl(const char *s, size_t len, double *v, const char **end)
+{
+  static const double pow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+  };
+
+  int neg = 0;
+  uint64_t m = 0;
+  int ex = 0;
+  if (_str_to_decimal(s, len, &neg, &m, &ex) == 0 && m <= ((uint64_t)1 << 53) && ex >= -22 && ex <= 22) {
+    // NOTE: both operands are exact, thus correctly rounded by a single IEEE-754 operation
+    double d = (double)m;
+    d = ex < 0 ? d / pow10[-ex] : d * pow10[ex];
+    *v = neg ? -d : d;
+    *end = s + len;
+    return 0;
+  }
+
+  return _str_to_dbl_slow(s, len, 0, v, end);
+}
+
+int tod_str_to_flt(const char *s, size_t len, float *v, const char **end)
+{
+  static const float pow10[] = {
+    1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f,
+  };
+
+  int neg = 0;
+  uint64_t m = 0;
+  int ex = 0;
+  if (_str_to_decimal(s, len, &neg, &m, &ex) == 0 && m <= ((uint64_t)1 << 24) && ex >= -10 && ex <= 10) {
+    float f = (float)m;
+    f = ex < 0 ? f / pow10[-ex] : f * pow10[ex];
+    *v = neg ? -f : f;
+    *end = s + len;
+    return 0;
+  }
+
+  double d = 0;
+  int r = _str_to_dbl_slow(s, len, 1, &d, end);
+  *v = (float)d;
+  return r;
+}
+
+static const char* _skip_spaces(const char *p, const char *e)
+{
+  while (p < e && isspace((unsigned char)*p)) ++p;
+  return p;
+}
+
+static const char* _match_keyword(const char *p, const char *e, const char *kw)
+{
+  size_t n = strlen(kw);
+  if ((size_t)(e - p) < n) return NULL;
+  if (tod_strncasecmp(p, kw, n)) return NULL;
+  p += n;
+  if (p < e && (isalnum((unsigned char)*p) || *p == '_')) return NULL;
+  return p;
+}
+
+static const char* _skip_quoted(const char *p, const char *e)
+{
+  const char q = *p++;
+  while (p < e) {
+    if (*p == '\\') {
+      p += 2;
+      continue;
+    }
+    if (*p++ == q) return p;
+  }
+  return NULL;
+}
+
+static const char* _skip_parens(const char *p, const char *e)
+{
+  int depth = 0;
+  while (p < e) {
+    switch (*p) {
+      case '\'':
+      case '"':
+      case '`':
+        p = _skip_quoted(p, e);
+        if (!p) return NULL;
+        continue;
+      case '(':
+        ++depth;
+        break;
+      case ')':
+        if (--depth == 0) return p + 1;
+        break;
+      default:
+        break;
+    }
+    ++p;
+  }
+  return NULL;
+}
+
+int tod_parse_plain_insert(const char *s, size_t len, size_t *tail, size_t *rows)
+{
+  const char *e = s + len;
+  const char *p = _skip_spaces(s, e);
+
+  p = _match_keyword(p, e, "insert");
+  if (!p) return -1;
+  p = _skip_spaces(p, e);
+  p = _match_keyword(p, e, "into");
+  if (!p) return -1;
+  p = _skip_spaces(p, e);
+
+  const char *tbl = p;
+  while (p < e) {
+    if (*p == '`') {
+      p = _skip_quoted(p, e);
+      if (!p) return -1;
+      continue;
+    }
+    if (isalnum((unsigned char)*p) || *p == '_' || *p == '.') {
+      ++p;
+      continue;
+    }
+    break;
+  }
+  if (p == tbl) return -1;
+  p = _skip_spaces(p, e);
+
+  if (p < e && *p == '(') {
+    p = _skip_parens(p, e);
+    if (!p) return -1;
+    p = _skip_spaces(p, e);
+  }
+
+  p = _match_keyword(p, e, "values");
+  if (!p) return -1;
+
+  size_t nr = 0;
+  while (1) {
+    p = _skip_spaces(p, e);
+    if (p == e) break;
+    if (nr && *p == ',') {
+      p = _skip_spaces(p + 1, e);
+      if (p == e) return -1;
+    }
+    if (*p != '(') return -1;
+    p = _skip_parens(p, e);
+    if (!p) return -1;
+    ++nr;
+  }
+  if (nr == 0) return -1;
+
+  *tail = (size_t)(tbl - s);
+  *rows = nr;
+  return 0;
+}
+
+static const char* _parse_digits(const char *p, const char *e, int64_t *v)
+{
+  const char *b = p;
+  int64_t n = 0;
+  while (p < e && isdigit((unsigned char)*p)) {
+    if (n > (INT64_MAX - 9) / 10) return NULL;
+    n = n * 10 + (*p++ - '0');
+  }
+  if (p == b) return NULL;
+  *v = n;
+  return p;
+}
+
+int tod_parse_plain_select(const char *s, size_t len, size_t *start, size_t *end, int64_t *rows)
+{
+  const char *e = s + len;
+  const char *p = _skip_spaces(s, e);
+
+  p = _match_keyword(p, e, "select");
+  if (!p) return -1;
+
+  const char *limit_start = NULL;
+  const char *limit_end   = NULL;
+  int64_t limit           = -1;
+
+  while (1) {
+    p = _skip_spaces(p, e);
+    if (p == e) break;
+    switch (*p) {
+      case '\'':
+      case '"':
+      case '`':
+        p = _skip_quoted(p, e);
+        if (!p) return -1;
+        continue;
+      case '(':
+        p = _skip_parens(p, e);
+        if (!p) return -1;
+        continue;
+      case ';':
+        return -1;
+      case '-':
+        if (p + 1 < e && p[1] == '-') return -1;
+        ++p;
+        continue;
+      case '/':
+        if (p + 1 < e && p[1] == '*') return -1;
+        ++p;
+        continue;
+      default:
+        break;
+    }
+    if (!isalpha((unsigned char)*p) && *p != '_') {
+      ++p;
+      continue;
+    }
+
+    // NOTE: LIMIT is applied per partition with PARTITION BY, and to the whole compound with UNION
+    if (_match_keyword(p, e, "union") || _match_keyword(p, e, "partition")) return -1;
+
+    const char *q = _match_keyword(p, e, "limit");
+    if (!q) {
+      while (p < e && (isalnum((unsigned char)*p) || *p == '_')) ++p;
+      continue;
+    }
+    if (limit_start) return -1;
+
+    int64_t n1 = 0, n2 = 0;
+    const char *b1 = _skip_spaces(q, e);
+    const char *e1 = _parse_digits(b1, e, &n1);
+    if (!e1) return -1;
+    p = _skip_spaces(e1, e);
+    if (p < e && *p == ',') {
+      // LIMIT offset, rows
+      const char *b2 = _skip_spaces(p + 1, e);
+      const char *e2 = _parse_digits(b2, e, &n2);
+      if (!e2) return -1;
+      limit_start = b2;
+      limit_end   = e2;
+      limit       = n2;
+      p = e2;
+    } else {
+      limit_start = b1;
+      limit_end   = e1;
+      limit       = n1;
+    }
+  }
+
+  if (limit_start) {
+    *start = (size_t)(limit_start - s);
+    *end   = (size_t)(limit_end - s);
+    *rows  = limit;
+    return 0;
+  }
+
+  while (e > s && isspace((unsigned char)e[-1])) --e;
+  *start = (size_t)(e - s);
+  *end   = *start;
+  *rows  = -1;
+  return 0;
+}
+
+size_t tod_normalize_sql(const char *s, size_t len, char *buf)
+{
+  const char *e = s + len;
+  const char *p = _skip_spaces(s, e);
+  char *d = buf;
+
+  while (p < e) {
+    if (*p == '\'' || *p == '"' || *p == '`') {
+      const char *q = _skip_quoted(p, e);
+      if (!q) q = e;
+      memcpy(d, p, (size_t)(q - p));
+      d += q - p;
+      p = q;
+      continue;
+    }
+    if (isspace((unsigned char)*p)) {
+      p = _skip_spaces(p, e);
+      if (p < e) *d++ = ' ';
+      continue;
+    }
+    *d++ = (char)tolower((unsigned char)*p++);
+  }
+  *d = '\0';
+
+  return (size_t)(d - buf);
+}
+
+static const char* _parse_table_name(const char *p, const char *e)
+{
+  const char *b = p;
+  while (p < e) {
+    if (*p == '`') {
+      p = _skip_quoted(p, e);
+      if (!p) return NULL;
+      continue;
+    }
+    if (isalnum((unsigned char)*p) || *p == '_' || *p == '.') {
+      ++p;
+      continue;
+    }
+    break;
+  }
+  if (p == b) return NULL;
+  return p;
+}
+
+int tod_sql_write_target(const char *s, size_t len, size_t *start, size_t *end)
+{
+  const char *e = s + len;
+  const char *p = _skip_spaces(s, e);
+
+  if (_match_keyword(p, e, "select") || _match_keyword(p, e, "show") ||
+      _match_keyword(p, e, "desc") || _match_keyword(p, e, "describe") ||
+      _match_keyword(p, e, "use"))
+  {
+    return 0;
+  }
+
+  size_t tail = 0, rows = 0;
+  if (tod_parse_plain_insert(s, len, &tail, &rows) == 0) {
+    p = s + tail;
+  } else {
+    p = _match_keyword(p, e, "delete");
+    if (!p) return 2;
+    p = _match_keyword(_skip_spaces(p, e), e, "from");
+    if (!p) return 2;
+    p = _skip_spaces(p, e);
+  }
+
+  const char *q = _parse_table_name(p, e);
+  if (!q) return 2;
+
+  *start = (size_t)(p - s);
+  *end   = (size_t)(q - s);
+  return 1;
+}
+
+static const char* _ts_range_column(const char *p, const char *e)
+{
+  static const char *names[] = {"ts", "_rowts", "_c0"};
+
+  int quoted = (*p == '`');
+  if (quoted) ++p;
+  for (size_t i=0; i<sizeof(names)/sizeof(names[0]); ++i) {
+    const char *q = _match_keyword(p, e, names[i]);
+    if (!q) continue;
+    if (!quoted) return q;
+    if (q < e && *q == '`') return q + 1;
+  }
+  return NULL;
+}
+
+static const char* _ts_range_value(const char *p, const char *e, int64_t *v, int8_t *is_str)
+{
+  const char *q = NULL;
+
+  if (p < e && (*p == '\'' || *p == '"')) {
+    q = _skip_quoted(p, e);
+    if (!q) return NULL;
+    tod_ts_t ts = {0};
+    if (tod_parse_iso8601(p + 1, (size_t)(q - p - 2), NULL, &ts)) return NULL;
+    *v = ts.sec * 1000000000 + ts.nsec;
+    *is_str = 1;
+  } else {
+    int neg = (p < e && *p == '-');
+    if (p < e && (*p == '-' || *p == '+')) ++p;
+    q = _parse_digits(p, e, v);
+    if (!q) return NULL;
+    if (neg) *v = -*v;
+    *is_str = 0;
+  }
+
+  // NOTE: nothing but a literal, `ts < 1000 + 1` and alike are not recognized
+  const char *r = _skip_spaces(q, e);
+  if (r < e && !_match_keyword(r, e, "and")) return NULL;
+
+  return q;
+}
+
+int tod_parse_ts_range(const char *s, size_t len, tod_ts_range_t *range)
+{
+  static const char *rejected[] = {
+    "or", "order", "group", "partition", "union", "limit", "slimit", "soffset", "interval",
+    "session", "state_window", "event_window", "count_window", "fill", "having", "join",
+  };
+
+  const char *e = s + len;
+  const char *p = _skip_spaces(s, e);
+  const char *q = NULL;
+
+  p = _match_keyword(p, e, "select");
+  if (!p) return -1;
+
+  // NOTE: no function call at all in the select list, aggregate or not
+  while (1) {
+    p = _skip_spaces(p, e);
+    if (p == e) return -1;
+    if (*p == '\'' || *p == '"' || *p == '`') {
+      p = _skip_quoted(p, e);
+      if (!p) return -1;
+      continue;
+    }
+    if (*p == '(') return -1;
+    if (!isalpha((unsigned char)*p) && *p != '_') {
+      ++p;
+      continue;
+    }
+    if (_match_keyword(p, e, "distinct")) return -1;
+    q = _match_keyword(p, e, "from");
+    if (q) break;
+    while (p < e && (isalnum((unsigned char)*p) || *p == '_')) ++p;
+  }
+
+  p = _skip_spaces(q, e);
+  if (p < e && *p == '(') return -1;
+  p = _parse_table_name(p, e);
+  if (!p) return -1;
+  p = _match_keyword(_skip_spaces(p, e), e, "where");
+  if (!p) return -1;
+
+  int has_lo = 0, has_hi = 0;
+  int8_t is_str = -1;
+  int64_t lo = 0, hi = 0;
+
+  while (1) {
+    p = _skip_spaces(p, e);
+    if (p == e) break;
+    switch (*p) {
+      case '\'':
+      case '"':
+        p = _skip_quoted(p, e);
+        if (!p) return -1;
+        continue;
+      case '(':
+        p = _skip_parens(p, e);
+        if (!p) return -1;
+        continue;
+      case ';':
+        return -1;
+      case '-':
+        if (p + 1 < e && p[1] == '-') return -1;
+        ++p;
+        continue;
+      case '/':
+        if (p + 1 < e && p[1] == '*') return -1;
+        ++p;
+        continue;
+      default:
+        break;
+    }
+    if (!isalpha((unsigned char)*p) && *p != '_' && *p != '`') {
+      ++p;
+      continue;
+    }
+    for (size_t i=0; i<sizeof(rejected)/sizeof(rejected[0]); ++i) {
+      if (_match_keyword(p, e, rejected[i])) return -1;
+    }
+
+    q = _ts_range_column(p, e);
+    if (!q) {
+      if (*p == '`') {
+        p = _skip_quoted(p, e);
+        if (!p) return -1;
+        continue;
+      }
+      while (p < e && (isalnum((unsigned char)*p) || *p == '_')) ++p;
+      continue;
+    }
+
+    const char *col = p;
+    p = _skip_spaces(q, e);
+
+    int64_t v1 = 0, v2 = 0;
+    int8_t s1 = 0, s2 = 0;
+    int lower = 0, upper = 0;
+    if (p + 1 < e && (p[0] == '>' || p[0] == '<') && p[1] == '=') {
+      lower = (p[0] == '>');
+      upper = !lower;
+      p = _ts_range_value(_skip_spaces(p + 2, e), e, &v1, &s1);
+    } else if (p < e && (p[0] == '>' || p[0] == '<') && (p + 1 == e || p[1] != '>')) {
+      lower = (p[0] == '>');
+      upper = !lower;
+      p = _ts_range_value(_skip_spaces(p + 1, e), e, &v1, &s1);
+    } else if ((q = _match_keyword(p, e, "between")) != NULL) {
+      p = _ts_range_value(_skip_spaces(q, e), e, &v1, &s1);
+      if (!p) return -1;
+      p = _match_keyword(_skip_spaces(p, e), e, "and");
+      if (!p) return -1;
+      p = _ts_range_value(_skip_spaces(p, e), e, &v2, &s2);
+      if (p && s1 != s2) return -1;
+      lower = 1;
+      upper = 2;
+    } else {
+      continue;
+    }
+    if (!p) return -1;
+
+    // NOTE: integers are in the precision of the database, which is unknown, thus never mixed with strings
+    if (is_str != -1 && is_str != s1) return -1;
+    is_str = s1;
+    if (lower) {
+      if (!has_lo || v1 > lo) lo = v1;
+      has_lo = 1;
+    }
+    if (upper) {
+      int64_t v = (upper == 2) ? v2 : v1;
+      if (!has_hi || v < hi) hi = v;
+      has_hi = 1;
+    }
+    range->col     = (size_t)(col - s);
+    if (*col == '`') {
+      range->col_len = (size_t)(_skip_quoted(col, e) - col);
+    } else {
+      const char *c = col;
+      while (c < e && (isalnum((unsigned char)*c) || *c == '_')) ++c;
+      range->col_len = (size_t)(c - col);
+    }
+  }
+
+  if (!has_lo || !has_hi || lo >= hi) return -1;
+
+  while (e > s && isspace((unsigned char)e[-1])) --e;
+  range->end    = (size_t)(e - s);
+  range->lo     = lo;
+  range->hi     = hi;
+  range->is_str = is_str;
+  return 0;
+}
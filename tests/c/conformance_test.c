@@ -23,6 +23,7 @@
  */
 
 #include "odbc_helpers.h"
+#include "taos_odbc_ext.h"
 
 #include "../test_helper.h"
 
@@ -1439,6 +1440,431 @@ static int test_case9(SQLHANDLE hconn)
   return r ? -1 : 0;
 }
 
+static int test_case10_with_stmt(SQLHANDLE hconn, SQLHANDLE hstmt)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+
+  sr = CALL_SQLSetStmtAttr(hstmt, SQL_ATTR_TAOS_PERF_RESET, 0, 0);
+  if (FAILED(sr)) return -1;
+
+  sr = CALL_SQLExecDirect(hstmt, (SQLCHAR*)"show databases", SQL_NTS);
+  if (FAILED(sr)) return -1;
+
+  int64_t rows = 0;
+  while (1) {
+    sr = CALL_SQLFetch(hstmt);
+    if (sr == SQL_NO_DATA) break;
+    if (FAILED(sr)) return -1;
+    ++rows;
+  }
+
+  taos_odbc_perf_t perf = {0};
+  SQLINTEGER len = 0;
+  sr = CALL_SQLGetStmtAttr(hstmt, SQL_ATTR_TAOS_PERF, &perf, sizeof(perf), &len);
+  if (FAILED(sr)) return -1;
+  if (len != (SQLINTEGER)sizeof(perf)) {
+    E("SQL_ATTR_TAOS_PERF:%d bytes expected, but got ==%d==", (int)sizeof(perf), len);
+    return -1;
+  }
+  if (perf.rows_fetched != rows || perf.blocks_fetched < 1 || perf.taosc_us < 0 || perf.convert_us < 0) {
+    E("rows_fetched:%" PRId64 " expected, but got ==%" PRId64 "==, blocks_fetched:%" PRId64 ", taosc_us:%" PRId64 ", convert_us:%" PRId64 "",
+        rows, perf.rows_fetched, perf.blocks_fetched, perf.taosc_us, perf.convert_us);
+    return -1;
+  }
+
+  SQLBIGINT v = 0;
+  sr = CALL_SQLGetConnectAttr(hconn, SQL_ATTR_TAOS_PERF_ROWS_FETCHED, &v, sizeof(v), NULL);
+  if (FAILED(sr)) return -1;
+  if (v < rows) {
+    E("connection rows_fetched:at least %" PRId64 " expected, but got ==%" PRId64 "==", rows, (int64_t)v);
+    return -1;
+  }
+
+  sr = CALL_SQLGetStmtAttr(hstmt, SQL_ATTR_TAOS_PERF, &perf, 1, &len);
+  if (sr != SQL_ERROR) {
+    E("SQL_ATTR_TAOS_PERF with insufficient buffer shall fail");
+    return -1;
+  }
+
+  // NOTE: no-op unless TAOS_ODBC_PROFILE=1
+  sr = CALL_SQLSetConnectAttr(hconn, SQL_ATTR_TAOS_PROFILE_DUMP, 0, 0);
+  if (FAILED(sr)) return -1;
+
+  return 0;
+}
+
+static int test_case10(SQLHANDLE hconn)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+  int r = 0;
+
+  if (_under_taos_mysql_sqlite3) return 0;
+
+  SQLHANDLE hstmt;
+
+  sr = CALL_SQLAllocHandle(SQL_HANDLE_STMT, hconn, &hstmt);
+  if (FAILED(sr)) return -1;
+
+  r = test_case10_with_stmt(hconn, hstmt);
+
+  CALL_SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+
+  return r ? -1 : 0;
+}
+
+typedef struct cancel_arg_s          cancel_arg_t;
+struct cancel_arg_s {
+  SQLHANDLE        hstmt;
+  SQLRETURN        sr;
+};
+
+static void* _test_case11_cancel_routine(void *arg)
+{
+  cancel_arg_t *cancel = (cancel_arg_t*)arg;
+  tod_sleep_ms(1);
+  cancel->sr = CALL_SQLCancel(cancel->hstmt);
+  return NULL;
+}
+
+static int test_case11_with_stmt(SQLHANDLE hstmt)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+
+  sr = CALL_SQLSetStmtAttr(hstmt, SQL_ATTR_QUERY_TIMEOUT, (SQLPOINTER)3, 0);
+  if (sr != SQL_SUCCESS) {
+    E("SQL_ATTR_QUERY_TIMEOUT shall be accepted as is");
+    return -1;
+  }
+
+  SQLULEN timeout = 0;
+  sr = CALL_SQLGetStmtAttr(hstmt, SQL_ATTR_QUERY_TIMEOUT, &timeout, sizeof(timeout), NULL);
+  if (FAILED(sr)) return -1;
+  if (timeout != 3) {
+    E("SQL_ATTR_QUERY_TIMEOUT:3 expected, but got ==%zd==", (size_t)timeout);
+    return -1;
+  }
+
+  // no effect when nothing is running
+  sr = CALL_SQLCancel(hstmt);
+  if (sr != SQL_SUCCESS) return -1;
+
+  for (int i=0; i<8; ++i) {
+    sr = CALL_SQLExecDirect(hstmt, (SQLCHAR*)"show databases", SQL_NTS);
+    if (FAILED(sr)) return -1;
+
+    cancel_arg_t cancel = {hstmt, SQL_SUCCESS};
+    pthread_t worker;
+    int r = pthread_create(&worker, NULL, _test_case11_cancel_routine, &cancel);
+    if (r) {
+      E("pthread_create failed:[%d]%s", r, strerror(r));
+      return -1;
+    }
+
+    // either all rows are fetched before the cancel lands, or the fetch is canceled with HY008
+    while (1) {
+      sr = CALL_SQLFetch(hstmt);
+      if (sr == SQL_NO_DATA) break;
+      if (sr == SQL_ERROR) break;
+    }
+
+    pthread_join(worker, NULL);
+    if (cancel.sr != SQL_SUCCESS) return -1;
+
+    CALL_SQLCloseCursor(hstmt);
+  }
+
+  sr = CALL_SQLSetStmtAttr(hstmt, SQL_ATTR_QUERY_TIMEOUT, (SQLPOINTER)0, 0);
+  if (FAILED(sr)) return -1;
+
+  // statement shall remain usable after being canceled
+  sr = CALL_SQLExecDirect(hstmt, (SQLCHAR*)"show databases", SQL_NTS);
+  if (FAILED(sr)) return -1;
+  CALL_SQLCloseCursor(hstmt);
+
+  return 0;
+}
+
+static int test_case11(SQLHANDLE hconn)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+  int r = 0;
+
+  if (_under_taos_mysql_sqlite3) return 0;
+
+  SQLHANDLE hstmt;
+
+  sr = CALL_SQLAllocHandle(SQL_HANDLE_STMT, hconn, &hstmt);
+  if (FAILED(sr)) return -1;
+
+  r = test_case11_with_stmt(hstmt);
+
+  CALL_SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+
+  return r ? -1 : 0;
+}
+
+static int _test_case12_fetch_all(SQLHANDLE hstmt, int async, int64_t *rows)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+
+  *rows = 0;
+
+again:
+  sr = CALL_SQLExecDirect(hstmt, (SQLCHAR*)"show databases", SQL_NTS);
+  if (sr == SQL_STILL_EXECUTING && async) {
+    tod_sleep_ms(1);
+    goto again;
+  }
+  if (FAILED(sr)) return -1;
+
+  while (1) {
+    sr = CALL_SQLFetch(hstmt);
+    if (sr == SQL_STILL_EXECUTING && async) {
+      tod_sleep_ms(1);
+      continue;
+    }
+    if (sr == SQL_NO_DATA) break;
+    if (FAILED(sr)) return -1;
+    ++*rows;
+  }
+
+  CALL_SQLCloseCursor(hstmt);
+
+  return 0;
+}
+
+static int test_case12_with_stmt(SQLHANDLE hconn, SQLHANDLE hstmt)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+  int r = 0;
+
+  SQLUINTEGER async_mode = 0;
+  sr = CALL_SQLGetInfo(hconn, SQL_ASYNC_MODE, &async_mode, sizeof(async_mode), NULL);
+  if (FAILED(sr)) return -1;
+  if (async_mode != SQL_AM_STATEMENT) {
+    E("SQL_ASYNC_MODE:SQL_AM_STATEMENT expected, but got ==%u==", async_mode);
+    return -1;
+  }
+
+  int64_t expected = 0;
+  r = _test_case12_fetch_all(hstmt, 0, &expected);
+  if (r) return -1;
+
+  sr = CALL_SQLSetStmtAttr(hstmt, SQL_ATTR_ASYNC_ENABLE, (SQLPOINTER)SQL_ASYNC_ENABLE_ON, 0);
+  if (FAILED(sr)) return -1;
+
+  for (int i=0; i<4; ++i) {
+    int64_t rows = 0;
+    r = _test_case12_fetch_all(hstmt, 1, &rows);
+    if (r) return -1;
+    if (rows != expected) {
+      E("async:%" PRId64 " rows expected, but got ==%" PRId64 "==", expected, rows);
+      return -1;
+    }
+  }
+
+  sr = CALL_SQLSetStmtAttr(hstmt, SQL_ATTR_ASYNC_ENABLE, (SQLPOINTER)SQL_ASYNC_ENABLE_OFF, 0);
+  if (FAILED(sr)) return -1;
+
+  return 0;
+}
+
+static int test_case12(SQLHANDLE hconn)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+  int r = 0;
+
+  if (_under_taos_mysql_sqlite3) return 0;
+
+  SQLHANDLE hstmt;
+
+  sr = CALL_SQLAllocHandle(SQL_HANDLE_STMT, hconn, &hstmt);
+  if (FAILED(sr)) return -1;
+
+  r = test_case12_with_stmt(hconn, hstmt);
+
+  CALL_SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+
+  return r ? -1 : 0;
+}
+
+static int _test_case13_count(SQLHANDLE hstmt, const char *sql, int64_t *rows)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+
+  *rows = 0;
+
+  sr = CALL_SQLExecDirect(hstmt, (SQLCHAR*)sql, SQL_NTS);
+  if (FAILED(sr)) return -1;
+
+  while (1) {
+    sr = CALL_SQLFetch(hstmt);
+    if (sr == SQL_NO_DATA) break;
+    if (FAILED(sr)) return -1;
+    ++*rows;
+  }
+
+  CALL_SQLCloseCursor(hstmt);
+
+  return 0;
+}
+
+static int test_case13_with_stmt(SQLHANDLE hstmt)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+  int r = 0;
+
+  const char *sqls[] = {
+    "show databases",                                             // capped while fetching
+    "select * from information_schema.ins_databases",             // `LIMIT` injected
+    "select * from information_schema.ins_databases limit 100",   // `LIMIT` tightened
+  };
+
+  for (size_t i=0; i<sizeof(sqls)/sizeof(sqls[0]); ++i) {
+    const char *sql = sqls[i];
+    int64_t expected = 0;
+    sr = CALL_SQLSetStmtAttr(hstmt, SQL_ATTR_MAX_ROWS, (SQLPOINTER)0, 0);
+    if (FAILED(sr)) return -1;
+    r = _test_case13_count(hstmt, sql, &expected);
+    if (r) return -1;
+    if (expected < 2) continue;
+
+    SQLULEN max_rows = 0;
+    sr = CALL_SQLSetStmtAttr(hstmt, SQL_ATTR_MAX_ROWS, (SQLPOINTER)1, 0);
+    if (FAILED(sr)) return -1;
+    sr = CALL_SQLGetStmtAttr(hstmt, SQL_ATTR_MAX_ROWS, &max_rows, sizeof(max_rows), NULL);
+    if (FAILED(sr)) return -1;
+    if (max_rows != 1) {
+      E("SQL_ATTR_MAX_ROWS:1 expected, but got ==%zd==", (size_t)max_rows);
+      return -1;
+    }
+
+    int64_t rows = 0;
+    r = _test_case13_count(hstmt, sql, &rows);
+    if (r) return -1;
+    if (rows != 1) {
+      E("[%s]:1 row expected under SQL_ATTR_MAX_ROWS, but got ==%" PRId64 "==", sql, rows);
+      return -1;
+    }
+  }
+
+  sr = CALL_SQLSetStmtAttr(hstmt, SQL_ATTR_MAX_ROWS, (SQLPOINTER)0, 0);
+  if (FAILED(sr)) return -1;
+
+  return 0;
+}
+
+static int test_case13(SQLHANDLE hconn)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+  int r = 0;
+
+  if (_under_taos_mysql_sqlite3) return 0;
+
+  SQLHANDLE hstmt;
+
+  sr = CALL_SQLAllocHandle(SQL_HANDLE_STMT, hconn, &hstmt);
+  if (FAILED(sr)) return -1;
+
+  r = test_case13_with_stmt(hstmt);
+
+  CALL_SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+
+  return r ? -1 : 0;
+}
+
+static int _test_case14_check(SQLHANDLE hstmt, SQLSMALLINT orientation, SQLLEN offset, const char *expected)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+
+  sr = CALL_SQLFetchScroll(hstmt, orientation, offset);
+  if (!expected) {
+    if (sr == SQL_NO_DATA) return 0;
+    E("%s/%zd:SQL_NO_DATA expected, but got ==%d==", sql_fetch_orientation(orientation), (size_t)offset, sr);
+    return -1;
+  }
+  if (FAILED(sr)) return -1;
+
+  char name[256]; name[0] = '\0';
+  SQLLEN len = 0;
+  sr = CALL_SQLGetData(hstmt, 1, SQL_C_CHAR, name, sizeof(name), &len);
+  if (FAILED(sr)) return -1;
+  if (strcmp(name, expected)) {
+    E("%s/%zd:`%s` expected, but got ==%s==", sql_fetch_orientation(orientation), (size_t)offset, expected, name);
+    return -1;
+  }
+
+  return 0;
+}
+
+static int test_case14_with_stmt(SQLHANDLE hstmt)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+  int r = 0;
+
+  const char *sql = "select name from information_schema.ins_databases";
+  char names[64][256];
+  size_t nr = 0;
+
+  sr = CALL_SQLSetStmtAttr(hstmt, SQL_ATTR_CURSOR_TYPE, (SQLPOINTER)SQL_CURSOR_STATIC, 0);
+  if (FAILED(sr)) return -1;
+
+  sr = CALL_SQLExecDirect(hstmt, (SQLCHAR*)sql, SQL_NTS);
+  if (FAILED(sr)) return -1;
+  while (nr < sizeof(names)/sizeof(names[0])) {
+    sr = CALL_SQLFetch(hstmt);
+    if (sr == SQL_NO_DATA) break;
+    if (FAILED(sr)) return -1;
+    SQLLEN len = 0;
+    sr = CALL_SQLGetData(hstmt, 1, SQL_C_CHAR, names[nr], sizeof(names[nr]), &len);
+    if (FAILED(sr)) return -1;
+    ++nr;
+  }
+  if (nr < 2 || nr == sizeof(names)/sizeof(names[0])) {
+    CALL_SQLCloseCursor(hstmt);
+    return 0;
+  }
+
+  // NOTE: scroll back and forth over what have been fetched, without re-executing
+  r = _test_case14_check(hstmt, SQL_FETCH_LAST,     0,              names[nr-1]);
+  if (!r) r = _test_case14_check(hstmt, SQL_FETCH_PRIOR,    0,              names[nr-2]);
+  if (!r) r = _test_case14_check(hstmt, SQL_FETCH_FIRST,    0,              names[0]);
+  if (!r) r = _test_case14_check(hstmt, SQL_FETCH_ABSOLUTE, 2,              names[1]);
+  if (!r) r = _test_case14_check(hstmt, SQL_FETCH_RELATIVE, -1,             names[0]);
+  if (!r) r = _test_case14_check(hstmt, SQL_FETCH_PRIOR,    0,              NULL);
+  if (!r) r = _test_case14_check(hstmt, SQL_FETCH_NEXT,     0,              names[0]);
+  if (!r) r = _test_case14_check(hstmt, SQL_FETCH_ABSOLUTE, -1,             names[nr-1]);
+  if (!r) r = _test_case14_check(hstmt, SQL_FETCH_NEXT,     0,              NULL);
+  if (!r) r = _test_case14_check(hstmt, SQL_FETCH_RELATIVE, -(SQLLEN)nr,    names[0]);
+  if (!r) r = _test_case14_check(hstmt, SQL_FETCH_ABSOLUTE, (SQLLEN)nr + 1, NULL);
+
+  CALL_SQLCloseCursor(hstmt);
+
+  sr = CALL_SQLSetStmtAttr(hstmt, SQL_ATTR_CURSOR_TYPE, (SQLPOINTER)SQL_CURSOR_FORWARD_ONLY, 0);
+  if (FAILED(sr)) return -1;
+
+  return r ? -1 : 0;
+}
+
+static int test_case14(SQLHANDLE hconn)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+  int r = 0;
+
+  if (_under_taos_mysql_sqlite3) return 0;
+
+  SQLHANDLE hstmt;
+
+  sr = CALL_SQLAllocHandle(SQL_HANDLE_STMT, hconn, &hstmt);
+  if (FAILED(sr)) return -1;
+
+  r = test_case14_with_stmt(hstmt);
+
+  CALL_SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+
+  return r ? -1 : 0;
+}
+
 static int _vexec_(SQLHANDLE hstmt, const char *fmt, va_list ap)
 {
   SQLRETURN sr = SQL_SUCCESS;
@@ -2149,6 +2575,107 @@ static int test_bind_exec_direct(SQLHANDLE hconn)
   return (r || FAILED(sr)) ? -1 : 0;
 }
 
+static int _test_case16_scan(SQLHANDLE hstmt, SQLULEN lanes, int64_t *rows)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+
+  sr = CALL_SQLSetStmtAttr(hstmt, SQL_ATTR_TAOS_PARALLEL_SCAN, (SQLPOINTER)lanes, 0);
+  if (FAILED(sr)) return -1;
+
+  SQLULEN v = 0;
+  sr = CALL_SQLGetStmtAttr(hstmt, SQL_ATTR_TAOS_PARALLEL_SCAN, &v, sizeof(v), NULL);
+  if (FAILED(sr)) return -1;
+  if (v != lanes) {
+    E("SQL_ATTR_TAOS_PARALLEL_SCAN:%zd expected, but got ==%zd==", (size_t)lanes, (size_t)v);
+    return -1;
+  }
+
+  const char *sql = "select ts, v from foo_ps.t where ts >= 1700000000000 and ts < 1700000200000";
+  sr = CALL_SQLExecDirect(hstmt, (SQLCHAR*)sql, SQL_NTS);
+  if (FAILED(sr)) return -1;
+
+  *rows = 0;
+  while (1) {
+    sr = CALL_SQLFetch(hstmt);
+    if (sr == SQL_NO_DATA) break;
+    if (FAILED(sr)) return -1;
+    int64_t val = 0;
+    sr = CALL_SQLGetData(hstmt, 2, SQL_C_SBIGINT, &val, sizeof(val), NULL);
+    if (FAILED(sr)) return -1;
+    // NOTE: rows of lanes are expected in the same timestamp order as those of a single query
+    if (val != *rows) {
+      E("[%s]:%zd lanes, row #%" PRId64 " expected, but got ==%" PRId64 "==", sql, (size_t)lanes, *rows, val);
+      CALL_SQLCloseCursor(hstmt);
+      return -1;
+    }
+    *rows += 1;
+  }
+
+  CALL_SQLCloseCursor(hstmt);
+
+  return 0;
+}
+
+static int test_case16_with_stmt(SQLHANDLE hstmt)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+  int r = 0;
+
+  r = _exec_(hstmt, "drop database if exists foo_ps");
+  if (r) return -1;
+  r = _exec_(hstmt, "create database foo_ps");
+  if (r) return -1;
+  r = _exec_(hstmt, "create table foo_ps.t (ts timestamp, v int)");
+  if (r) return -1;
+  for (int i=0; i<200; i+=20) {
+    char buf[1024];
+    int n = snprintf(buf, sizeof(buf), "insert into foo_ps.t values");
+    for (int j=i; j<i+20; ++j) {
+      n += snprintf(buf + n, sizeof(buf) - n, " (%" PRId64 ", %d)", (int64_t)1700000000000 + j * 1000, j);
+    }
+    r = _exec_(hstmt, "%s", buf);
+    if (r) return -1;
+  }
+
+  const SQLULEN lanes[] = {0, 4, 3};
+  for (size_t i=0; i<sizeof(lanes)/sizeof(lanes[0]); ++i) {
+    int64_t rows = 0;
+    r = _test_case16_scan(hstmt, lanes[i], &rows);
+    if (r) return -1;
+    if (rows != 200) {
+      E("%zd lanes:200 rows expected, but got ==%" PRId64 "==", (size_t)lanes[i], rows);
+      return -1;
+    }
+  }
+
+  sr = CALL_SQLSetStmtAttr(hstmt, SQL_ATTR_TAOS_PARALLEL_SCAN, (SQLPOINTER)0, 0);
+  if (FAILED(sr)) return -1;
+
+  r = _exec_(hstmt, "drop database if exists foo_ps");
+  if (r) return -1;
+
+  return 0;
+}
+
+static int test_case16(SQLHANDLE hconn)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+  int r = 0;
+
+  if (_under_taos_mysql_sqlite3) return 0;
+
+  SQLHANDLE hstmt;
+
+  sr = CALL_SQLAllocHandle(SQL_HANDLE_STMT, hconn, &hstmt);
+  if (FAILED(sr)) return -1;
+
+  r = test_case16_with_stmt(hstmt);
+
+  CALL_SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+
+  return r ? -1 : 0;
+}
+
 static int test_cases(SQLHANDLE hconn)
 {
   int r = 0;
@@ -2199,6 +2726,24 @@ static int test_cases(SQLHANDLE hconn)
   r = test_case9(hconn);
   if (r) return r;
 
+  r = test_case10(hconn);
+  if (r) return r;
+
+  r = test_case11(hconn);
+  if (r) return r;
+
+  r = test_case12(hconn);
+  if (r) return r;
+
+  r = test_case13(hconn);
+  if (r) return r;
+
+  r = test_case14(hconn);
+  if (r) return r;
+
+  r = test_case16(hconn);
+  if (r) return r;
+
   return r;
 }
 
@@ -2229,6 +2774,112 @@ static void check_driver(SQLHANDLE hconn)
   _under_taos_mysql_sqlite3 = 0;
 }
 
+static int _test_case15_count(SQLHANDLE hstmt, int64_t *count, SQLBIGINT *blocks)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+
+  SQLBIGINT blocks0 = 0, blocks1 = 0;
+  sr = CALL_SQLGetStmtAttr(hstmt, SQL_ATTR_TAOS_PERF_BLOCKS_FETCHED, &blocks0, sizeof(blocks0), NULL);
+  if (FAILED(sr)) return -1;
+
+  sr = CALL_SQLExecDirect(hstmt, (SQLCHAR*)"select count(*) from foo_rc.t", SQL_NTS);
+  if (FAILED(sr)) return -1;
+
+  sr = CALL_SQLFetch(hstmt);
+  if (FAILED(sr) || sr == SQL_NO_DATA) return -1;
+  sr = CALL_SQLGetData(hstmt, 1, SQL_C_SBIGINT, count, sizeof(*count), NULL);
+  if (FAILED(sr)) return -1;
+  // NOTE: the result set is kept in the result cache only if all rows are fetched
+  sr = CALL_SQLFetch(hstmt);
+  if (sr != SQL_NO_DATA) return -1;
+
+  CALL_SQLCloseCursor(hstmt);
+
+  sr = CALL_SQLGetStmtAttr(hstmt, SQL_ATTR_TAOS_PERF_BLOCKS_FETCHED, &blocks1, sizeof(blocks1), NULL);
+  if (FAILED(sr)) return -1;
+  *blocks = blocks1 - blocks0;
+
+  return 0;
+}
+
+static int test_case15_with_stmt(SQLHANDLE hstmt)
+{
+  int r = 0;
+
+  r = _exec_(hstmt, "drop database if exists foo_rc");
+  if (r) return -1;
+  r = _exec_(hstmt, "create database foo_rc");
+  if (r) return -1;
+  r = _exec_(hstmt, "create table foo_rc.t (ts timestamp, v int)");
+  if (r) return -1;
+  r = _exec_(hstmt, "insert into foo_rc.t values (now, 1)");
+  if (r) return -1;
+
+  const struct {
+    int64_t         count;
+    int             hit;
+    const char     *write;
+  } _cases[] = {
+    {1, 0, NULL},
+    {1, 1, "insert into foo_rc.t values (now+1s, 2)"},
+    {2, 0, NULL},
+    {2, 1, NULL},
+  };
+
+  for (size_t i=0; i<sizeof(_cases)/sizeof(_cases[0]); ++i) {
+    int64_t count = 0;
+    SQLBIGINT blocks = 0;
+    r = _test_case15_count(hstmt, &count, &blocks);
+    if (r) return -1;
+    if (count != _cases[i].count) {
+      E("#%zd:count %" PRId64 " expected, but got ==%" PRId64 "==", i+1, _cases[i].count, count);
+      return -1;
+    }
+    if (_cases[i].hit != (blocks == 0)) {
+      E("#%zd:result cache %s expected, but got ==%" PRId64 "== blocks fetched", i+1, _cases[i].hit ? "hit" : "miss", (int64_t)blocks);
+      return -1;
+    }
+    if (_cases[i].write) {
+      r = _exec_(hstmt, "%s", _cases[i].write);
+      if (r) return -1;
+    }
+  }
+
+  r = _exec_(hstmt, "drop database if exists foo_rc");
+  if (r) return -1;
+
+  return 0;
+}
+
+static int test_case15(SQLHANDLE henv)
+{
+  SQLRETURN sr = SQL_SUCCESS;
+  int r = 0;
+
+  if (_under_taos_mysql_sqlite3) return 0;
+
+  SQLHANDLE hconn = SQL_NULL_HANDLE;
+  sr = CALL_SQLAllocHandle(SQL_HANDLE_DBC, henv, &hconn);
+  if (FAILED(sr)) return -1;
+
+  r = _driver_connect(hconn, "DSN=TAOS_ODBC_DSN;RESULT_CACHE_TTL_MS=60000");
+  if (r == 0) {
+    SQLHANDLE hstmt = SQL_NULL_HANDLE;
+    sr = CALL_SQLAllocHandle(SQL_HANDLE_STMT, hconn, &hstmt);
+    if (FAILED(sr)) {
+      r = -1;
+    } else {
+      r = test_case15_with_stmt(hstmt);
+      CALL_SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+    }
+    CALL_SQLDisconnect(hconn);
+  }
+
+  CALL_SQLFreeHandle(SQL_HANDLE_DBC, hconn);
+
+  return r ? -1 : 0;
+}
+
 static int test_connected_conn(SQLHANDLE hconn, conn_arg_t *conn_arg)
 {
   int r = 0;
@@ -2816,6 +3467,8 @@ static int test_env(int argc, char *argv[], SQLHANDLE henv)
 
   CALL_SQLFreeHandle(SQL_HANDLE_DBC, hconn);
 
+  if (r == 0) r = test_case15(henv);
+
   return r;
 }
 